@@ -15,9 +15,20 @@
 
 #include <boost/program_options.hpp>
 
+#include "access/system/OperatorProfile.h"
+#include "access/system/RequestParseTask.h"
+#include "access/system/WorkloadLayouter.h"
 #include "helper/HwlocHelper.h"
-#include "net/AsyncConnection.h"
+#include "helper/PerfEventTracer.h"
+#include "helper/QueryArena.h"
+#include "net/EventLoopPool.h"
+#include "io/GarbageCollector.h"
 #include "io/StorageManager.h"
+#include "io/TransactionManager.h"
+#include "layouter/calibration.h"
+#include "taskscheduler/AdmissionController.h"
+#include "taskscheduler/CentralScheduler.h"
+#include "taskscheduler/SchedulerTracer.h"
 #include "taskscheduler/SharedScheduler.h"
 
 namespace po = boost::program_options;
@@ -32,6 +43,12 @@ const char *PORT_FILE = "./hyrise_server.port";
 const size_t DEFAULT_PORT = 5000;
 // default maximum task size. 0 is disabled.
 const size_t DEFAULT_MTS = 0;
+// default garbage collection interval in ms. 0 is disabled.
+const size_t DEFAULT_GC_INTERVAL = 1000;
+// default time in s after which idle transactions are rolled back
+const size_t DEFAULT_SESSION_TIMEOUT = 600;
+// default number of event loops accepting connections
+const size_t DEFAULT_LISTENERS = 1;
 
 
 LoggerPtr logger(Logger::getLogger("hyrise"));
@@ -42,10 +59,10 @@ LoggerPtr logger(Logger::getLogger("hyrise"));
 /// we initialize
 class PortResource {
  public:
-  PortResource(size_t start, size_t end, ebb_server& s) : _current(0) {
+  PortResource(size_t start, size_t end, net::EventLoopPool& loops) : _current(0) {
     assert((start < end) && "start must be smaller than end");
     for (size_t current = start; current < end; ++current) {
-      if (ebb_server_listen_on_port(&s, current) != -1) {
+      if (loops.listen(current)) {
           _current = current;
           break;
       } else {
@@ -129,6 +146,18 @@ int main(int argc, char *argv[]) {
   std::string logPropertyFile;
   std::string scheduler_name;
   size_t maxTaskSize;
+  size_t gcInterval;
+  size_t sessionTimeout;
+  size_t inlineThreshold;
+  size_t queryMemoryLimit;
+  size_t memoryBudget;
+  size_t maxWaitingQueries;
+  size_t relayoutInterval;
+  std::string layouterCalibration;
+  size_t listeners;
+  size_t minWorkers;
+  size_t workerIdleTimeout;
+  size_t lockWaitTimeout;
 
   // Program Options
   po::options_description desc("Allowed Parameters");
@@ -136,8 +165,24 @@ int main(int argc, char *argv[]) {
   ("port,p", po::value<size_t>(&port)->default_value(DEFAULT_PORT), "Server Port")
   ("logdef,l", po::value<std::string>(&logPropertyFile)->default_value("build/log.properties"), "Log4CXX Log Properties File")
   ("maxTaskSize,m", po::value<size_t>(&maxTaskSize)->default_value(DEFAULT_MTS), "Maximum task size used in dynamic parallelization scheduler. Use 0 for unbounded task run time.")
+  ("gcInterval", po::value<size_t>(&gcInterval)->default_value(DEFAULT_GC_INTERVAL), "Interval in ms between garbage collection runs. Use 0 to disable garbage collection.")
+  ("sessionTimeout", po::value<size_t>(&sessionTimeout)->default_value(DEFAULT_SESSION_TIMEOUT), "Time in s after which idle transactions are rolled back by the garbage collector")
+  ("lockWaitTimeout", po::value<size_t>(&lockWaitTimeout)->default_value(tx::TransactionManager::DEFAULT_LOCK_WAIT_TIMEOUT_US), "Time in us a write waits for a row locked by another transaction before its transaction is aborted. Use 0 to abort right away.")
+  ("inlineThreshold", po::value<size_t>(&inlineThreshold)->default_value(access::RequestParseTask::DEFAULT_INLINE_THRESHOLD), "Queries that are a chain of at most this many operators run on the thread that parsed them instead of the scheduler. Use 0 to schedule all queries.")
+  ("queryMemoryLimit", po::value<size_t>(&queryMemoryLimit)->default_value(0), "Maximum size in bytes of the intermediate results a query may allocate from its arena before it is aborted. Use 0 for no limit.")
+  ("memoryBudget", po::value<size_t>(&memoryBudget)->default_value(0), "Bytes the intermediate results of all running queries may hold before new queries have to wait. Use 0 to admit all queries.")
+  ("maxWaitingQueries", po::value<size_t>(&maxWaitingQueries)->default_value(taskscheduler::AdmissionController::DEFAULT_MAX_WAITING), "Number of queries that may wait for memory before further queries are rejected")
+  ("relayoutInterval", po::value<size_t>(&relayoutInterval)->default_value(0), "Interval in ms between rounds that adapt the layout of tables to the recorded workload, applied with their next merge. Use 0 to disable workload recording.")
+  ("profileOperators", "Record the wall time and hardware counters of all plan operations for the summary under /profile/, not only of queries that request performance data")
+  ("traceScheduler", "Record the tasks every worker thread runs from startup, served as Chrome trace JSON under /trace/ where tracing can also be turned on and off")
+  ("calibrateLayouter", "Measure the memory hierarchy on startup for the calibrated cost model of the layouter, written to layouterCalibration if given")
+  ("layouterCalibration", po::value<std::string>(&layouterCalibration)->default_value(""), "File with the memory costs of the calibrated cost model of the layouter, loaded on startup unless calibrateLayouter is set")
+  ("listeners,n", po::value<size_t>(&listeners)->default_value(DEFAULT_LISTENERS), "Number of event loops handling connections, each with its own listening socket on the server port")
+  ("pinListeners", "Bind event loops to cores, distributed round robin over NUMA nodes")
   ("scheduler,s", po::value<std::string>(&scheduler_name)->default_value("ThreadPerTaskScheduler"), "Name of the scheduler to use")
-  ("threads,t", po::value<int>(&worker_threads)->default_value(getNumberOfCoresOnSystem()), "Number of worker threads for scheduler (only relevant for scheduler with fixed number of threads)");
+  ("threads,t", po::value<int>(&worker_threads)->default_value(getNumberOfCoresOnSystem()), "Number of worker threads for scheduler (only relevant for scheduler with fixed number of threads)")
+  ("minWorkers", po::value<size_t>(&minWorkers)->default_value(0), "Workers the CentralScheduler keeps while idle. Use 0 to keep all threads.")
+  ("workerIdleTimeout", po::value<size_t>(&workerIdleTimeout)->default_value(taskscheduler::CentralScheduler::DEFAULT_IDLE_TIMEOUT_MS), "Time in ms after which idle workers of the CentralScheduler above minWorkers retire");
   po::variables_map vm;
 
   try {
@@ -166,23 +211,53 @@ int main(int argc, char *argv[]) {
 #endif
 
   taskscheduler::SharedScheduler::getInstance().init(scheduler_name, worker_threads, maxTaskSize);
+  if (const auto central = std::dynamic_pointer_cast<taskscheduler::CentralScheduler>(
+          taskscheduler::SharedScheduler::getInstance().getScheduler())) {
+    if (minWorkers > 0)
+      central->setMinWorkers(minWorkers);
+    central->setIdleTimeout(std::chrono::milliseconds(workerIdleTimeout));
+  }
+  tx::TransactionManager::getInstance().setLockWaitTimeout(std::chrono::microseconds(lockWaitTimeout));
+  access::RequestParseTask::setInlineThreshold(inlineThreshold);
+  QueryArena::setDefaultLimit(queryMemoryLimit);
+  taskscheduler::AdmissionController::getInstance().setBudget(memoryBudget);
+  taskscheduler::AdmissionController::getInstance().setMaxWaiting(maxWaitingQueries);
+
+  if (gcInterval > 0) {
+    auto& gc = io::GarbageCollector::getInstance();
+    gc.setSessionTimeout(std::chrono::seconds(sessionTimeout));
+    gc.start(std::chrono::milliseconds(gcInterval));
+  }
+
+  if (vm.count("calibrateLayouter")) {
+    LOG4CXX_INFO(logger, "Calibrating layouter cost model");
+    const auto calibration = layouter::CostCalibration::measure();
+    if (!layouterCalibration.empty())
+      calibration.save(layouterCalibration);
+    layouter::CostCalibration::setCurrent(calibration);
+  } else if (!layouterCalibration.empty()) {
+    layouter::CostCalibration::setCurrent(layouter::CostCalibration::load(layouterCalibration));
+  }
+
+  access::OperatorProfile::getInstance().setProfileAll(vm.count("profileOperators") > 0);
+  if (vm.count("profileOperators") && !PerfEventTracer::isAvailable())
+    LOG4CXX_WARN(logger, "perf events are not available, operators are profiled without hardware counters");
 
-  // Main Server Loop
-  struct ev_loop *loop = ev_default_loop(0);
-  ebb_server server;
-  // Initialize server based on libev event loop
-  ebb_server_init(&server, loop);
+  taskscheduler::SchedulerTracer::getInstance().setEnabled(vm.count("traceScheduler") > 0);
 
+  if (relayoutInterval > 0)
+    access::WorkloadLayouter::getInstance().start(std::chrono::milliseconds(relayoutInterval));
 
-  // Define handler for ebb
-  server.new_connection = net::new_connection;
+  // Main Server Loops
+  net::EventLoopPool loops(listeners, vm.count("pinListeners") > 0);
 
   PidFile pi;
-  PortResource pa(port, port+100, server);
+  PortResource pa(port, port+100, loops);
 
-  LOG4CXX_INFO(logger, "Started server on port " << pa.getPort());
-  ev_loop(loop, 0);
+  LOG4CXX_INFO(logger, "Started server on port " << pa.getPort() << " with " << loops.size() << " event loops");
+  loops.run();
   LOG4CXX_INFO(logger, "Stopping Server...");
-  ev_default_destroy ();
+  io::GarbageCollector::getInstance().stop();
+  access::WorkloadLayouter::getInstance().stop();
   return 0;
 }
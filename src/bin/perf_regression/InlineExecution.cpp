@@ -0,0 +1,105 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include <gtest/gtest-bench.h>
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "access/system/RequestParseTask.h"
+#include "helper/HwlocHelper.h"
+#include "net/AbstractConnection.h"
+#include "taskscheduler/SharedScheduler.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+
+/// Connection that hands a query to the request parser and waits for its
+/// response
+class WaitingConnection : public net::AbstractConnection {
+ public:
+  explicit WaitingConnection(const std::string& body) : _body(body), _responded(false) {}
+
+  void respond(const std::string& message, size_t status, const std::string& contentType) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _responded = true;
+    _cond.notify_one();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    while (!_responded)
+      _cond.wait(lock);
+  }
+
+  bool hasBody() const { return true; }
+  std::string getBody() const { return _body; }
+  std::string getPath() const { return "/query/"; }
+
+ private:
+  std::string _body;
+  bool _responded;
+  std::mutex _mtx;
+  std::condition_variable _cond;
+};
+
+// TPC-C customer lookup, see SimpleTableScan.cpp
+const std::string point_lookup = "query={"
+    "\"operators\": {"
+    "\"get\": {\"type\": \"GetTable\", \"name\": \"customer\"},"
+    "\"scan\": {\"type\": \"SimpleTableScan\", \"predicates\": ["
+    "{\"type\": \"AND\"}, {\"type\": \"AND\"},"
+    "{\"type\": \"EQ\", \"in\": 0, \"f\": 0, \"vtype\": 0, \"value\": 2564},"
+    "{\"type\": \"EQ\", \"in\": 0, \"f\": 1, \"vtype\": 0, \"value\": 9},"
+    "{\"type\": \"EQ\", \"in\": 0, \"f\": 2, \"vtype\": 0, \"value\": 1}]},"
+    "\"project\": {\"type\": \"ProjectionScan\", \"fields\": [0, 1, 2]}"
+    "},"
+    "\"edges\": [[\"get\", \"scan\"], [\"scan\", \"project\"]]"
+    "}&autocommit=true";
+
+}
+
+/// Latency of a single point lookup from parsing the request to its
+/// response, executed inline or by the scheduler
+class InlineExecutionBase : public ::testing::Benchmark {
+ protected:
+  size_t threshold;
+
+ public:
+  InlineExecutionBase() {
+    SetNumIterations(1000);
+    SetWarmUp(10);
+  }
+
+  void BenchmarkSetUp() {
+    threshold = RequestParseTask::getInlineThreshold();
+    taskscheduler::SharedScheduler::getInstance().resetScheduler("WSCoreBoundQueuesScheduler", getNumberOfCoresOnSystem());
+  }
+
+  void BenchmarkTearDown() {
+    RequestParseTask::setInlineThreshold(threshold);
+  }
+
+  void execute() {
+    WaitingConnection connection(point_lookup);
+    RequestParseTask request(&connection);
+    request();
+    connection.wait();
+  }
+};
+
+BENCHMARK_F(InlineExecutionBase, point_lookup_inline) {
+  RequestParseTask::setInlineThreshold(RequestParseTask::DEFAULT_INLINE_THRESHOLD);
+  execute();
+}
+
+BENCHMARK_F(InlineExecutionBase, point_lookup_scheduled) {
+  RequestParseTask::setInlineThreshold(0);
+  execute();
+}
+
+}
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include <gtest/gtest-bench.h>
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "access/system/RequestParseTask.h"
+#include "helper/HttpHelper.h"
+#include "helper/HwlocHelper.h"
+#include "helper/Settings.h"
+#include "io/shortcuts.h"
+#include "io/StorageManager.h"
+#include "json.h"
+#include "net/AbstractConnection.h"
+#include "taskscheduler/SharedScheduler.h"
+
+#include "TpchGenerator.h"
+
+namespace hyrise {
+namespace access {
+
+// TPC-H queries expressed as JSON plans, see test/tpch/ and TpchGenerator.h
+// for the columns the plans use instead of expressions.
+//
+// The data is generated on first use into $HYRISE_DB_PATH/tpch-sf<SF>-v<n>,
+// the scale factor is taken from HYRISE_TPCH_SF and defaults to 0.01.
+// Every query runs on a single worker thread and on all cores, where the
+// scans of base tables are split into one instance per core. Besides the
+// cycles of a whole query, each benchmark logs the mean time in ms every
+// operator of the plan took from the performance data of the response.
+
+namespace {
+
+const double DEFAULT_SCALE_FACTOR = 0.01;
+
+/// Connection that hands a query to the request parser and waits for its
+/// response
+class WaitingConnection : public net::AbstractConnection {
+ public:
+  explicit WaitingConnection(const std::string& body) : _body(body), _responded(false) {}
+
+  void respond(const std::string& message, size_t status, const std::string& contentType) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _response = message;
+    _responded = true;
+    _cond.notify_one();
+  }
+
+  std::string wait() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    while (!_responded)
+      _cond.wait(lock);
+    return _response;
+  }
+
+  bool hasBody() const { return true; }
+  std::string getBody() const { return _body; }
+  std::string getPath() const { return "/query/"; }
+
+ private:
+  std::string _body;
+  std::string _response;
+  bool _responded;
+  std::mutex _mtx;
+  std::condition_variable _cond;
+};
+
+/// Generates the data if needed and loads the tables as tpch_<table>
+void loadTpch() {
+  static std::once_flag loaded;
+  std::call_once(loaded, [] () {
+    const char *env = getenv("HYRISE_TPCH_SF");
+    const double scaleFactor = env ? atof(env) : DEFAULT_SCALE_FACTOR;
+    std::ostringstream directory;
+    directory << Settings::getInstance()->getDBPath() << "/tpch-sf" << scaleFactor << "-v" << tpch::DATA_VERSION;
+
+    if (!std::ifstream(directory.str() + "/lineitem.tbl")) {
+      mkdir(directory.str().c_str(), 0755);
+      tpch::generate(directory.str(), scaleFactor);
+    }
+
+    auto *sm = io::StorageManager::getInstance();
+    for (const auto &table : tpch::tableNames())
+      sm->loadTable("tpch_" + table, io::Loader::shortcuts::load(directory.str() + "/" + table + ".tbl"));
+  });
+}
+
+/// Request body of a query, with the scans of base tables split into
+/// the given number of instances
+std::string queryBody(const std::string &query, size_t instances) {
+  static std::map<std::pair<std::string, size_t>, std::string> bodies;
+  const auto key = std::make_pair(query, instances);
+  if (bodies.count(key))
+    return bodies[key];
+
+  std::ifstream file("test/tpch/" + query + ".json");
+  Json::Value plan;
+  if (!Json::Reader().parse(file, plan))
+    throw std::runtime_error("Could not read test/tpch/" + query + ".json");
+
+  if (instances > 1) {
+    for (unsigned i = 0; i < plan["edges"].size(); ++i) {
+      const auto &edge = plan["edges"][i];
+      const auto &from = plan["operators"][edge[0u].asString()];
+      auto &to = plan["operators"][edge[1u].asString()];
+      if (from["type"].asString() == "GetTable" && to["type"].asString() == "SimpleTableScan")
+        to["instances"] = Json::UInt(instances);
+    }
+  }
+
+  return bodies[key] = "query=" + urlencode(Json::FastWriter().write(plan)) + "&autocommit=true&performance=true";
+}
+
+}
+
+class TpchBase : public ::testing::Benchmark {
+ protected:
+  const size_t threads;
+  std::string response;
+  int iteration;
+  // time in ms and number of executions per operator id
+  std::map<std::string, std::pair<double, size_t>> operators;
+
+ public:
+  explicit TpchBase(size_t threads) : threads(threads), iteration(0) {
+    SetNumIterations(5);
+    SetWarmUp(1);
+  }
+
+  void SetUp() {
+    loadTpch();
+    taskscheduler::SharedScheduler::getInstance().resetScheduler("WSCoreBoundQueuesScheduler", threads);
+  }
+
+  void BenchmarkTearDown() {
+    Json::Value result;
+    Json::Reader().parse(response, result);
+    if (result.isMember("error"))
+      throw std::runtime_error(result["error"].toStyledString());
+
+    if (iteration++ < WarmUp())
+      return;
+    for (unsigned i = 0; i < result["performanceData"].size(); ++i) {
+      const auto &op = result["performanceData"][i];
+      auto &time = operators[op["id"].asString() + "_" + op["name"].asString()];
+      time.first += op["endTime"].asDouble() - op["startTime"].asDouble();
+      ++time.second;
+    }
+  }
+
+  void TearDown() {
+    for (const auto &op : operators)
+      logValue(op.first + "_MS", op.second.first / op.second.second);
+  }
+
+  void execute(const std::string &query) {
+    WaitingConnection connection(queryBody(query, threads));
+    RequestParseTask request(&connection);
+    request();
+    response = connection.wait();
+  }
+};
+
+class TpchSingleBase : public TpchBase {
+ public:
+  TpchSingleBase() : TpchBase(1) {}
+};
+
+class TpchParallelBase : public TpchBase {
+ public:
+  TpchParallelBase() : TpchBase(getNumberOfCoresOnSystem()) {}
+};
+
+#define TPCH_BENCHMARK(query)                   \
+  BENCHMARK_F(TpchSingleBase, query) {          \
+    execute(#query);                            \
+  }                                             \
+  BENCHMARK_F(TpchParallelBase, query) {        \
+    execute(#query);                            \
+  }
+
+TPCH_BENCHMARK(q1)
+TPCH_BENCHMARK(q3)
+TPCH_BENCHMARK(q4)
+TPCH_BENCHMARK(q5)
+TPCH_BENCHMARK(q6)
+TPCH_BENCHMARK(q7)
+TPCH_BENCHMARK(q8)
+TPCH_BENCHMARK(q9)
+TPCH_BENCHMARK(q10)
+TPCH_BENCHMARK(q12)
+TPCH_BENCHMARK(q14)
+TPCH_BENCHMARK(q15)
+TPCH_BENCHMARK(q18)
+TPCH_BENCHMARK(q19)
+
+}
+}
@@ -0,0 +1,340 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "TpchGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace hyrise {
+namespace tpch {
+
+namespace {
+
+typedef std::vector<std::pair<std::string, std::string>> columns_t;
+
+/// Writes the rows of a table in hyrise format, one container per column
+class TableFile {
+ public:
+  TableFile(const std::string &path, const columns_t &columns) : _out(path), _column(0) {
+    if (!_out)
+      throw std::runtime_error("Could not write " + path);
+    _out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < columns.size(); ++i)
+      _out << (i ? "|" : "") << columns[i].first;
+    _out << '\n';
+    for (size_t i = 0; i < columns.size(); ++i)
+      _out << (i ? "|" : "") << columns[i].second;
+    _out << '\n';
+    for (size_t i = 0; i < columns.size(); ++i)
+      _out << (i ? "|" : "") << i << "_C";
+    _out << "\n===\n";
+  }
+
+  template <typename T>
+  TableFile &operator<<(const T &value) {
+    if (_column++ > 0)
+      _out << '|';
+    _out << value;
+    return *this;
+  }
+
+  void endRow() {
+    _out << '\n';
+    _column = 0;
+  }
+
+ private:
+  std::ofstream _out;
+  size_t _column;
+};
+
+const char *REGIONS[] = {"AFRICA", "AMERICA", "ASIA", "EUROPE", "MIDDLE EAST"};
+
+const std::pair<const char *, int> NATIONS[] = {
+  {"ALGERIA", 0}, {"ARGENTINA", 1}, {"BRAZIL", 1}, {"CANADA", 1}, {"EGYPT", 4},
+  {"ETHIOPIA", 0}, {"FRANCE", 3}, {"GERMANY", 3}, {"INDIA", 2}, {"INDONESIA", 2},
+  {"IRAN", 4}, {"IRAQ", 4}, {"JAPAN", 2}, {"JORDAN", 4}, {"KENYA", 0},
+  {"MOROCCO", 0}, {"MOZAMBIQUE", 0}, {"PERU", 1}, {"CHINA", 2}, {"ROMANIA", 3},
+  {"SAUDI ARABIA", 4}, {"VIETNAM", 2}, {"RUSSIA", 3}, {"UNITED KINGDOM", 3}, {"UNITED STATES", 1}
+};
+
+const std::vector<std::string> SEGMENTS = {"AUTOMOBILE", "BUILDING", "FURNITURE", "MACHINERY", "HOUSEHOLD"};
+const std::vector<std::string> PRIORITIES = {"1-URGENT", "2-HIGH", "3-MEDIUM", "4-NOT SPECIFIED", "5-LOW"};
+const std::vector<std::string> INSTRUCTIONS = {"DELIVER IN PERSON", "COLLECT COD", "NONE", "TAKE BACK RETURN"};
+const std::vector<std::string> MODES = {"REG AIR", "AIR", "RAIL", "SHIP", "TRUCK", "MAIL", "FOB"};
+const std::vector<std::string> TYPE_SIZES = {"STANDARD", "SMALL", "MEDIUM", "LARGE", "ECONOMY", "PROMO"};
+const std::vector<std::string> TYPE_FINISHES = {"ANODIZED", "BURNISHED", "PLATED", "POLISHED", "BRUSHED"};
+const std::vector<std::string> TYPE_MATERIALS = {"TIN", "NICKEL", "BRASS", "STEEL", "COPPER"};
+const std::vector<std::string> CONTAINER_SIZES = {"SM", "LG", "MED", "JUMBO", "WRAP"};
+const std::vector<std::string> CONTAINER_KINDS = {"CASE", "BOX", "BAG", "JAR", "PKG", "PACK", "CAN", "DRUM"};
+const std::vector<std::string> COLORS = {
+  "almond", "antique", "aquamarine", "azure", "beige", "bisque", "black", "blanched", "blue", "blush",
+  "brown", "burlywood", "chartreuse", "chocolate", "coral", "cornsilk", "cream", "cyan", "forest", "green"
+};
+const std::vector<std::string> WORDS = {
+  "furiously", "quickly", "carefully", "blithely", "slyly", "final", "regular", "special", "pending", "express",
+  "ironic", "bold", "even", "silent", "requests", "deposits", "packages", "accounts", "foxes", "instructions"
+};
+
+// TPC-H dates, as days since 1970-01-01
+int daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  const int era = (year >= 0 ? year : year - 399) / 400;
+  const int yoe = year - era * 400;
+  const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+int civilFromDays(int days) {
+  days += 719468;
+  const int era = (days >= 0 ? days : days - 146096) / 146097;
+  const int doe = days - era * 146097;
+  const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int mp = (5 * doy + 2) / 153;
+  const int day = doy - (153 * mp + 2) / 5 + 1;
+  const int month = mp + (mp < 10 ? 3 : -9);
+  return (yoe + era * 400 + (month <= 2)) * 10000 + month * 100 + day;
+}
+
+const int START_DATE = daysFromCivil(1992, 1, 1);
+const int END_DATE = daysFromCivil(1998, 12, 31);
+const int CURRENT_DATE = daysFromCivil(1995, 6, 17);
+
+class Generator {
+ public:
+  Generator(const std::string &directory, double scaleFactor) :
+      _directory(directory),
+      _suppliers(scaled(10000, scaleFactor)),
+      _customers(scaled(150000, scaleFactor)),
+      _parts(scaled(200000, scaleFactor)),
+      _orders(scaled(1500000, scaleFactor)) {}
+
+  void run() {
+    region();
+    nation();
+    supplier();
+    customer();
+    part();
+    partsupp();
+    ordersAndLineitem();
+  }
+
+ private:
+  static long scaled(long base, double scaleFactor) {
+    return std::max(1l, std::lround(base * scaleFactor));
+  }
+
+  void seed(unsigned value) {
+    _random.seed(value);
+  }
+
+  long uniform(long min, long max) {
+    return std::uniform_int_distribution<long>(min, max)(_random);
+  }
+
+  const std::string &pick(const std::vector<std::string> &values) {
+    return values[uniform(0, values.size() - 1)];
+  }
+
+  std::string text(size_t minWords, size_t maxWords) {
+    std::string result;
+    const size_t words = uniform(minWords, maxWords);
+    for (size_t i = 0; i < words; ++i)
+      result += (i ? " " : "") + pick(WORDS);
+    return result;
+  }
+
+  std::string phone(long nation) {
+    std::ostringstream result;
+    result << nation + 10 << '-' << uniform(100, 999) << '-' << uniform(100, 999) << '-' << uniform(1000, 9999);
+    return result.str();
+  }
+
+  static std::string numbered(const std::string &prefix, long number) {
+    std::ostringstream result;
+    result << prefix << std::setw(9) << std::setfill('0') << number;
+    return result.str();
+  }
+
+  static double retailPrice(long part) {
+    return (90000 + ((part / 10) % 20001) + 100 * (part % 1000)) / 100.0;
+  }
+
+  // the i-th of the four suppliers of a part
+  long supplierOf(long part, long i) const {
+    return (part + i * (_suppliers / 4 + (part - 1) / _suppliers)) % _suppliers + 1;
+  }
+
+  std::string path(const std::string &table) const {
+    return _directory + "/" + table + ".tbl";
+  }
+
+  void region() {
+    seed(1);
+    TableFile file(path("region"), {{"R_REGIONKEY", "INTEGER"}, {"R_NAME", "STRING"}, {"R_COMMENT", "STRING"}});
+    for (int i = 0; i < 5; ++i) {
+      file << i << REGIONS[i] << text(5, 10);
+      file.endRow();
+    }
+  }
+
+  void nation() {
+    seed(2);
+    TableFile file(path("nation"), {{"N_NATIONKEY", "INTEGER"}, {"N_NAME", "STRING"}, {"N_REGIONKEY", "INTEGER"}, {"N_COMMENT", "STRING"}});
+    for (int i = 0; i < 25; ++i) {
+      file << i << NATIONS[i].first << NATIONS[i].second << text(5, 10);
+      file.endRow();
+    }
+  }
+
+  void supplier() {
+    seed(3);
+    TableFile file(path("supplier"), {{"S_SUPPKEY", "INTEGER"}, {"S_NAME", "STRING"}, {"S_ADDRESS", "STRING"},
+        {"S_NATIONKEY", "INTEGER"}, {"S_PHONE", "STRING"}, {"S_ACCTBAL", "FLOAT"}, {"S_COMMENT", "STRING"}});
+    for (long key = 1; key <= _suppliers; ++key) {
+      const long nation = uniform(0, 24);
+      file << key << numbered("Supplier#", key) << text(2, 4) << nation << phone(nation)
+           << uniform(-99999, 999999) / 100.0 << text(5, 10);
+      file.endRow();
+    }
+  }
+
+  void customer() {
+    seed(4);
+    TableFile file(path("customer"), {{"C_CUSTKEY", "INTEGER"}, {"C_NAME", "STRING"}, {"C_ADDRESS", "STRING"},
+        {"C_NATIONKEY", "INTEGER"}, {"C_PHONE", "STRING"}, {"C_ACCTBAL", "FLOAT"}, {"C_MKTSEGMENT", "STRING"},
+        {"C_COMMENT", "STRING"}});
+    for (long key = 1; key <= _customers; ++key) {
+      const long nation = uniform(0, 24);
+      file << key << numbered("Customer#", key) << text(2, 4) << nation << phone(nation)
+           << uniform(-99999, 999999) / 100.0 << pick(SEGMENTS) << text(5, 10);
+      file.endRow();
+    }
+  }
+
+  void part() {
+    seed(5);
+    TableFile file(path("part"), {{"P_PARTKEY", "INTEGER"}, {"P_NAME", "STRING"}, {"P_MFGR", "STRING"},
+        {"P_BRAND", "STRING"}, {"P_TYPE", "STRING"}, {"P_SIZE", "INTEGER"}, {"P_CONTAINER", "STRING"},
+        {"P_RETAILPRICE", "FLOAT"}, {"P_COMMENT", "STRING"}, {"P_PROMO", "INTEGER"}});
+    for (long key = 1; key <= _parts; ++key) {
+      std::vector<std::string> colors(COLORS);
+      std::shuffle(colors.begin(), colors.end(), _random);
+      const long manufacturer = uniform(1, 5);
+      const std::string brand = "Brand#" + std::to_string(manufacturer) + std::to_string(uniform(1, 5));
+      const std::string &size = pick(TYPE_SIZES);
+      const std::string type = size + " " + pick(TYPE_FINISHES) + " " + pick(TYPE_MATERIALS);
+      file << key << colors[0] + " " + colors[1] + " " + colors[2] + " " + colors[3] + " " + colors[4]
+           << "Manufacturer#" + std::to_string(manufacturer) << brand << type
+           << uniform(1, 50) << pick(CONTAINER_SIZES) + " " + pick(CONTAINER_KINDS)
+           << retailPrice(key) << text(1, 3) << (size == "PROMO" ? 1 : 0);
+      file.endRow();
+    }
+  }
+
+  void partsupp() {
+    seed(6);
+    TableFile file(path("partsupp"), {{"PS_PARTKEY", "INTEGER"}, {"PS_SUPPKEY", "INTEGER"}, {"PS_AVAILQTY", "INTEGER"},
+        {"PS_SUPPLYCOST", "FLOAT"}, {"PS_COMMENT", "STRING"}});
+    _supplyCosts.clear();
+    for (long key = 1; key <= _parts; ++key) {
+      for (long i = 0; i < 4; ++i) {
+        const long availQty = uniform(1, 9999);
+        _supplyCosts.push_back(uniform(100, 100000) / 100.0);
+        file << key << supplierOf(key, i) << availQty << _supplyCosts.back() << text(5, 10);
+        file.endRow();
+      }
+    }
+  }
+
+  void ordersAndLineitem() {
+    seed(7);
+    TableFile orders(path("orders"), {{"O_ORDERKEY", "INTEGER"}, {"O_CUSTKEY", "INTEGER"}, {"O_ORDERSTATUS", "STRING"},
+        {"O_TOTALPRICE", "FLOAT"}, {"O_ORDERDATE", "INTEGER"}, {"O_ORDERPRIORITY", "STRING"}, {"O_CLERK", "STRING"},
+        {"O_SHIPPRIORITY", "INTEGER"}, {"O_COMMENT", "STRING"}, {"O_ORDERYEAR", "INTEGER"}});
+    TableFile lineitem(path("lineitem"), {{"L_ORDERKEY", "INTEGER"}, {"L_PARTKEY", "INTEGER"}, {"L_SUPPKEY", "INTEGER"},
+        {"L_LINENUMBER", "INTEGER"}, {"L_QUANTITY", "FLOAT"}, {"L_EXTENDEDPRICE", "FLOAT"}, {"L_DISCOUNT", "FLOAT"},
+        {"L_TAX", "FLOAT"}, {"L_RETURNFLAG", "STRING"}, {"L_LINESTATUS", "STRING"}, {"L_SHIPDATE", "INTEGER"},
+        {"L_COMMITDATE", "INTEGER"}, {"L_RECEIPTDATE", "INTEGER"}, {"L_SHIPINSTRUCT", "STRING"},
+        {"L_SHIPMODE", "STRING"}, {"L_COMMENT", "STRING"}, {"L_DISC_PRICE", "FLOAT"}, {"L_CHARGE", "FLOAT"},
+        {"L_DISC_AMOUNT", "FLOAT"}, {"L_LATE", "INTEGER"}, {"L_EARLY", "INTEGER"}, {"L_SHIPYEAR", "INTEGER"},
+        {"L_PROFIT", "FLOAT"}});
+    const long clerks = std::max(1l, _suppliers / 10);
+
+    for (long key = 1; key <= _orders; ++key) {
+      long customer;
+      // as in dbgen, every third customer has no orders
+      do {
+        customer = uniform(1, _customers);
+      } while (customer % 3 == 0 && _customers >= 3);
+      const int orderDate = START_DATE + uniform(0, END_DATE - START_DATE - 151);
+      const long lines = uniform(1, 7);
+
+      double total = 0;
+      size_t shipped = 0;
+      for (long line = 1; line <= lines; ++line) {
+        const long part = uniform(1, _parts);
+        const long supplier = uniform(0, 3);
+        const long quantity = uniform(1, 50);
+        const double price = quantity * retailPrice(part);
+        const double discount = uniform(0, 10) / 100.0;
+        const double tax = uniform(0, 8) / 100.0;
+        const int shipDate = orderDate + uniform(1, 121);
+        const int commitDate = orderDate + uniform(30, 90);
+        const int receiptDate = shipDate + uniform(1, 30);
+        const char *returnFlag = receiptDate <= CURRENT_DATE ? (uniform(0, 1) ? "R" : "A") : "N";
+        const bool open = shipDate > CURRENT_DATE;
+        const double discPrice = price * (1 - discount);
+        total += discPrice * (1 + tax);
+        shipped += !open;
+
+        lineitem << key << part << supplierOf(part, supplier) << line << static_cast<double>(quantity)
+                 << price << discount << tax << returnFlag << (open ? "O" : "F") << civilFromDays(shipDate)
+                 << civilFromDays(commitDate) << civilFromDays(receiptDate) << pick(INSTRUCTIONS) << pick(MODES)
+                 << text(2, 5) << discPrice << discPrice * (1 + tax) << price * discount
+                 << (commitDate < receiptDate ? 1 : 0) << (shipDate < commitDate ? 1 : 0)
+                 << civilFromDays(shipDate) / 10000
+                 << discPrice - _supplyCosts[(part - 1) * 4 + supplier] * quantity;
+        lineitem.endRow();
+      }
+
+      const char *status = shipped == static_cast<size_t>(lines) ? "F" : (shipped == 0 ? "O" : "P");
+      orders << key << customer << status << total << civilFromDays(orderDate) << pick(PRIORITIES)
+             << numbered("Clerk#", uniform(1, clerks)) << 0 << text(3, 8) << civilFromDays(orderDate) / 10000;
+      orders.endRow();
+    }
+  }
+
+  const std::string _directory;
+  const long _suppliers;
+  const long _customers;
+  const long _parts;
+  const long _orders;
+  // PS_SUPPLYCOST of the i-th supplier of a part at (part - 1) * 4 + i
+  std::vector<double> _supplyCosts;
+  std::mt19937 _random;
+};
+
+}
+
+const std::vector<std::string> &tableNames() {
+  static const std::vector<std::string> names = {
+    "region", "nation", "supplier", "customer", "part", "partsupp", "orders", "lineitem"
+  };
+  return names;
+}
+
+void generate(const std::string &directory, double scaleFactor) {
+  if (scaleFactor <= 0)
+    throw std::runtime_error("TPC-H scale factor must be positive");
+  Generator(directory, scaleFactor).run();
+}
+
+} } // namespace hyrise::tpch
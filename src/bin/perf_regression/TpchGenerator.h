@@ -0,0 +1,44 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_BIN_PERF_REGRESSION_TPCHGENERATOR_H_
+#define SRC_BIN_PERF_REGRESSION_TPCHGENERATOR_H_
+
+#include <string>
+#include <vector>
+
+namespace hyrise {
+namespace tpch {
+
+/// Names of the generated tables, the file of a table is <name>.tbl
+const std::vector<std::string> &tableNames();
+
+/// Writes the eight TPC-H tables at the given scale factor as hyrise
+/// .tbl files into directory, which must exist.
+///
+/// The data follows the cardinalities, domains and correlations of the
+/// TPC-H specification closely enough for the selectivities of the
+/// queries, it is not a replacement for dbgen. Dates are INTEGER columns
+/// of the form yyyymmdd. As the JSON plans cannot compute expressions,
+/// LINEITEM carries the derived columns the queries aggregate or filter:
+///
+///   L_DISC_PRICE   = L_EXTENDEDPRICE * (1 - L_DISCOUNT)
+///   L_CHARGE       = L_DISC_PRICE * (1 + L_TAX)
+///   L_DISC_AMOUNT  = L_EXTENDEDPRICE * L_DISCOUNT
+///   L_LATE         = 1 if L_COMMITDATE < L_RECEIPTDATE, else 0
+///   L_EARLY        = 1 if L_SHIPDATE < L_COMMITDATE, else 0
+///   L_SHIPYEAR     = year of L_SHIPDATE
+///   L_PROFIT       = L_DISC_PRICE - PS_SUPPLYCOST * L_QUANTITY, with the
+///                    supply cost of the line's part and supplier
+///
+/// ORDERS carries O_ORDERYEAR, the year of O_ORDERDATE, and PART carries
+/// P_PROMO = 1 if P_TYPE starts with PROMO, else 0.
+///
+/// The same scale factor always generates the same data.
+void generate(const std::string &directory, double scaleFactor);
+
+/// Version of the generated columns, data of other versions has to be
+/// generated again
+const int DATA_VERSION = 2;
+
+} } // namespace hyrise::tpch
+
+#endif  // SRC_BIN_PERF_REGRESSION_TPCHGENERATOR_H_
@@ -5,6 +5,31 @@
 #include <io.h>
 #include <sys/stat.h>
 
+#include <cstring>
+#include <string>
+
+namespace {
+
+const char *OUTPUT_FLAG = "--benchmark_output=";
+
+/// Adds a writer for --benchmark_output=json:<file> or csv:<file>
+bool addResultWriter(::testing::TestEventListeners &listeners, const std::string &output) {
+  const auto separator = output.find(':');
+  if (separator == std::string::npos || separator + 1 == output.size())
+    return false;
+  const auto format = output.substr(0, separator);
+  const auto file = output.substr(separator + 1);
+  if (format == "json")
+    listeners.Append(new testing::BenchmarkResultWriter(file, testing::BenchmarkResultWriter::JSON));
+  else if (format == "csv")
+    listeners.Append(new testing::BenchmarkResultWriter(file, testing::BenchmarkResultWriter::CSV));
+  else
+    return false;
+  return true;
+}
+
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -15,6 +40,18 @@ int main(int argc, char **argv) {
   delete listeners.Release(listeners.default_result_printer());
   listeners.Append(new testing::BenchmarkPrinter);
 
+  // Results for tools/benchcompare.py, other flags gtest did not consume
+  // are left to the benchmarks
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--benchmark", strlen("--benchmark")) != 0)
+      continue;
+    if (strncmp(argv[i], OUTPUT_FLAG, strlen(OUTPUT_FLAG)) != 0 ||
+        !addResultWriter(listeners, argv[i] + strlen(OUTPUT_FLAG))) {
+      std::cout << "Bad argument " << argv[i] << ", expected " << OUTPUT_FLAG << "json:<file> or csv:<file>" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
   // get xml printer and remove it, we have to add our own here
   // listeners.Release(listeners.default_xml_generator());
 
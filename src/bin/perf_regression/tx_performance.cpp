@@ -1,6 +1,8 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "gtest/gtest-bench.h"
@@ -66,3 +68,62 @@ BENCHMARK_F(TXBase, simple_insert_commit) {
     c.execute();
 }
 
+
+namespace hyrise { namespace access {
+
+class CommitScalingTest : public ::testing::TestWithParam<std::size_t> {};
+
+// Every writer inserts one row into the same store and commits it, the
+// commit throughput should scale with the number of writer threads as
+// commit ids are drawn and published without a global commit lock
+TEST_P(CommitScalingTest, concurrent_insert_commit) {
+  const auto threads = GetParam();
+  const std::size_t runs = 200000 / threads;
+
+  tx::TransactionManager::getInstance().reset();
+  auto store = checked_pointer_cast<storage::Store>(io::Loader::shortcuts::load("test/lin_xxxs.tbl"));
+
+  storage::TableBuilder::param_list list;
+  list.append().set_type("INTEGER").set_name("col_0");
+  list.append().set_type("INTEGER").set_name("col_1");
+  auto one_row = storage::TableBuilder::build(list);
+  one_row->resize(1);
+  one_row->setValue<hyrise_int_t>(0, 0, 99);
+  one_row->setValue<hyrise_int_t>(1, 0, 999);
+
+  auto before = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> writers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    writers.emplace_back([&] () {
+      for (std::size_t r = 0; r < runs; ++r) {
+        auto ctx = tx::TransactionManager::beginTransaction();
+        InsertScan is;
+        is.setEvent("NO_PAPI");
+        is.setTXContext(ctx);
+        is.addInput(store);
+        is.setInputData(one_row);
+        is.execute();
+
+        Commit c;
+        c.setEvent("NO_PAPI");
+        c.setTXContext(ctx);
+        c.execute();
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  auto after = std::chrono::high_resolution_clock::now();
+  auto ms = std::max<long>(1, std::chrono::duration_cast<std::chrono::milliseconds>(after - before).count());
+
+  ASSERT_EQ(static_cast<tx::transaction_cid_t>(runs * threads), tx::TransactionManager::getInstance().getLastCommitId());
+  RecordProperty("threads", threads);
+  RecordProperty("commits/ms", runs * threads / ms);
+}
+
+INSTANTIATE_TEST_CASE_P(CommitScaling,
+                        CommitScalingTest,
+                        ::testing::Values(1, 2, 4, 8, 16, 32, 64));
+
+}}
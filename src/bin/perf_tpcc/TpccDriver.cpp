@@ -0,0 +1,878 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "TpccDriver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include "access/system/RequestParseTask.h"
+#include "access/system/ResponseTask.h"
+#include "helper/HttpHelper.h"
+#include "helper/Settings.h"
+#include "net/AbstractConnection.h"
+#include "taskscheduler/SharedScheduler.h"
+
+namespace hyrise {
+namespace tpcc {
+
+namespace {
+
+const char *TRANSACTION_NAMES[TRANSACTION_TYPES] = {"NewOrder", "Payment", "OrderStatus", "Delivery", "StockLevel"};
+
+const char *LAST_NAME_SYLLABLES[] = {"BAR", "OUGHT", "ABLE", "PRI", "PRES", "ESE", "ANTI", "CALLY", "ATION", "EING"};
+
+// Tables written by hyrise-perf-datagen, named as in test/tpcc
+const std::vector<std::pair<std::string, std::string>> TABLES = {
+  {"WAREHOUSE", "warehouse.tbl"}, {"DISTRICT", "district.tbl"}, {"CUSTOMER", "customer.tbl"},
+  {"HISTORY", "history.tbl"}, {"ITEM", "item.tbl"}, {"STOCK", "stock.tbl"},
+  {"ORDERS", "order.tbl"}, {"NEW_ORDER", "new_order.tbl"}, {"ORDER_LINE", "order_line.tbl"}
+};
+
+// The first column of every lookup key
+const std::vector<std::pair<std::string, std::string>> INDEXES = {
+  {"WAREHOUSE", "W_ID"}, {"DISTRICT", "D_W_ID"}, {"CUSTOMER", "C_ID"}, {"CUSTOMER", "C_LAST"},
+  {"ITEM", "I_ID"}, {"STOCK", "S_I_ID"}, {"ORDERS", "O_ID"}, {"ORDERS", "O_C_ID"},
+  {"NEW_ORDER", "NO_D_ID"}, {"NEW_ORDER", "NO_O_ID"}, {"ORDER_LINE", "OL_O_ID"}
+};
+
+const size_t C_DATA_LENGTH = 500;
+
+/// Collects the response of a request executed in process
+class LocalConnection : public net::AbstractConnection {
+ public:
+  explicit LocalConnection(const std::string &body) : _body(body) {}
+
+  virtual void respond(const std::string &message, size_t status, const std::string &contentType) {
+    _response = message;
+  }
+
+  std::string getResponse() const {
+    return _response;
+  }
+
+  bool hasBody() const {
+    return !_body.empty();
+  }
+
+  std::string getBody() const {
+    return _body;
+  }
+
+  std::string getPath() const {
+    return "";
+  }
+
+ private:
+  std::string _body;
+  std::string _response;
+};
+
+Json::Value op(const std::string &type) {
+  Json::Value value;
+  value["type"] = type;
+  return value;
+}
+
+unsigned vtype(const Json::Value &value) {
+  if (value.isString())
+    return 2;
+  return value.isDouble() ? 1 : 0;
+}
+
+Json::Value predicate(const std::string &type, const std::string &field, const Json::Value &value) {
+  Json::Value p = op(type);
+  p["in"] = 0;
+  p["f"] = field;
+  p["vtype"] = vtype(value);
+  p["value"] = value;
+  return p;
+}
+
+std::string indexName(const std::string &table, const std::string &column) {
+  return "tpcc_" + table + "_" + column;
+}
+
+Json::Value getTable(const std::string &table) {
+  Json::Value get = op("GetTable");
+  get["name"] = table;
+  return get;
+}
+
+/// Scan for rows matching all but the first column of key
+Json::Value filter(const row_key_t &key) {
+  Json::Value scan = op("SimpleTableScan");
+  scan["positions"] = true;
+  for (size_t i = 2; i < key.size(); ++i)
+    scan["predicates"].append(op("AND"));
+  for (size_t i = 1; i < key.size(); ++i)
+    scan["predicates"].append(predicate("EQ", key[i].first, key[i].second));
+  return scan;
+}
+
+/// Adds the lookup of the rows of table matching key, the index on the
+/// first column narrows the rows down and a scan checks the others
+std::string lookup(Plan &plan, const std::string &table, const row_key_t &key) {
+  Json::Value scan = op("IndexScan");
+  scan["index"] = indexName(table, key[0].first);
+  scan["fields"].append(key[0].first);
+  scan["value"] = key[0].second;
+  scan["vtype"] = vtype(key[0].second);
+
+  const auto rows = plan.add(scan, plan.add(getTable(table)));
+  return key.size() > 1 ? plan.add(filter(key), rows) : rows;
+}
+
+void insert(Plan &plan, const std::string &table, const Json::Value &rows) {
+  Json::Value insert = op("InsertScan");
+  insert["data"] = rows;
+  plan.add(insert, plan.add(getTable(table)));
+}
+
+Json::Value fields(const std::vector<std::string> &names) {
+  Json::Value projection = op("ProjectionScan");
+  for (const auto &name : names)
+    projection["fields"].append(name);
+  return projection;
+}
+
+Json::Value rowsOf(const Json::Value &response) {
+  return response.get("rows", Json::Value(Json::arrayValue));
+}
+
+/// Current time in the format written by hyrise-perf-datagen
+std::string now() {
+  const time_t t = time(nullptr);
+  struct tm date;
+  localtime_r(&t, &date);
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d-%02d-%02d-%02d",
+           date.tm_year + 1900, date.tm_mon + 1, date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec);
+  return buffer;
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  const size_t rank = (size_t) std::ceil(p * sorted.size());
+  return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+/// Adds a scan of table for the rows matching predicates that are
+/// visible to the transaction
+std::string visibleRows(Plan &plan, const std::string &table, const std::vector<Json::Value> &predicates) {
+  Json::Value scan = op("SimpleTableScan");
+  for (size_t i = 1; i < predicates.size(); ++i)
+    scan["predicates"].append(op("AND"));
+  for (const auto &p : predicates)
+    scan["predicates"].append(p);
+  return plan.add(op("ValidatePositions"), plan.add(scan, plan.add(getTable(table))));
+}
+
+Json::Value aggregate(const std::string &type, const std::string &field, const std::string &as) {
+  Json::Value function = op(type);
+  function["field"] = field;
+  function["as"] = as;
+  return function;
+}
+
+}
+
+const char *transactionName(transaction_t type) {
+  return TRANSACTION_NAMES[type];
+}
+
+Plan::Plan() : _plan(Json::objectValue), _next(0) {
+  _plan["operators"] = Json::Value(Json::objectValue);
+  _plan["edges"] = Json::Value(Json::arrayValue);
+}
+
+std::string Plan::add(const Json::Value &op, const std::string &input) {
+  const std::string id = std::to_string(_next++);
+  _plan["operators"][id] = op;
+  if (!input.empty())
+    edge(input, id);
+  return id;
+}
+
+std::string Plan::addAfterAll(const Json::Value &op) {
+  std::set<std::string> sources;
+  for (const auto &e : _plan["edges"])
+    sources.insert(e[0u].asString());
+
+  const auto sinks = _plan["operators"].getMemberNames();
+  const std::string id = add(op);
+  for (const auto &sink : sinks) {
+    if (sources.count(sink) == 0)
+      edge(sink, id);
+  }
+  return id;
+}
+
+void Plan::edge(const std::string &from, const std::string &to) {
+  Json::Value e(Json::arrayValue);
+  e.append(from);
+  e.append(to);
+  _plan["edges"].append(e);
+}
+
+Json::Value Session::request(const Json::Value &plan, size_t limit, bool withContext) {
+  Json::FastWriter writer;
+  std::string body = "query=" + urlencode(writer.write(plan));
+  if (withContext && !_context.empty())
+    body += "&session_context=" + _context;
+  if (limit > 0)
+    body += "&limit=" + std::to_string(limit);
+
+  LocalConnection connection(body);
+  auto request = std::make_shared<access::RequestParseTask>(&connection);
+  auto response = request->getResponseTask();
+
+  auto wait = std::make_shared<taskscheduler::WaitTask>();
+  wait->addDependency(response);
+
+  const auto &scheduler = taskscheduler::SharedScheduler::getInstance().getScheduler();
+  scheduler->schedule(wait);
+  scheduler->schedule(request);
+  wait->wait();
+
+  Json::Value result;
+  Json::Reader reader;
+  if (!reader.parse(connection.getResponse(), result))
+    throw std::runtime_error("Malformed response: " + connection.getResponse());
+  return result;
+}
+
+Json::Value Session::execute(const Plan &plan, size_t limit) {
+  const auto response = request(plan.json(), limit, true);
+  if (response.isMember("error")) {
+    // Failed writes roll back themselves, others leave the transaction
+    // open, also if the plan that failed began it
+    if (response.isMember("session_context"))
+      _context = response["session_context"].asString();
+    rollback();
+    throw TransactionAborted(response["error"][0u].asString());
+  }
+  if (response.isMember("session_context"))
+    _context = response["session_context"].asString();
+  return response;
+}
+
+Json::Value Session::commit(Plan plan, size_t limit) {
+  plan.addAfterAll(op("Commit"));
+  const auto response = execute(plan, limit);
+  _context.clear();
+  return response;
+}
+
+void Session::commit() {
+  if (_context.empty())
+    return;
+  Plan plan;
+  plan.add(op("Commit"));
+  execute(plan);
+  _context.clear();
+}
+
+void Session::rollback() {
+  if (_context.empty())
+    return;
+  Plan plan;
+  plan.add(op("Rollback"));
+  request(plan.json(), 1, true);
+  _context.clear();
+}
+
+std::vector<analytical_query_t> analyticalQueries() {
+  std::vector<analytical_query_t> queries;
+
+  {
+    Plan plan;
+    const auto rows = visibleRows(plan, "ORDER_LINE", {predicate("GT", "OL_DELIVERY_D", "2007-01-02-00-00-00")});
+    Json::Value hash = op("HashBuild");
+    hash["fields"].append("OL_NUMBER");
+    hash["key"] = "join";
+    // groups by value, the rows of the delta have value ids of their own
+    Json::Value group = op("GroupByScan");
+    group["fields"].append("OL_NUMBER");
+    group["key"] = "value";
+    group["functions"].append(aggregate("SUM", "OL_QUANTITY", "SUM_QTY"));
+    group["functions"].append(aggregate("SUM", "OL_AMOUNT", "SUM_AMOUNT"));
+    group["functions"].append(aggregate("AVG", "OL_QUANTITY", "AVG_QTY"));
+    group["functions"].append(aggregate("AVG", "OL_AMOUNT", "AVG_AMOUNT"));
+    group["functions"].append(aggregate("COUNT", "OL_NUMBER", "COUNT_ORDER"));
+    const auto grouped = plan.add(group, rows);
+    plan.edge(plan.add(hash, rows), grouped);
+    Json::Value sort = op("SortScan");
+    sort["fields"].append(0);
+    plan.add(sort, grouped);
+    queries.push_back({"CH-Q1", plan});
+  }
+
+  {
+    Plan plan;
+    const auto rows = visibleRows(plan, "ORDER_LINE", {
+        predicate("GTE_V", "OL_DELIVERY_D", "1999-01-01-00-00-00"),
+        predicate("LT", "OL_DELIVERY_D", "2020-01-01-00-00-00"),
+        predicate("GTE_V", "OL_QUANTITY", 1),
+        predicate("LTE_V", "OL_QUANTITY", 100000)});
+    Json::Value group = op("GroupByScan");
+    group["functions"].append(aggregate("SUM", "OL_AMOUNT", "REVENUE"));
+    plan.add(group, rows);
+    queries.push_back({"CH-Q6", plan});
+  }
+
+  {
+    Plan plan;
+    Json::Value items = op("SimpleTableScan");
+    items["predicates"].append(op("AND"));
+    items["predicates"].append(predicate("GTE_V", "I_PRICE", 1.0));
+    items["predicates"].append(predicate("LTE_V", "I_PRICE", 400000.0));
+    Json::Value build = op("HashBuild");
+    build["fields"].append("I_ID");
+    build["key"] = "join";
+    const auto hashed = plan.add(build, plan.add(items, plan.add(getTable("ITEM"))));
+
+    const auto rows = visibleRows(plan, "ORDER_LINE", {
+        predicate("GTE_V", "OL_QUANTITY", 1),
+        predicate("LTE_V", "OL_QUANTITY", 10)});
+    Json::Value probe = op("HashJoinProbe");
+    probe["fields"].append("OL_I_ID");
+    const auto joined = plan.add(probe, rows);
+    plan.edge(hashed, joined);
+
+    Json::Value group = op("GroupByScan");
+    group["functions"].append(aggregate("SUM", "OL_AMOUNT", "REVENUE"));
+    plan.add(group, joined);
+    queries.push_back({"CH-Q19", plan});
+  }
+
+  return queries;
+}
+
+scale_t loadTables(const std::string &path) {
+  Settings::getInstance()->setDBPath(path);
+
+  Session session;
+  std::map<std::string, size_t> sizes;
+  for (const auto &table : TABLES) {
+    Plan plan;
+    Json::Value load = op("TableLoad");
+    load["table"] = table.first;
+    load["filename"] = table.second;
+    plan.add(load);
+    sizes[table.first] = session.commit(plan, 1)["real_size"].asUInt();
+  }
+
+  for (const auto &index : INDEXES) {
+    Plan plan;
+    Json::Value create = op("CreateIndex");
+    create["fields"].append(index.second);
+    create["index_name"] = indexName(index.first, index.second);
+    create["index_type"] = "ordered";
+    plan.add(create, plan.add(getTable(index.first)));
+    session.commit(plan, 1);
+  }
+
+  scale_t scale;
+  scale.warehouses = sizes["WAREHOUSE"];
+  scale.districts = scale.warehouses > 0 ? sizes["DISTRICT"] / scale.warehouses : 0;
+  scale.customers = scale.districts > 0 ? sizes["CUSTOMER"] / (scale.warehouses * scale.districts) : 0;
+  scale.items = sizes["ITEM"];
+  if (scale.customers == 0 || scale.items == 0)
+    throw std::runtime_error("No TPC-C data in " + path);
+  return scale;
+}
+
+Terminal::Terminal(const scale_t &scale, int warehouse, unsigned seed) :
+    _scale(scale),
+    _warehouse(warehouse),
+    _generator(seed) {}
+
+int Terminal::uniform(int min, int max) {
+  return std::uniform_int_distribution<int>(min, max)(_generator);
+}
+
+// The constant C is 0 as hyrise-perf-datagen uses 0 to load the tables
+int Terminal::nurand(int a, int min, int max) {
+  return (uniform(0, a) | uniform(min, max)) % (max - min + 1) + min;
+}
+
+std::string Terminal::lastName(int number) {
+  return std::string(LAST_NAME_SYLLABLES[number / 100]) + LAST_NAME_SYLLABLES[number / 10 % 10] + LAST_NAME_SYLLABLES[number % 10];
+}
+
+transaction_t Terminal::next() {
+  const int r = uniform(1, 100);
+  if (r <= 45)
+    return NewOrder;
+  if (r <= 88)
+    return Payment;
+  if (r <= 92)
+    return OrderStatus;
+  return r <= 96 ? Delivery : StockLevel;
+}
+
+bool Terminal::run(transaction_t type) {
+  try {
+    switch (type) {
+      case NewOrder:
+        return newOrder();
+      case Payment:
+        payment();
+        break;
+      case OrderStatus:
+        orderStatus();
+        break;
+      case Delivery:
+        delivery();
+        break;
+      case StockLevel:
+        stockLevel();
+        break;
+    }
+  } catch (const TransactionAborted &) {
+    throw;
+  } catch (const std::exception &) {
+    _session.rollback();
+    throw;
+  }
+  return true;
+}
+
+Json::Value Terminal::select(const std::string &table, const row_key_t &key, const std::vector<std::string> &names) {
+  Plan plan;
+  plan.add(fields(names), lookup(plan, table, key));
+  return rowsOf(_session.execute(plan));
+}
+
+Json::Value Terminal::selectOne(const std::string &table, const row_key_t &key, const std::vector<std::string> &names) {
+  const auto rows = select(table, key, names);
+  if (rows.size() != 1)
+    throw std::runtime_error("Found " + std::to_string(rows.size()) + " rows in " + table + " for " +
+                             key[0].first + " " + key[0].second.asString() + " instead of one");
+  return rows[0u];
+}
+
+void Terminal::update(const std::string &table, const row_key_t &key, const Json::Value &values) {
+  Plan plan;
+  Json::Value update = op("PosUpdateScan");
+  update["data"] = values;
+  plan.add(update, lookup(plan, table, key));
+  _session.execute(plan, 1);
+}
+
+row_key_t Terminal::customer(int warehouse, int district) {
+  if (uniform(1, 100) <= 60) {
+    const auto name = lastName(nurand(255, 0, std::min(999, _scale.customers - 1)));
+    const auto rows = select("CUSTOMER", {{"C_LAST", name}, {"C_D_ID", district}, {"C_W_ID", warehouse}}, {"C_ID", "C_FIRST"});
+    if (!rows.empty()) {
+      // The customer in the middle when ordered by first name
+      std::vector<Json::Value> customers;
+      for (const auto &row : rows)
+        customers.push_back(row);
+      std::sort(customers.begin(), customers.end(), [](const Json::Value &a, const Json::Value &b) {
+        return a[1u].asString() < b[1u].asString();
+      });
+      return {{"C_ID", customers[(customers.size() - 1) / 2][0u]}, {"C_D_ID", district}, {"C_W_ID", warehouse}};
+    }
+  }
+  return {{"C_ID", nurand(1023, 1, _scale.customers)}, {"C_D_ID", district}, {"C_W_ID", warehouse}};
+}
+
+bool Terminal::newOrder() {
+  const int d = uniform(1, _scale.districts);
+  const int c = nurand(1023, 1, _scale.customers);
+  const int lines = uniform(5, 15);
+  // 1% of the orders contain an unused item and are rolled back
+  const bool invalid = uniform(1, 100) == 1;
+
+  selectOne("WAREHOUSE", {{"W_ID", _warehouse}}, {"W_TAX"});
+  const row_key_t district = {{"D_W_ID", _warehouse}, {"D_ID", d}};
+  const int o = selectOne("DISTRICT", district, {"D_TAX", "D_NEXT_O_ID"})[1u].asInt();
+  Json::Value next;
+  next["D_NEXT_O_ID"] = o + 1;
+  update("DISTRICT", district, next);
+  selectOne("CUSTOMER", {{"C_ID", c}, {"C_D_ID", d}, {"C_W_ID", _warehouse}}, {"C_DISCOUNT", "C_LAST", "C_CREDIT"});
+
+  char dist[16];
+  snprintf(dist, sizeof(dist), "S_DIST_%02d", d);
+
+  bool allLocal = true;
+  Json::Value orderLines(Json::arrayValue);
+  for (int l = 1; l <= lines; ++l) {
+    const int item = invalid && l == lines ? _scale.items + 1 : nurand(8191, 1, _scale.items);
+    int supply = _warehouse;
+    if (_scale.warehouses > 1 && uniform(1, 100) == 1) {
+      supply = uniform(1, _scale.warehouses - 1);
+      supply += supply >= _warehouse ? 1 : 0;
+      allLocal = false;
+    }
+    const int quantity = uniform(1, 10);
+
+    const auto items = select("ITEM", {{"I_ID", item}}, {"I_PRICE", "I_NAME", "I_DATA"});
+    if (items.empty()) {
+      _session.rollback();
+      return false;
+    }
+
+    const row_key_t stockKey = {{"S_I_ID", item}, {"S_W_ID", supply}};
+    const auto stock = selectOne("STOCK", stockKey, {"S_QUANTITY", dist, "S_YTD", "S_ORDER_CNT", "S_REMOTE_CNT"});
+    const int available = stock[0u].asInt();
+    Json::Value values;
+    values["S_QUANTITY"] = available >= quantity + 10 ? available - quantity : available - quantity + 91;
+    values["S_YTD"] = stock[2u].asInt() + quantity;
+    values["S_ORDER_CNT"] = stock[3u].asInt() + 1;
+    if (supply != _warehouse)
+      values["S_REMOTE_CNT"] = stock[4u].asInt() + 1;
+    update("STOCK", stockKey, values);
+
+    Json::Value line(Json::arrayValue);
+    for (const auto &value : {Json::Value(o), Json::Value(d), Json::Value(_warehouse), Json::Value(l), Json::Value(item),
+                              Json::Value(supply), Json::Value(""), Json::Value((double) quantity),
+                              Json::Value(quantity * items[0u][0u].asDouble()), stock[1u]})
+      line.append(value);
+    orderLines.append(line);
+  }
+
+  Json::Value order(Json::arrayValue), orders(Json::arrayValue);
+  for (const auto &value : {Json::Value(o), Json::Value(d), Json::Value(_warehouse), Json::Value(c), Json::Value(now()),
+                            Json::Value(0), Json::Value(lines), Json::Value(allLocal ? 1 : 0)})
+    order.append(value);
+  orders.append(order);
+
+  Json::Value newOrder(Json::arrayValue), newOrders(Json::arrayValue);
+  for (const auto &value : {Json::Value(o), Json::Value(d), Json::Value(_warehouse)})
+    newOrder.append(value);
+  newOrders.append(newOrder);
+
+  Plan plan;
+  insert(plan, "ORDERS", orders);
+  insert(plan, "NEW_ORDER", newOrders);
+  insert(plan, "ORDER_LINE", orderLines);
+  _session.commit(plan, 1);
+  return true;
+}
+
+void Terminal::payment() {
+  const int d = uniform(1, _scale.districts);
+  // 15% of the payments are for customers of another warehouse
+  int cw = _warehouse, cd = d;
+  if (_scale.warehouses > 1 && uniform(1, 100) > 85) {
+    cw = uniform(1, _scale.warehouses - 1);
+    cw += cw >= _warehouse ? 1 : 0;
+    cd = uniform(1, _scale.districts);
+  }
+  const double amount = uniform(100, 500000) / 100.0;
+
+  const row_key_t warehouse = {{"W_ID", _warehouse}};
+  const auto w = selectOne("WAREHOUSE", warehouse, {"W_YTD", "W_NAME"});
+  Json::Value warehouseYtd;
+  warehouseYtd["W_YTD"] = w[0u].asDouble() + amount;
+  update("WAREHOUSE", warehouse, warehouseYtd);
+
+  const row_key_t district = {{"D_W_ID", _warehouse}, {"D_ID", d}};
+  const auto dr = selectOne("DISTRICT", district, {"D_YTD", "D_NAME"});
+  Json::Value districtYtd;
+  districtYtd["D_YTD"] = dr[0u].asDouble() + amount;
+  update("DISTRICT", district, districtYtd);
+
+  const auto key = customer(cw, cd);
+  const auto c = selectOne("CUSTOMER", key, {"C_ID", "C_BALANCE", "C_YTD_PAYMENT", "C_PAYMENT_CNT", "C_CREDIT", "C_DATA"});
+  Json::Value values;
+  values["C_BALANCE"] = c[1u].asDouble() - amount;
+  values["C_YTD_PAYMENT"] = c[2u].asDouble() + amount;
+  values["C_PAYMENT_CNT"] = c[3u].asInt() + 1;
+  if (c[4u].asString() == "BC") {
+    const std::string data = std::to_string(c[0u].asInt()) + " " + std::to_string(cd) + " " + std::to_string(cw) + " " +
+                             std::to_string(d) + " " + std::to_string(_warehouse) + " " + std::to_string(amount) + "|" + c[5u].asString();
+    values["C_DATA"] = data.substr(0, C_DATA_LENGTH);
+  }
+  update("CUSTOMER", key, values);
+
+  Json::Value history(Json::arrayValue), rows(Json::arrayValue);
+  for (const auto &value : {c[0u], Json::Value(cd), Json::Value(cw), Json::Value(d), Json::Value(_warehouse), Json::Value(now()),
+                            Json::Value(amount), Json::Value(w[1u].asString() + "    " + dr[1u].asString())})
+    history.append(value);
+  rows.append(history);
+
+  Plan plan;
+  insert(plan, "HISTORY", rows);
+  _session.commit(plan, 1);
+}
+
+void Terminal::orderStatus() {
+  const int d = uniform(1, _scale.districts);
+  const auto c = selectOne("CUSTOMER", customer(_warehouse, d), {"C_ID", "C_BALANCE", "C_FIRST", "C_MIDDLE", "C_LAST"});
+
+  const auto orders = select("ORDERS", {{"O_C_ID", c[0u]}, {"O_D_ID", d}, {"O_W_ID", _warehouse}}, {"O_ID", "O_ENTRY_D", "O_CARRIER_ID"});
+  int last = 0;
+  for (const auto &order : orders)
+    last = std::max(last, order[0u].asInt());
+
+  if (last > 0)
+    select("ORDER_LINE", {{"OL_O_ID", last}, {"OL_D_ID", d}, {"OL_W_ID", _warehouse}},
+           {"OL_I_ID", "OL_SUPPLY_W_ID", "OL_QUANTITY", "OL_AMOUNT", "OL_DELIVERY_D"});
+  _session.commit();
+}
+
+void Terminal::delivery() {
+  const int carrier = uniform(1, 10);
+  const std::string date = now();
+
+  for (int d = 1; d <= _scale.districts; ++d) {
+    // The oldest undelivered order of the district
+    Plan oldest;
+    Json::Value sort = op("SortScan");
+    sort["fields"].append(0u);
+    oldest.add(sort, lookup(oldest, "NEW_ORDER", {{"NO_D_ID", d}, {"NO_W_ID", _warehouse}}));
+    const auto rows = rowsOf(_session.execute(oldest, 1));
+    if (rows.empty())
+      continue;
+    const int o = rows[0u][0u].asInt();
+
+    Plan remove;
+    remove.add(op("Delete"), lookup(remove, "NEW_ORDER", {{"NO_O_ID", o}, {"NO_D_ID", d}, {"NO_W_ID", _warehouse}}));
+    _session.execute(remove, 1);
+
+    const row_key_t order = {{"O_ID", o}, {"O_D_ID", d}, {"O_W_ID", _warehouse}};
+    const auto c = selectOne("ORDERS", order, {"O_C_ID"})[0u];
+    Json::Value carrierId;
+    carrierId["O_CARRIER_ID"] = carrier;
+    update("ORDERS", order, carrierId);
+
+    const row_key_t lines = {{"OL_O_ID", o}, {"OL_D_ID", d}, {"OL_W_ID", _warehouse}};
+    double total = 0;
+    for (const auto &line : select("ORDER_LINE", lines, {"OL_AMOUNT"}))
+      total += line[0u].asDouble();
+    Json::Value delivered;
+    delivered["OL_DELIVERY_D"] = date;
+    update("ORDER_LINE", lines, delivered);
+
+    const row_key_t customer = {{"C_ID", c}, {"C_D_ID", d}, {"C_W_ID", _warehouse}};
+    const auto balance = selectOne("CUSTOMER", customer, {"C_BALANCE", "C_DELIVERY_CNT"});
+    Json::Value values;
+    values["C_BALANCE"] = balance[0u].asDouble() + total;
+    values["C_DELIVERY_CNT"] = balance[1u].asInt() + 1;
+    update("CUSTOMER", customer, values);
+  }
+  _session.commit();
+}
+
+void Terminal::stockLevel() {
+  const int d = uniform(1, _scale.districts);
+  const int threshold = uniform(10, 20);
+  const int next = selectOne("DISTRICT", {{"D_W_ID", _warehouse}, {"D_ID", d}}, {"D_NEXT_O_ID"})[0u].asInt();
+
+  // Items of the last 20 orders of the district with low stock
+  Plan plan;
+  Json::Value recent = op("IndexScan");
+  recent["index"] = indexName("ORDER_LINE", "OL_O_ID");
+  recent["fields"].append("OL_O_ID");
+  recent["value"] = next - 20;
+  recent["value_max"] = next - 1;
+  recent["vtype"] = 0;
+  const auto lines = plan.add(filter({{"OL_O_ID", 0}, {"OL_D_ID", d}, {"OL_W_ID", _warehouse}}),
+                              plan.add(recent, plan.add(getTable("ORDER_LINE"))));
+
+  Json::Value build = op("HashBuild");
+  build["fields"].append("OL_I_ID");
+  build["key"] = "join";
+  const auto hash = plan.add(build, lines);
+
+  Json::Value low = op("SimpleTableScan");
+  low["positions"] = true;
+  low["predicates"].append(op("AND"));
+  low["predicates"].append(predicate("EQ", "S_W_ID", _warehouse));
+  low["predicates"].append(predicate("LT", "S_QUANTITY", threshold));
+  const auto stock = plan.add(op("ValidatePositions"), plan.add(low, plan.add(getTable("STOCK"))));
+
+  Json::Value probe = op("HashJoinProbe");
+  probe["fields"].append("S_I_ID");
+  const auto joined = plan.add(probe, stock);
+  plan.edge(hash, joined);
+  plan.add(fields({"S_I_ID"}), joined);
+  _session.commit(plan);
+}
+
+Driver::Driver(const scale_t &scale, size_t terminals, size_t streams) :
+    _scale(scale),
+    _terminals(terminals),
+    _streams(streams),
+    _queries(analyticalQueries()),
+    _measured(0),
+    _failed(false),
+    _stats(TRANSACTION_TYPES, transaction_stats_t{0, 0, 0, 0, {}}),
+    _queryStats(_queries.size(), transaction_stats_t{0, 0, 0, 0, {}}) {}
+
+void Driver::run(std::chrono::seconds warmup, std::chrono::seconds duration) {
+  _measureFrom = std::chrono::steady_clock::now() + warmup;
+  _stopAt = _measureFrom + duration;
+  _measured = duration;
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < _terminals; ++t)
+    threads.emplace_back(&Driver::runTerminal, this, t);
+  for (size_t s = 0; s < _streams; ++s)
+    threads.emplace_back(&Driver::runStream, this, s);
+  for (auto &thread : threads)
+    thread.join();
+
+  if (_failed)
+    throw std::runtime_error(_error);
+}
+
+void Driver::runTerminal(size_t number) {
+  // Terminals are spread evenly over the warehouses
+  Terminal terminal(_scale, number % _scale.warehouses + 1, number + 1);
+  std::vector<transaction_stats_t> stats(TRANSACTION_TYPES, transaction_stats_t{0, 0, 0, 0, {}});
+
+  try {
+    while (!_failed) {
+      const auto type = terminal.next();
+      const auto start = std::chrono::steady_clock::now();
+      if (start >= _stopAt)
+        break;
+
+      bool aborted = false, failed = false, rolledBack = false;
+      try {
+        rolledBack = !terminal.run(type);
+      } catch (const TransactionAborted &) {
+        aborted = true;
+      } catch (const std::exception &) {
+        // e.g. a row the transaction reads is not visible to it
+        failed = true;
+      }
+
+      // Only transactions that ran entirely within the measurement count
+      const auto end = std::chrono::steady_clock::now();
+      if (start < _measureFrom || end > _stopAt)
+        continue;
+
+      auto &s = stats[type];
+      if (aborted) {
+        ++s.aborted;
+      } else if (failed) {
+        ++s.failed;
+      } else {
+        ++s.completed;
+        s.rolledBack += rolledBack ? 1 : 0;
+        s.latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+      }
+    }
+  } catch (const std::exception &e) {
+    fail(std::string("Terminal ") + std::to_string(number) + " failed: " + e.what());
+  }
+
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  for (size_t type = 0; type < TRANSACTION_TYPES; ++type) {
+    _stats[type].completed += stats[type].completed;
+    _stats[type].aborted += stats[type].aborted;
+    _stats[type].rolledBack += stats[type].rolledBack;
+    _stats[type].failed += stats[type].failed;
+    _stats[type].latencies.insert(_stats[type].latencies.end(), stats[type].latencies.begin(), stats[type].latencies.end());
+  }
+}
+
+void Driver::runStream(size_t number) {
+  Session session;
+  std::vector<transaction_stats_t> stats(_queries.size(), transaction_stats_t{0, 0, 0, 0, {}});
+
+  try {
+    // Streams start at different queries, as in the CH-benCHmark
+    for (size_t q = number; !_failed; ++q) {
+      const auto &query = _queries[q % _queries.size()];
+      const auto start = std::chrono::steady_clock::now();
+      if (start >= _stopAt)
+        break;
+
+      bool aborted = false;
+      try {
+        session.commit(query.plan);
+      } catch (const TransactionAborted &) {
+        aborted = true;
+      }
+
+      const auto end = std::chrono::steady_clock::now();
+      if (start < _measureFrom || end > _stopAt)
+        continue;
+
+      auto &s = stats[q % _queries.size()];
+      if (aborted) {
+        ++s.aborted;
+      } else {
+        ++s.completed;
+        s.latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+      }
+    }
+  } catch (const std::exception &e) {
+    fail(std::string("Analytical stream ") + std::to_string(number) + " failed: " + e.what());
+  }
+
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  for (size_t q = 0; q < _queries.size(); ++q) {
+    _queryStats[q].completed += stats[q].completed;
+    _queryStats[q].aborted += stats[q].aborted;
+    _queryStats[q].latencies.insert(_queryStats[q].latencies.end(), stats[q].latencies.begin(), stats[q].latencies.end());
+  }
+}
+
+void Driver::fail(const std::string &error) {
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  if (!_failed)
+    _error = error;
+  _failed = true;
+}
+
+void Driver::report(std::ostream &out) {
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  const double minutes = std::chrono::duration<double>(_measured).count() / 60;
+
+  out << std::fixed << std::setprecision(2);
+  out << "Warehouses: " << _scale.warehouses << ", terminals: " << _terminals << std::endl;
+  out << "tpmC: " << _stats[NewOrder].completed / minutes << std::endl << std::endl;
+
+  out << std::left << std::setw(12) << "Transaction" << std::right
+      << std::setw(10) << "Completed" << std::setw(10) << "Aborted" << std::setw(10) << "Abort %"
+      << std::setw(12) << "Rolled back" << std::setw(10) << "Failed" << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+      << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::endl;
+
+  for (size_t type = 0; type < TRANSACTION_TYPES; ++type) {
+    auto &s = _stats[type];
+    std::sort(s.latencies.begin(), s.latencies.end());
+    const size_t attempts = s.completed + s.aborted;
+    out << std::left << std::setw(12) << transactionName((transaction_t) type) << std::right
+        << std::setw(10) << s.completed << std::setw(10) << s.aborted
+        << std::setw(10) << (attempts > 0 ? 100.0 * s.aborted / attempts : 0.0)
+        << std::setw(12) << s.rolledBack << std::setw(10) << s.failed
+        << std::setw(10) << percentile(s.latencies, 0.5) << std::setw(10) << percentile(s.latencies, 0.9)
+        << std::setw(10) << percentile(s.latencies, 0.99) << std::setw(10) << percentile(s.latencies, 1.0) << std::endl;
+  }
+
+  if (_streams == 0)
+    return;
+
+  size_t completed = 0;
+  for (const auto &s : _queryStats)
+    completed += s.completed;
+  out << std::endl << "Analytical streams: " << _streams << ", queries per hour: " << completed / minutes * 60 << std::endl << std::endl;
+
+  out << std::left << std::setw(12) << "Query" << std::right
+      << std::setw(10) << "Completed" << std::setw(10) << "Failed" << std::setw(10) << "p50 ms"
+      << std::setw(10) << "p90 ms" << std::setw(10) << "max ms" << std::endl;
+
+  for (size_t q = 0; q < _queries.size(); ++q) {
+    auto &s = _queryStats[q];
+    std::sort(s.latencies.begin(), s.latencies.end());
+    out << std::left << std::setw(12) << _queries[q].name << std::right
+        << std::setw(10) << s.completed << std::setw(10) << s.aborted
+        << std::setw(10) << percentile(s.latencies, 0.5) << std::setw(10) << percentile(s.latencies, 0.9)
+        << std::setw(10) << percentile(s.latencies, 1.0) << std::endl;
+  }
+}
+
+} } // namespace hyrise::tpcc
@@ -0,0 +1,202 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_BIN_PERF_TPCC_TPCCDRIVER_H_
+#define SRC_BIN_PERF_TPCC_TPCCDRIVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+
+namespace hyrise {
+namespace tpcc {
+
+typedef enum {
+  NewOrder,
+  Payment,
+  OrderStatus,
+  Delivery,
+  StockLevel
+} transaction_t;
+
+const size_t TRANSACTION_TYPES = 5;
+
+const char *transactionName(transaction_t type);
+
+/// Thrown when the server failed a plan of a transaction, e.g. because
+/// of a write conflict with a concurrent transaction
+class TransactionAborted : public std::runtime_error {
+ public:
+  explicit TransactionAborted(const std::string &what) : std::runtime_error(what) {}
+};
+
+/// Builds the operators and edges of a JSON query plan
+class Plan {
+ public:
+  Plan();
+
+  /// Adds op under a generated id, consuming the result of input if given
+  std::string add(const Json::Value &op, const std::string &input = "");
+
+  /// Adds op consuming the results of all operators without successors
+  std::string addAfterAll(const Json::Value &op);
+
+  void edge(const std::string &from, const std::string &to);
+
+  const Json::Value &json() const {
+    return _plan;
+  }
+
+ private:
+  Json::Value _plan;
+  size_t _next;
+};
+
+/// Executes plans in process the way the server executes the requests
+/// of a client, keeping the transaction context between the plans of a
+/// transaction.
+class Session {
+ public:
+  /// Executes plan in the current transaction, the first plan begins a
+  /// transaction. Transmits at most limit rows of the result, 0
+  /// transmits all.
+  /// \throws TransactionAborted if the plan failed, the transaction is
+  /// rolled back
+  Json::Value execute(const Plan &plan, size_t limit = 0);
+
+  /// Executes plan followed by the commit of the transaction
+  Json::Value commit(Plan plan, size_t limit = 0);
+
+  void commit();
+
+  /// Rolls back the current transaction, if any
+  void rollback();
+
+ private:
+  Json::Value request(const Json::Value &plan, size_t limit, bool withContext);
+
+  std::string _context;
+};
+
+/// Values of the columns identifying rows, the first column is indexed
+typedef std::vector<std::pair<std::string, Json::Value>> row_key_t;
+
+/// Scale of the database as generated by hyrise-perf-datagen
+typedef struct {
+  int warehouses;
+  // per warehouse
+  int districts;
+  // per district
+  int customers;
+  int items;
+} scale_t;
+
+/// Loads the tables written by hyrise-perf-datagen --hyrise into path
+/// and creates the indexes the transactions look up rows with
+scale_t loadTables(const std::string &path);
+
+/// Emulates a terminal of one home warehouse that issues transactions
+/// back to back, without keying and think times
+class Terminal {
+ public:
+  Terminal(const scale_t &scale, int warehouse, unsigned seed);
+
+  /// Draws the type of the next transaction from the TPC-C mix
+  transaction_t next();
+
+  /// Runs a transaction, returns false if it was rolled back on purpose,
+  /// as 1% of the new order transactions are
+  /// \throws TransactionAborted if the server aborted the transaction,
+  /// other exceptions if the transaction failed on the client; it is
+  /// rolled back in both cases
+  bool run(transaction_t type);
+
+ private:
+  bool newOrder();
+  void payment();
+  void orderStatus();
+  void delivery();
+  void stockLevel();
+
+  int uniform(int min, int max);
+  int nurand(int a, int min, int max);
+  std::string lastName(int number);
+
+  /// Key of a customer of the district, selected by last name in 60% of
+  /// the cases
+  row_key_t customer(int warehouse, int district);
+
+  Json::Value select(const std::string &table, const row_key_t &key, const std::vector<std::string> &fields);
+  Json::Value selectOne(const std::string &table, const row_key_t &key, const std::vector<std::string> &fields);
+  void update(const std::string &table, const row_key_t &key, const Json::Value &values);
+
+  const scale_t _scale;
+  const int _warehouse;
+  std::mt19937 _generator;
+  Session _session;
+};
+
+typedef struct {
+  size_t completed;
+  size_t aborted;
+  size_t rolledBack;
+  // Transactions that failed on the client, e.g. on an unexpected result
+  size_t failed;
+  // in ms, of completed transactions
+  std::vector<double> latencies;
+} transaction_stats_t;
+
+/// Analytical query of the CH-benCHmark on the TPC-C tables
+typedef struct {
+  std::string name;
+  Plan plan;
+} analytical_query_t;
+
+/// Queries 1, 6 and 19 of the CH-benCHmark, the ones the plan operators
+/// can express; query 19 only checks the quantity and price ranges, not
+/// the disjunction over item data and warehouses
+std::vector<analytical_query_t> analyticalQueries();
+
+/// Runs terminals on their own threads and collects the statistics of
+/// the transactions they complete after the warmup. Analytical streams
+/// run the CH-benCHmark queries back to back on the same tables at the
+/// same time, so their latencies and the tpmC show how both workloads
+/// interfere.
+class Driver {
+ public:
+  Driver(const scale_t &scale, size_t terminals, size_t streams = 0);
+
+  void run(std::chrono::seconds warmup, std::chrono::seconds duration);
+
+  /// Prints tpmC, abort rates and latency percentiles
+  void report(std::ostream &out);
+
+ private:
+  void runTerminal(size_t number);
+  void runStream(size_t number);
+  void fail(const std::string &error);
+
+  const scale_t _scale;
+  const size_t _terminals;
+  const size_t _streams;
+  const std::vector<analytical_query_t> _queries;
+  std::chrono::steady_clock::time_point _measureFrom;
+  std::chrono::steady_clock::time_point _stopAt;
+  std::chrono::steady_clock::duration _measured;
+
+  std::atomic<bool> _failed;
+  std::mutex _statsMutex;
+  std::vector<transaction_stats_t> _stats;
+  std::vector<transaction_stats_t> _queryStats;
+  std::string _error;
+};
+
+} } // namespace hyrise::tpcc
+
+#endif  // SRC_BIN_PERF_TPCC_TPCCDRIVER_H_
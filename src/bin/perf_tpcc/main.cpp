@@ -0,0 +1,92 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include "log4cxx/logger.h"
+#include "log4cxx/propertyconfigurator.h"
+
+#include <boost/program_options.hpp>
+
+#include "helper/HwlocHelper.h"
+#include "helper/Settings.h"
+#include "taskscheduler/SharedScheduler.h"
+
+#include "TpccDriver.h"
+
+namespace po = boost::program_options;
+using namespace hyrise;
+
+namespace {
+
+// default number of terminals per warehouse, as in TPC-C
+const size_t TERMINALS_PER_WAREHOUSE = 10;
+// default length in s of the measurement and of the warmup before it
+const size_t DEFAULT_DURATION = 60;
+const size_t DEFAULT_WARMUP = 10;
+
+}
+
+/// Runs the TPC-C transaction mix against the tables generated by
+///
+///    hyrise-perf-datagen -w <warehouses> -d <data> --hyrise
+///
+/// executing each transaction as a sequence of JSON plans on an in
+/// process server and reports tpmC, abort rates and latencies. With
+/// --analytical, streams of CH-benCHmark queries run on the same tables
+/// alongside the terminals.
+int main(int argc, char *argv[]) {
+  std::string data;
+  std::string logPropertyFile;
+  std::string scheduler_name;
+  int worker_threads = 0;
+  size_t terminals;
+  size_t streams;
+  size_t duration;
+  size_t warmup;
+
+  po::options_description desc("Allowed Parameters");
+  desc.add_options()("help", "Shows this help message")
+  ("data,d", po::value<std::string>(&data)->default_value(Settings::getInstance()->getDBPath()), "Directory with the tables written by hyrise-perf-datagen --hyrise, defaults to HYRISE_DB_PATH")
+  ("logdef,l", po::value<std::string>(&logPropertyFile)->default_value("build/log.properties"), "Log4CXX Log Properties File")
+  ("terminals", po::value<size_t>(&terminals)->default_value(0), "Number of terminals issuing transactions concurrently. Use 0 for ten terminals per warehouse.")
+  ("analytical", po::value<size_t>(&streams)->default_value(0), "Number of streams running the analytical queries of the CH-benCHmark concurrently to the terminals")
+  ("duration", po::value<size_t>(&duration)->default_value(DEFAULT_DURATION), "Length of the measurement in s")
+  ("warmup", po::value<size_t>(&warmup)->default_value(DEFAULT_WARMUP), "Time in s the terminals run before the measurement starts")
+  ("scheduler,s", po::value<std::string>(&scheduler_name)->default_value("WSCoreBoundQueuesScheduler"), "Name of the scheduler to use")
+  ("threads,t", po::value<int>(&worker_threads)->default_value(getNumberOfCoresOnSystem()), "Number of worker threads for scheduler (only relevant for scheduler with fixed number of threads)");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch(po::error &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  log4cxx::PropertyConfigurator::configure(logPropertyFile);
+  taskscheduler::SharedScheduler::getInstance().init(scheduler_name, worker_threads);
+
+  try {
+    std::cout << "Loading tables from " << data << std::endl;
+    const auto scale = tpcc::loadTables(data);
+    if (terminals == 0)
+      terminals = TERMINALS_PER_WAREHOUSE * scale.warehouses;
+
+    std::cout << "Running " << terminals << " terminals and " << streams << " analytical streams for "
+              << warmup << "s warmup and " << duration << "s" << std::endl;
+    tpcc::Driver driver(scale, terminals, streams);
+    driver.run(std::chrono::seconds(warmup), std::chrono::seconds(duration));
+    driver.report(std::cout);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "helper/QueryArena.h"
+
+namespace hyrise {
+
+TEST(QueryArenaTest, allocations_are_aligned_and_counted) {
+  QueryArena arena;
+  ASSERT_EQ(0u, arena.reserved());
+
+  void *a = arena.allocate(1);
+  void *b = arena.allocate(20);
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(a) % QueryArena::alignment);
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(b) % QueryArena::alignment);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(QueryArena::alignment * 3, arena.allocated());
+  ASSERT_EQ(QueryArena::first_chunk_size, arena.reserved());
+
+  // Does not fit into the current chunk, the next one is twice as large
+  arena.allocate(QueryArena::first_chunk_size);
+  ASSERT_EQ(QueryArena::first_chunk_size * 3, arena.reserved());
+
+  // Large allocations get a chunk of their own
+  arena.allocate(QueryArena::max_chunk_size);
+  ASSERT_EQ(QueryArena::first_chunk_size * 3 + QueryArena::max_chunk_size, arena.reserved());
+}
+
+TEST(QueryArenaTest, limit_aborts_allocation) {
+  QueryArena arena(1024);
+  arena.allocate(1000);
+  ASSERT_THROW(arena.allocate(100), QueryMemoryExceeded);
+  arena.setLimit(0);
+  arena.allocate(100);
+}
+
+TEST(QueryArenaTest, freed_blocks_are_credited_and_reused) {
+  QueryArena arena(4096);
+  void *buckets = arena.allocate(2048);
+  arena.allocate(1024);
+  // Without crediting, the grown buckets would exceed the limit
+  arena.deallocate(buckets, 2048);
+  ASSERT_EQ(1024u, arena.allocated());
+  void *grown = arena.allocate(3072);
+  ASSERT_EQ(4096u, arena.allocated());
+  arena.deallocate(grown, 3072);
+
+  // A freed block serves a smaller allocation without a new chunk
+  const size_t reserved = arena.reserved();
+  void *reused = arena.allocate(2000);
+  ASSERT_TRUE(reused == buckets || reused == grown);
+  ASSERT_EQ(reserved, arena.reserved());
+
+  // Small blocks stay accounted
+  void *small = arena.allocate(16);
+  arena.deallocate(small, 16);
+  ASSERT_EQ(1024u + 2000u + 16u, arena.allocated());
+}
+
+TEST(QueryArenaTest, concurrent_allocations) {
+  QueryArena arena;
+  const size_t threads = 8, allocations = 10000;
+  std::vector<std::vector<char *>> blocks(threads);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&arena, &blocks, t, allocations] () {
+        for (size_t i = 0; i < allocations; ++i) {
+          auto block = static_cast<char *>(arena.allocate(32));
+          block[0] = static_cast<char>(t);
+          blocks[t].push_back(block);
+        }
+      });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  ASSERT_EQ(threads * allocations * 32, arena.allocated());
+  std::set<char *> distinct;
+  for (size_t t = 0; t < threads; ++t) {
+    for (auto block : blocks[t]) {
+      ASSERT_EQ(static_cast<char>(t), block[0]);
+      distinct.insert(block);
+    }
+  }
+  ASSERT_EQ(threads * allocations, distinct.size());
+}
+
+TEST(QueryArenaTest, containers_keep_arena_alive) {
+  typedef std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<const int, int>>> map_t;
+  std::unique_ptr<map_t> map;
+  std::weak_ptr<QueryArena> weak;
+  {
+    auto arena = std::make_shared<QueryArena>();
+    weak = arena;
+    map.reset(new map_t(0, map_t::hasher(), map_t::key_equal(), map_t::allocator_type(arena)));
+    for (int i = 0; i < 1000; ++i)
+      (*map)[i] = i * 2;
+    ASSERT_GT(arena->allocated(), 1000 * sizeof(map_t::value_type));
+  }
+  ASSERT_FALSE(weak.expired());
+  ASSERT_EQ(1000u, map->size());
+  ASSERT_EQ(1998, map->at(999));
+  map.reset();
+  ASSERT_TRUE(weak.expired());
+
+  // Without an arena the heap is used
+  std::vector<int, ArenaAllocator<int>> heap(100, 1);
+  ASSERT_EQ(100, std::accumulate(heap.begin(), heap.end(), 0));
+}
+
+}  // namespace hyrise
@@ -3,8 +3,15 @@
 #include "access/SimpleTableScan.h"
 #include "access/expressions/pred_LikeExpression.h"
 #include "access/expressions/pred_InExpression.h"
+#include "access/expressions/pred_BetweenOperation.h"
+#include "access/expressions/pred_CompiledExpression.h"
+#include "access/expressions/pred_CompoundExpression.h"
+#include "access/expressions/pred_EqualsExpression.h"
+#include "access/expressions/pred_GreaterThanExpression.h"
+#include "access/expressions/pred_LessThanExpression.h"
 #include <json.h>
 #include "io/shortcuts.h"
+#include "storage/Store.h"
 
 namespace hyrise {
 namespace access {
@@ -92,6 +99,191 @@ TEST_F(ExpressionTests, in_error_on_non_array_value_test)
 {
   ASSERT_ANY_THROW(new InExpression<hyrise_int_t>(0, field_name_t("student_number"), hyrise_int_t(42)));
 }
+
+TEST_F(ExpressionTests, like_prefix_matches_regex_test)
+{
+  // "Ber.*" is evaluated as a value id range, "(Ber).*" with the regex
+  scan->setPredicate(new LikeExpression(0, field_name_t("city"), hyrise_string_t("Ber.*")));
+  scan->execute();
+
+  SimpleTableScan regexScan;
+  regexScan.addInput(students);
+  regexScan.setPredicate(new LikeExpression(0, field_name_t("city"), hyrise_string_t("(Ber).*")));
+  regexScan.execute();
+
+  ASSERT_EQ(34u, resultSize());
+  ASSERT_EQ(regexScan.getResultTable()->size(), resultSize());
+}
+
+TEST_F(ExpressionTests, dictionary_predicates_on_store_delta_test)
+{
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  const auto city = store->numberOfColumn("city");
+  const auto grade = store->numberOfColumn("grade");
+  store->resizeDelta(2);
+  store->copyRowToDelta(store, 0, 0, tx::START_TID);
+  store->copyRowToDelta(store, 0, 1, tx::START_TID);
+  // Values unknown to the main dictionary are only part of the delta
+  store->setValue<hyrise_string_t>(city, store->size() - 1, "Bern");
+  store->setValue<hyrise_float_t>(grade, store->size() - 1, 0.5f);
+
+  SimpleTableScan likeScan;
+  likeScan.addInput(store);
+  likeScan.setPredicate(new LikeExpression(0, field_name_t("city"), hyrise_string_t("Ber.*")));
+  likeScan.execute();
+  ASSERT_EQ(34u + 2u, likeScan.getResultTable()->size());
+
+  SimpleTableScan regexScan;
+  regexScan.addInput(store);
+  regexScan.setPredicate(new LikeExpression(0, field_name_t("city"), hyrise_string_t("Be.l.n")));
+  regexScan.execute();
+  ASSERT_EQ(34u + 1u, regexScan.getResultTable()->size());
+
+  Json::Value values(Json::ValueType::arrayValue);
+  values.append("Bern");
+  SimpleTableScan inScan;
+  inScan.addInput(store);
+  inScan.setPredicate(new InExpression<hyrise_string_t>(0, field_name_t("city"), values));
+  inScan.execute();
+  ASSERT_EQ(1u, inScan.getResultTable()->size());
+
+  SimpleTableScan betweenScan;
+  betweenScan.addInput(store);
+  betweenScan.setPredicate(new BetweenExpression<hyrise_float_t>(store, grade, 0.f, 0.9f));
+  betweenScan.execute();
+  ASSERT_EQ(1u, betweenScan.getResultTable()->size());
+}
+
+TEST_F(ExpressionTests, like_regex_matches_values_added_after_walk_test)
+{
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  const auto city = store->numberOfColumn("city");
+  std::unique_ptr<LikeExpression> like(new LikeExpression(store, city, hyrise_string_t("Be.l.n")));
+  like->walk({store});
+
+  // The values are unknown to the dictionaries when the filter is built
+  store->resizeDelta(2);
+  store->copyRowToDelta(store, 0, 0, tx::START_TID);
+  store->copyRowToDelta(store, 0, 1, tx::START_TID);
+  store->setValue<hyrise_string_t>(city, store->size() - 2, "Beblin");
+  store->setValue<hyrise_string_t>(city, store->size() - 1, "Bern");
+
+  ASSERT_TRUE((*like)(store->size() - 2));
+  ASSERT_FALSE((*like)(store->size() - 1));
+}
  
+TEST_F(ExpressionTests, compiled_conjunction_matches_interpreter_test)
+{
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  const auto city = store->numberOfColumn("city");
+  const auto grade = store->numberOfColumn("grade");
+  store->resizeDelta(3);
+  for (size_t row = 0; row < 3; ++row)
+    store->copyRowToDelta(store, row, row, tx::START_TID);
+  store->setValue<hyrise_string_t>(city, store->size() - 1, "Bern");
+
+  std::unique_ptr<SimpleExpression> expression(new CompoundExpression(
+      new CompoundExpression(
+          new LikeExpression(store, city, hyrise_string_t("Ber.*")),
+          new GreaterThanExpression<hyrise_float_t>(store, grade, 1.5f),
+          AND),
+      new LessThanExpression<hyrise_float_t>(store, grade, 3.5f),
+      AND));
+  expression->walk({store});
+
+  auto compiled = CompiledExpression::compile(expression.get(), store);
+  ASSERT_TRUE(compiled != nullptr);
+  ASSERT_EQ(3u, compiled->conjuncts());
+
+  pos_list_t interpreted;
+  for (size_t row = 0; row < store->size(); ++row) {
+    if ((*expression)(row))
+      interpreted.push_back(row);
+  }
+  pos_list_t fused;
+  compiled->match(0, store->size(), fused);
+  ASSERT_FALSE(interpreted.empty());
+  ASSERT_EQ(interpreted, fused);
+
+  pos_list_t delta;
+  compiled->match(store->deltaOffset(), store->size(), delta);
+  const auto in_delta = std::count_if(interpreted.begin(), interpreted.end(),
+                                      [&store] (pos_t p) { return p >= store->deltaOffset(); });
+  ASSERT_EQ(static_cast<size_t>(in_delta), delta.size());
+}
+
+TEST_F(ExpressionTests, compiled_expression_scans_rows_appended_after_compile_test)
+{
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  const auto city = store->numberOfColumn("city");
+  std::unique_ptr<SimpleExpression> expression(new LikeExpression(store, city, hyrise_string_t("Ber.*")));
+  expression->walk({store});
+  auto compiled = CompiledExpression::compile(expression.get(), store);
+  ASSERT_TRUE(compiled != nullptr);
+
+  // Inserted between setup and execution of a scan
+  store->resizeDelta(1);
+  store->copyRowToDelta(store, 0, 0, tx::START_TID);
+  store->setValue<hyrise_string_t>(city, store->size() - 1, "Bern");
+
+  pos_list_t positions;
+  compiled->match(store->deltaOffset(), store->size(), positions);
+  ASSERT_EQ(pos_list_t({store->size() - 1}), positions);
+}
+
+TEST_F(ExpressionTests, compiled_expression_rejects_unsupported_shapes_test)
+{
+  storage::c_atable_ptr_t t = io::Loader::shortcuts::load("test/students.tbl");
+  const auto city = t->numberOfColumn("city");
+
+  std::unique_ptr<SimpleExpression> disjunction(new CompoundExpression(
+      new EqualsExpression<hyrise_string_t>(t, city, "Berlin"),
+      new EqualsExpression<hyrise_string_t>(t, city, "Potsdam"),
+      OR));
+  disjunction->walk({t});
+  ASSERT_TRUE(CompiledExpression::compile(disjunction.get(), t) == nullptr);
+
+  SimpleExpression *wide = new EqualsExpression<hyrise_string_t>(t, city, "Berlin");
+  for (size_t i = 0; i < CompiledExpression::MAX_CONJUNCTS; ++i)
+    wide = new CompoundExpression(wide, new EqualsExpression<hyrise_string_t>(t, city, "Berlin"), AND);
+  std::unique_ptr<SimpleExpression> conjunction(wide);
+  conjunction->walk({t});
+  ASSERT_TRUE(CompiledExpression::compile(conjunction.get(), t) == nullptr);
+
+  // A predicate on the second input does not read the scanned table
+  storage::c_atable_ptr_t other = io::Loader::shortcuts::load("test/students.tbl");
+  std::unique_ptr<SimpleExpression> inputs(new CompoundExpression(
+      new EqualsExpression<hyrise_string_t>(0, field_name_t("city"), "Berlin"),
+      new EqualsExpression<hyrise_string_t>(1, field_name_t("city"), "Berlin"),
+      AND));
+  inputs->walk({t, other});
+  ASSERT_TRUE(CompiledExpression::compile(inputs.get(), t) == nullptr);
+}
+
+TEST_F(ExpressionTests, compiled_expression_matches_values_added_after_walk_test)
+{
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  storage::c_atable_ptr_t table = store;
+  const auto city = store->numberOfColumn("city");
+  std::unique_ptr<SimpleExpression> expression(new CompoundExpression(
+      new LikeExpression(table, city, hyrise_string_t("Be.l.n")),
+      new EqualsExpression<hyrise_string_t>(table, city, "Beblin"),
+      AND));
+  expression->walk({store});
+
+  // The delta dictionary grows after the filters were built
+  store->resizeDelta(2);
+  store->copyRowToDelta(store, 0, 0, tx::START_TID);
+  store->copyRowToDelta(store, 0, 1, tx::START_TID);
+  store->setValue<hyrise_string_t>(city, store->size() - 2, "Beblin");
+  store->setValue<hyrise_string_t>(city, store->size() - 1, "Bexlin");
+
+  auto compiled = CompiledExpression::compile(expression.get(), store);
+  ASSERT_TRUE(compiled != nullptr);
+  pos_list_t positions;
+  compiled->match(0, store->size(), positions);
+  ASSERT_EQ((pos_list_t {store->size() - 2}), positions);
+}
+
 }
 }
@@ -1,5 +1,6 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "access/HashBuild.h"
+#include "access/system/ResponseTask.h"
 #include "io/shortcuts.h"
 #include "storage/HashTable.h"
 #include "testing/test.h"
@@ -36,6 +37,37 @@ TEST_F(HashBuildTests, basic_hash_build_for_join_test) {
 
   ASSERT_NE(result.get(), (storage::JoinHashTable *) nullptr);
 }
+TEST_F(HashBuildTests, hash_table_uses_arena_of_query) {
+  auto t = io::Loader::shortcuts::load("test/10_30_group.tbl");
+  auto response = std::make_shared<ResponseTask>(nullptr);
+
+  auto hb = std::make_shared<HashBuild>();
+  response->registerPlanOperation(hb);
+  hb->addInput(t);
+  hb->addField(0);
+  hb->setKey("groupby");
+  (*hb)();
+
+  ASSERT_EQ(OpSuccess, hb->getState());
+  ASSERT_EQ(t->size(), hb->getResultHashTable()->size());
+  ASSERT_GT(response->getArena()->allocated(), 0u);
+}
+
+TEST_F(HashBuildTests, memory_limit_aborts_hash_build) {
+  auto t = io::Loader::shortcuts::load("test/10_30_group.tbl");
+  auto response = std::make_shared<ResponseTask>(nullptr);
+  response->getArena()->setLimit(64);
+
+  auto hb = std::make_shared<HashBuild>();
+  response->registerPlanOperation(hb);
+  hb->addInput(t);
+  hb->addField(0);
+  hb->setKey("groupby");
+  (*hb)();
+
+  ASSERT_EQ(OpFail, hb->getState());
+  ASSERT_EQ(1u, response->getErrorMessages().size());
+}
 
 }
 }
@@ -0,0 +1,66 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/system/RequestParseTask.h"
+#include "access/NoOp.h"
+#include "testing/test.h"
+
+#include "helper.h"
+
+namespace hyrise {
+namespace access {
+
+class InlineExecutionTest : public AccessTest {};
+
+TEST_F(InlineExecutionTest, sorts_tasks_topologically) {
+  auto a = std::make_shared<NoOp>(), b = std::make_shared<NoOp>(), c = std::make_shared<NoOp>();
+  b->addDependency(a);
+  c->addDependency(b);
+  std::vector<taskscheduler::task_ptr_t> tasks = {c, a, b};
+
+  bool chain = false;
+  ASSERT_TRUE(RequestParseTask::sortTopologically(tasks, chain));
+  ASSERT_TRUE(chain);
+  ASSERT_EQ(std::vector<taskscheduler::task_ptr_t>({a, b, c}), tasks);
+  ASSERT_TRUE(RequestParseTask::executesInline(tasks, chain, taskscheduler::Task::DEFAULT_PRIORITY));
+
+  // A join of two inputs is not a chain and left to the scheduler
+  auto d = std::make_shared<NoOp>();
+  c->addDependency(d);
+  tasks.push_back(d);
+  ASSERT_TRUE(RequestParseTask::sortTopologically(tasks, chain));
+  ASSERT_FALSE(chain);
+  ASSERT_EQ(c, tasks.back());
+  ASSERT_FALSE(RequestParseTask::executesInline(tasks, chain, taskscheduler::Task::DEFAULT_PRIORITY));
+  ASSERT_TRUE(RequestParseTask::executesInline(tasks, chain, taskscheduler::Task::HIGH_PRIORITY));
+}
+
+TEST_F(InlineExecutionTest, rejects_cycles) {
+  auto a = std::make_shared<NoOp>(), b = std::make_shared<NoOp>();
+  b->addDependency(a);
+  a->addDependency(b);
+  std::vector<taskscheduler::task_ptr_t> tasks = {a, b};
+
+  bool chain = false;
+  ASSERT_FALSE(RequestParseTask::sortTopologically(tasks, chain));
+}
+
+TEST_F(InlineExecutionTest, inline_and_scheduled_results_match) {
+  const std::string query = R"({
+      "operators": {
+        "load": {"type": "TableLoad", "table": "lin_xxs", "filename": "lin_xxxs.tbl"},
+        "scan": {"type": "SimpleTableScan", "predicates": [{"type": "EQ", "in": 0, "f": 0, "value": 1, "vtype": 0}]},
+        "project": {"type": "ProjectionScan", "fields": [0, 1]}
+      },
+      "edges": [["load", "scan"], ["scan", "project"]]
+    })";
+  const size_t threshold = RequestParseTask::getInlineThreshold();
+
+  RequestParseTask::setInlineThreshold(0);
+  const auto scheduled = executeAndWait(query);
+  RequestParseTask::setInlineThreshold(threshold);
+  const auto inlined = executeAndWait(query);
+
+  ASSERT_TABLE_EQUAL(scheduled, inlined);
+}
+
+}
+}
@@ -167,6 +167,56 @@ TEST_F(JSONTests, remove_operator_nodes) {
   ASSERT_TRUE(isEdgeEqual(query["edges"], 1, someNode, someNode));
 }
 
+TEST_F(JSONTests, fuse_pipeline) {
+  Json::Value query(Json::objectValue);
+  query["pipelined"] = true;
+  query["operators"]["load"]["type"] = "TableLoad";
+  query["operators"]["scan"]["type"] = "SimpleTableScan";
+  query["operators"]["project"]["type"] = "ProjectionScan";
+  query["operators"]["hash"]["type"] = "HashBuild";
+  query["operators"]["group"]["type"] = "GroupByScan";
+  query["operators"]["group"]["fields"].append(0);
+  query["edges"] = EdgesBuilder().
+      appendEdge("load", "scan").
+      appendEdge("scan", "project").
+      appendEdge("project", "hash").
+      appendEdge("project", "group").
+      appendEdge("hash", "group").
+      getEdges();
+
+  QueryTransformationEngine::getInstance()->transform(query);
+  ASSERT_EQ(3u, query["operators"].size());
+  ASSERT_EQ("Pipeline", query["operators"]["hash"]["type"].asString());
+  ASSERT_TRUE(query["operators"]["hash"]["table"].asBool());
+  const Json::Value &stages = query["operators"]["hash"]["stages"];
+  ASSERT_EQ(3u, stages.size());
+  ASSERT_EQ("SimpleTableScan", stages[0u]["type"].asString());
+  ASSERT_EQ("ProjectionScan", stages[1u]["type"].asString());
+  ASSERT_EQ("HashBuild", stages[2u]["type"].asString());
+  ASSERT_EQ(2u, query["edges"].size());
+  ASSERT_TRUE(isEdgeEqual(query["edges"], 0, "hash", "group"));
+  ASSERT_TRUE(isEdgeEqual(query["edges"], 1, "load", "hash"));
+}
+
+TEST_F(JSONTests, fuse_pipeline_keeps_shared_results) {
+  Json::Value query(Json::objectValue);
+  query["pipelined"] = true;
+  query["operators"]["load"]["type"] = "TableLoad";
+  query["operators"]["scan"]["type"] = "SimpleTableScan";
+  query["operators"]["hash"]["type"] = "HashBuild";
+  query["operators"]["probe"]["type"] = "HashJoinProbe";
+  query["edges"] = EdgesBuilder().
+      appendEdge("load", "scan").
+      appendEdge("scan", "hash").
+      appendEdge("scan", "probe").
+      appendEdge("hash", "probe").
+      getEdges();
+
+  QueryTransformationEngine::getInstance()->transform(query);
+  ASSERT_EQ("HashBuild", query["operators"]["hash"]["type"].asString());
+  ASSERT_EQ(4u, query["edges"].size());
+}
+
 TEST_F(JSONTests, simple_parse) {
   Json::Value root;   // will contains the root value after parsing.
   Json::Reader reader;
@@ -1,12 +1,38 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "testing/test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include <json.h>
 #include <io/shortcuts.h>
 #include <access.h>
+#include "access/QueryStatisticsTable.h"
+#include "access/system/OperatorProfile.h"
+#include "access/system/QueryStatistics.h"
+#include "helper.h"
 
 namespace hyrise {
 namespace access {
 
-class PerformanceDataTests : public AccessTest {};
+namespace {
+// All plans probe the same slots of the statistics
+std::string collidingPlanHash(size_t plan) {
+  const uint64_t key = 1 + plan * QueryStatistics::CAPACITY;
+  std::string hash(20, '\0');
+  memcpy(&hash[0], &key, sizeof(key));
+  return hash;
+}
+}
+
+class PerformanceDataTests : public AccessTest {
+ public:
+  void TearDown() {
+    OperatorProfile::getInstance().setWindow(OperatorProfile::DEFAULT_WINDOW);
+  }
+};
 
 TEST_F(PerformanceDataTests, single_op_data) {
   storage::atable_ptr_t w = io::Loader::shortcuts::loadWithHeader("test/regression/projection_fail.data", "test/regression/projection_fail.tbl");
@@ -26,6 +52,206 @@ TEST_F(PerformanceDataTests, single_op_data) {
   ASSERT_GT(perf.endTime, 0u) << "end time should be set";
 }
 
+TEST_F(PerformanceDataTests, operations_are_profiled_per_type) {
+  storage::atable_ptr_t w = io::Loader::shortcuts::loadWithHeader("test/regression/projection_fail.data", "test/regression/projection_fail.tbl");
+  OperatorProfile::getInstance().clear();
+
+  for (size_t i = 0; i < 3; ++i) {
+    ProjectionScan ps;
+    ps.addInput(w);
+    ps.addField(w->numberOfColumn("w_tax"));
+    performance_attributes_t perf;
+    ps.setPerformanceData(&perf);
+    ps.execute();
+
+    // each counter is measured or missing on its own, e.g. on machines
+    // without a last level cache miss event
+    for (const auto counter : {perf.counters.cycles, perf.counters.instructions,
+                               perf.counters.llcMisses, perf.counters.branchMisses})
+      ASSERT_TRUE(counter == -1 || counter >= 0) << counter;
+  }
+
+  // without performance data only while all operations are profiled
+  ProjectionScan ps;
+  ps.addInput(w);
+  ps.addField(0);
+  ps.execute();
+
+  const auto summary = OperatorProfile::getInstance().summary();
+  ASSERT_EQ(3u, summary["ProjectionScan"]["executions"].asUInt());
+  ASSERT_GT(summary["ProjectionScan"]["wallTimeNs"].asDouble(), 0);
+  ASSERT_EQ(PerfEventTracer::isAvailable(), summary["ProjectionScan"].isMember("cycles"));
+}
+
+TEST_F(PerformanceDataTests, threads_of_single_tasks_do_not_count) {
+  std::thread thread([] () {
+      PerfEventTracer::disableForThread();
+      PerfEventTracer counters;
+      counters.start();
+      counters.stop();
+      ASSERT_FALSE(PerfEventTracer::isAvailable());
+      ASSERT_EQ(-1, counters.values().cycles);
+      ASSERT_EQ(-1, counters.values().instructions);
+    });
+  thread.join();
 }
+
+TEST_F(PerformanceDataTests, profile_averages_over_window) {
+  auto& profile = OperatorProfile::getInstance();
+  profile.setWindow(2);
+  const perf_counters_t none = {-1, -1, -1, -1};
+  const perf_counters_t counters = {100, 200, 3, 4};
+
+  profile.record("Op", 1000, none);
+  profile.record("Op", 2000, counters);
+  profile.record("Op", 4000, counters);
+
+  const auto summary = profile.summary()["Op"];
+  ASSERT_EQ(3u, summary["executions"].asUInt());
+  ASSERT_DOUBLE_EQ(3000, summary["wallTimeNs"].asDouble());
+  ASSERT_DOUBLE_EQ(100, summary["cycles"].asDouble());
+  ASSERT_DOUBLE_EQ(3, summary["llcMisses"].asDouble());
 }
 
+TEST_F(PerformanceDataTests, queries_are_aggregated_per_plan) {
+  auto& statistics = QueryStatistics::getInstance();
+  statistics.clear();
+  const std::string query = "{\"operators\": {\"0\": {\"type\": \"TableLoad\", \"table\": \"statistics_lin\", "
+                            "\"filename\": \"lin_xxs.tbl\"}}, \"edges\": [[\"0\", \"0\"]]}";
+  for (size_t i = 0; i < 3; ++i)
+    executeAndWait(query, 1);
+
+  Json::Value plan_data;
+  Json::Reader().parse(query, plan_data);
+  const auto normalized = QueryStatistics::normalize(plan_data);
+  const auto summary = statistics.summary();
+  const auto plan = std::find_if(summary.begin(), summary.end(), [&normalized] (const query_summary_t& s) {
+    return s.query == normalized;
+  });
+  ASSERT_NE(summary.end(), plan);
+  ASSERT_EQ(3u, plan->calls);
+  ASSERT_EQ(0u, plan->errors);
+  ASSERT_EQ(300u, plan->rows);
+  ASSERT_GT(plan->latencyNs, 0u);
+  ASSERT_GE(plan->p99LatencyNs, plan->latencyNs / plan->calls);
+  ASSERT_EQ(1u, plan->operators.size());
+  ASSERT_EQ("0:TableLoad", plan->operators[0].name);
+  ASSERT_EQ(3u, plan->operators[0].executions);
+
+  QueryStatisticsTable table(false, true);
+  table.execute();
+  const auto result = table.getResultTable();
+  size_t row = 0;
+  while (row < result->size() && result->getValue<hyrise_string_t>(result->numberOfColumn("query"), row) != normalized)
+    ++row;
+  ASSERT_LT(row, result->size());
+  ASSERT_EQ(3, result->getValue<hyrise_int_t>(result->numberOfColumn("calls"), row));
+  ASSERT_EQ(300, result->getValue<hyrise_int_t>(result->numberOfColumn("rows"), row));
+
+  // the statistics were reset after they were read
+  ASSERT_TRUE(statistics.summary().empty());
+}
+
+TEST_F(PerformanceDataTests, p99_latency_bounds_the_recorded_latency) {
+  auto& statistics = QueryStatistics::getInstance();
+  for (const uint64_t latency : {0ul, 999ul, 1000ul, 2999ul, 3000ul, 123456ul, 5000000ul}) {
+    statistics.clear();
+    auto entry = statistics.entry(std::string(20, 'p'), "plan");
+    QueryStatistics::record(entry, latency, 0, 0, false);
+    const auto summary = statistics.summary();
+    ASSERT_EQ(1u, summary.size());
+    ASSERT_LE(latency, summary[0].p99LatencyNs);
+    ASSERT_GE(latency + latency / 4 + 1000, summary[0].p99LatencyNs);
+  }
+  statistics.clear();
+}
+
+TEST_F(PerformanceDataTests, queries_differing_in_literals_share_a_plan) {
+  Json::Value first, second, other;
+  Json::Reader reader;
+  reader.parse("{\"operators\": {\"0\": {\"type\": \"SimpleTableScan\", \"predicates\": "
+               "[{\"type\": \"EQ\", \"in\": 0, \"f\": \"a\", \"value\": 1}]}}, \"priority\": 1}", first);
+  reader.parse("{\"operators\": {\"0\": {\"type\": \"SimpleTableScan\", \"predicates\": "
+               "[{\"type\": \"EQ\", \"in\": 0, \"f\": \"a\", \"value\": 42}]}}, \"priority\": 2}", second);
+  reader.parse("{\"operators\": {\"0\": {\"type\": \"SimpleTableScan\", \"predicates\": "
+               "[{\"type\": \"EQ\", \"in\": 0, \"f\": \"b\", \"value\": 1}]}}}", other);
+
+  ASSERT_EQ(QueryStatistics::normalize(first), QueryStatistics::normalize(second));
+  ASSERT_NE(QueryStatistics::normalize(first), QueryStatistics::normalize(other));
+  ASSERT_EQ(std::string::npos, QueryStatistics::normalize(second).find("42"));
+}
+
+TEST_F(PerformanceDataTests, least_called_plans_are_evicted_and_cleared) {
+  auto& statistics = QueryStatistics::getInstance();
+  statistics.clear();
+
+  // The table fills after MAX_PROBES plans
+  auto planHash = collidingPlanHash;
+  for (size_t plan = 0; plan < QueryStatistics::MAX_PROBES; ++plan) {
+    auto entry = statistics.entry(planHash(plan), "plan " + std::to_string(plan));
+    ASSERT_NE(nullptr, entry);
+    for (size_t call = 0; call <= plan; ++call)
+      QueryStatistics::record(entry, 1000, 1, 0, false);
+  }
+  ASSERT_EQ(0u, statistics.dropped());
+
+  auto entry = statistics.entry(planHash(QueryStatistics::MAX_PROBES), "plan 16");
+  ASSERT_NE(nullptr, entry);
+  QueryStatistics::record(entry, 1000, 1, 0, false);
+  ASSERT_EQ(1u, statistics.dropped());
+
+  // plan 0 was called least and made room for plan 16
+  auto summary = statistics.summary();
+  ASSERT_EQ(QueryStatistics::MAX_PROBES, summary.size());
+  ASSERT_TRUE(std::none_of(summary.begin(), summary.end(), [] (const query_summary_t& s) {
+    return s.query == "plan 0";
+  }));
+  const auto added = std::find_if(summary.begin(), summary.end(), [] (const query_summary_t& s) {
+    return s.query == "plan 16";
+  });
+  ASSERT_NE(summary.end(), added);
+  ASSERT_EQ(1u, added->calls);
+
+  // Cleared entries are free for new plans
+  statistics.clear();
+  ASSERT_TRUE(statistics.summary().empty());
+  for (size_t plan = 0; plan < QueryStatistics::MAX_PROBES; ++plan)
+    ASSERT_NE(nullptr, statistics.entry(planHash(100 + plan), "new plan"));
+  ASSERT_EQ(0u, statistics.dropped());
+}
+
+TEST_F(PerformanceDataTests, summaries_skip_entries_being_evicted) {
+  auto& statistics = QueryStatistics::getInstance();
+  statistics.clear();
+  // Every plan is named by its hash, so a summary must never mix the
+  // query of one plan with the hash of another
+  auto hex = [] (const std::string& hash) -> std::string {
+    static const char digits[] = "0123456789abcdef";
+    std::string result;
+    for (const auto c : hash) {
+      result += digits[static_cast<unsigned char>(c) >> 4];
+      result += digits[static_cast<unsigned char>(c) & 15];
+    }
+    return result;
+  };
+
+  std::atomic<bool> done(false);
+  std::thread writer([&] () {
+      for (size_t plan = 0; !done; ++plan) {
+        const auto hash = collidingPlanHash(plan % (4 * QueryStatistics::MAX_PROBES));
+        QueryStatistics::record(statistics.entry(hash, hex(hash)), 1000, 1, 0, false);
+      }
+    });
+  size_t mismatches = 0;
+  for (size_t i = 0; i < 200; ++i) {
+    for (const auto& summary : statistics.summary())
+      mismatches += summary.planHash != summary.query;
+  }
+  done = true;
+  writer.join();
+  ASSERT_EQ(0u, mismatches);
+  statistics.clear();
+}
+
+}
+}
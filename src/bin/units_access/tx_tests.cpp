@@ -5,10 +5,14 @@
 #include "helper.h"
 
 #include <access.h>
+#include <access/CreateIndex.h>
+#include <access/IndexScan.h>
 #include <algorithm>
 
 #include <io/shortcuts.h>
+#include <io/StorageManager.h>
 #include <storage/Store.h>
+#include <storage/InvertedIndex.h>
 #include <storage/PointerCalculator.h>
 #include <storage/TableBuilder.h>
 #include <helper/types.h>
@@ -349,7 +353,7 @@ TEST_F(TransactionTests, delete_op_with_commit_and_concurrent_read) {
   del.execute();
 
 
-  // Acquire the TX Lock
+  // Draw a commit id
   auto& txmgr = hyrise::tx::TransactionManager::getInstance();
   writeCtx.cid = txmgr.prepareCommit();
 
@@ -377,7 +381,7 @@ TEST_F(TransactionTests, delete_op_with_commit_and_concurrent_read) {
 
   auto res = vp.getResultTable();
 
-  txmgr.commit(writeCtx.tid);
+  txmgr.commit(writeCtx.tid, writeCtx.cid);
 
   ASSERT_EQ(before , res->size());
 }
@@ -550,4 +554,78 @@ TEST_F(TransactionTests, delete_rollback) {
   ASSERT_EQ(tx::START_TID, linxxxs->tid(0));
 }
 
+TEST_F(TransactionTests, index_follows_inserts_and_merge) {
+  CreateIndex ci;
+  ci.addInput(linxxxs);
+  ci.addField(0);
+  ci.setIndexName("linxxxs_col_0");
+  ci.execute();
+
+  auto lookup = [this] (const tx::TXContext& ctx) {
+    IndexScan is;
+    is.setTXContext(ctx);
+    is.addInput(linxxxs);
+    is.addField(0);
+    is.setIndexName("linxxxs_col_0");
+    is.setValue<hyrise_int_t>(99);
+    is.execute();
+    return is.getResultTable();
+  };
+
+  auto writeCtx = tx::TransactionManager::getInstance().buildContext();
+  auto readCtx = tx::TransactionManager::getInstance().buildContext();
+
+  InsertScan is;
+  is.setTXContext(writeCtx);
+  is.addInput(linxxxs);
+  is.setInputData(one_row);
+  is.execute();
+
+  ASSERT_EQ(1u, lookup(writeCtx)->size());
+  ASSERT_EQ(0u, lookup(readCtx)->size());
+  ASSERT_EQ(0u, lookup(tx::TXContext())->size());
+
+  Commit c;
+  c.addInput(linxxxs);
+  c.setTXContext(writeCtx);
+  c.execute();
+
+  ASSERT_EQ(0u, lookup(readCtx)->size());
+  ASSERT_EQ(1u, lookup(tx::TransactionManager::getInstance().buildContext())->size());
+
+  linxxxs->merge();
+  ASSERT_EQ(0u, linxxxs->getDeltaTable()->size());
+
+  auto merged = lookup(tx::TXContext());
+  ASSERT_EQ(1u, merged->size());
+  ASSERT_EQ(99, merged->getValue<hyrise_int_t>(0, 0));
+  ASSERT_EQ(999, merged->getValue<hyrise_int_t>(1, 0));
+}
+
+TEST_F(TransactionTests, index_created_during_inserts_covers_them) {
+  auto writeCtx = tx::TransactionManager::getInstance().buildContext();
+  const size_t main_size = linxxxs->getMainTable()->size();
+
+  // One row is written but not added to indexes yet, the other one is
+  // only appended
+  const auto written = linxxxs->appendToDelta(2).first;
+  linxxxs->copyRowToDelta(one_row, 0, written, writeCtx.tid);
+  tx::TransactionManager::getInstance()[writeCtx.tid].insertPositions(linxxxs, main_size + written, 2);
+
+  CreateIndex ci;
+  ci.addInput(linxxxs);
+  ci.addField(0);
+  ci.setIndexName("linxxxs_col_0");
+  ci.execute();
+
+  linxxxs->copyRowToDelta(one_row, 0, written + 1, writeCtx.tid);
+  linxxxs->addToIndexes(main_size + written, 2);
+
+  auto index = std::dynamic_pointer_cast<storage::InvertedIndex<hyrise_int_t>>(
+      io::StorageManager::getInstance()->getInvertedIndex("linxxxs_col_0"));
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(pos_list_t({main_size + written, main_size + written + 1}), index->getPositionsForKey(99));
+  tx::TransactionManager::rollbackTransaction(writeCtx);
+}
+
 }}
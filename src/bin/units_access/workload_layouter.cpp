@@ -0,0 +1,72 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/system/WorkloadLayouter.h"
+
+#include <thread>
+
+#include "io/shortcuts.h"
+#include "storage/PointerCalculator.h"
+#include "storage/Store.h"
+#include "testing/test.h"
+
+namespace hyrise {
+namespace access {
+
+class WorkloadLayouterTest : public AccessTest {
+ public:
+  void TearDown() {
+    WorkloadLayouter::getInstance().clear();
+  }
+};
+
+TEST_F(WorkloadLayouterTest, tuple_accesses_merge_columns) {
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/10_30_group.tbl"));
+  const auto reference = io::Loader::shortcuts::load("test/10_30_group.tbl");
+  ASSERT_EQ(5u, store->partitionCount());
+
+  // Point lookups of whole rows favor a single container
+  const field_list_t fields = {0, 1, 2, 3, 4};
+  const auto row = std::make_shared<storage::PointerCalculator>(store, pos_list_t({3}));
+  auto& layouter = WorkloadLayouter::getInstance();
+  for (size_t i = 0; i < 100; ++i)
+    layouter.record(row, fields);
+
+  ASSERT_EQ(1u, layouter.relayout());
+  ASSERT_TRUE(store->hasNextMain());
+  // Nothing recorded since the last round
+  ASSERT_EQ(0u, layouter.relayout());
+
+  store->merge();
+  ASSERT_FALSE(store->hasNextMain());
+  ASSERT_LT(store->partitionCount(), 5u);
+  ASSERT_TABLE_EQUAL(reference, store);
+}
+
+TEST_F(WorkloadLayouterTest, accesses_of_all_threads_are_collected) {
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/10_30_group.tbl"));
+  const field_list_t fields = {0, 1, 2, 3, 4};
+  const auto row = std::make_shared<storage::PointerCalculator>(store, pos_list_t({3}));
+  auto& layouter = WorkloadLayouter::getInstance();
+
+  // Threads that ended hand their accesses to the next round
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&layouter, &row, &fields] () {
+        for (size_t i = 0; i < 25; ++i)
+          layouter.record(row, fields);
+      });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  ASSERT_EQ(1u, layouter.relayout());
+  ASSERT_TRUE(store->hasNextMain());
+}
+
+TEST_F(WorkloadLayouterTest, next_main_keeps_columns) {
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/10_30_group.tbl"));
+  ASSERT_THROW(store->setNextMain(io::Loader::shortcuts::load("test/lin_xxxs.tbl")), std::runtime_error);
+  ASSERT_FALSE(store->hasNextMain());
+}
+
+}
+}
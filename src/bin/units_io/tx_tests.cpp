@@ -1,8 +1,12 @@
 #include "testing/test.h"
 
 #include <limits>
+#include <thread>
 
+#include "io/GarbageCollector.h"
+#include "io/shortcuts.h"
 #include "io/TransactionManager.h"
+#include "storage/Store.h"
 
 namespace hyrise {
 namespace tx {
@@ -32,7 +36,7 @@ TEST(TX, commit_invalid) {
 TEST(TX, modifying_transactions) {
   EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
   auto t1 = TM::beginTransaction();
-  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 1u) << "Transactions are registered when they begin";
   TM::commitTransaction(t1);
   EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
 }
@@ -45,4 +49,144 @@ TEST(TX, rollback_transaction) {
   EXPECT_EQ(before, after) << "No commits are made when doing a rollback";
 }
 
+TEST(TX, modifying_transactions_across_shards) {
+  std::vector<TXContext> contexts;
+  for (size_t i = 0; i < 200; ++i) {
+    contexts.push_back(TM::beginTransaction());
+    TM::getTransactionData(contexts.back().tid);
+  }
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), contexts.size());
+  EXPECT_EQ(TM::getContext(contexts[42].tid).tid, contexts[42].tid);
+  for (const auto& ctx : contexts) {
+    TM::rollbackTransaction(ctx);
+  }
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
+}
+
+TEST(TX, batched_modifications) {
+  auto t1 = TM::beginTransaction();
+  auto& mods = TM::getInstance()[t1.tid];
+  auto table = std::make_shared<storage::Store>();
+  mods.insertPos(table, 1);
+  mods.insertPositions(table, 10, 3);
+  mods.deletePositions(table, {4, 2});
+  EXPECT_EQ(mods.getInserted(table), (storage::pos_list_t {1, 10, 11, 12}));
+  EXPECT_EQ(mods.getDeleted(table), (storage::pos_list_t {4, 2}));
+  TM::getInstance().endTransaction(t1.tid);
+}
+
+TEST(TX, modification_batch_is_recorded_on_failure) {
+  auto t1 = TM::beginTransaction();
+  auto& mods = TM::getInstance()[t1.tid];
+  auto table = std::make_shared<storage::Store>();
+  try {
+    TXModificationBatch batch(mods, table);
+    batch.deleted(4);
+    batch.inserted(10);
+    batch.inserted(11);
+    throw std::runtime_error("operation failed");
+  } catch (const std::runtime_error&) {}
+  EXPECT_EQ(mods.getInserted(table), (storage::pos_list_t {10, 11}));
+  EXPECT_EQ(mods.getDeleted(table), (storage::pos_list_t {4}));
+  TM::getInstance().endTransaction(t1.tid);
+}
+
+TEST(TX, failing_commit_completes_its_commit_id) {
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/lin_xxs.tbl"));
+  auto t1 = TM::beginTransaction();
+  const auto row = store->appendToDelta(1).first;
+  store->copyRowToDelta(store, 0, row, t1.tid);
+  TM::getInstance()[t1.tid].insertPos(store, store->deltaOffset() + row);
+  {
+    // Writing the commit to a replaced store throws
+    storage::Store::WriteExclusion exclusion(*store);
+    exclusion.retire();
+  }
+  EXPECT_THROW(TM::commitTransaction(t1), std::runtime_error);
+  TM::rollbackTransaction(t1);
+
+  // Later commits are still published
+  const auto cid = TM::commitTransaction(TM::beginTransaction());
+  EXPECT_EQ(cid, TM::getInstance().getLastCommitId());
+}
+
+TEST(TX, oldest_active_snapshot) {
+  auto t1 = TM::beginTransaction();
+  TM::touchTransaction(t1);
+  EXPECT_EQ(TM::getOldestActiveSnapshot(), t1.lastCid);
+
+  // later commits do not advance the snapshot while t1 is active
+  auto t2 = TM::beginTransaction();
+  TM::commitTransaction(t2);
+  EXPECT_GT(TM::getInstance().getLastCommitId(), t1.lastCid);
+  EXPECT_EQ(TM::getOldestActiveSnapshot(), t1.lastCid);
+
+  TM::rollbackTransaction(t1);
+  EXPECT_EQ(TM::getOldestActiveSnapshot(), TM::getInstance().getLastCommitId());
+}
+
+TEST(TX, reclaim_abandoned_transactions) {
+  auto t1 = TM::beginTransaction();
+  TM::touchTransaction(t1);
+  EXPECT_EQ(TM::reclaimAbandonedTransactions(0), 0u) << "Recently accessed transactions are kept";
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 1u);
+  EXPECT_EQ(TM::reclaimAbandonedTransactions(get_epoch_nanoseconds() + 1), 1u);
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
+}
+
+TEST(TX, read_only_transactions_are_released) {
+  auto t1 = TM::beginTransaction();
+  auto t2 = TM::beginTransaction();
+  TM::getInstance()[t2.tid].insertPos(std::make_shared<storage::Store>(), 0);
+  TM::releaseReadOnlyTransaction(t1.tid);
+  TM::releaseReadOnlyTransaction(t2.tid);
+  auto registered = TM::getCurrentModifyingTransactionContexts();
+  ASSERT_EQ(1u, registered.size());
+  EXPECT_EQ(t2.tid, registered[0].tid);
+  TM::getInstance().endTransaction(t2.tid);
+}
+
+TEST(TX, snapshot_older_than_collected_is_rejected) {
+  auto t1 = TM::beginTransaction();
+  TM::releaseReadOnlyTransaction(t1.tid);
+  TM::commitTransaction(TM::beginTransaction());
+  TM::getOldestActiveSnapshot();
+  EXPECT_THROW(TM::touchTransaction(t1), std::runtime_error);
+  EXPECT_EQ(TM::getCurrentModifyingTransactionContexts().size(), 0u);
+
+  // registered snapshots are kept
+  auto t2 = TM::beginTransaction();
+  TM::commitTransaction(TM::beginTransaction());
+  TM::getOldestActiveSnapshot();
+  TM::touchTransaction(t2);
+  TM::rollbackTransaction(t2);
+}
+
+TEST(TX, committing_transactions_are_not_reclaimed) {
+  auto t1 = TM::beginTransaction();
+  TM::getTransactionData(t1.tid)._committing = true;
+  EXPECT_EQ(TM::reclaimAbandonedTransactions(get_epoch_nanoseconds() + 1), 0u);
+  TM::getInstance().endTransaction(t1.tid);
+
+  // The collector rolls back an abandoned transaction that inserted a row
+  auto store = std::make_shared<storage::Store>(io::Loader::shortcuts::load("test/lin_xxs.tbl"));
+  auto t2 = TM::beginTransaction();
+  const auto row = store->appendToDelta(1).first;
+  store->copyRowToDelta(store, 0, row, t2.tid);
+  TM::getInstance()[t2.tid].insertPos(store, store->deltaOffset() + row);
+
+  auto& gc = io::GarbageCollector::getInstance();
+  gc.setSessionTimeout(std::chrono::milliseconds(0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_GE(gc.collect().transactions, 1u);
+  gc.setSessionTimeout(std::chrono::minutes(10));
+
+  // Its client returns too late, neither continuing nor committing succeeds
+  EXPECT_THROW(TM::touchTransaction(t2), std::runtime_error);
+  EXPECT_THROW(TM::commitTransaction(t2), std::runtime_error);
+  auto& txmgr = TM::getInstance();
+  const auto valid = store->buildValidPositions(txmgr.getLastCommitId(), txmgr.buildContext().tid);
+  EXPECT_EQ(store->deltaOffset(), valid.size());
+}
+
 } } // namespace hyrise::tx
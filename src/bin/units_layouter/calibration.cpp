@@ -0,0 +1,86 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "layouter/base.h"
+#include "layouter/calibration.h"
+
+#include "gtest/gtest.h"
+
+namespace hyrise {
+namespace layouter {
+
+class CalibrationTests : public ::testing::Test {
+
+ public:
+
+  virtual void TearDown() {
+    CostCalibration::setCurrent(CostCalibration());
+  }
+
+  CostCalibration twoLevels() {
+    CostCalibration c;
+    c.addLevel(1 << 20, 4.0, 100.0);
+    c.addLevel(1 << 10, 1.0, 10.0);
+    return c;
+  }
+
+};
+
+TEST_F(CalibrationTests, line_cost_interpolates_between_levels) {
+  CostCalibration c = twoLevels();
+  ASSERT_EQ(1u << 10, c.levels().front().bytes);
+
+  ASSERT_DOUBLE_EQ(1.0, c.lineCost(CostCalibration::access_sequential, 512));
+  ASSERT_DOUBLE_EQ(4.0, c.lineCost(CostCalibration::access_sequential, 1 << 22));
+  ASSERT_DOUBLE_EQ(2.5, c.lineCost(CostCalibration::access_sequential, 1 << 15));
+  ASSERT_DOUBLE_EQ(55.0, c.lineCost(CostCalibration::access_random, 1 << 15));
+
+  // Half of the DRAM accesses are remote
+  c.setRemote(8.0, 200.0, 0.5);
+  ASSERT_DOUBLE_EQ(6.0, c.lineCost(CostCalibration::access_sequential, 1 << 22));
+  ASSERT_DOUBLE_EQ(150.0, c.lineCost(CostCalibration::access_random, 1 << 22));
+  ASSERT_DOUBLE_EQ(10.0, c.lineCost(CostCalibration::access_random, 1 << 10));
+
+  ASSERT_DOUBLE_EQ(1.0, CostCalibration().lineCost(CostCalibration::access_random, 1 << 22));
+}
+
+TEST_F(CalibrationTests, calibrated_cost_weighs_misses) {
+  std::vector<std::string> names = {"ID", "NAME", "MAIL", "COMPANY"};
+  Schema s(std::vector<unsigned>(4, 4), 1000000, names);
+
+  Query q(LayouterConfiguration::access_type_outoforder, {1, 2}, 0.02, 1);
+  s.add(&q);
+  std::vector<unsigned> part = {1, 2, 3};
+
+  // Without calibration every cache line costs the same
+  const double misses = q.containerCost(part, s, HYRISE_COST);
+  ASSERT_DOUBLE_EQ(misses, q.containerCost(part, s, CALIBRATED_COST));
+
+  CostCalibration c;
+  c.addLevel(1 << 30, 2.0, 10.0);
+  CostCalibration::setCurrent(c);
+  ASSERT_DOUBLE_EQ(misses * (10.0 + 0.02 * (2.0 - 10.0)), q.containerCost(part, s, CALIBRATED_COST));
+
+  Query scan(LayouterConfiguration::access_type_fullprojection, {1}, -1, 1);
+  ASSERT_DOUBLE_EQ(scan.containerCost(part, s, HYRISE_COST) * 2.0, scan.containerCost(part, s, CALIBRATED_COST));
+}
+
+TEST_F(CalibrationTests, save_and_load) {
+  CostCalibration c = twoLevels();
+  c.setRemote(8.0, 200.0, 0.5);
+
+  const std::string path = "calibration_test.txt";
+  c.save(path);
+  CostCalibration loaded = CostCalibration::load(path);
+  std::remove(path.c_str());
+
+  ASSERT_EQ(2u, loaded.levels().size());
+  ASSERT_EQ(1u << 20, loaded.levels().back().bytes);
+  ASSERT_DOUBLE_EQ(150.0, loaded.lineCost(CostCalibration::access_random, 1 << 22));
+  ASSERT_THROW(CostCalibration::load("does_not_exist.txt"), std::runtime_error);
+}
+
+} } // namespace hyrise::layouter
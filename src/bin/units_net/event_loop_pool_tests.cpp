@@ -0,0 +1,56 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+
+#include "net/EventLoopPool.h"
+
+namespace hyrise {
+namespace net {
+
+class EventLoopPoolTests : public ::testing::Test {
+ public:
+  bool connectTo(size_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const bool connected = connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0;
+    close(fd);
+    return connected;
+  }
+};
+
+TEST_F(EventLoopPoolTests, loops_share_port_and_stop) {
+  EventLoopPool pool(4, false);
+  ASSERT_EQ(4u, pool.size());
+
+  size_t port = 29000;
+  while (!pool.listen(port))
+    ++port;
+
+  // Other servers must not be able to use the port of the pool
+  EventLoopPool other(1, false);
+  ASSERT_FALSE(other.listen(port));
+  EventLoopPool others(2, false);
+  ASSERT_FALSE(others.listen(port));
+
+  std::thread runner([&pool] () { pool.run(); });
+  for (size_t i = 0; i < 8; ++i)
+    ASSERT_TRUE(connectTo(port));
+
+  pool.shutdown();
+  runner.join();
+  ASSERT_EQ(nullptr, EventLoopPool::running());
+}
+
+}
+}
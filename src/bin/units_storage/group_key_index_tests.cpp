@@ -0,0 +1,78 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "testing/test.h"
+
+#include <atomic>
+#include <thread>
+
+#include <io/shortcuts.h>
+#include <storage/GroupKeyIndex.h>
+#include <storage/InvertedIndex.h>
+#include <storage/Store.h>
+
+namespace hyrise { namespace storage {
+
+class GroupKeyIndexTests : public ::hyrise::Test {};
+
+TEST_F(GroupKeyIndexTests, lookups_match_inverted_index) {
+  auto t = io::Loader::shortcuts::load("test/index_test.tbl");
+  InvertedIndex<hyrise_int_t> inverted(t, 0);
+  GroupKeyIndex<hyrise_int_t> plain(t, 0);
+  GroupKeyIndex<hyrise_int_t> packed(t, 0, true);
+
+  for (hyrise_int_t key = -1; key <= 1001; ++key) {
+    ASSERT_EQ(inverted.getPositionsForKey(key), plain.getPositionsForKey(key));
+    ASSERT_EQ(inverted.getPositionsForKey(key), packed.getPositionsForKey(key));
+  }
+  ASSERT_LT(packed.memoryUsage(), plain.memoryUsage());
+}
+
+TEST_F(GroupKeyIndexTests, follows_store_delta_and_merge) {
+  auto store = std::make_shared<Store>(io::Loader::shortcuts::load("test/students.tbl"));
+  const auto city = store->numberOfColumn("city");
+  auto index = std::make_shared<GroupKeyIndex<hyrise_string_t>>(store, city);
+  store->addIndex(index);
+  const size_t berlin = index->getPositionsForKey("Berlin").size();
+  ASSERT_LT(0u, berlin);
+
+  auto area = store->appendToDelta(2);
+  const pos_t first = store->deltaOffset() + area.first;
+  store->copyRowToDelta(store, index->getPositionsForKey("Berlin").front(), area.first, tx::START_TID);
+  store->copyRowToDelta(store, 0, area.first + 1, tx::START_TID);
+  store->setValue<hyrise_string_t>(city, first + 1, "Bern");
+  store->addToIndexes(first, 2);
+
+  ASSERT_EQ(berlin + 1, index->getPositionsForKey("Berlin").size());
+  ASSERT_EQ(first, index->getPositionsForKey("Berlin").back());
+  ASSERT_EQ(pos_list_t({first + 1}), index->getPositionsForKey("Bern"));
+
+  // Rebuilding keeps the delta rows that are not part of the main dictionary
+  std::vector<bool> kept(store->size(), true);
+  index->moveRows(*store, kept);
+  ASSERT_EQ(berlin + 1, index->getPositionsForKey("Berlin").size());
+  store->removeIndex(index);
+}
+
+TEST_F(GroupKeyIndexTests, lookups_during_rebuild_see_all_rows) {
+  auto store = std::make_shared<Store>(io::Loader::shortcuts::load("test/index_test.tbl"));
+  GroupKeyIndex<hyrise_int_t> index(store, 0, true);
+  const auto key = store->getValue<hyrise_int_t>(0, 0);
+  const auto expected = index.getPositionsForKey(key);
+  ASSERT_LT(0u, expected.size());
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> mismatches(0);
+  std::thread reader([&] () {
+      while (!done) {
+        if (index.getPositionsForKey(key) != expected)
+          ++mismatches;
+      }
+    });
+  const std::vector<bool> kept(store->size(), true);
+  for (size_t i = 0; i < 20; ++i)
+    index.moveRows(*store, kept);
+  done = true;
+  reader.join();
+  ASSERT_EQ(0u, mismatches.load());
+}
+
+}}
@@ -0,0 +1,124 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "testing/test.h"
+
+#include <atomic>
+#include <thread>
+
+#include <io/shortcuts.h>
+#include <storage/OrderedIndex.h>
+#include <storage/Store.h>
+
+namespace hyrise { namespace storage {
+
+class OrderedIndexTests : public ::hyrise::Test {
+ public:
+  void SetUp() {
+    // Main with an ordered dictionary and a delta with many keys so that
+    // the tree gets inner levels
+    store = std::make_shared<Store>(io::Loader::shortcuts::load("test/index_test.tbl"));
+    const size_t delta_rows = 5000;
+    store->resizeDelta(delta_rows);
+    for (size_t row = 0; row < delta_rows; ++row) {
+      store->copyRowToDelta(store, 0, row, tx::START_TID);
+      store->setValue<hyrise_int_t>(0, store->deltaOffset() + row, (row * 7919) % 3000);
+    }
+  }
+
+  pos_list_t scan(const c_atable_ptr_t& table, hyrise_int_t from, hyrise_int_t to) {
+    pos_list_t result;
+    for (size_t row = 0; row < table->size(); ++row) {
+      const auto value = table->getValue<hyrise_int_t>(0, row);
+      if (from <= value && value <= to)
+        result.push_back(row);
+    }
+    return result;
+  }
+
+  store_ptr_t store;
+};
+
+TEST_F(OrderedIndexTests, range_lookups_match_scan) {
+  OrderedIndex<hyrise_int_t> index(store, 0);
+
+  ASSERT_EQ(scan(store, 200, 200), index.getPositionsForKey(200));
+  ASSERT_EQ(scan(store, 0, 2999), index.getPositionsForRange(0, 2999));
+  ASSERT_EQ(scan(store, 150, 1499), index.getPositionsForRange(150, 1499));
+  ASSERT_EQ(scan(store, 2998, 5000), index.getPositionsForRange(2998, 5000));
+  ASSERT_TRUE(index.getPositionsForRange(5000, 6000).empty());
+  ASSERT_TRUE(index.getPositionsForRange(20, 10).empty());
+}
+
+TEST_F(OrderedIndexTests, lookups_during_remap_see_all_rows) {
+  OrderedIndex<hyrise_int_t> index(nullptr, 0);
+  index.insertRows(*store, 0, store->size());
+  const auto expected = index.getPositionsForRange(150, 1499);
+  ASSERT_EQ(scan(store, 150, 1499), expected);
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> mismatches(0);
+  std::thread reader([&] () {
+      while (!done) {
+        if (index.getPositionsForRange(150, 1499) != expected)
+          ++mismatches;
+      }
+    });
+  // The first remap moves all rows from the delta into the tree
+  const std::vector<bool> kept(store->size(), true);
+  for (size_t i = 0; i < 20; ++i)
+    index.moveRows(*store, kept);
+  done = true;
+  reader.join();
+  ASSERT_EQ(0u, mismatches.load());
+  ASSERT_EQ(expected, index.getPositionsForRange(150, 1499));
+}
+
+TEST_F(OrderedIndexTests, inserted_rows_are_found_and_remapped) {
+  auto index = std::make_shared<OrderedIndex<hyrise_int_t>>(store, 0);
+  store->addIndex(index);
+
+  auto area = store->appendToDelta(2);
+  const pos_t first = store->deltaOffset() + area.first;
+  store->copyRowToDelta(store, 0, area.first, tx::START_TID);
+  store->copyRowToDelta(store, 0, area.first + 1, tx::START_TID);
+  store->setValue<hyrise_int_t>(0, first, 1234);
+  store->setValue<hyrise_int_t>(0, first + 1, 100000);
+  store->addToIndexes(first, 2);
+
+  ASSERT_EQ(scan(store, 1234, 1234), index->getPositionsForKey(1234));
+  ASSERT_EQ(pos_list_t({first + 1}), index->getPositionsForRange(50000, 200000));
+
+  // Drop every third row
+  std::vector<bool> kept(store->size());
+  std::vector<hyrise_int_t> values;
+  for (size_t row = 0; row < kept.size(); ++row) {
+    kept[row] = row % 3 != 0;
+    if (kept[row])
+      values.push_back(store->getValue<hyrise_int_t>(0, row));
+  }
+  index->moveRows(*store, kept);
+
+  pos_list_t expected;
+  for (size_t row = 0; row < values.size(); ++row) {
+    if (values[row] >= 1000 && values[row] <= 1300)
+      expected.push_back(row);
+  }
+  ASSERT_EQ(expected, index->getPositionsForRange(1000, 1300));
+  store->removeIndex(index);
+}
+
+TEST_F(OrderedIndexTests, prefix_lookup) {
+  auto students = io::Loader::shortcuts::load("test/students.tbl");
+  const auto city = students->numberOfColumn("city");
+  OrderedIndex<hyrise_string_t> index(students, city);
+
+  pos_list_t expected;
+  for (size_t row = 0; row < students->size(); ++row) {
+    if (students->getValue<hyrise_string_t>(city, row).compare(0, 3, "Ber") == 0)
+      expected.push_back(row);
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(expected, index.getPositionsForPrefix("Ber"));
+  ASSERT_TRUE(index.getPositionsForPrefix("Zz").empty());
+}
+
+}}
@@ -3,8 +3,12 @@
 #include "helper.h"
 
 #include <algorithm>
+#include <thread>
 
+#include <io/GarbageCollector.h>
 #include <io/shortcuts.h>
+#include <io/StorageManager.h>
+#include <storage/InvertedIndex.h>
 #include <storage/Store.h>
 #include <storage/PointerCalculator.h>
 #include <storage/TableBuilder.h>
@@ -65,10 +69,56 @@ TEST_F(VisibilityTests, check_tx_prepare_commit) {
 	auto lc = ctx.lastCid;
 
 	ASSERT_EQ(hyrise::tx::UNKNOWN, lc);
-	ASSERT_EQ(lc + 1, txmgr.tryPrepareCommit());
-	txmgr.commit(ctx.tid);
+	auto cid = txmgr.prepareCommit();
+	ASSERT_EQ(lc + 1, cid);
+	txmgr.commit(ctx.tid, cid);
 	ASSERT_EQ(lc + 1, txmgr.getLastCommitId());
-	ASSERT_ANY_THROW(txmgr.commit(hyrise::tx::UNKNOWN)) << "Double commit is not allowed";
+	ASSERT_ANY_THROW(txmgr.commit(hyrise::tx::UNKNOWN, cid)) << "Double commit is not allowed";
+}
+
+TEST_F(VisibilityTests, out_of_order_commits) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+	auto ctx_c = txmgr.buildContext();
+	auto lc = txmgr.getLastCommitId();
+
+	auto cid_a = txmgr.prepareCommit();
+	auto cid_b = txmgr.prepareCommit();
+	auto cid_c = txmgr.prepareCommit();
+	ASSERT_EQ(lc + 1, cid_a);
+	ASSERT_EQ(lc + 2, cid_b);
+	ASSERT_EQ(lc + 3, cid_c);
+
+	// later commits stay invisible until all earlier ones completed
+	txmgr.commit(ctx_c.tid, cid_c);
+	ASSERT_EQ(lc, txmgr.getLastCommitId());
+	txmgr.commit(ctx_b.tid, cid_b);
+	ASSERT_EQ(lc, txmgr.getLastCommitId());
+	txmgr.abort(cid_a);
+	ASSERT_EQ(cid_c, txmgr.getLastCommitId());
+
+	ASSERT_ANY_THROW(txmgr.commit(ctx_a.tid, cid_a)) << "Aborted commit ids cannot be committed";
+}
+
+TEST_F(VisibilityTests, concurrent_commits_advance_last_commit_id) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto lc = txmgr.getLastCommitId();
+	const size_t threads = 8, commits = 1000;
+
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; ++t) {
+		workers.emplace_back([&txmgr] () {
+			for (size_t i = 0; i < commits; ++i) {
+				auto ctx = txmgr.buildContext();
+				txmgr.commit(ctx.tid, txmgr.prepareCommit());
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	ASSERT_EQ(lc + static_cast<tx::transaction_cid_t>(threads * commits), txmgr.getLastCommitId());
 }
 
 TEST_F(VisibilityTests, read_your_own_writes) {
@@ -125,7 +175,7 @@ TEST_F (VisibilityTests, read_writes_after_commit) {
 
 	pos_list_t pos_tmp = {linxxxs->size() -1};
 	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions(pos_tmp, next_cid, true));
-	txmgr.commit(tid_a);
+	txmgr.commit(tid_a, next_cid);
 
 	// the second transaction should see all the values after the commit is done
 	lc = txmgr.getLastCommitId();
@@ -161,7 +211,7 @@ TEST_F (VisibilityTests, read_writes_after_commit_old_cid) {
 	ASSERT_EQ(next_cid, txmgr.getLastCommitId() + 1);
 	pos_list_t pos_tmp = {linxxxs->size() -1};
 	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions(pos_tmp, next_cid, true));
-	txmgr.commit(tid_a);
+	txmgr.commit(tid_a, next_cid);
 
 	// the second transaction should not see all the values after the commit, due to old cid
 	auto tmp2 = new pos_list_t(linxxxs->size(), 0);
@@ -174,4 +224,324 @@ TEST_F (VisibilityTests, read_writes_after_commit_old_cid) {
 	EXPECT_RELATION_EQ(io::Loader::shortcuts::load("test/lin_xxxs.tbl"), r);
 }
 
+TEST_F (VisibilityTests, visibility_bitmap_matches_row_checks) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+	auto lc = txmgr.getLastCommitId();
+
+	linxxxs->resizeDelta(1);
+	linxxxs->copyRowToDelta(one_row, 0, 0, ctx_a.tid);
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(0, ctx_a.tid));
+
+	for (const auto tid : {ctx_a.tid, ctx_b.tid}) {
+		Store::visibility_bitmap_t bitmap;
+		linxxxs->buildVisibilityBitmap(0, lc, tid, bitmap);
+		for (size_t row = 0; row < Store::mvcc_chunk_size; ++row) {
+			bool visible = (bitmap[row / 64] >> (row % 64)) & 1;
+			bool expected = row < linxxxs->size() && linxxxs->isVisibleForTransaction(row, lc, tid);
+			ASSERT_EQ(expected, visible) << "row " << row << " tid " << tid;
+		}
+	}
+
+	// the first transaction sees its insert but not its delete
+	auto valid_a = linxxxs->buildValidPositions(lc, ctx_a.tid);
+	ASSERT_EQ(linxxxs->size() - 1, valid_a.size());
+	ASSERT_EQ(1u, valid_a.front());
+	ASSERT_EQ(linxxxs->size() - 1, valid_a.back());
+
+	// the second transaction only sees the main
+	auto valid_b = linxxxs->buildValidPositions(lc, ctx_b.tid);
+	ASSERT_EQ(linxxxs->size() - 1, valid_b.size());
+	ASSERT_EQ(0u, valid_b.front());
+	ASSERT_EQ(linxxxs->deltaOffset() - 1, valid_b.back());
+}
+
+TEST_F (VisibilityTests, all_visible_main_fast_path) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx = txmgr.buildContext();
+
+	// a main that spans more than one full mvcc chunk
+	auto main = one_row->copy_structure_modifiable();
+	main->resize(Store::mvcc_chunk_size + 10);
+	auto big = std::make_shared<Store>(main);
+	ASSERT_EQ(Store::mvcc_chunk_size + 10, big->deltaOffset());
+
+	auto lc = txmgr.getLastCommitId();
+	ASSERT_EQ(big->size(), big->buildValidPositions(lc, ctx.tid).size());
+
+	// touching a row of the full main chunk leaves the fast path
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, big->markForDeletion(5, ctx.tid));
+	auto valid = big->buildValidPositions(lc, ctx.tid);
+	ASSERT_EQ(big->size() - 1, valid.size());
+	ASSERT_TRUE(std::find(valid.begin(), valid.end(), 5u) == valid.end());
+
+	pos_list_t check = {4, 5, 6};
+	big->validatePositions(check, lc, ctx.tid);
+	ASSERT_EQ((pos_list_t {4, 6}), check);
+}
+
+
+TEST_F (VisibilityTests, compact_delta_removes_dead_rows) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+	auto ctx_c = txmgr.buildContext();
+	const auto main_size = linxxxs->deltaOffset();
+
+	linxxxs->resizeDelta(4);
+	for (size_t row = 0; row < 3; ++row)
+		linxxxs->copyRowToDelta(one_row, 0, row, ctx_a.tid);
+	linxxxs->copyRowToDelta(one_row, 0, 3, ctx_c.tid);
+
+	auto insert_cid = txmgr.prepareCommit();
+	pos_list_t inserted = {main_size, main_size + 1, main_size + 2};
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions(inserted, insert_cid, true));
+	txmgr.commit(ctx_a.tid, insert_cid);
+
+	// rows that are still being written prevent compaction
+	{
+		Store::WriteExclusion exclusion(*linxxxs);
+		ASSERT_EQ(nullptr, linxxxs->compactDelta(insert_cid));
+	}
+
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->abortInsertions({main_size + 3}, ctx_c.tid));
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(main_size, ctx_b.tid));
+	auto delete_cid = txmgr.prepareCommit();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions({main_size}, delete_cid, false));
+	txmgr.commit(ctx_b.tid, delete_cid);
+
+	// the deleted row is still visible to snapshots before the delete
+	ASSERT_EQ(1u, linxxxs->deadDeltaRows(insert_cid));
+	ASSERT_EQ(2u, linxxxs->deadDeltaRows(delete_cid));
+
+	std::shared_ptr<Store> compacted;
+	{
+		Store::WriteExclusion exclusion(*linxxxs);
+		compacted = linxxxs->compactDelta(delete_cid);
+	}
+	ASSERT_NE(nullptr, compacted);
+	ASSERT_EQ(2u, compacted->getDeltaTable()->size());
+	ASSERT_EQ(main_size + 2, compacted->size());
+	ASSERT_EQ(0u, compacted->deadDeltaRows(delete_cid));
+	ASSERT_EQ(std::to_string(linxxxs->getUuid()), std::to_string(compacted->getUuid()));
+
+	auto valid = compacted->buildValidPositions(txmgr.getLastCommitId(), txmgr.buildContext().tid);
+	ASSERT_EQ(compacted->size(), valid.size());
+	ASSERT_EQ(99, compacted->getValue<hyrise_int_t>(0, main_size + 1));
+
+	// the store itself is left to its readers
+	ASSERT_EQ(main_size + 4, linxxxs->size());
+	ASSERT_EQ(2u, linxxxs->deadDeltaRows(delete_cid));
+
+	// once retired, writes to the store fail while rollbacks still work
+	Store::WriteExclusion exclusion(*linxxxs);
+	exclusion.retire();
+	ASSERT_THROW(linxxxs->appendToDelta(1), std::runtime_error);
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->abortInsertions({main_size + 1}, ctx_a.tid));
+}
+
+
+TEST_F (VisibilityTests, compaction_moves_attached_indexes) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+	const auto main_size = linxxxs->deltaOffset();
+	auto index = std::make_shared<InvertedIndex<hyrise_int_t>>(linxxxs, 0);
+	linxxxs->addIndex(index);
+
+	linxxxs->resizeDelta(3);
+	for (size_t row = 0; row < 3; ++row)
+		linxxxs->copyRowToDelta(one_row, 0, row, ctx_a.tid);
+	linxxxs->addToIndexes(main_size, 3);
+	auto insert_cid = txmgr.prepareCommit();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions({main_size, main_size + 1, main_size + 2}, insert_cid, true));
+	txmgr.commit(ctx_a.tid, insert_cid);
+
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(main_size, ctx_b.tid));
+	auto delete_cid = txmgr.prepareCommit();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions({main_size}, delete_cid, false));
+	txmgr.commit(ctx_b.tid, delete_cid);
+
+	std::shared_ptr<Store> compacted;
+	{
+		Store::WriteExclusion exclusion(*linxxxs);
+		compacted = linxxxs->compactDelta(delete_cid);
+	}
+	ASSERT_NE(nullptr, compacted);
+
+	// the index lists the positions of the compacted store
+	pos_list_t expected;
+	for (pos_t row = 0; row < compacted->size(); ++row) {
+		if (compacted->getValue<hyrise_int_t>(0, row) == 99)
+			expected.push_back(row);
+	}
+	ASSERT_EQ(expected, index->getPositionsForKey(99));
+	ASSERT_EQ(main_size + 1, expected.back());
+
+	// and follows its inserts
+	auto ctx_c = txmgr.buildContext();
+	const auto area = compacted->appendToDelta(1);
+	compacted->copyRowToDelta(one_row, 0, area.first, ctx_c.tid);
+	compacted->addToIndexes(main_size + area.first, 1);
+	ASSERT_EQ(main_size + 2, index->getPositionsForKey(99).back());
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, compacted->abortInsertions({main_size + area.first}, ctx_c.tid));
+}
+
+
+TEST_F (VisibilityTests, compaction_runs_concurrently_with_writes_and_scans) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto& gc = io::GarbageCollector::getInstance();
+	auto* sm = io::StorageManager::getInstance();
+	sm->loadTable("concurrent_compaction", linxxxs);
+	gc.setFragmentationThreshold(0.1, 1);
+	const auto main_size = linxxxs->deltaOffset();
+	const size_t rounds = 1000;
+	std::atomic<bool> done(false);
+
+	// Each round commits one row and aborts another, so half of the delta is dead
+	std::thread writer([&] () {
+		for (size_t round = 0; round < rounds; ++round) {
+			for (const bool valid : {true, false}) {
+				while (true) {
+					auto store = std::dynamic_pointer_cast<Store>(sm->getTable("concurrent_compaction"));
+					auto ctx = txmgr.buildContext();
+					size_t row;
+					try {
+						row = store->appendToDelta(1).first;
+					} catch (const std::runtime_error&) {
+						// the store was replaced by a compacted copy
+						continue;
+					}
+					store->copyRowToDelta(one_row, 0, row, ctx.tid);
+					const pos_t pos = store->deltaOffset() + row;
+					if (valid) {
+						auto cid = txmgr.prepareCommit();
+						store->commitPositions({pos}, cid, true);
+						txmgr.commit(ctx.tid, cid);
+					} else {
+						store->abortInsertions({pos}, ctx.tid);
+					}
+					break;
+				}
+			}
+		}
+		done = true;
+	});
+
+	// Scans see all committed rows of their snapshot, whichever store they read
+	std::thread scanner([&] () {
+		size_t last_visible = 0;
+		while (!done) {
+			auto store = std::dynamic_pointer_cast<Store>(sm->getTable("concurrent_compaction"));
+			auto valid = store->buildValidPositions(txmgr.getLastCommitId(), txmgr.buildContext().tid);
+			ASSERT_LE(last_visible, valid.size());
+			last_visible = valid.size();
+			for (const auto& pos : valid) {
+				if (pos >= main_size)
+					ASSERT_EQ(99, store->getValue<hyrise_int_t>(0, pos));
+			}
+		}
+	});
+
+	while (!done)
+		gc.collect();
+	writer.join();
+	scanner.join();
+
+	// Without writes in progress, the remaining aborted rows are removed
+	gc.collect();
+	auto store = std::dynamic_pointer_cast<Store>(sm->getTable("concurrent_compaction"));
+	ASSERT_EQ(rounds, store->getDeltaTable()->size());
+	ASSERT_EQ(main_size + rounds, store->buildValidPositions(txmgr.getLastCommitId(), txmgr.buildContext().tid).size());
+
+	gc.setFragmentationThreshold(0.25, 1024);
+	sm->removeTable("concurrent_compaction");
+}
+
+TEST_F (VisibilityTests, first_committer_wins) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(0, ctx_a.tid));
+	auto cid = txmgr.prepareCommit();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->commitPositions({0}, cid, false));
+	txmgr.commit(ctx_a.tid, cid);
+
+	// the row is unlocked again but its version has been superseded
+	ASSERT_EQ(hyrise::tx::START_TID, linxxxs->tid(0));
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT, linxxxs->markForDeletion(0, ctx_b.tid));
+	ASSERT_EQ(hyrise::tx::START_TID, linxxxs->tid(0));
+	ASSERT_EQ(1u, linxxxs->getConflictStats().conflicts);
+}
+
+TEST_F (VisibilityTests, rows_of_a_new_store_can_be_deleted_before_its_first_merge) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto main = one_row->copy();
+	auto store = std::make_shared<Store>(main);
+	// Unlocked like the rows of a merged main, not UNKNOWN as rows of aborted inserts
+	ASSERT_EQ(hyrise::tx::START_TID, store->tid(0));
+
+	auto ctx_old = txmgr.buildContext();
+	auto ctx_a = txmgr.buildContext();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, store->markForDeletion(0, ctx_a.tid));
+	auto cid = txmgr.prepareCommit();
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, store->commitPositions({0}, cid, false));
+	txmgr.commit(ctx_a.tid, cid);
+
+	auto ctx_new = txmgr.buildContext();
+	ASSERT_FALSE(store->isVisibleForTransaction(0, ctx_new.lastCid, ctx_new.tid));
+	ASSERT_TRUE(store->isVisibleForTransaction(0, ctx_old.lastCid, ctx_old.tid));
+}
+
+TEST_F (VisibilityTests, wait_for_lock_holder_rollback) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	auto ctx_a = txmgr.buildContext();
+	auto ctx_b = txmgr.buildContext();
+	const auto timeout = txmgr.getLockWaitTimeout();
+
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(1, ctx_a.tid));
+
+	txmgr.setLockWaitTimeout(std::chrono::microseconds(0));
+	ASSERT_EQ(hyrise::tx::TX_CODE::TX_FAIL_LOCK_TIMEOUT, linxxxs->markForDeletion(1, ctx_b.tid));
+
+	txmgr.setLockWaitTimeout(std::chrono::seconds(10));
+	std::thread holder([&] () {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			linxxxs->unmarkForDeletion({1}, ctx_a.tid);
+		});
+	EXPECT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(1, ctx_b.tid));
+	holder.join();
+	txmgr.setLockWaitTimeout(timeout);
+
+	ASSERT_EQ(ctx_b.tid, linxxxs->tid(1));
+	auto stats = linxxxs->getConflictStats();
+	ASSERT_EQ(1u, stats.waits);
+	ASSERT_EQ(1u, stats.retries);
+	ASSERT_EQ(1u, stats.conflicts);
+}
+
+TEST_F (VisibilityTests, waiter_sees_concurrent_commit) {
+	auto&	 txmgr = hyrise::tx::TransactionManager::getInstance();
+	const auto timeout = txmgr.getLockWaitTimeout();
+	txmgr.setLockWaitTimeout(std::chrono::seconds(10));
+
+	// the waiter acquires the unlocked tid and must see the end cid that
+	// was written before it, so it never deletes a deleted row again
+	for (size_t row = 0; row < linxxxs->size(); ++row) {
+		auto ctx_a = txmgr.buildContext();
+		auto ctx_b = txmgr.buildContext();
+		ASSERT_EQ(hyrise::tx::TX_CODE::TX_OK, linxxxs->markForDeletion(row, ctx_a.tid));
+		std::thread committer([&] () {
+				auto cid = txmgr.prepareCommit();
+				linxxxs->commitPositions({row}, cid, false);
+				txmgr.commit(ctx_a.tid, cid);
+			});
+		EXPECT_EQ(hyrise::tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT, linxxxs->markForDeletion(row, ctx_b.tid));
+		committer.join();
+	}
+	txmgr.setLockWaitTimeout(timeout);
+}
+
 }}
@@ -0,0 +1,97 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "testing/test.h"
+
+#include "taskscheduler/AdmissionController.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+class AdmissionControllerTest : public ::hyrise::Test {
+ public:
+  virtual void SetUp() {
+    auto& admission = AdmissionController::getInstance();
+    admission.setBudget(1000);
+    admission.setMaxWaiting(1);
+  }
+
+  virtual void TearDown() {
+    auto& admission = AdmissionController::getInstance();
+    admission.setBudget(0);
+    admission.setMaxWaiting(AdmissionController::DEFAULT_MAX_WAITING);
+  }
+};
+
+TEST_F(AdmissionControllerTest, queries_wait_while_budget_is_exhausted) {
+  auto& admission = AdmissionController::getInstance();
+  size_t started = 0;
+  auto start = [&started] () { ++started; };
+
+  ASSERT_EQ(AdmissionController::Admitted, admission.admit(1, 0, start));
+  admission.charge(1, 600);
+  ASSERT_EQ(AdmissionController::Admitted, admission.admit(1, 0, start));
+  admission.charge(2, 600);
+  ASSERT_EQ(1200u, admission.getUsage());
+  ASSERT_EQ(600u, admission.getSessionUsage(1));
+
+  ASSERT_EQ(AdmissionController::Waiting, admission.admit(1, 0, start));
+  ASSERT_EQ(AdmissionController::Rejected, admission.admit(1, 0, start));
+  ASSERT_EQ(1u, admission.getWaiting());
+
+  // Still above the budget
+  admission.release(2, 100, 100);
+  ASSERT_EQ(0u, started);
+
+  admission.release(1, 600, 600);
+  ASSERT_EQ(1u, started);
+  ASSERT_EQ(0u, admission.getWaiting());
+  ASSERT_EQ(0u, admission.getSessionUsage(1));
+
+  admission.release(2, 500, 500);
+  ASSERT_EQ(0u, admission.getUsage());
+}
+
+TEST_F(AdmissionControllerTest, reservations_are_charged_on_admission) {
+  auto& admission = AdmissionController::getInstance();
+  size_t started = 0;
+  auto start = [&started] () { ++started; };
+
+  ASSERT_EQ(AdmissionController::Admitted, admission.admit(1, 800, start));
+  ASSERT_EQ(800u, admission.getUsage());
+  ASSERT_EQ(800u, admission.getSessionUsage(1));
+
+  // Does not fit next to the first query although the budget is not used up
+  ASSERT_EQ(AdmissionController::Waiting, admission.admit(2, 300, start));
+
+  admission.release(1, 800, 100);
+  ASSERT_EQ(1u, started);
+  ASSERT_EQ(300u, admission.getSessionUsage(2));
+
+  admission.release(2, 300, 300);
+  ASSERT_EQ(0u, admission.getUsage());
+
+  // A query alone may reserve more than the budget
+  ASSERT_EQ(AdmissionController::Admitted, admission.admit(1, 5000, start));
+  admission.release(1, 5000, 5000);
+}
+
+TEST_F(AdmissionControllerTest, estimate_follows_what_queries_used) {
+  auto& admission = AdmissionController::getInstance();
+  const size_t before = admission.getEstimate();
+  admission.release(1, 0, before + 8000);
+  ASSERT_GT(admission.getEstimate(), before);
+  const size_t after = admission.getEstimate();
+  admission.release(1, 0, 0);
+  ASSERT_LT(admission.getEstimate(), after);
+}
+
+TEST_F(AdmissionControllerTest, no_budget_admits_all_queries) {
+  auto& admission = AdmissionController::getInstance();
+  admission.setBudget(0);
+  admission.charge(1, 5000);
+  ASSERT_EQ(AdmissionController::Admitted, admission.admit(1, 0, [] () {}));
+  admission.release(1, 5000, 5000);
+  ASSERT_EQ(0u, admission.getUsage());
+}
+
+}
+}
@@ -4,16 +4,25 @@
 #include <iterator>
 #include <ctime>
 #include <sys/time.h>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 #include "testing/test.h"
 
 #include "access/NoOp.h"
 
 #include "taskscheduler/SharedScheduler.h"
+#include "taskscheduler/BlockingRegion.h"
+#include "taskscheduler/CentralScheduler.h"
 #include "taskscheduler/CoreBoundQueuesScheduler.h"
 #include "taskscheduler/WSCoreBoundQueuesScheduler.h"
 #include "taskscheduler/ThreadPerTaskScheduler.h"
 #include "taskscheduler/DynamicPriorityScheduler.h"
+#include "taskscheduler/FairShareScheduler.h"
+#include "taskscheduler/SchedulerTracer.h"
 
 #include "helper/HwlocHelper.h"
 
@@ -35,7 +44,8 @@ std::vector<std::string> getSchedulersToTest() {
            "CoreBoundPriorityQueuesScheduler",
            "WSCoreBoundPriorityQueuesScheduler",
            "ThreadPerTaskScheduler",
-           "DynamicPriorityScheduler"};
+           "DynamicPriorityScheduler",
+           "FairShareScheduler"};
 }
 
 class SchedulerTest : public TestWithParam<std::string> {
@@ -72,6 +82,84 @@ TEST_P(SchedulerTest, wait_task_test) {
   waiter->wait();
 }
 
+TEST_P(SchedulerTest, tasks_are_traced) {
+  // the tracer records the tasks of worker threads
+  if (scheduler_name == "ThreadPerTaskScheduler")
+    return;
+
+  SharedScheduler::getInstance().resetScheduler(scheduler_name, 2);
+  const auto& scheduler = SharedScheduler::getInstance().getScheduler();
+  auto& tracer = SchedulerTracer::getInstance();
+  tracer.clear();
+  tracer.setEnabled(true);
+
+  auto nop = std::make_shared<access::NoOp>();
+  nop->setPlanOperationName("TracedNoOp");
+  std::shared_ptr<WaitTask> waiter = std::make_shared<WaitTask>();
+  waiter->addDependency(nop);
+  scheduler->schedule(nop);
+  scheduler->schedule(waiter);
+  waiter->wait();
+  tracer.setEnabled(false);
+
+  // the NoOp is recorded before its successor runs
+  const auto events = tracer.events();
+  const auto event = std::find_if(events.begin(), events.end(), [] (const trace_event_t& e) {
+    return std::string(e.name) == "TracedNoOp" && e.victim < 0;
+  });
+  ASSERT_NE(events.end(), event);
+  ASSERT_LE(event->start, event->end);
+  ASSERT_GT(event->enqueued, 0u);
+  ASSERT_LE(event->enqueued, event->start);
+
+  std::ostringstream trace;
+  tracer.writeChromeTrace(trace);
+  ASSERT_NE(std::string::npos, trace.str().find("{\"name\": \"TracedNoOp\""));
+  tracer.clear();
+}
+
+// a task named after the core it is traced on
+class CoreTask : public Task {
+ public:
+  explicit CoreTask(int core) : _name("core" + std::to_string(core)) {}
+  const std::string vname() { return _name; }
+
+ private:
+  std::string _name;
+};
+
+TEST(SchedulerTracerTest, events_read_while_recording_are_whole) {
+  auto& tracer = SchedulerTracer::getInstance();
+  tracer.clear();
+  tracer.setEnabled(true);
+  std::atomic<bool> done(false);
+  std::thread worker([&] () {
+      std::vector<std::shared_ptr<CoreTask>> tasks;
+      for (int core = 0; core < 8; ++core)
+        tasks.push_back(std::make_shared<CoreTask>(core));
+      for (size_t i = 0; !done; ++i)
+        tracer.execute(*tasks[i % tasks.size()], i % tasks.size());
+    });
+
+  while (tracer.events().empty())
+    std::this_thread::yield();
+  size_t read = 0;
+  for (size_t i = 0; i < 200; ++i) {
+    for (const auto& event : tracer.events()) {
+      ASSERT_EQ("core" + std::to_string(event.core), std::string(event.name));
+      ++read;
+    }
+    if (i % 50 == 0)
+      tracer.clear();
+  }
+  done = true;
+  worker.join();
+  tracer.setEnabled(false);
+  tracer.clear();
+  ASSERT_LT(0u, read);
+  ASSERT_TRUE(tracer.events().empty());
+}
+
 long int getTimeInMillis() {
   /* Linux */
   struct timeval tv;
@@ -265,5 +353,191 @@ TEST(SchedulerBlockTest, dont_block_test_with_work_stealing) {
   long_block_test(scheduler.get());
 }
 
+// appends its name to a log when it runs, blocks the worker until it is
+// released
+class LoggingTask : public Task {
+ public:
+  LoggingTask(const std::string& name, std::vector<std::string>& log, std::mutex& mutex) :
+      _name(name), _log(log), _mutex(mutex) {}
+
+  virtual void operator()() {
+    started = true;
+    while (!released)
+      std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lk(_mutex);
+    _log.push_back(_name);
+  }
+  const std::string vname() { return _name; }
+
+  std::atomic<bool> started{false};
+  std::atomic<bool> released{true};
+
+ private:
+  std::string _name;
+  std::vector<std::string>& _log;
+  std::mutex& _mutex;
+};
+
+TEST(FairShareSchedulerTest, sessions_share_the_worker) {
+  auto scheduler = std::make_shared<FairShareScheduler>(1);
+  std::vector<std::string> log;
+  std::mutex mutex;
+  auto waiter = std::make_shared<WaitTask>();
+  const auto task = [&] (const std::string& name, int session, int query, epoch_t deadline) {
+    auto t = std::make_shared<LoggingTask>(name, log, mutex);
+    t->setSessionId(session);
+    t->setId(query);
+    t->setDeadline(deadline);
+    waiter->addDependency(t);
+    return t;
+  };
+
+  // the single worker is blocked while the other tasks are queued
+  auto blocker = task("blocker", 3, 3, 0);
+  blocker->released = false;
+  scheduler->schedule(blocker);
+  while (!blocker->started)
+    std::this_thread::yield();
+
+  scheduler->schedule(task("long1", 1, 1, 0));
+  scheduler->schedule(task("long2", 1, 1, 0));
+  scheduler->schedule(task("long3", 1, 1, 0));
+  scheduler->schedule(task("short", 2, 2, 0));
+  scheduler->schedule(task("urgent", 4, 4, get_epoch_nanoseconds()));
+  scheduler->schedule(waiter);
+  blocker->released = true;
+  waiter->wait();
+
+  ASSERT_EQ(6u, log.size());
+  // the task past its deadline runs first, the short session does not
+  // wait for all tasks of the long one
+  ASSERT_EQ("urgent", log[1]);
+  ASSERT_LE(std::find(log.begin(), log.end(), "short") - log.begin(), 3);
+  ASSERT_EQ("long3", log.back());
+  ASSERT_GE(scheduler->getSessionTime(1), 3u * 1000 * 1000);
+  ASSERT_EQ(0u, scheduler->getQueryTime(1));
+}
+
+TEST(FairShareSchedulerTest, idle_sessions_keep_their_lead) {
+  auto scheduler = std::make_shared<FairShareScheduler>(1);
+  std::vector<std::string> log;
+  std::mutex mutex;
+  const auto task = [&] (const std::string& name, int session, bool released) {
+    auto t = std::make_shared<LoggingTask>(name, log, mutex);
+    t->setSessionId(session);
+    t->setId(session);
+    t->released = released;
+    return t;
+  };
+
+  // session 1 consumes 20 ms and goes idle
+  auto heavy = task("heavy", 1, false);
+  auto waiter = std::make_shared<WaitTask>();
+  waiter->addDependency(heavy);
+  scheduler->schedule(heavy);
+  scheduler->schedule(waiter);
+  while (!heavy->started)
+    std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  heavy->released = true;
+  waiter->wait();
+
+  // it returns right away and has to wait for a new session
+  auto blocker = task("blocker", 3, false);
+  scheduler->schedule(blocker);
+  while (!blocker->started)
+    std::this_thread::yield();
+  waiter = std::make_shared<WaitTask>();
+  for (const auto& t : {task("returning", 1, true), task("new", 2, true)}) {
+    waiter->addDependency(t);
+    scheduler->schedule(t);
+  }
+  scheduler->schedule(waiter);
+  blocker->released = true;
+  waiter->wait();
+
+  ASSERT_EQ(4u, log.size());
+  ASSERT_EQ("new", log[2]);
+  ASSERT_EQ("returning", log[3]);
+}
+
+// a LoggingTask that tells the scheduler its worker is blocked
+class BlockingTask : public LoggingTask {
+ public:
+  BlockingTask(const std::string& name, std::vector<std::string>& log, std::mutex& mutex) :
+      LoggingTask(name, log, mutex) {}
+
+  virtual void operator()() {
+    BlockingRegion region;
+    LoggingTask::operator()();
+  }
+};
+
+TEST(CentralSchedulerPoolTest, blocked_worker_is_compensated) {
+  auto scheduler = std::make_shared<CentralScheduler>(1);
+  scheduler->setIdleTimeout(std::chrono::milliseconds(10));
+  std::vector<std::string> log;
+  std::mutex mutex;
+
+  // the only worker blocks until the task queued after it ran
+  auto blocking = std::make_shared<BlockingTask>("blocking", log, mutex);
+  blocking->released = false;
+  auto next = std::make_shared<LoggingTask>("next", log, mutex);
+  auto waiter = std::make_shared<WaitTask>();
+  waiter->addDependency(next);
+  scheduler->schedule(blocking);
+  while (!blocking->started)
+    std::this_thread::yield();
+  scheduler->schedule(next);
+  scheduler->schedule(waiter);
+  waiter->wait();
+  ASSERT_EQ(1u, log.size());
+
+  auto pool = scheduler->getPoolStatistics();
+  ASSERT_EQ(2u, pool.workers);
+  ASSERT_EQ(1u, pool.blocked);
+  ASSERT_EQ(1u, pool.spawned);
+
+  // the pool shrinks back once the worker returned
+  blocking->released = true;
+  while (scheduler->getNumberOfWorker() > 1)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  pool = scheduler->getPoolStatistics();
+  ASSERT_EQ(0u, pool.blocked);
+  ASSERT_EQ(1u, pool.retired);
+  ASSERT_GT(pool.blockedTime, 0u);
+  // joins the workers here, before a worker may drop the last reference
+  scheduler->shutdown();
+}
+
+TEST(CentralSchedulerPoolTest, idle_pool_shrinks_to_min_workers) {
+  auto scheduler = std::make_shared<CentralScheduler>(4);
+  scheduler->setMinWorkers(1);
+  scheduler->setIdleTimeout(std::chrono::milliseconds(10));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (scheduler->getNumberOfWorker() > 1 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(1u, scheduler->getNumberOfWorker());
+
+  // the last worker stays although it is idle
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto pool = scheduler->getPoolStatistics();
+  ASSERT_EQ(1u, pool.workers);
+  ASSERT_EQ(3u, pool.retired);
+
+  std::vector<std::string> log;
+  std::mutex mutex;
+  auto task = std::make_shared<LoggingTask>("task", log, mutex);
+  auto waiter = std::make_shared<WaitTask>();
+  waiter->addDependency(task);
+  scheduler->schedule(task);
+  scheduler->schedule(waiter);
+  waiter->wait();
+  ASSERT_EQ(1u, log.size());
+  scheduler->shutdown();
+}
+
 } } // namespace hyrise::taskscheduler
 
@@ -0,0 +1,47 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/ConflictStatistics.h"
+
+#include "access/system/QueryParser.h"
+#include "access/system/BasicParser.h"
+
+#include "io/StorageManager.h"
+
+#include "storage/Store.h"
+#include "storage/TableBuilder.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+  auto _ = QueryParser::registerTrivialPlanOperation<ConflictStatistics>("ConflictStatistics");
+}
+
+void ConflictStatistics::executePlanOperation() {
+  storage::TableBuilder::param_list list;
+  list.append().set_type("STRING").set_name("table");
+  list.append().set_type("INTEGER").set_name("waits");
+  list.append().set_type("INTEGER").set_name("retries");
+  list.append().set_type("INTEGER").set_name("conflicts");
+  auto result = storage::TableBuilder::build(list);
+
+  const auto &storageManager = io::StorageManager::getInstance();
+  size_t row = 0;
+  for (const auto & tableName: storageManager->getTableNames()) {
+    auto store = std::dynamic_pointer_cast<storage::Store>(storageManager->getTable(tableName));
+    if (!store)
+      continue;
+
+    const auto stats = store->getConflictStats();
+    result->resize(row + 1);
+    result->setValue<hyrise_string_t>(0, row, tableName);
+    result->setValue<hyrise_int_t>(1, row, stats.waits);
+    result->setValue<hyrise_int_t>(2, row, stats.retries);
+    result->setValue<hyrise_int_t>(3, row, stats.conflicts);
+    ++row;
+  }
+
+  addResult(result);
+}
+
+}
+}
@@ -0,0 +1,20 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_CONFLICTSTATISTICS_H_
+#define SRC_LIB_ACCESS_CONFLICTSTATISTICS_H_
+
+#include "access/system/PlanOperation.h"
+
+namespace hyrise {
+namespace access {
+
+/// Reports the write-write conflict statistics of all stores loaded in the
+/// StorageManager, one row per table
+class ConflictStatistics : public PlanOperation {
+public:
+  void executePlanOperation();
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_CONFLICTSTATISTICS_H_
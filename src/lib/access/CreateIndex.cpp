@@ -14,8 +14,11 @@
 #include "storage/meta_storage.h"
 #include "storage/storage_types.h"
 #include "storage/PointerCalculator.h"
+#include "storage/Store.h"
 #include "storage/AbstractIndex.h"
+#include "storage/GroupKeyIndex.h"
 #include "storage/InvertedIndex.h"
+#include "storage/OrderedIndex.h"
 #include "storage/PagedIndex.h"
 
 namespace hyrise {
@@ -35,6 +38,35 @@ struct CreateIndexFunctor {
   }
 };
 
+struct CreateOrderedIndexFunctor {
+  typedef std::shared_ptr<hyrise::storage::AbstractIndex> value_type;
+  const storage::c_atable_ptr_t& in;
+  size_t column;
+
+  CreateOrderedIndexFunctor(const storage::c_atable_ptr_t& t, size_t c):
+    in(t), column(c) {}
+
+  template<typename R>
+  value_type operator()() {
+    return std::make_shared<storage::OrderedIndex<R>>(in, column);
+  }
+};
+
+struct CreateGroupKeyIndexFunctor {
+  typedef std::shared_ptr<hyrise::storage::AbstractIndex> value_type;
+  const storage::c_atable_ptr_t& in;
+  size_t column;
+  bool compressed;
+
+  CreateGroupKeyIndexFunctor(const storage::c_atable_ptr_t& t, size_t c, bool comp):
+    in(t), column(c), compressed(comp) {}
+
+  template<typename R>
+  value_type operator()() {
+    return std::make_shared<storage::GroupKeyIndex<R>>(in, column, compressed);
+  }
+};
+
 struct CreatePagedIndexFunctor {
   typedef std::shared_ptr<hyrise::storage::AbstractIndex> value_type;
   const storage::c_atable_ptr_t& in;
@@ -66,15 +98,43 @@ void CreateIndex::executePlanOperation() {
 
   storage::type_switch<hyrise_basic_types> ts;
 
-  if (_index_type == "paged") {
-    CreatePagedIndexFunctor fun(in, column, _index_paged_page_size);
-    _index = ts(in->typeOfColumn(column), fun);
-  } else { // if (_index_type == "inverted")
-    CreateIndexFunctor fun(in, column);
-    _index = ts(in->typeOfColumn(column), fun);
-  }
+  auto build = [&] (const storage::c_atable_ptr_t& table) -> std::shared_ptr<hyrise::storage::AbstractIndex> {
+    if (_index_type == "paged") {
+      CreatePagedIndexFunctor fun(table, column, _index_paged_page_size);
+      return ts(table->typeOfColumn(column), fun);
+    } else if (_index_type == "groupkey") {
+      CreateGroupKeyIndexFunctor fun(table, column, _index_compressed);
+      return ts(table->typeOfColumn(column), fun);
+    } else if (_index_type == "ordered") {
+      CreateOrderedIndexFunctor fun(table, column);
+      return ts(table->typeOfColumn(column), fun);
+    } else { // if (_index_type == "inverted")
+      CreateIndexFunctor fun(table, column);
+      return ts(table->typeOfColumn(column), fun);
+    }
+  };
 
   auto sm = io::StorageManager::getInstance();
+  auto store = std::dynamic_pointer_cast<const storage::Store>(in);
+
+  if (store && _index_type != "paged") {
+    // All but paged indexes on a store follow its inserts, updates and
+    // merges. The index is built from the main and attached before the
+    // store adds its delta, so rows written meanwhile are not missed.
+    auto mutable_store = std::const_pointer_cast<storage::Store>(store);
+    if (sm->exists(_index_name))
+      mutable_store->removeIndex(sm->getInvertedIndex(_index_name));
+    storage::c_atable_ptr_t main;
+    do {
+      main = store->getMainTable();
+      _index = build(main);
+    } while (!mutable_store->addIndex(_index, main));
+  } else {
+    _index = build(in);
+    if (store && sm->exists(_index_name))
+      std::const_pointer_cast<storage::Store>(store)->removeIndex(sm->getInvertedIndex(_index_name));
+  }
+
   sm->addInvertedIndex(_index_name, _index);
 }
 
@@ -90,6 +150,8 @@ std::shared_ptr<PlanOperation> CreateIndex::parse(const Json::Value &data) {
   else
     i->setIndexPageSize(-1);
 
+  i->setIndexCompressed(data.get("compressed", false).asBool());
+
   return i;
 }
 
@@ -105,5 +167,9 @@ void CreateIndex::setIndexPageSize(size_t pageSize) {
   _index_paged_page_size = pageSize;
 }
 
+void CreateIndex::setIndexCompressed(bool compressed) {
+  _index_compressed = compressed;
+}
+
 }
 }
@@ -18,11 +18,14 @@ public:
   void setIndexName(const std::string &t);
   void setIndexType(const std::string &t);
   void setIndexPageSize(size_t pageSize);
+  /// Bit pack group key indexes
+  void setIndexCompressed(bool compressed);
 
 private:
   std::string _index_name;
   std::string _index_type;
   size_t _index_paged_page_size;
+  bool _index_compressed = false;
 };
 
 }
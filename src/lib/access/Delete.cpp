@@ -28,16 +28,21 @@ void DeleteOp::executePlanOperation() {
 
 	// A delete is nothing more than marking the positions as deleted in the TX
 	// Modifications record
-	auto& modRecord = txmgr[_txContext.tid];
+	tx::TXModificationBatch batch(txmgr[_txContext.tid], tab->getActualTable());
 	for(const auto& p : *(tab->getPositions())) {
 		LOG4CXX_DEBUG(logger, "Deleting row:" << p);
-		bool deleteOk = store->markForDeletion(p, _txContext.tid) == tx::TX_CODE::TX_OK;
-		if(!deleteOk) {
-		  txmgr.rollbackTransaction(_txContext);
-			throw std::runtime_error("Aborted TX because TID of other TX found");
+		auto result = store->markForDeletion(p, _txContext.tid);
+		if(result != tx::TX_CODE::TX_OK) {
+			// Rows locked so far have to be known to the rollback
+			batch.flush();
+			txmgr.rollbackTransaction(_txContext);
+			if (result == tx::TX_CODE::TX_FAIL_LOCK_TIMEOUT)
+				throw std::runtime_error("Aborted TX because row stayed locked by another TX for longer than the lock wait timeout");
+			throw std::runtime_error("Aborted TX because row was modified by a concurrent TX");
 		}
-		modRecord.deletePos(tab->getActualTable(), p);
+		batch.deleted(p);
 	}
+	batch.flush();
 
 	auto rsp = getResponseTask();
   if (rsp != nullptr)
@@ -20,16 +20,17 @@ void HashBuild::executePlanOperation() {
   auto input = std::dynamic_pointer_cast<const storage::TableRangeView>(getInputTable());
   if(input)
     row_offset = input->getStart();
+  const auto arena = getArena();
   if (_key == "groupby" || _key == "selfjoin" ) {
     if (_field_definition.size() == 1)
-        addResult(std::make_shared<storage::SingleAggregateHashTable>(getInputTable(), _field_definition, row_offset));
+        addResult(std::make_shared<storage::SingleAggregateHashTable>(getInputTable(), _field_definition, row_offset, arena));
       else
-        addResult(std::make_shared<storage::AggregateHashTable>(getInputTable(), _field_definition, row_offset));
+        addResult(std::make_shared<storage::AggregateHashTable>(getInputTable(), _field_definition, row_offset, arena));
   } else if (_key == "join") {
     if (_field_definition.size() == 1)
-      addResult(std::make_shared<storage::SingleJoinHashTable>(getInputTable(), _field_definition, row_offset));
+      addResult(std::make_shared<storage::SingleJoinHashTable>(getInputTable(), _field_definition, row_offset, arena));
     else
-      addResult(std::make_shared<storage::JoinHashTable>(getInputTable(), _field_definition, row_offset));
+      addResult(std::make_shared<storage::JoinHashTable>(getInputTable(), _field_definition, row_offset, arena));
   } else {
     throw std::runtime_error("Type in Plan operation HashBuild not supported; key: " + _key);
   }
@@ -60,5 +61,35 @@ const std::string HashBuild::getKey() const {
   return _key;
 }
 
+template <typename HashTable>
+void HashBuild::openHashTable(const storage::c_atable_ptr_t &table) {
+  auto hashTable = std::make_shared<HashTable>(table, _field_definition, pos_list_t(), getArena());
+  _insertBatch = [hashTable] (const pos_list_t &rows) { hashTable->insertRows(rows); };
+  addResult(hashTable);
+}
+
+storage::c_atable_ptr_t HashBuild::openStage(const storage::c_atable_ptr_t &table) {
+  addInput(table);
+  setupPlanOperation();
+  if (_key == "groupby" || _key == "selfjoin") {
+    if (_field_definition.size() == 1)
+      openHashTable<storage::SingleAggregateHashTable>(table);
+    else
+      openHashTable<storage::AggregateHashTable>(table);
+  } else if (_key == "join") {
+    if (_field_definition.size() == 1)
+      openHashTable<storage::SingleJoinHashTable>(table);
+    else
+      openHashTable<storage::JoinHashTable>(table);
+  } else {
+    throw std::runtime_error("Type in Plan operation HashBuild not supported; key: " + _key);
+  }
+  return table;
+}
+
+void HashBuild::processBatch(pos_list_t &rows) {
+  _insertBatch(rows);
+}
+
 }
 }
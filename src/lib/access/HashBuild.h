@@ -2,12 +2,15 @@
 #ifndef SRC_LIB_ACCESS_HASHBUILD_H_
 #define SRC_LIB_ACCESS_HASHBUILD_H_
 
+#include <functional>
+
 #include "access/system/ParallelizablePlanOperation.h"
+#include "access/system/PipelineStage.h"
 
 namespace hyrise {
 namespace access {
 
-class HashBuild : public ParallelizablePlanOperation {
+class HashBuild : public ParallelizablePlanOperation, public PipelineStage {
 public:
   virtual ~HashBuild();
 
@@ -31,8 +34,20 @@ public:
   void setKey(const std::string &key);
   const std::string getKey() const;
 
+  /// As the breaker of a pipeline the hash table is created when the
+  /// stage is opened and filled with every batch
+  storage::c_atable_ptr_t openStage(const storage::c_atable_ptr_t &table);
+  void processBatch(pos_list_t &rows);
+  bool isBreaker() const {
+    return true;
+  }
+
 private:
+  template <typename HashTable>
+  void openHashTable(const storage::c_atable_ptr_t &table);
+
   std::string _key;
+  std::function<void(const pos_list_t &)> _insertBatch;
 };
 
 }
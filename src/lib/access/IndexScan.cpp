@@ -8,10 +8,14 @@
 #include "access/system/QueryParser.h"
 
 #include "io/StorageManager.h"
+#include "io/TransactionManager.h"
 
+#include "storage/GroupKeyIndex.h"
 #include "storage/InvertedIndex.h"
+#include "storage/OrderedIndex.h"
 #include "storage/meta_storage.h"
 #include "storage/PointerCalculator.h"
+#include "storage/Store.h"
 
 namespace hyrise {
 namespace access {
@@ -20,30 +24,56 @@ struct CreateIndexValueFunctor {
   typedef AbstractIndexValue *value_type;
 
   const Json::Value &_d;
+  const char *_key;
 
-  explicit CreateIndexValueFunctor(const Json::Value &c): _d(c) {}
+  CreateIndexValueFunctor(const Json::Value &c, const char *key = "value"): _d(c), _key(key) {}
 
   template<typename R>
   value_type operator()() {
     IndexValue<R> *v = new IndexValue<R>();
-    v->value = json_converter::convert<R>(_d["value"]);
+    v->value = json_converter::convert<R>(_d[_key]);
     return v;
   }
 };
 
+template<typename T>
+storage::pos_list_t prefixLookup(const storage::OrderedIndex<T>&, const T&) {
+  throw std::runtime_error("Prefix lookups are only supported on string columns");
+}
+
+storage::pos_list_t prefixLookup(const storage::OrderedIndex<hyrise_string_t>& index, const hyrise_string_t& prefix) {
+  return index.getPositionsForPrefix(prefix);
+}
+
 struct ScanIndexFunctor {
   typedef storage::pos_list_t *value_type;
 
   std::shared_ptr<storage::AbstractIndex> _index;
   AbstractIndexValue *_indexValue;
+  AbstractIndexValue *_indexValueMax;
+  bool _prefix;
 
-  ScanIndexFunctor(AbstractIndexValue *i, std::shared_ptr<storage::AbstractIndex> d):
-    _index(d), _indexValue(i) {}
+  ScanIndexFunctor(AbstractIndexValue *i, AbstractIndexValue *max, bool prefix, std::shared_ptr<storage::AbstractIndex> d):
+    _index(d), _indexValue(i), _indexValueMax(max), _prefix(prefix) {}
 
   template<typename ValueType>
   value_type operator()() {
-    auto idx = std::dynamic_pointer_cast<storage::InvertedIndex<ValueType>>(_index);
     auto v = static_cast<IndexValue<ValueType>*>(_indexValue);
+    if (auto ordered = std::dynamic_pointer_cast<storage::OrderedIndex<ValueType>>(_index)) {
+      if (_prefix)
+        return new storage::pos_list_t(prefixLookup(*ordered, v->value));
+      if (_indexValueMax != nullptr)
+        return new storage::pos_list_t(ordered->getPositionsForRange(v->value, static_cast<IndexValue<ValueType>*>(_indexValueMax)->value));
+      return new storage::pos_list_t(ordered->getPositionsForKey(v->value));
+    }
+
+    if (_prefix || _indexValueMax != nullptr)
+      throw std::runtime_error("Range and prefix lookups require an ordered index");
+    if (auto groupKey = std::dynamic_pointer_cast<storage::GroupKeyIndex<ValueType>>(_index))
+      return new storage::pos_list_t(groupKey->getPositionsForKey(v->value));
+    auto idx = std::dynamic_pointer_cast<storage::InvertedIndex<ValueType>>(_index);
+    if (idx == nullptr)
+      throw std::runtime_error("Index does not match the type of the column");
     storage::pos_list_t *result = new storage::pos_list_t(idx->getPositionsForKey(v->value));
     return result;
   }
@@ -55,6 +85,7 @@ namespace {
 
 IndexScan::~IndexScan() {
   delete _value;
+  delete _valueMax;
 }
 
 void IndexScan::executePlanOperation() {
@@ -63,9 +94,18 @@ void IndexScan::executePlanOperation() {
 
   // Handle type of index and value
   storage::type_switch<hyrise_basic_types> ts;
-  ScanIndexFunctor fun(_value, idx);
+  ScanIndexFunctor fun(_value, _valueMax, _prefix, idx);
   storage::pos_list_t *pos = ts(input.getTable(0)->typeOfColumn(_field_definition[0]), fun);
 
+  // Indexes on a store contain all row versions, scans outside of a
+  // transaction see the last committed state
+  if (auto store = std::dynamic_pointer_cast<const storage::Store>(input.getTable(0))) {
+    if (_txContext.tid == tx::UNKNOWN)
+      store->validatePositions(*pos, tx::TransactionManager::getInstance().getLastCommitId(), tx::MERGE_TID);
+    else
+      store->validatePositions(*pos, _txContext.lastCid, _txContext.tid);
+  }
+
   addResult(storage::PointerCalculator::create(input.getTable(0), pos));
 }
 
@@ -74,6 +114,11 @@ std::shared_ptr<PlanOperation> IndexScan::parse(const Json::Value &data) {
   storage::type_switch<hyrise_basic_types> ts;
   CreateIndexValueFunctor civf(data);
   s->_value = ts(data["vtype"].asUInt(), civf);
+  if (data.isMember("value_max")) {
+    CreateIndexValueFunctor max(data, "value_max");
+    s->_valueMax = ts(data["vtype"].asUInt(), max);
+  }
+  s->_prefix = data.get("prefix", false).asBool();
   s->_indexName = data["index"].asString();
   return s;
 }
@@ -86,6 +131,10 @@ void IndexScan::setIndexName(const std::string &name) {
   _indexName = name;
 }
 
+void IndexScan::setPrefix(bool prefix) {
+  _prefix = prefix;
+}
+
 namespace {
   auto _2 = QueryParser::registerPlanOperation<MergeIndexScan>("MergeIndexScan");
 }
@@ -17,8 +17,10 @@ public:
   value_type value;
 };
 
-/// Scan an existing index for the result. Currently only EQ predicates
-/// allowed for the index.
+/// Scan an existing index for the result. Inverted indexes only allow EQ
+/// predicates, ordered indexes additionally serve closed ranges (value to
+/// value_max) and prefixes of strings. Positions of indexes on a store are
+/// validated against the snapshot of the transaction.
 class IndexScan : public PlanOperation {
 public:
   virtual ~IndexScan();
@@ -33,10 +35,21 @@ public:
     val->value = value;
     _value = static_cast<AbstractIndexValue*>(val);
   }
+  /// Upper bound of a range lookup, including value_max
+  template<typename T>
+  void setValueMax(const T value) {
+    auto val = new IndexValue<T>();
+    val->value = value;
+    _valueMax = static_cast<AbstractIndexValue*>(val);
+  }
+  /// Matches all strings that start with the value
+  void setPrefix(bool prefix);
 
 private:
   std::string _indexName;
-  AbstractIndexValue *_value;
+  AbstractIndexValue *_value = nullptr;
+  AbstractIndexValue *_valueMax = nullptr;
+  bool _prefix = false;
 };
 
 
@@ -87,12 +87,15 @@ void InsertScan::executePlanOperation() {
 
   const size_t firstPosition = store->getMainTable()->size() + writeArea.first;
 
-  // Get the modifications record
-  auto& mods = tx::TransactionManager::getInstance()[_txContext.tid];
+  // Record all inserted rows in the modifications record at once
+  tx::TXModificationBatch batch(tx::TransactionManager::getInstance()[_txContext.tid], store);
   for(size_t i=0, upper = _data->size(); i < upper; ++i) {
+    // the row is locked before it is filled
+    batch.inserted(firstPosition+i);
     store->copyRowToDelta(_data, i, writeArea.first+i, _txContext.tid);
-    mods.insertPos(store, firstPosition+i);
   }
+  batch.flush();
+  store->addToIndexes(firstPosition, _data->size());
 
   auto rsp = getResponseTask();
   if (rsp != nullptr)
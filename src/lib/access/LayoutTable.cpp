@@ -26,7 +26,7 @@ void LayoutTable::executePlanOperation() {
     throw std::runtime_error("Input is not a store");
 
   auto main = store->getMainTable();
-  auto dest = createEmptyLayoutedTable(_layout);
+  auto dest = createEmptyLayoutedTable(_layout, input.getTable());
 
   // Add all table to the game
   std::vector<storage::c_atable_ptr_t> tables { main, store->getDeltaTable() };
@@ -49,7 +49,8 @@ const std::string LayoutTable::vname() {
   return "LayoutTable";
 }
 
-storage::atable_ptr_t LayoutTable::createEmptyLayoutedTable(const std::string &layout) const {
+storage::atable_ptr_t LayoutTable::createEmptyLayoutedTable(const std::string &layout,
+                                                            const storage::c_atable_ptr_t &reference) {
   // Prepare the new table by defining an empty input and load the
   // partitioning for the table from the string header
   io::EmptyInput input;
@@ -59,7 +60,7 @@ storage::atable_ptr_t LayoutTable::createEmptyLayoutedTable(const std::string &l
   p.setInput(input);
   p.setHeader(header);
   p.setReturnsMutableVerticalTable(true);
-  p.setReferenceTable(this->input.getTable());
+  p.setReferenceTable(reference);
   return io::Loader::load(p);
 }
 
@@ -20,8 +20,12 @@ public:
   static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
   const std::string vname();
 
+  /// Creates an empty table with the columns of reference partitioned
+  /// according to the header layout
+  static storage::atable_ptr_t createEmptyLayoutedTable(const std::string &layout,
+                                                        const storage::c_atable_ptr_t &reference);
+
 private:
-  storage::atable_ptr_t createEmptyLayoutedTable(const std::string &layout) const;
   const std::string _layout;
 };
 
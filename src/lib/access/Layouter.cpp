@@ -2,6 +2,7 @@
 #include "access/Layouter.h"
 
 #include "access/system/QueryParser.h"
+#include "layouter/calibration.h"
 #include "storage/DictionaryFactory.h"
 #include "storage/OrderIndifferentDictionary.h"
 #include "storage/Table.h"
@@ -11,11 +12,13 @@ namespace access {
 
 namespace {
   auto _ = QueryParser::registerPlanOperation<LayoutSingleTable>("LayoutSingleTable");
+  auto _2 = QueryParser::registerPlanOperation<CalibrateLayouter>("CalibrateLayouter");
 }
 
 LayoutSingleTable::LayoutSingleTable() : _numRows(0),
                                          _layouter(CandidateLayouter),
-                                         _maxResults(1) {
+                                         _maxResults(1),
+                                         _costModel(HYRISE_COST) {
 }
 
 LayoutSingleTable::~LayoutSingleTable() {
@@ -49,7 +52,7 @@ void LayoutSingleTable::executePlanOperation() {
       break;
   }
 
-  bl->layout(s, HYRISE_COST);
+  bl->layout(s, _costModel);
   r = bl->getNBestResults(_maxResults);
   size = bl->count();
 
@@ -153,6 +156,9 @@ std::shared_ptr<PlanOperation> LayoutSingleTable::parse(const Json::Value &data)
   else
     s->setMaxResults(10);
 
+  if (data.isMember("cost_model"))
+    s->setCostModel(data["cost_model"].asString());
+
   return s;
 }
 
@@ -183,6 +189,12 @@ void LayoutSingleTable::setMaxResults(const size_t n) {
   _maxResults = n;
 }
 
+void LayoutSingleTable::setCostModel(const std::string &costModel) {
+  if (costModel != HYRISE_COST && costModel != CALIBRATED_COST)
+    throw std::runtime_error("Cost model not available, chose " HYRISE_COST " or " CALIBRATED_COST);
+  _costModel = costModel;
+}
+
 layouter::Query *LayoutSingleTable::parseQuery(const BaseQuery &q) {
   layouter::LayouterConfiguration::access_type_t t = (q.selectivity == 1.0 ?
       layouter::LayouterConfiguration::access_type_fullprojection :
@@ -193,6 +205,48 @@ layouter::Query *LayoutSingleTable::parseQuery(const BaseQuery &q) {
 
   return q1;
 }
+void CalibrateLayouter::executePlanOperation() {
+  const auto calibration = layouter::CostCalibration::measure();
+  if (!_path.empty())
+    calibration.save(_path);
+  layouter::CostCalibration::setCurrent(calibration);
+
+  storage::metadata_list vc;
+  vc.push_back(storage::ColumnMetadata::metadataFromString("INTEGER", "bytes"));
+  vc.push_back(storage::ColumnMetadata::metadataFromString("FLOAT", "sequential"));
+  vc.push_back(storage::ColumnMetadata::metadataFromString("FLOAT", "random"));
+
+  std::vector<storage::AbstractTable::SharedDictionaryPtr > vd;
+  vd.push_back(storage::makeDictionary(IntegerTypeDelta));
+  vd.push_back(storage::makeDictionary(FloatTypeDelta));
+  vd.push_back(storage::makeDictionary(FloatTypeDelta));
+
+  const auto &levels = calibration.levels();
+  auto result = std::make_shared<storage::Table>(&vc, &vd, levels.size(), false);
+  result->resize(levels.size());
+  for (size_t i = 0; i < levels.size(); ++i) {
+    result->setValue<hyrise_int_t>(0, i, levels[i].bytes);
+    result->setValue<float>(1, i, levels[i].sequential);
+    result->setValue<float>(2, i, levels[i].random);
+  }
+
+  addResult(result);
+}
+
+std::shared_ptr<PlanOperation> CalibrateLayouter::parse(const Json::Value &data) {
+  auto c = std::make_shared<CalibrateLayouter>();
+  if (data.isMember("path"))
+    c->setPath(data["path"].asString());
+  return c;
+}
+
+const std::string CalibrateLayouter::vname() {
+  return "CalibrateLayouter";
+}
+
+void CalibrateLayouter::setPath(const std::string &path) {
+  _path = path;
+}
 
 }
 }
@@ -38,6 +38,8 @@ public:
   /// plan op. All additional layouts are added as new rows to the
   /// result table.
   void setMaxResults(const size_t n);
+  /// Cost model of the layouter, HYRISE_COST or CALIBRATED_COST
+  void setCostModel(const std::string &costModel);
 
 private:
   typedef std::vector<std::string> names_list_t;
@@ -52,6 +54,23 @@ private:
   size_t _numRows;
   layouter_type _layouter;
   size_t _maxResults;
+  std::string _costModel;
+};
+
+/// Measures the memory hierarchy for the CALIBRATED_COST model of the
+/// layouter and makes the result the current calibration. Returns one
+/// row per measured working set size with the time in ns to load a
+/// cache line sequentially and in random order.
+class CalibrateLayouter : public PlanOperation {
+public:
+  void executePlanOperation();
+  static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
+  const std::string vname();
+  /// Also writes the calibration to path, to be loaded on startup
+  void setPath(const std::string &path);
+
+private:
+  std::string _path;
 };
 
 }
@@ -14,16 +14,17 @@ namespace {
 
 void MergeHashTables::executePlanOperation() {
   // get first HashTable and merge subsequent tables into HashTable
+  const auto arena = getArena();
   if (_key == "groupby" || _key == "selfjoin" ) {
   	if (getInputHashTable(0)->getFieldCount() == 1)
-  		addResult(std::make_shared<storage::SingleAggregateHashTable>(input.getHashTables()));
+  		addResult(std::make_shared<storage::SingleAggregateHashTable>(input.getHashTables(), arena));
   	else
-  		addResult(std::make_shared<storage::AggregateHashTable>(input.getHashTables()));
+  		addResult(std::make_shared<storage::AggregateHashTable>(input.getHashTables(), arena));
   } else if (_key == "join") {
   	if (getInputHashTable(0)->getFieldCount() == 1)
-  		addResult(std::make_shared<storage::SingleJoinHashTable>(input.getHashTables()));
+  		addResult(std::make_shared<storage::SingleJoinHashTable>(input.getHashTables(), arena));
   	else
-  		addResult(std::make_shared<storage::JoinHashTable>(input.getHashTables()));
+  		addResult(std::make_shared<storage::JoinHashTable>(input.getHashTables(), arena));
   } else {
     throw std::runtime_error("Type in Plan operation HashBuild not supported; key: " + _key);
   }
@@ -0,0 +1,34 @@
+#include "access/OperatorProfileHandler.h"
+
+#include "json.h"
+#include "net/AbstractConnection.h"
+#include "access/system/OperatorProfile.h"
+
+namespace hyrise {
+namespace access {
+
+bool OperatorProfileHandler::registered =
+    net::Router::registerRoute<OperatorProfileHandler>("/profile/");
+
+OperatorProfileHandler::OperatorProfileHandler(net::AbstractConnection *data)
+    : _connection_data(data) {}
+
+std::string OperatorProfileHandler::name() {
+  return "OperatorProfileHandler";
+}
+
+const std::string OperatorProfileHandler::vname() {
+  return "OperatorProfileHandler";
+}
+
+std::string OperatorProfileHandler::constructResponse() {
+  Json::StyledWriter writer;
+  return writer.write(OperatorProfile::getInstance().summary());
+}
+
+void OperatorProfileHandler::operator()() {
+  std::string response(constructResponse());
+  _connection_data->respond(response);
+}
+}
+}
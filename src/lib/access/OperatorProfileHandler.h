@@ -0,0 +1,25 @@
+#ifndef SRC_LIB_ACCESS_OPERATORPROFILEHANDLER_H
+#define SRC_LIB_ACCESS_OPERATORPROFILEHANDLER_H
+
+#include "net/Router.h"
+
+namespace hyrise {
+namespace net { class AbstractConnection; }
+namespace access {
+
+/// Responds with the rolling summary of the OperatorProfile
+class OperatorProfileHandler : public net::AbstractRequestHandler {
+  static bool registered;
+  net::AbstractConnection *_connection_data;
+ public:
+  explicit OperatorProfileHandler(net::AbstractConnection *data);
+  std::string constructResponse();
+  void operator()();
+  static std::string name();
+  const std::string vname();
+};
+
+}}
+
+
+#endif
@@ -0,0 +1,85 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/Pipeline.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "access/system/PipelineStage.h"
+#include "storage/AbstractHashTable.h"
+#include "storage/PointerCalculator.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+  auto _ = QueryParser::registerPlanOperation<Pipeline>("Pipeline");
+}
+
+const size_t Pipeline::batch_size;
+
+void Pipeline::executePlanOperation() {
+  if (_stages.empty())
+    throw std::runtime_error("Pipeline without stages");
+
+  const size_t rows = getInputTable()->size();
+  std::vector<PipelineStage *> stages;
+  storage::c_atable_ptr_t table = getInputTable();
+  for (const auto& op : _stages) {
+    stages.push_back(dynamic_cast<PipelineStage *>(op.get()));
+    table = stages.back()->openStage(table);
+  }
+
+  const bool breaker = stages.back()->isBreaker();
+  pos_list_t *positions = breaker ? nullptr : new pos_list_t;
+  pos_list_t batch;
+  batch.reserve(batch_size);
+  for (size_t first = 0; first < rows; first += batch_size) {
+    batch.resize(std::min(batch_size, rows - first));
+    std::iota(batch.begin(), batch.end(), first);
+    for (const auto& stage : stages) {
+      stage->processBatch(batch);
+      if (batch.empty())
+        break;
+    }
+    if (positions)
+      positions->insert(positions->end(), batch.begin(), batch.end());
+  }
+
+  if (breaker) {
+    addResult(_stages.back()->getResultHashTable());
+    if (_forwardTable)
+      addResult(table);
+  } else {
+    addResult(storage::PointerCalculator::create(table, positions));
+  }
+}
+
+std::shared_ptr<PlanOperation> Pipeline::parse(const Json::Value &data) {
+  auto pipeline = std::make_shared<Pipeline>();
+  for (unsigned i = 0; i < data["stages"].size(); ++i) {
+    const Json::Value &stage = data["stages"][i];
+    pipeline->addStage(QueryParser::instance().parse(stage["type"].asString(), stage));
+  }
+  pipeline->setForwardTable(data["table"].asBool());
+  return pipeline;
+}
+
+const std::string Pipeline::vname() {
+  return "Pipeline";
+}
+
+void Pipeline::addStage(const std::shared_ptr<PlanOperation> &stage) {
+  if (dynamic_cast<PipelineStage *>(stage.get()) == nullptr)
+    throw std::runtime_error(stage->planOperationName() + " cannot be a stage of a pipeline");
+  if (!_stages.empty() && dynamic_cast<PipelineStage *>(_stages.back().get())->isBreaker())
+    throw std::runtime_error("Only the last stage of a pipeline can be a breaker");
+  _stages.push_back(stage);
+}
+
+void Pipeline::setForwardTable(bool forward) {
+  _forwardTable = forward;
+}
+
+}
+}
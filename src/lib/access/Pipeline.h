@@ -0,0 +1,57 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_PIPELINE_H_
+#define SRC_LIB_ACCESS_PIPELINE_H_
+
+#include <memory>
+#include <vector>
+
+#include "access/system/PlanOperation.h"
+
+namespace hyrise {
+namespace access {
+
+/// Runs a chain of plan operations on its input in batches of rows.
+///
+/// Every stage has to implement PipelineStage. Batches of batch_size rows
+/// pass through all stages, so a scan that feeds a hash build never
+/// materializes its position list. If the last stage is a breaker its
+/// result, e.g. the hash table of a HashBuild, is the result of the
+/// pipeline, with "table" the table the breaker indexes is passed on as
+/// well. Otherwise the rows that passed all stages are returned.
+///
+/// {
+///     "operators": {
+///         "0": {"type": "TableLoad", "table": "revenue", "filename": "tables/revenue.tbl"},
+///         "1": {
+///             "type": "Pipeline",
+///             "stages": [
+///                 {"type": "SimpleTableScan", "predicates": [{"type": "GT", "in": 0, "f": "year", "vtype": 0, "value": 2009}]},
+///                 {"type": "ProjectionScan", "fields": ["year", "amount"]},
+///                 {"type": "HashBuild", "fields": ["year"], "key": "groupby"}
+///             ],
+///             "table": true
+///         },
+///         "2": {"type": "GroupByScan", "fields": ["year"], "functions": [{"type": "SUM", "field": "amount"}]}
+///     },
+///     "edges": [["0", "1"], ["1", "2"]]
+/// }
+class Pipeline : public PlanOperation {
+ public:
+  static const size_t batch_size = 1024;
+
+  void executePlanOperation();
+  static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
+  const std::string vname();
+
+  void addStage(const std::shared_ptr<PlanOperation> &stage);
+  void setForwardTable(bool forward);
+
+ private:
+  std::vector<std::shared_ptr<PlanOperation>> _stages;
+  bool _forwardTable = false;
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_PIPELINE_H_
@@ -0,0 +1,107 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/PipelineTransformation.h"
+
+#include <algorithm>
+
+#include "access/system/QueryTransformationEngine.h"
+
+namespace hyrise {
+namespace access {
+
+bool PipelineTransformation::transformation_is_registered = QueryTransformationEngine::registerTransformation<PipelineTransformation>();
+
+bool PipelineTransformation::isFusable(const Json::Value &op) const {
+  // Parallel instances, dynamic parallelization and materialization need
+  // the operator on its own
+  if (op["instances"].asUInt() >= 2 || op["dynamic"].asBool() || op.isMember("part") || op.isMember("count") ||
+      op.isMember("input") || op["positions"].asBool())
+    return false;
+  if (op["type"] == "SimpleTableScan")
+    return !op["materializing"].asBool() && !op["ofDelta"].asBool();
+  if (op["type"] == "ProjectionScan")
+    return op["limit"].asUInt() == 0;
+  return false;
+}
+
+std::vector<std::string> PipelineTransformation::getInputIds(const std::string &id, const Json::Value &query) const {
+  std::vector<std::string> inputs;
+  for (unsigned i = 0; i < query["edges"].size(); ++i) {
+    if (query["edges"][i][1u] == id)
+      inputs.push_back(query["edges"][i][0u].asString());
+  }
+  return inputs;
+}
+
+std::vector<std::string> PipelineTransformation::getOutputIds(const std::string &id, const Json::Value &query) const {
+  std::vector<std::string> outputs;
+  for (unsigned i = 0; i < query["edges"].size(); ++i) {
+    if (query["edges"][i][0u] == id)
+      outputs.push_back(query["edges"][i][1u].asString());
+  }
+  return outputs;
+}
+
+void PipelineTransformation::transform(Json::Value &op, const std::string &operatorId, Json::Value &query) {
+  if (!query["pipelined"].asBool() || op["instances"].asUInt() >= 2 || op.isMember("input"))
+    return;
+
+  const auto hashOutputs = getOutputIds(operatorId, query);
+  // Fused operators from the HashBuild upwards
+  std::vector<std::string> chain;
+  bool forwardTable = false;
+  std::string current = operatorId;
+  for (auto inputs = getInputIds(current, query); inputs.size() == 1; inputs = getInputIds(current, query)) {
+    const std::string candidate = inputs[0];
+    if (!isFusable(query["operators"][candidate]) || getInputIds(candidate, query).size() != 1)
+      break;
+
+    bool shared = false, usedElsewhere = false;
+    for (const auto& output : getOutputIds(candidate, query)) {
+      if (output == current)
+        continue;
+      // GroupByScans with fields only read the rows of the hash table
+      const Json::Value &consumer = query["operators"][output];
+      if (chain.empty() && consumer["type"] == "GroupByScan" && consumer["fields"].size() > 0 &&
+          std::find(hashOutputs.begin(), hashOutputs.end(), output) != hashOutputs.end())
+        shared = true;
+      else
+        usedElsewhere = true;
+    }
+    if (usedElsewhere)
+      break;
+
+    forwardTable |= shared;
+    chain.push_back(candidate);
+    current = candidate;
+  }
+  if (chain.empty())
+    return;
+
+  const std::string source = getInputIds(chain.back(), query)[0];
+  Json::Value pipeline;
+  pipeline["type"] = "Pipeline";
+  pipeline["table"] = forwardTable;
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    pipeline["stages"].append(query["operators"][*it]);
+  pipeline["stages"].append(query["operators"][operatorId]);
+
+  Json::Value remainingEdges(Json::arrayValue);
+  for (unsigned i = 0; i < query["edges"].size(); ++i) {
+    const Json::Value &edge = query["edges"][i];
+    if (std::find(chain.begin(), chain.end(), edge[0u].asString()) == chain.end() &&
+        std::find(chain.begin(), chain.end(), edge[1u].asString()) == chain.end())
+      remainingEdges.append(edge);
+  }
+  Json::Value edge(Json::arrayValue);
+  edge.append(source);
+  edge.append(operatorId);
+  remainingEdges.append(edge);
+  query["edges"] = remainingEdges;
+
+  for (const auto& id : chain)
+    query["operators"].removeMember(id);
+  query["operators"][operatorId] = pipeline;
+}
+
+}
+}
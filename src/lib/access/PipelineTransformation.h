@@ -0,0 +1,44 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_PIPELINETRANSFORMATION_H_
+#define SRC_LIB_ACCESS_PIPELINETRANSFORMATION_H_
+
+#include <string>
+#include <vector>
+
+#include <json.h>
+#include "access/system/AbstractPlanOpTransformation.h"
+
+namespace hyrise {
+namespace access {
+
+/*
+ * Fuses the chain of scans and projections in front of a HashBuild into a
+ * Pipeline if the query sets "pipelined". The chain ends at the first
+ * operator that is not a non-materializing, sequential SimpleTableScan or
+ * ProjectionScan or whose result is used elsewhere. Only GroupByScans that
+ * also use the hash table may share the input of the HashBuild, they get
+ * the table from the pipeline instead. The pipeline keeps the id of the
+ * HashBuild.
+ */
+class PipelineTransformation : public AbstractPlanOpTransformation {
+  static bool transformation_is_registered;
+
+  bool isFusable(const Json::Value &op) const;
+  std::vector<std::string> getInputIds(const std::string &id, const Json::Value &query) const;
+  std::vector<std::string> getOutputIds(const std::string &id, const Json::Value &query) const;
+
+public:
+  PipelineTransformation() {}
+  virtual ~PipelineTransformation() {}
+
+  void transform(Json::Value &op, const std::string &operatorId, Json::Value &query);
+
+  static const std::string name() {
+    return "HashBuild";
+  }
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_PIPELINETRANSFORMATION_H_
@@ -42,24 +42,29 @@ void PosUpdateScan::executePlanOperation() {
 
   // Get the modification record for the current transaction
   auto& txmgr = tx::TransactionManager::getInstance();
-  auto& modRecord = txmgr[_txContext.tid];
+  tx::TXModificationBatch batch(txmgr[_txContext.tid], store);
 
   // Functor we use for updating the data
   set_json_value_functor fun(store->getDeltaTable());
   storage::type_switch<hyrise_basic_types> ts;
 
+  const auto& positions = *(c_pc->getPositions());
   size_t counter = 0;
-  for(const auto& p : *(c_pc->getPositions())) {
+  for(const auto& p : positions) {
     // First delete the old record
-    bool deleteOk = store->markForDeletion(p, _txContext.tid) == tx::TX_CODE::TX_OK;
-    if(!deleteOk) {
+    auto result = store->markForDeletion(p, _txContext.tid);
+    if(result != tx::TX_CODE::TX_OK) {
+      // Rows locked and inserted so far have to be known to the rollback
+      batch.flush();
       txmgr.rollbackTransaction(_txContext);
-      throw std::runtime_error("Aborted TX because TID of other TX found");
+      if (result == tx::TX_CODE::TX_FAIL_LOCK_TIMEOUT)
+        throw std::runtime_error("Aborted TX because row stayed locked by another TX for longer than the lock wait timeout");
+      throw std::runtime_error("Aborted TX because row was modified by a concurrent TX");
     }
-    modRecord.deletePos(store, p);
-    //store->setTid(p, _txContext.tid);
+    batch.deleted(p);
 
-    // Copy the old row from the main
+    // Copy the old row from the main, it is locked before it is filled
+    batch.inserted(firstPosition+counter);
     store->copyRowToDelta(store, p, writeArea.first+counter, _txContext.tid);
     // Update all the necessary values
     for(const auto& kv : _raw_data) {
@@ -68,10 +73,11 @@ void PosUpdateScan::executePlanOperation() {
       ts(store->typeOfColumn(fld), fun);
     }
 
-    // Insert the new one
-    modRecord.insertPos(store, firstPosition+counter);
     ++counter;
   }
+  // Record the deleted old and inserted new versions at once
+  batch.flush();
+  store->addToIndexes(firstPosition, counter);
 
   // Update affected rows
   auto rsp = getResponseTask();
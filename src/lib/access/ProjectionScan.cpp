@@ -1,6 +1,8 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "access/ProjectionScan.h"
 
+#include <stdexcept>
+
 #include "access/system/QueryParser.h"
 #include "access/system/BasicParser.h"
 
@@ -45,5 +47,14 @@ const std::string ProjectionScan::vname() {
   return "ProjectionScan";
 }
 
+storage::c_atable_ptr_t ProjectionScan::openStage(const storage::c_atable_ptr_t &table) {
+  if (_limit != 0)
+    throw std::runtime_error("ProjectionScan with a limit cannot be pipelined");
+  addInput(table);
+  setupPlanOperation();
+  // Without positions the projection keeps the row ids of table
+  return storage::PointerCalculator::create(table, nullptr, new std::vector<field_t>(_field_definition));
+}
+
 }
 }
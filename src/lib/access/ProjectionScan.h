@@ -3,16 +3,20 @@
 #define SRC_LIB_ACCESS_PROJECTIONSCAN_H_
 
 #include "access/system/PlanOperation.h"
+#include "access/system/PipelineStage.h"
 
 namespace hyrise {
 namespace access {
 
-class ProjectionScan : public PlanOperation {
+class ProjectionScan : public PlanOperation, public PipelineStage {
 public:
   void setupPlanOperation();
   void executePlanOperation();
   static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
   const std::string vname();
+
+  storage::c_atable_ptr_t openStage(const storage::c_atable_ptr_t &table);
+  void processBatch(pos_list_t &rows) {}
 };
 
 }
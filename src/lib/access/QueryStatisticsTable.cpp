@@ -0,0 +1,85 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/QueryStatisticsTable.h"
+
+#include "access/system/QueryParser.h"
+#include "access/system/QueryStatistics.h"
+
+#include "storage/TableBuilder.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+  auto _ = QueryParser::registerPlanOperation<QueryStatisticsTable>("QueryStatisticsTable");
+
+  hyrise_float_t toMs(uint64_t ns) {
+    return ns / 1000000.0;
+  }
+}
+
+QueryStatisticsTable::QueryStatisticsTable(bool operators, bool reset) : _operators(operators), _reset(reset) {}
+
+void QueryStatisticsTable::executePlanOperation() {
+  auto& statistics = QueryStatistics::getInstance();
+  const auto queries = statistics.summary();
+
+  storage::TableBuilder::param_list list;
+  list.append().set_type("STRING").set_name("plan_hash");
+  if (_operators) {
+    list.append().set_type("STRING").set_name("operator");
+    list.append().set_type("INTEGER").set_name("executions");
+    list.append().set_type("FLOAT").set_name("total_ms");
+    list.append().set_type("FLOAT").set_name("mean_ms");
+    list.append().set_type("INTEGER").set_name("mean_memory");
+  } else {
+    list.append().set_type("STRING").set_name("query");
+    list.append().set_type("INTEGER").set_name("calls");
+    list.append().set_type("INTEGER").set_name("errors");
+    list.append().set_type("FLOAT").set_name("total_ms");
+    list.append().set_type("FLOAT").set_name("mean_ms");
+    list.append().set_type("FLOAT").set_name("p99_ms");
+    list.append().set_type("INTEGER").set_name("rows");
+    list.append().set_type("INTEGER").set_name("mean_memory");
+  }
+  auto result = storage::TableBuilder::build(list);
+
+  size_t row = 0;
+  for (const auto& query : queries) {
+    if (_operators) {
+      for (const auto& op : query.operators) {
+        result->resize(row + 1);
+        result->setValue<hyrise_string_t>(0, row, query.planHash);
+        result->setValue<hyrise_string_t>(1, row, op.name);
+        result->setValue<hyrise_int_t>(2, row, op.executions);
+        result->setValue<hyrise_float_t>(3, row, toMs(op.timeNs));
+        result->setValue<hyrise_float_t>(4, row, toMs(op.timeNs) / op.executions);
+        result->setValue<hyrise_int_t>(5, row, op.memory / op.executions);
+        ++row;
+      }
+    } else {
+      result->resize(row + 1);
+      result->setValue<hyrise_string_t>(0, row, query.planHash);
+      result->setValue<hyrise_string_t>(1, row, query.query);
+      result->setValue<hyrise_int_t>(2, row, query.calls);
+      result->setValue<hyrise_int_t>(3, row, query.errors);
+      result->setValue<hyrise_float_t>(4, row, toMs(query.latencyNs));
+      result->setValue<hyrise_float_t>(5, row, toMs(query.latencyNs) / query.calls);
+      result->setValue<hyrise_float_t>(6, row, toMs(query.p99LatencyNs));
+      result->setValue<hyrise_int_t>(7, row, query.rows);
+      result->setValue<hyrise_int_t>(8, row, query.memory / query.calls);
+      ++row;
+    }
+  }
+
+  if (_reset)
+    statistics.clear();
+
+  addResult(result);
+}
+
+std::shared_ptr<PlanOperation> QueryStatisticsTable::parse(const Json::Value &data) {
+  return std::make_shared<QueryStatisticsTable>(data.get("operators", false).asBool(), data.get("reset", false).asBool());
+}
+
+}
+}
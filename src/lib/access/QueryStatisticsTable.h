@@ -0,0 +1,32 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_QUERYSTATISTICSTABLE_H_
+#define SRC_LIB_ACCESS_QUERYSTATISTICSTABLE_H_
+
+#include "access/system/PlanOperation.h"
+
+namespace hyrise {
+namespace access {
+
+/// Reports the statistics of all queries the server executed, see
+/// QueryStatistics, one row per plan hash ordered by descending total
+/// time. With "operators": true there is one row per operation of every
+/// plan instead, with "reset": true the statistics are reset after they
+/// were read.
+///
+///     "0": {"type": "QueryStatisticsTable", "operators": false, "reset": false}
+class QueryStatisticsTable : public PlanOperation {
+ public:
+  QueryStatisticsTable(bool operators = false, bool reset = false);
+
+  void executePlanOperation();
+  static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
+
+ private:
+  bool _operators;
+  bool _reset;
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_QUERYSTATISTICSTABLE_H_
@@ -234,6 +234,7 @@ std::vector<taskscheduler::task_ptr_t> RadixJoin::applyDynamicParallelization(si
 void RadixJoin::copyTaskAttributesFromThis(std::shared_ptr<PlanOperation> to){
     to->setPriority(_priority);
     to->setSessionId(_sessionId);
+    to->setDeadline(_deadline);
     to->setPlanId(_planId);
     to->setTXContext(_txContext);
     to->setId(_txContext.tid);
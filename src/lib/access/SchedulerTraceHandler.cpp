@@ -0,0 +1,46 @@
+#include "access/SchedulerTraceHandler.h"
+
+#include <sstream>
+
+#include "helper/HttpHelper.h"
+#include "net/AbstractConnection.h"
+#include "taskscheduler/SchedulerTracer.h"
+
+namespace hyrise {
+namespace access {
+
+bool SchedulerTraceHandler::registered =
+    net::Router::registerRoute<SchedulerTraceHandler>("/trace/");
+
+SchedulerTraceHandler::SchedulerTraceHandler(net::AbstractConnection *data)
+    : _connection_data(data) {}
+
+std::string SchedulerTraceHandler::name() {
+  return "SchedulerTraceHandler";
+}
+
+const std::string SchedulerTraceHandler::vname() {
+  return "SchedulerTraceHandler";
+}
+
+std::string SchedulerTraceHandler::constructResponse() {
+  auto& tracer = taskscheduler::SchedulerTracer::getInstance();
+  if (_connection_data->hasBody()) {
+    auto form = parseHTTPFormData(_connection_data->getBody());
+    if (form.count("enable"))
+      tracer.setEnabled(form["enable"] == "true");
+    if (form["clear"] == "true")
+      tracer.clear();
+  }
+
+  std::ostringstream trace;
+  tracer.writeChromeTrace(trace);
+  return trace.str();
+}
+
+void SchedulerTraceHandler::operator()() {
+  std::string response(constructResponse());
+  _connection_data->respond(response);
+}
+}
+}
@@ -0,0 +1,27 @@
+#ifndef SRC_LIB_ACCESS_SCHEDULERTRACEHANDLER_H
+#define SRC_LIB_ACCESS_SCHEDULERTRACEHANDLER_H
+
+#include "net/Router.h"
+
+namespace hyrise {
+namespace net { class AbstractConnection; }
+namespace access {
+
+/// Controls the SchedulerTracer and responds with its timeline as Chrome
+/// trace JSON. A request with the form data enable=true or enable=false
+/// turns tracing on or off, clear=true drops the recorded events.
+class SchedulerTraceHandler : public net::AbstractRequestHandler {
+  static bool registered;
+  net::AbstractConnection *_connection_data;
+ public:
+  explicit SchedulerTraceHandler(net::AbstractConnection *data);
+  std::string constructResponse();
+  void operator()();
+  static std::string name();
+  const std::string vname();
+};
+
+}}
+
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "helper/checked_cast.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace hyrise {
@@ -27,6 +28,13 @@ SimpleTableScan::~SimpleTableScan() {
 
 void SimpleTableScan::setupPlanOperation() {
   _comparator->walk(input.getTables());
+  _compiled = CompiledExpression::compile(_comparator, input.getTable(0));
+}
+
+field_list_t SimpleTableScan::accessedFields() const {
+  field_list_t fields;
+  _comparator->collectFields(fields);
+  return fields;
 }
 
 void SimpleTableScan::executePositional() {
@@ -35,9 +43,13 @@ void SimpleTableScan::executePositional() {
 
 
   size_t row = _ofDelta ? checked_pointer_cast<const storage::Store>(tbl)->deltaOffset() : 0;
-  for (size_t input_size=tbl->size(); row < input_size; ++row) {
-    if ((*_comparator)(row)) {
-      pos_list->push_back(row);
+  if (_compiled) {
+    _compiled->match(row, tbl->size(), *pos_list);
+  } else {
+    for (size_t input_size=tbl->size(); row < input_size; ++row) {
+      if ((*_comparator)(row)) {
+        pos_list->push_back(row);
+      }
     }
   }
   addResult(storage::PointerCalculator::create(tbl, pos_list));
@@ -49,6 +61,17 @@ void SimpleTableScan::executeMaterialized() {
   size_t target_row = 0;
 
   size_t row = _ofDelta ? checked_pointer_cast<const storage::Store>(tbl)->deltaOffset() : 0;
+  if (_compiled) {
+    pos_list_t positions;
+    _compiled->match(row, tbl->size(), positions);
+    result_table->resize(positions.size());
+    for (const auto& p : positions) {
+      result_table->copyRowFrom(tbl, p, target_row++, true /* Copy Value*/, false /* Use Memcpy */);
+    }
+    addResult(result_table);
+    return;
+  }
+
   for (size_t input_size=tbl->size();
        row < input_size;
        ++row) {
@@ -102,5 +125,24 @@ void SimpleTableScan::setPredicate(SimpleExpression *c) {
   _comparator = c;
 }
 
+storage::c_atable_ptr_t SimpleTableScan::openStage(const storage::c_atable_ptr_t &table) {
+  addInput(table);
+  setupPlanOperation();
+  return table;
+}
+
+void SimpleTableScan::processBatch(pos_list_t &rows) {
+  if (rows.empty())
+    return;
+  // The first filter of a pipeline sees a range of rows and runs the kernel
+  if (_compiled && rows.back() - rows.front() + 1 == rows.size()) {
+    const size_t start = rows.front(), stop = rows.back() + 1;
+    rows.clear();
+    _compiled->match(start, stop, rows);
+    return;
+  }
+  rows.erase(std::remove_if(rows.begin(), rows.end(), [this] (pos_t row) { return !(*_comparator)(row); }), rows.end());
+}
+
 }
 }
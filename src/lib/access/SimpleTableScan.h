@@ -3,12 +3,14 @@
 #define SRC_LIB_ACCESS_SIMPLETABLESCAN_H_
 
 #include "access/system/ParallelizablePlanOperation.h"
+#include "access/system/PipelineStage.h"
 #include "access/expressions/pred_SimpleExpression.h"
+#include "access/expressions/pred_CompiledExpression.h"
 
 namespace hyrise {
 namespace access {
 
-class SimpleTableScan : public ParallelizablePlanOperation {
+class SimpleTableScan : public ParallelizablePlanOperation, public PipelineStage {
 public:
   SimpleTableScan();
   virtual ~SimpleTableScan();
@@ -21,8 +23,16 @@ public:
   const std::string vname();
   void setPredicate(SimpleExpression *c);
 
+  storage::c_atable_ptr_t openStage(const storage::c_atable_ptr_t &table);
+  void processBatch(pos_list_t &rows);
+
+protected:
+  field_list_t accessedFields() const;
+
 private:
   SimpleExpression *_comparator;
+  // Fused kernel for the comparator if its shape is supported
+  std::unique_ptr<CompiledExpression> _compiled;
   bool _ofDelta = false;
 };
 
@@ -111,6 +111,7 @@ std::vector<taskscheduler::task_ptr_t> TableScan::applyDynamicParallelization(si
     t->setCount(dynamicCount);
     t->setPriority(_priority);
     t->setSessionId(_sessionId);
+    t->setDeadline(_deadline);
     t->setPlanId(_planId);
     t->setTXContext(_txContext);
     t->setId(_txContext.tid);
@@ -135,6 +136,7 @@ std::vector<taskscheduler::task_ptr_t> TableScan::applyDynamicParallelization(si
   unionall->setProducesPositions(producesPositions);
   unionall->setPriority(_priority);
   unionall->setSessionId(_sessionId);
+  unionall->setDeadline(_deadline);
   unionall->setPlanId(_planId);
   unionall->setTXContext(_txContext);
   unionall->setId(_txContext.tid);
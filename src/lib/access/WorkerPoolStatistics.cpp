@@ -0,0 +1,60 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/WorkerPoolStatistics.h"
+
+#include "access/system/QueryParser.h"
+
+#include "storage/TableBuilder.h"
+
+#include "taskscheduler/CentralScheduler.h"
+#include "taskscheduler/SharedScheduler.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+  auto _ = QueryParser::registerPlanOperation<WorkerPoolStatistics>("WorkerPoolStatistics");
+
+  hyrise_float_t toMs(epoch_t ns) {
+    return ns / 1000000.0;
+  }
+}
+
+void WorkerPoolStatistics::executePlanOperation() {
+  const auto scheduler = std::dynamic_pointer_cast<taskscheduler::CentralScheduler>(
+      taskscheduler::SharedScheduler::getInstance().getScheduler());
+  if (!scheduler)
+    throw std::runtime_error("WorkerPoolStatistics requires the CentralScheduler");
+  const auto pool = scheduler->getPoolStatistics();
+
+  storage::TableBuilder::param_list list;
+  list.append().set_type("INTEGER").set_name("workers");
+  list.append().set_type("INTEGER").set_name("blocked");
+  list.append().set_type("INTEGER").set_name("idle");
+  list.append().set_type("INTEGER").set_name("max_workers");
+  list.append().set_type("INTEGER").set_name("spawned");
+  list.append().set_type("INTEGER").set_name("retired");
+  list.append().set_type("FLOAT").set_name("busy_ms");
+  list.append().set_type("FLOAT").set_name("blocked_ms");
+  list.append().set_type("FLOAT").set_name("utilization");
+  auto result = storage::TableBuilder::build(list);
+
+  result->resize(1);
+  result->setValue<hyrise_int_t>(0, 0, pool.workers);
+  result->setValue<hyrise_int_t>(1, 0, pool.blocked);
+  result->setValue<hyrise_int_t>(2, 0, pool.idle);
+  result->setValue<hyrise_int_t>(3, 0, pool.maxWorkers);
+  result->setValue<hyrise_int_t>(4, 0, pool.spawned);
+  result->setValue<hyrise_int_t>(5, 0, pool.retired);
+  result->setValue<hyrise_float_t>(6, 0, toMs(pool.busyTime));
+  result->setValue<hyrise_float_t>(7, 0, toMs(pool.blockedTime));
+  result->setValue<hyrise_float_t>(8, 0, pool.utilization);
+
+  addResult(result);
+}
+
+std::shared_ptr<PlanOperation> WorkerPoolStatistics::parse(const Json::Value &data) {
+  return std::make_shared<WorkerPoolStatistics>();
+}
+
+}
+}
@@ -0,0 +1,25 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_WORKERPOOLSTATISTICS_H_
+#define SRC_LIB_ACCESS_WORKERPOOLSTATISTICS_H_
+
+#include "access/system/PlanOperation.h"
+
+namespace hyrise {
+namespace access {
+
+/// Reports the worker pool of the CentralScheduler as a single row: the
+/// threads, blocked and idle workers, the maximum of running workers, the
+/// threads the pool added and retired, the time spent in tasks and
+/// blocked in them, and the utilization of the workers since startup.
+///
+///     "0": {"type": "WorkerPoolStatistics"}
+class WorkerPoolStatistics : public PlanOperation {
+ public:
+  void executePlanOperation();
+  static std::shared_ptr<PlanOperation> parse(const Json::Value &data);
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_WORKERPOOLSTATISTICS_H_
@@ -3,20 +3,21 @@
 
 #include "helper/types.h"
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 
 namespace hyrise {
 namespace access {
 
+/// Matches values in [lower_value, upper_value], evaluated as a value id
+/// range on order-preserving dictionaries and once per distinct value on
+/// unordered ones, e.g. the delta of a store
 template <typename T>
 class BetweenExpression : public SimpleFieldExpression {
  private:
-  ValueId lower_bound;
-  ValueId upper_bound;
   T lower_value;
   T upper_value;
-  std::shared_ptr<storage::BaseDictionary<T>> valueIdMap;
-  bool lower_value_exists;
-  bool upper_value_exists;
+  DictionaryFilter<T> filter;
+  bool useFilter = false;
  public:
 
   BetweenExpression(size_t i, field_t f, T _lower_value, T _upper_value):
@@ -34,35 +35,25 @@ class BetweenExpression : public SimpleFieldExpression {
   virtual void walk(const std::vector<storage::c_atable_ptr_t > &l) {
     SimpleFieldExpression::walk(l);
 
-    valueIdMap = std::dynamic_pointer_cast<storage::BaseDictionary<T>>(table->dictionaryAt(field));
-
-    lower_bound.table = 0;
-    lower_bound.valueId = valueIdMap->getValueIdForValue(lower_value);
-    lower_value_exists = valueIdMap->isValueIdValid(lower_bound.valueId) && lower_value == valueIdMap->getValueForValueId(lower_bound.valueId);
-    upper_bound.table = 0;
-    upper_bound.valueId = valueIdMap->getValueIdForValue(upper_value);
-    upper_value_exists = valueIdMap->isValueIdValid(upper_bound.valueId) && upper_value == valueIdMap->getValueForValueId(upper_bound.valueId);
+    const T lower = lower_value;
+    const T upper = upper_value;
+    useFilter = filter.buildRange(table, field, [lower, upper] (const T& v) {
+        if (v < lower)
+          return -1;
+        return upper < v ? 1 : 0;
+      });
   }
 
 
   virtual ~BetweenExpression() {}
 
-  inline virtual bool operator()(size_t row) {
-    ValueId valueId = table->getValueId(field, row);
-
-    if ((valueId.table == lower_bound.table) && (valueId.table == upper_bound.table)) {
-      if ((valueId.valueId <= upper_bound.valueId) && (valueId.valueId >= lower_bound.valueId)) {
-        return true;
-      }
-
-      if ((valueId.valueId > upper_bound.valueId) || (valueId.valueId < lower_bound.valueId)) {
-        return false;
-      }
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return useFilter ? &filter.parts() : nullptr;
+  }
 
-      if (upper_value_exists && lower_value_exists) {
-        return false;
-      }
-    }
+  inline virtual bool operator()(size_t row) {
+    if (useFilter)
+      return filter(table->getValueId(field, row));
 
     T value = table->getValue<T>(field, row);
     return (value <= upper_value) && (value >= lower_value);
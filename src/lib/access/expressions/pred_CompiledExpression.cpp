@@ -0,0 +1,165 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/expressions/pred_CompiledExpression.h"
+
+#include <algorithm>
+
+#include "access/expressions/pred_CompoundExpression.h"
+#include "storage/FixedLengthVector.h"
+#include "storage/PointerCalculator.h"
+#include "storage/Store.h"
+
+namespace hyrise {
+namespace access {
+
+const size_t CompiledExpression::MAX_CONJUNCTS;
+
+namespace {
+
+typedef CompiledExpression::leaf_t leaf_t;
+
+template <bool Raw>
+inline bool matches(const leaf_t& leaf, size_t local_row, size_t row) {
+  const value_id_t vid = Raw ? leaf.data[local_row * leaf.stride + leaf.offset] : leaf.vector->get(leaf.offset, local_row);
+  const auto& filter = *leaf.filter;
+  if (vid < filter.size) {
+    if (filter.ordered)
+      return vid >= filter.begin && vid < filter.end;
+    return filter.matches[vid];
+  }
+  // Values added to the dictionary after the filter was built
+  return (*leaf.expression)(row);
+}
+
+template <size_t I, size_t N, bool Raw>
+struct Conjunction {
+  static inline bool eval(const leaf_t *leaves, size_t local_row, size_t row) {
+    return matches<Raw>(leaves[I], local_row, row) && Conjunction<I + 1, N, Raw>::eval(leaves, local_row, row);
+  }
+};
+
+template <size_t N, bool Raw>
+struct Conjunction<N, N, Raw> {
+  static inline bool eval(const leaf_t *, size_t, size_t) {
+    return true;
+  }
+};
+
+template <size_t N, bool Raw>
+void scanPart(const leaf_t *leaves, size_t first_row, size_t from, size_t to, pos_list_t &positions) {
+  for (size_t local_row = from; local_row < to; ++local_row) {
+    if (Conjunction<0, N, Raw>::eval(leaves, local_row, first_row + local_row))
+      positions.push_back(first_row + local_row);
+  }
+}
+
+template <bool Raw>
+CompiledExpression::kernel_t kernelFor(size_t conjuncts) {
+  static_assert(CompiledExpression::MAX_CONJUNCTS == 4, "Instantiate a kernel for every number of conjuncts");
+  switch (conjuncts) {
+    case 1: return &scanPart<1, Raw>;
+    case 2: return &scanPart<2, Raw>;
+    case 3: return &scanPart<3, Raw>;
+    case 4: return &scanPart<4, Raw>;
+    default:
+      throw std::runtime_error("No kernel for " + std::to_string(conjuncts) + " conjuncts");
+  }
+}
+
+/// Collects the field predicates of a tree of AND nodes, fails on any
+/// other node, on predicates that were not evaluated on the dictionaries
+/// and on predicates that read another table than the scanned one
+bool collectConjuncts(SimpleExpression *expression, const storage::c_atable_ptr_t &table, std::vector<SimpleFieldExpression *>& conjuncts) {
+  if (auto compound = dynamic_cast<CompoundExpression *>(expression)) {
+    return compound->getType() == AND &&
+        collectConjuncts(compound->lhs, table, conjuncts) &&
+        collectConjuncts(compound->rhs, table, conjuncts);
+  }
+  auto field = dynamic_cast<SimpleFieldExpression *>(expression);
+  if (field == nullptr || field->dictionaryParts() == nullptr || field->getTable() != table)
+    return false;
+  conjuncts.push_back(field);
+  return true;
+}
+
+}
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(SimpleExpression *expression, const storage::c_atable_ptr_t &table) {
+  std::unique_ptr<CompiledExpression> result;
+
+  std::vector<SimpleFieldExpression *> conjuncts;
+  if (!collectConjuncts(expression, table, conjuncts) || conjuncts.size() > MAX_CONJUNCTS)
+    return result;
+
+  // Rows covered by each subtable, positions of a PointerCalculator do
+  // not map onto attribute vectors
+  std::vector<std::pair<size_t, size_t>> bounds;
+  const auto store = std::dynamic_pointer_cast<const storage::Store>(table);
+  if (store) {
+    bounds = {{0, store->deltaOffset()}, {store->deltaOffset(), store->size()}};
+  } else if (table->subtableCount() == 1 && !std::dynamic_pointer_cast<const storage::PointerCalculator>(table)) {
+    bounds = {{0, table->size()}};
+  } else {
+    return result;
+  }
+
+  result.reset(new CompiledExpression);
+  result->_parts.resize(bounds.size());
+  for (const auto& conjunct : conjuncts) {
+    const auto& filter_parts = *conjunct->dictionaryParts();
+    storage::attr_vectors_t vectors;
+    try {
+      vectors = table->getAttributeVectors(conjunct->getField());
+    } catch (const std::runtime_error&) {
+      return nullptr;
+    }
+    if (vectors.size() != bounds.size() || filter_parts.size() < bounds.size())
+      return nullptr;
+
+    for (size_t p = 0; p < bounds.size(); ++p) {
+      leaf_t leaf;
+      leaf.expression = conjunct;
+      leaf.filter = &filter_parts[p];
+      leaf.vector = std::dynamic_pointer_cast<storage::BaseAttributeVector<value_id_t>>(vectors[p].attribute_vector);
+      if (!leaf.vector)
+        return nullptr;
+      leaf.offset = vectors[p].attribute_offset;
+      if (auto fixed = std::dynamic_pointer_cast<storage::FixedLengthVector<value_id_t>>(leaf.vector)) {
+        leaf.data = static_cast<const value_id_t *>(fixed->data());
+        leaf.stride = fixed->columns();
+      } else {
+        leaf.data = nullptr;
+        leaf.stride = 0;
+      }
+      result->_parts[p].leaves.push_back(leaf);
+    }
+  }
+
+  for (size_t p = 0; p < bounds.size(); ++p) {
+    auto& part = result->_parts[p];
+    part.begin = bounds[p].first;
+    part.end = bounds[p].second;
+    part.delta_of = store && p == 1 ? store.get() : nullptr;
+    const bool raw = std::all_of(part.leaves.begin(), part.leaves.end(), [] (const leaf_t& leaf) { return leaf.data != nullptr; });
+    part.kernel = raw ? kernelFor<true>(conjuncts.size()) : kernelFor<false>(conjuncts.size());
+  }
+  return result;
+}
+
+void CompiledExpression::match(size_t start, size_t stop, pos_list_t &positions) const {
+  for (const auto& part : _parts) {
+    // The vector of the delta captured by compile() bounds the rows even
+    // if the store was merged since
+    const size_t end = part.delta_of ?
+        std::min(part.delta_of->size(), part.begin + part.leaves.front().vector->size()) : part.end;
+    const size_t from = std::max(start, part.begin);
+    const size_t to = std::min(stop, end);
+    if (from < to)
+      part.kernel(part.leaves.data(), part.begin, from - part.begin, to - part.begin, positions);
+  }
+}
+
+size_t CompiledExpression::conjuncts() const {
+  return _parts.empty() ? 0 : _parts.front().leaves.size();
+}
+
+} } // namespace hyrise::access
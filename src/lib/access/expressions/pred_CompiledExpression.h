@@ -0,0 +1,74 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "pred_common.h"
+#include "pred_DictionaryFilter.h"
+#include "storage/BaseAttributeVector.h"
+
+namespace hyrise {
+namespace storage {
+class Store;
+}
+
+namespace access {
+
+/// Fused scan kernels for conjunctions of field predicates.
+///
+/// Predicate trees built by buildExpression() are interpreted with one
+/// virtual call per node and row. Field predicates that were evaluated on
+/// the dictionaries during walk() (equality, ranges, LIKE and IN on int,
+/// float and string columns) reduce to checks of value ids, so a
+/// conjunction of up to MAX_CONJUNCTS of them is mapped onto a kernel that
+/// is instantiated at compile time per number of predicates and attribute
+/// vector layout. The kernel reads the attribute vectors of main and delta
+/// directly. All other shapes, including predicates on other inputs than
+/// the scanned table, are left to the interpreter.
+class CompiledExpression {
+ public:
+  static const size_t MAX_CONJUNCTS = 4;
+
+  /// One predicate bound to the attribute vector of one subtable
+  typedef struct {
+    SimpleFieldExpression *expression;
+    const dictionary_filter_part_t *filter;
+    std::shared_ptr<storage::BaseAttributeVector<value_id_t>> vector;
+    // Raw storage of fixed length vectors, nullptr otherwise
+    const value_id_t *data;
+    size_t stride;
+    size_t offset;
+  } leaf_t;
+
+  typedef void (*kernel_t)(const leaf_t *leaves, size_t first_row, size_t from, size_t to, pos_list_t &positions);
+
+  /// Returns a kernel for the walked expression on table, or nullptr if
+  /// the shape of the expression or the layout of the table is not
+  /// supported
+  static std::unique_ptr<CompiledExpression> compile(SimpleExpression *expression, const storage::c_atable_ptr_t &table);
+
+  /// Appends all matching rows in [start, stop) to positions
+  void match(size_t start, size_t stop, pos_list_t &positions) const;
+
+  /// Number of fused predicates
+  size_t conjuncts() const;
+
+ private:
+  CompiledExpression() {}
+
+  typedef struct {
+    // Rows of the table covered by this subtable
+    size_t begin;
+    size_t end;
+    // Store whose delta the subtable is, its end is read on every match
+    // as rows may be appended after compile()
+    const storage::Store *delta_of;
+    kernel_t kernel;
+    std::vector<leaf_t> leaves;
+  } part_t;
+
+  std::vector<part_t> _parts;
+};
+
+} } // namespace hyrise::access
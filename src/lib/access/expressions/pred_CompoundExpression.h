@@ -43,6 +43,14 @@ class CompoundExpression : public SimpleExpression {
     }
   }
 
+  virtual void collectFields(field_list_t &fields) const {
+    lhs->collectFields(fields);
+
+    if (!one_leg) {
+      rhs->collectFields(fields);
+    }
+  }
+
   inline virtual bool operator()(size_t row) {
     switch (type) {
       case AND:
@@ -63,6 +71,10 @@ class CompoundExpression : public SimpleExpression {
     }
   }
 
+  ExpressionType getType() const {
+    return type;
+  }
+
   inline void add(SimpleExpression *e) {
     if (!lhs) lhs = e;
     else if (!rhs) rhs = e;
@@ -0,0 +1,132 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "helper/types.h"
+
+#include <storage/AbstractTable.h>
+#include <storage/BaseDictionary.h>
+#include <storage/PointerCalculator.h>
+#include <storage/RawTable.h>
+
+namespace hyrise {
+namespace access {
+
+/// Matching value ids of one subtable of a DictionaryFilter
+typedef struct {
+  // Number of value ids known when the filter was built
+  value_id_t size;
+  bool ordered;
+  // Matching value id range of ordered dictionaries
+  value_id_t begin;
+  value_id_t end;
+  // Matching value ids of unordered dictionaries
+  std::vector<bool> matches;
+} dictionary_filter_part_t;
+
+/// Evaluates a predicate once per dictionary entry instead of once per row.
+///
+/// For every subtable of the column (e.g. main and delta of a store) the
+/// filter either stores a bitmap of matching value ids or, for range
+/// predicates on order-preserving dictionaries, the matching value id range.
+/// Value ids added to a dictionary after the filter was built, e.g. by
+/// concurrent inserts into the delta, are evaluated on their value.
+template <typename T>
+class DictionaryFilter {
+ public:
+  typedef std::function<bool(const T&)> predicate_t;
+  /// Classifies a value as below (-1), inside (0) or above (1) a range
+  typedef std::function<int(const T&)> range_t;
+
+  /// Matches all values for which predicate holds
+  /// \returns false if the column is not dictionary encoded
+  bool build(const storage::c_atable_ptr_t& table, field_t field, predicate_t predicate) {
+    _predicate = predicate;
+    return init(table, field, nullptr);
+  }
+
+  /// Matches all values inside the range. Ordered dictionaries are binary
+  /// searched for the bounds of the range, unordered ones are scanned.
+  /// \returns false if the column is not dictionary encoded
+  bool buildRange(const storage::c_atable_ptr_t& table, field_t field, range_t range) {
+    _predicate = [range] (const T& value) { return range(value) == 0; };
+    return init(table, field, range);
+  }
+
+  /// Matching value ids per subtable, indexed by table id
+  const std::vector<dictionary_filter_part_t>& parts() const {
+    return _parts;
+  }
+
+  inline bool operator()(const ValueId& valueId) const {
+    if (valueId.table < _parts.size()) {
+      const auto& part = _parts[valueId.table];
+      if (valueId.valueId < part.size) {
+        if (part.ordered)
+          return valueId.valueId >= part.begin && valueId.valueId < part.end;
+        return part.matches[valueId.valueId];
+      }
+    }
+    return _predicate(_table->getValueForValueId<T>(_field, valueId));
+  }
+
+ private:
+  bool init(const storage::c_atable_ptr_t& table, field_t field, const range_t& range) {
+    _table = table;
+    _field = field;
+    _parts.clear();
+
+    auto actual = table;
+    if (auto pc = std::dynamic_pointer_cast<const storage::PointerCalculator>(table))
+      actual = pc->getActualTable();
+    if (std::dynamic_pointer_cast<const storage::RawTable>(actual))
+      return false;
+
+    for (table_id_t t = 0; t < actual->subtableCount(); ++t) {
+      auto dict = std::dynamic_pointer_cast<storage::BaseDictionary<T>>(table->dictionaryByTableId(field, t));
+      if (!dict) {
+        _parts.clear();
+        return false;
+      }
+
+      dictionary_filter_part_t part;
+      const value_id_t size = part.size = dict->size();
+      part.ordered = range && dict->isOrdered();
+      if (part.ordered) {
+        part.begin = lowerBound(dict, size, [&range] (const T& v) { return range(v) < 0; });
+        part.end = lowerBound(dict, size, [&range] (const T& v) { return range(v) <= 0; });
+      } else {
+        part.matches.resize(size);
+        for (value_id_t vid = 0; vid < size; ++vid)
+          part.matches[vid] = _predicate(dict->getValueForValueId(vid));
+      }
+      _parts.push_back(std::move(part));
+    }
+    return true;
+  }
+
+  /// First value id for which below does not hold
+  template <typename Below>
+  static value_id_t lowerBound(const std::shared_ptr<storage::BaseDictionary<T>>& dict, value_id_t size, Below below) {
+    value_id_t first = 0;
+    while (size > 0) {
+      const value_id_t half = size / 2;
+      if (below(dict->getValueForValueId(first + half))) {
+        first += half + 1;
+        size -= half + 1;
+      } else {
+        size = half;
+      }
+    }
+    return first;
+  }
+
+  storage::c_atable_ptr_t _table;
+  field_t _field = 0;
+  predicate_t _predicate;
+  std::vector<dictionary_filter_part_t> _parts;
+};
+
+} } // namespace hyrise::access
@@ -4,6 +4,7 @@
 #include "helper/types.h"
 
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 
 // Required for Raw Table Scan
 #include <storage/RawTable.h>
@@ -14,9 +15,8 @@ namespace access {
 template <typename T>
 class EqualsExpression : public SimpleFieldExpression {
  private:
-  ValueId lower_bound;
-  std::shared_ptr<storage::BaseDictionary<T>> valueIdMap;
-  bool value_exists;
+  DictionaryFilter<T> filter;
+  bool useFilter = false;
 
  public:
 
@@ -36,13 +36,15 @@ class EqualsExpression : public SimpleFieldExpression {
 
   virtual void walk(const std::vector<storage::c_atable_ptr_t > &l) {
     SimpleFieldExpression::walk(l);
-    valueIdMap = std::dynamic_pointer_cast<storage::BaseDictionary<T>>(table->dictionaryAt(field));
 
-    value_exists = valueIdMap->valueExists(value);
-
-    if (value_exists) {
-      lower_bound = table->getValueIdForValue(field, value);
-    }
+    // Main and delta have separate dictionaries, so the value id of the
+    // value is looked up per subtable
+    const T v = value;
+    useFilter = filter.buildRange(table, field, [v] (const T& other) {
+        if (other < v)
+          return -1;
+        return v < other ? 1 : 0;
+      });
   }
  
   virtual std::unique_ptr<AbstractExpression> clone(){
@@ -51,8 +53,14 @@ class EqualsExpression : public SimpleFieldExpression {
 
   virtual ~EqualsExpression() { }
 
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return useFilter ? &filter.parts() : nullptr;
+  }
+
   inline virtual bool operator()(size_t row) {
-    return value_exists && table->getValueId(field, row) == lower_bound;
+    if (useFilter)
+      return filter(table->getValueId(field, row));
+    return table->getValue<T>(field, row) == value;
   }
 };
 
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 
 namespace hyrise {
 namespace access {
@@ -9,10 +10,9 @@ namespace access {
 template <typename T>
 class GreaterThanExpression : public SimpleFieldExpression {
  private:
-  ValueId lower_bound;
   T value;
-  std::shared_ptr<storage::BaseDictionary<T>> valueIdMap;
-  bool value_exists;
+  DictionaryFilter<T> filter;
+  bool useFilter = false;
 
  public:
 
@@ -32,30 +32,19 @@ class GreaterThanExpression : public SimpleFieldExpression {
   virtual void walk(const std::vector<storage::c_atable_ptr_t > &l) {
     SimpleFieldExpression::walk(l);
 
-    valueIdMap = std::dynamic_pointer_cast<storage::BaseDictionary<T>>(table->dictionaryAt(field));
-    lower_bound.table = 0;
-    lower_bound.valueId = valueIdMap->getValueIdForValue(value);
-    value_exists = valueIdMap->isValueIdValid(lower_bound.valueId) &&
-        value == valueIdMap->getValueForValueId(lower_bound.valueId);
+    const T bound = value;
+    useFilter = filter.buildRange(table, field, [bound] (const T& v) {
+        return bound < v ? 0 : -1;
+      });
   }
 
-  inline virtual bool operator()(size_t row) {
-    ValueId valueId = table->getValueId(field, row);
-
-    if (valueId.table == lower_bound.table) {
-      if (valueId.valueId > lower_bound.valueId) {
-        return true;
-      }
-
-      if (valueId.valueId < lower_bound.valueId) {
-        return false;
-      }
-
-      if (value_exists) {
-        return false;
-      }
-    }
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return useFilter ? &filter.parts() : nullptr;
+  }
 
+  inline virtual bool operator()(size_t row) {
+    if (useFilter)
+      return filter(table->getValueId(field, row));
     return table->getValue<T>(field, row) > value;
   }
 };
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 #include <vector>
 #include <algorithm>
 #include <json.h>
@@ -20,6 +21,7 @@ namespace access {
 ///         "predicates":[{ "type" : "IN", "in" : 0, "f" : "quarter", "vtype" : 0, "value": [2, 3, 4] }]
 ///     }
 /// This is equal to the mysql syntax: SELECT * FROM table WHERE quarter IN(2,3,4);
+/// On dictionary encoded columns the list is probed once per distinct value.
 ///
 template <typename T>
 class InExpression : public SimpleFieldExpression {
@@ -39,16 +41,35 @@ public:
     values(getValues(value))
   {}
 
+  virtual void walk(const std::vector<storage::c_atable_ptr_t > &l) {
+    SimpleFieldExpression::walk(l);
+
+    std::vector<T> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    useFilter = filter.build(table, field, [sorted] (const T& v) {
+        return std::binary_search(sorted.begin(), sorted.end(), v);
+      });
+  }
+
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return useFilter ? &filter.parts() : nullptr;
+  }
+
   ///
   /// @return true if the value at column[field,row] matches any values of the list named "values"
   ///
   inline virtual bool operator()(size_t row) {
+    if (useFilter)
+      return filter(table->getValueId(field, row));
+
     T currentValue = table->getValue<T>(field, row);
     return std::find(values.cbegin(), values.cend(), currentValue) != values.cend();
   }
 
 private:
   const std::vector<T> values;
+  DictionaryFilter<T> filter;
+  bool useFilter = false;
   ///
   /// converts the string containing the values to a vector of values of the right type
   /// @return list of values to compare
@@ -4,8 +4,10 @@
 #include <boost/regex.hpp>
 
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 #include <helper/types.h>
-#include <boost/regex.hpp>
+
+#include "optional.hpp"
 
 namespace hyrise {
 namespace access {
@@ -20,36 +22,94 @@ namespace access {
 /// { "type" : "LIKE", "in" : 0, "f" : "employee_name", "vtype" : 2, "value": "Jeffre. .\\. .*ley" } \n
 /// matches employee_name "Jeffrey O. Henley".
 ///
+/// On dictionary encoded columns the regex is evaluated once per distinct
+/// value. Plain prefix patterns ("abc.*") are evaluated as value id ranges
+/// on order-preserving dictionaries.
+///
 class LikeExpression : public SimpleFieldExpression {
 public:
   LikeExpression(size_t i, field_t f, const hyrise_string_t& value) :
     SimpleFieldExpression(i, f),
-    regExpr(boost::regex(value))
+    regExpr(boost::regex(value)),
+    prefix(literalPrefix(value))
   { }
 
   LikeExpression(size_t i, field_name_t f, const hyrise_string_t& value) :
     SimpleFieldExpression(i, f),
-    regExpr(boost::regex(value))
+    regExpr(boost::regex(value)),
+    prefix(literalPrefix(value))
   { }
 
   LikeExpression(const storage::c_atable_ptr_t& _table, field_t _field, const hyrise_string_t& value) :
     SimpleFieldExpression(_table, _field),
-    regExpr(boost::regex(value))
+    regExpr(boost::regex(value)),
+    prefix(literalPrefix(value))
   { }
 
+  virtual void walk(const std::vector<storage::c_atable_ptr_t > &l) {
+    SimpleFieldExpression::walk(l);
+
+    if (prefix) {
+      const hyrise_string_t p = *prefix;
+      useFilter = filter.buildRange(table, field, [p] (const hyrise_string_t& v) {
+          if (v.compare(0, p.size(), p) == 0)
+            return 0;
+          return v < p ? -1 : 1;
+        });
+    } else {
+      // The filter keeps the predicate for values added to the dictionary later
+      const boost::regex re = regExpr;
+      useFilter = filter.build(table, field, [re] (const hyrise_string_t& v) {
+          return boost::regex_match(v, re);
+        });
+    }
+  }
+
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return useFilter ? &filter.parts() : nullptr;
+  }
+
   ///
   /// Applies the like expression on each field using the generated regex object.
   /// @return true if current line matches the regular expression.
   ///
   inline virtual bool operator()(size_t row) {
+    if (useFilter)
+      return filter(table->getValueId(field, row));
+
     std::string currentValue = std::string(table->getValue<hyrise_string_t>(field, row));
 
     return boost::regex_match(currentValue, regExpr);
   }
 
 private:
+  /// Returns the literal prefix if the pattern has the form "prefix.*"
+  /// without any other regex syntax
+  static std::optional<hyrise_string_t> literalPrefix(const hyrise_string_t& pattern) {
+    static const std::string special = ".[]{}()\\*+?|^$";
+    if (pattern.size() < 2 || pattern.compare(pattern.size() - 2, 2, ".*") != 0)
+      return std::optional<hyrise_string_t>();
+
+    hyrise_string_t result;
+    for (size_t i = 0; i < pattern.size() - 2; ++i) {
+      if (pattern[i] == '\\' && i + 1 < pattern.size() - 2 && special.find(pattern[i + 1]) != std::string::npos) {
+        result.push_back(pattern[++i]);
+      } else if (special.find(pattern[i]) != std::string::npos) {
+        return std::optional<hyrise_string_t>();
+      } else {
+        result.push_back(pattern[i]);
+      }
+    }
+    return result;
+  }
+
   /// Hold the regular expression object. Generated in constructor.
   const boost::regex regExpr;
+  /// Literal prefix of prefix patterns
+  const std::optional<hyrise_string_t> prefix;
+
+  DictionaryFilter<hyrise_string_t> filter;
+  bool useFilter = false;
 };
 
 } } // namesapce hyrise::access
@@ -25,6 +25,9 @@ class SimpleExpression : public access::AbstractExpression {
   inline virtual bool operator()(size_t row) {
     throw std::runtime_error("Cannot call base class");
   }
+
+  /// Adds the fields read by the expression to fields, valid after walk()
+  virtual void collectFields(field_list_t &fields) const {}
 };
 
 } } // namespace hyrise::access
@@ -3,6 +3,7 @@
 
 #include "helper/types.h"
 #include "pred_common.h"
+#include "pred_DictionaryFilter.h"
 
 namespace hyrise {
 namespace access {
@@ -47,6 +48,25 @@ class SimpleFieldExpression : public SimpleExpression {
   inline virtual bool operator()(size_t row) {
     throw std::runtime_error("Cannot call base class");
   }
+
+  field_t getField() const {
+    return field;
+  }
+
+  /// Table the field is read from, set by walk()
+  const storage::c_atable_ptr_t& getTable() const {
+    return table;
+  }
+
+  virtual void collectFields(field_list_t &fields) const {
+    fields.push_back(field);
+  }
+
+  /// Matching value ids per subtable of the field if the expression was
+  /// evaluated on the dictionaries during walk(), nullptr otherwise
+  virtual const std::vector<dictionary_filter_part_t>* dictionaryParts() const {
+    return nullptr;
+  }
 };
 
 template <typename T, class Op = std::equal_to<T> >
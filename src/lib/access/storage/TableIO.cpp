@@ -10,6 +10,8 @@
 
 #include <storage/Store.h>
 
+#include <taskscheduler/BlockingRegion.h>
+
 #include <helper/checked_cast.h>
 
 namespace hyrise { namespace access  {
@@ -27,6 +29,7 @@ void DumpTable::executePlanOperation() {
   const auto& tab = std::const_pointer_cast<storage::Store>(c_tab);
   tab->merge();
   storage::SimpleTableDump dump(Settings::getInstance()->getDBPath());
+  taskscheduler::BlockingRegion blocking;
   dump.dump(_name, tab);
 
   // No Output here
@@ -42,7 +45,11 @@ void LoadDumpedTable::executePlanOperation() {
   io::TableDumpLoader input(Settings::getInstance()->getDBPath(), _name);
   io::CSVHeader header(Settings::getInstance()->getDBPath() + "/" + _name + "/header.dat", io::CSVHeader::params().setCSVParams(io::csv::HYRISE_FORMAT));
 
-  auto t = io::Loader::load(io::Loader::params().setInput(input).setHeader(header));
+  std::shared_ptr<storage::AbstractTable> t;
+  {
+    taskscheduler::BlockingRegion blocking;
+    t = io::Loader::load(io::Loader::params().setInput(input).setHeader(header));
+  }
   addResult(checked_pointer_cast<storage::Store>(t));
 }
 
@@ -7,6 +7,8 @@
 #include "io/shortcuts.h"
 #include "io/StorageManager.h"
 
+#include "taskscheduler/BlockingRegion.h"
+
 #include "log4cxx/logger.h"
 
 namespace hyrise {
@@ -29,6 +31,8 @@ TableLoad::~TableLoad() {
 void TableLoad::executePlanOperation() {
   auto sm = io::StorageManager::getInstance();
   if (!sm->exists(_table_name)) {
+    // reading the files blocks the worker
+    taskscheduler::BlockingRegion blocking;
 
     // Load Raw Table
     if (_raw) {
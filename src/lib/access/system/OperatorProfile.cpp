@@ -0,0 +1,81 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/system/OperatorProfile.h"
+
+#include <algorithm>
+
+namespace hyrise {
+namespace access {
+
+namespace {
+
+void addCounter(RollingAverage<double>& average, int64_t value) {
+  if (value >= 0)
+    average.add(value);
+}
+
+}
+
+OperatorProfile& OperatorProfile::getInstance() {
+  static OperatorProfile profile;
+  return profile;
+}
+
+OperatorProfile::OperatorProfile() : _profileAll(false), _window(DEFAULT_WINDOW) {}
+
+void OperatorProfile::setProfileAll(bool profileAll) {
+  _profileAll = profileAll;
+}
+
+bool OperatorProfile::profilesAll() const {
+  return _profileAll;
+}
+
+void OperatorProfile::setWindow(size_t window) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _window = std::max<size_t>(window, 1);
+  _operations.clear();
+}
+
+void OperatorProfile::record(const std::string& operationType, int64_t wallTimeNs, const perf_counters_t& counters) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  auto operation = _operations.find(operationType);
+  if (operation == _operations.end())
+    operation = _operations.emplace(operationType, operation_profile_t(_window)).first;
+
+  auto& profile = operation->second;
+  ++profile.executions;
+  profile.wallTime.add(wallTimeNs);
+  if (counters.cycles >= 0)
+    ++profile.counted;
+  addCounter(profile.cycles, counters.cycles);
+  addCounter(profile.instructions, counters.instructions);
+  addCounter(profile.llcMisses, counters.llcMisses);
+  addCounter(profile.branchMisses, counters.branchMisses);
+}
+
+Json::Value OperatorProfile::summary() const {
+  Json::Value result(Json::objectValue);
+  std::lock_guard<std::mutex> lock(_mtx);
+  for (const auto& operation : _operations) {
+    const auto& profile = operation.second;
+    Json::Value element;
+    element["executions"] = Json::Value((Json::UInt64) profile.executions);
+    element["wallTimeNs"] = profile.wallTime.getAverage();
+    if (profile.counted > 0) {
+      element["cycles"] = profile.cycles.getAverage();
+      element["instructions"] = profile.instructions.getAverage();
+      element["llcMisses"] = profile.llcMisses.getAverage();
+      element["branchMisses"] = profile.branchMisses.getAverage();
+    }
+    result[operation.first] = element;
+  }
+  return result;
+}
+
+void OperatorProfile::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _operations.clear();
+}
+
+}
+}
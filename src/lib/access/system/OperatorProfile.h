@@ -0,0 +1,70 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "json.h"
+
+#include "helper/noncopyable.h"
+#include "helper/PerfEventTracer.h"
+#include "helper/RollingAverage.h"
+
+namespace hyrise {
+namespace access {
+
+/// Rolling summary of the wall time and hardware counters of the plan
+/// operations executed, per operation type.
+///
+/// Plan operations of queries that request performance data are always
+/// recorded, all others only while profileAll is set. Averages are taken
+/// over the last window executions of a type, hardware counters the
+/// machine does not provide are left out. The summary is served as JSON
+/// under /profile/.
+class OperatorProfile : noncopyable {
+ public:
+  static const size_t DEFAULT_WINDOW = 1000;
+
+  static OperatorProfile& getInstance();
+
+  void setProfileAll(bool profileAll);
+  bool profilesAll() const;
+
+  /// Number of executions per type the averages are taken over, clears
+  /// the summary
+  void setWindow(size_t window);
+
+  void record(const std::string& operationType, int64_t wallTimeNs, const perf_counters_t& counters);
+
+  /// Executions and average wall time in ns and counters per type
+  Json::Value summary() const;
+
+  void clear();
+
+ private:
+  typedef struct operation_profile_t {
+    explicit operation_profile_t(size_t window) :
+        executions(0), counted(0), wallTime(window), cycles(window), instructions(window), llcMisses(window), branchMisses(window) {}
+
+    size_t executions;
+    // executions with hardware counters
+    size_t counted;
+    RollingAverage<double> wallTime;
+    RollingAverage<double> cycles;
+    RollingAverage<double> instructions;
+    RollingAverage<double> llcMisses;
+    RollingAverage<double> branchMisses;
+  } operation_profile_t;
+
+  OperatorProfile();
+
+  std::atomic<bool> _profileAll;
+  size_t _window;
+  mutable std::mutex _mtx;
+  std::map<std::string, operation_profile_t> _operations;
+};
+
+}
+}
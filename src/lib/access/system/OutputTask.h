@@ -10,6 +10,7 @@
 
 #include <storage/storage_types.h>
 #include "helper/epoch.h"
+#include "helper/PerfEventTracer.h"
 #include "taskscheduler/Task.h"
 
 namespace hyrise { namespace access {
@@ -35,6 +36,8 @@ typedef struct {
   epoch_t startTime;
   epoch_t endTime;
   std::string executingThread;
+  // of the execution of the operation itself, -1 if not measured
+  perf_counters_t counters;
 } performance_attributes_t;
 
 typedef std::vector<std::unique_ptr<performance_attributes_t>> performance_vector_t;
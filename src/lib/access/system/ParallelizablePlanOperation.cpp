@@ -1,5 +1,6 @@
 #include "access/system/ParallelizablePlanOperation.h"
 
+#include "helper/QueryArena.h"
 #include "storage/TableRangeView.h"
 
 namespace hyrise {  namespace access {
@@ -18,7 +19,8 @@ void ParallelizablePlanOperation::splitInput() {
   const auto& tables = input.getTables();
   if (_count > 0 && !tables.empty()) {
     auto r = distribute(tables[0]->size(), _part, _count);
-    input.setTable(storage::TableRangeView::create(std::const_pointer_cast<storage::AbstractTable>(tables[0]), r.first, r.second), 0);
+    input.setTable(std::allocate_shared<storage::TableRangeView>(ArenaAllocator<storage::TableRangeView>(getArena()),
+                                                                 std::const_pointer_cast<storage::AbstractTable>(tables[0]), r.first, r.second), 0);
   }
 }
 
@@ -0,0 +1,40 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_ACCESS_SYSTEM_PIPELINESTAGE_H_
+#define SRC_LIB_ACCESS_SYSTEM_PIPELINESTAGE_H_
+
+#include "helper/types.h"
+#include "storage/storage_types.h"
+
+namespace hyrise {
+namespace access {
+
+/// Interface of plan operations that can run as a stage of a Pipeline.
+///
+/// A pipeline pushes the rows of its input through all stages in batches
+/// instead of letting every operation produce its full result. All stages
+/// address rows by the row ids of the pipeline input: filters remove rows
+/// from a batch and projections only change the columns that later stages
+/// see. The last stage may be a breaker that collects the rows into its
+/// own result, e.g. a hash table.
+class PipelineStage {
+ public:
+  virtual ~PipelineStage() {}
+
+  /// Prepares the stage for rows of table
+  /// \returns the table of the rows passed on to the next stage
+  virtual storage::c_atable_ptr_t openStage(const storage::c_atable_ptr_t &table) = 0;
+
+  /// Processes a batch of ascending rows, removing all rows that do not
+  /// pass the stage
+  virtual void processBatch(pos_list_t &rows) = 0;
+
+  /// Whether the stage keeps the rows as its result and ends the pipeline
+  virtual bool isBreaker() const {
+    return false;
+  }
+};
+
+}
+}
+
+#endif  // SRC_LIB_ACCESS_SYSTEM_PIPELINESTAGE_H_
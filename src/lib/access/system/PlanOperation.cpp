@@ -4,9 +4,12 @@
 #include <algorithm>
 #include <thread>
 
+#include "access/system/OperatorProfile.h"
 #include "access/system/ResponseTask.h"
+#include "access/system/WorkloadLayouter.h"
 #include "helper/epoch.h"
 #include "helper/PapiTracer.h"
+#include "helper/PerfEventTracer.h"
 #include "io/StorageManager.h"
 #include "storage/AbstractResource.h"
 #include "storage/AbstractHashTable.h"
@@ -187,6 +190,10 @@ const PlanOperation * PlanOperation::execute() {
     startTime = get_epoch_nanoseconds();
 
   PapiTracer pt;
+  auto& profile = OperatorProfile::getInstance();
+  const bool profiling = recordPerformance || profile.profilesAll();
+  PerfEventTracer counters;
+  epoch_t executeStart = 0;
 
   // Start the execution
   refreshInput();
@@ -197,18 +204,44 @@ const PlanOperation * PlanOperation::execute() {
     pt.addEvent(getEvent());
     pt.start();
   }
+  if (profiling || _operatorStatistics)
+    executeStart = get_epoch_nanoseconds();
+  if (profiling)
+    counters.start();
 
   executePlanOperation();
 
+  if (profiling)
+    counters.stop();
+  if (profiling || _operatorStatistics) {
+    const epoch_t executeTime = get_epoch_nanoseconds() - executeStart;
+    if (profiling)
+      profile.record(planOperationName(), executeTime, counters.values());
+    if (_operatorStatistics) {
+      _operatorStatistics->executions.fetch_add(1, std::memory_order_relaxed);
+      _operatorStatistics->timeNs.fetch_add(executeTime, std::memory_order_relaxed);
+    }
+  }
   if (recordPerformance) pt.stop();
 
   teardownPlanOperation();
 
+  if (const auto responseTask = getResponseTask()) {
+    const size_t resultBytes = responseTask->accountResults(output);
+    if (_operatorStatistics)
+      _operatorStatistics->memory.fetch_add(resultBytes, std::memory_order_relaxed);
+  }
+
+  auto& workloadLayouter = WorkloadLayouter::getInstance();
+  if (workloadLayouter.isRecording() && input.numberOfTables() == 1)
+    workloadLayouter.record(input.getTable(0), accessedFields());
+
   if (recordPerformance) {
     epoch_t endTime = get_epoch_nanoseconds();
     std::string threadId = boost::lexical_cast<std::string>(std::this_thread::get_id());
     *_performance_attr = (performance_attributes_t) {
-      pt.value("PAPI_TOT_CYC"), pt.value(getEvent()), getEvent() , planOperationName(), _operatorId, startTime, endTime, threadId
+      pt.value("PAPI_TOT_CYC"), pt.value(getEvent()), getEvent() , planOperationName(), _operatorId, startTime, endTime, threadId,
+      counters.values()
     };
   }
 
@@ -239,6 +272,10 @@ void PlanOperation::setOperatorId(std::string i) {
   _operatorId = i;
 }
 
+const std::string& PlanOperation::getOperatorId() const {
+  return _operatorId;
+}
+
 const std::string& PlanOperation::planOperationName() const {
   return _planOperationName;
 }
@@ -258,5 +295,19 @@ std::shared_ptr<access::ResponseTask> PlanOperation::getResponseTask() const {
   return _responseTask.lock();
 }
 
+void PlanOperation::setOperatorStatistics(operator_statistics_t* statistics) {
+  _operatorStatistics = statistics;
+}
+
+field_list_t PlanOperation::accessedFields() const {
+  return _field_definition;
+}
+
+std::shared_ptr<QueryArena> PlanOperation::getArena() const {
+  if (const auto responseTask = getResponseTask())
+    return responseTask->getArena();
+  return nullptr;
+}
+
 
 }}
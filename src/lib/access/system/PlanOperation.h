@@ -5,6 +5,7 @@
 #include "access/system/OutputTask.h"
 #include "access/system/OperationData.h"
 #include "access/system/QueryParser.h"
+#include "access/system/QueryStatistics.h"
 #include "io/TXContext.h"
 
 #include "storage/storage_types.h"
@@ -15,6 +16,9 @@
 
 
 namespace hyrise {
+
+class QueryArena;
+
 namespace access {
 
 class ResponseTask;
@@ -39,6 +43,10 @@ class PlanOperation : public OutputTask {
   virtual void executePlanOperation() = 0;
   virtual void teardownPlanOperation() {}
 
+  /// Fields of the input table read by the operation, reported to the
+  /// WorkloadLayouter while it records
+  virtual field_list_t accessedFields() const;
+
   /* Returns true when none of the dependencies have OpFail state */
   bool allDependenciesSuccessful();
 
@@ -93,6 +101,7 @@ class PlanOperation : public OutputTask {
 
   void setPlanId(std::string i);
   void setOperatorId(std::string i);
+  const std::string& getOperatorId() const;
   const std::string& planOperationName() const;
   void setPlanOperationName(const std::string& name);
 
@@ -103,6 +112,12 @@ class PlanOperation : public OutputTask {
   void setErrorMessage(const std::string& message);
   void setResponseTask(const std::shared_ptr<ResponseTask>& responseTask);
   std::shared_ptr<ResponseTask> getResponseTask() const;
+  /// Counters of the position of this operation in the plan of its query,
+  /// see QueryStatistics
+  void setOperatorStatistics(operator_statistics_t* statistics);
+  /// Arena for the intermediate results of the query, nullptr if the
+  /// operation does not belong to a query
+  std::shared_ptr<QueryArena> getArena() const;
  protected:
   /// Containers to store and handle input/output or rather result data.
   OperationData input;
@@ -119,6 +134,7 @@ class PlanOperation : public OutputTask {
   field_list_t _indexed_field_definition;
 
   std::weak_ptr<ResponseTask> _responseTask;
+  operator_statistics_t* _operatorStatistics = nullptr;
 
   bool producesPositions = true;
 
@@ -0,0 +1,256 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/system/QueryStatistics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <thread>
+
+#include "json.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+
+/// Histogram bucket of a latency, with v = us + 1 >= 2^m the bucket is
+/// 4m plus the two bits following the leading one
+size_t latencyBucket(uint64_t latencyNs) {
+  const uint64_t v = latencyNs / 1000 + 1;
+  const size_t msb = 63 - __builtin_clzll(v);
+  const size_t sub = msb >= 2 ? (v >> (msb - 2)) & 3 : (v << (2 - msb)) & 3;
+  return std::min(4 * msb + sub, query_statistics_t::LATENCY_BUCKETS - 1);
+}
+
+/// Upper bound of the latencies of a bucket in ns
+uint64_t latencyBound(size_t bucket) {
+  const size_t msb = bucket / 4, sub = bucket % 4;
+  // Largest v of the bucket, below four the buckets hold a single v
+  const uint64_t v = msb >= 2 ? ((5 + sub) << (msb - 2)) - 1 : (4 + sub) >> (2 - msb);
+  return v * 1000 - 1;
+}
+
+void copyString(char* destination, const std::string& source, size_t length) {
+  const size_t n = std::min(source.size(), length - 1);
+  memcpy(destination, source.data(), n);
+  destination[n] = '\0';
+}
+
+/// Replaces the values of plan operation and predicate attributes that
+/// hold literals of the query
+void stripLiterals(Json::Value& value) {
+  static const std::set<std::string> literals = {"value", "value_max", "v_f1", "data", "limit", "offset"};
+  if (value.isObject()) {
+    for (const auto& name : value.getMemberNames()) {
+      if (literals.count(name))
+        value[name] = "?";
+      else
+        stripLiterals(value[name]);
+    }
+  } else if (value.isArray()) {
+    for (unsigned i = 0; i < value.size(); ++i)
+      stripLiterals(value[i]);
+  }
+}
+
+void resetCounters(query_statistics_t& entry) {
+  entry.calls = 0;
+  entry.errors = 0;
+  entry.latencyNs = 0;
+  entry.rows = 0;
+  entry.memory = 0;
+  for (auto& bucket : entry.latencies)
+    bucket = 0;
+  for (auto& op : entry.operators) {
+    op.executions = 0;
+    op.timeNs = 0;
+    op.memory = 0;
+  }
+}
+
+/// Makes the version of an entry odd, waiting for another writer of the
+/// entry to finish
+void beginWrite(query_statistics_t& entry) {
+  while (true) {
+    uint64_t version = entry.version.load(std::memory_order_relaxed);
+    if (version % 2 == 0 && entry.version.compare_exchange_weak(version, version + 1, std::memory_order_acquire))
+      break;
+    std::this_thread::yield();
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void endWrite(query_statistics_t& entry) {
+  entry.version.fetch_add(1, std::memory_order_release);
+}
+
+}
+
+QueryStatistics& QueryStatistics::getInstance() {
+  static QueryStatistics statistics;
+  return statistics;
+}
+
+const size_t QueryStatistics::CAPACITY;
+const size_t QueryStatistics::MAX_PROBES;
+
+QueryStatistics::QueryStatistics() : _entries(new query_statistics_t[CAPACITY]()), _dropped(0) {}
+
+std::string QueryStatistics::normalize(const Json::Value& query) {
+  Json::Value plan = query;
+  plan.removeMember("priority");
+  plan.removeMember("sessionId");
+  plan.removeMember("deadline");
+  plan.removeMember("weight");
+  stripLiterals(plan);
+  Json::FastWriter writer;
+  auto normalized = writer.write(plan);
+  if (!normalized.empty() && normalized.back() == '\n')
+    normalized.pop_back();
+  return normalized;
+}
+
+query_statistics_t* QueryStatistics::entry(const std::string& planHash, const std::string& query) {
+  uint64_t key = 0;
+  memcpy(&key, planHash.data(), std::min(planHash.size(), sizeof(key)));
+  key = std::max<uint64_t>(key, 1);
+
+  query_statistics_t* claimed = nullptr;
+  query_statistics_t* victim = nullptr;
+  uint64_t victimKey = 0;
+  for (size_t probe = 0; probe < MAX_PROBES && !claimed; ++probe) {
+    auto& entry = _entries[(key + probe) % CAPACITY];
+    uint64_t current = entry.key.load(std::memory_order_acquire);
+    if (current == key)
+      return &entry;
+    if (current == 0 && entry.key.compare_exchange_strong(current, key))
+      claimed = &entry;
+    else if (current != 0 && (!victim || entry.calls < victim->calls)) {
+      victim = &entry;
+      victimKey = current;
+    }
+  }
+
+  if (!claimed) {
+    // Evicts the least called plan, unless another plan replaced it
+    // meanwhile
+    if (!victim->key.compare_exchange_strong(victimKey, key))
+      return victimKey == key ? victim : nullptr;
+    claimed = victim;
+    beginWrite(*claimed);
+    resetCounters(*claimed);
+    for (auto& op : claimed->operators)
+      op.state = 0;
+    ++_dropped;
+  } else {
+    beginWrite(*claimed);
+  }
+
+  static const char digits[] = "0123456789abcdef";
+  const size_t bytes = std::min<size_t>(planHash.size(), 20);
+  for (size_t i = 0; i < bytes; ++i) {
+    claimed->planHash[2 * i] = digits[static_cast<unsigned char>(planHash[i]) >> 4];
+    claimed->planHash[2 * i + 1] = digits[static_cast<unsigned char>(planHash[i]) & 15];
+  }
+  claimed->planHash[2 * bytes] = '\0';
+  copyString(claimed->query, query, query_statistics_t::QUERY_LENGTH);
+  endWrite(*claimed);
+  return claimed;
+}
+
+operator_statistics_t* QueryStatistics::operatorAt(query_statistics_t* entry, size_t position, const std::string& name) {
+  if (entry == nullptr || position >= query_statistics_t::MAX_OPERATORS)
+    return nullptr;
+
+  auto& op = entry->operators[position];
+  int unnamed = 0;
+  if (op.state.load(std::memory_order_acquire) == 0 && op.state.compare_exchange_strong(unnamed, 1)) {
+    copyString(op.name, name, operator_statistics_t::NAME_LENGTH);
+    op.state.store(2, std::memory_order_release);
+  }
+  return &op;
+}
+
+void QueryStatistics::record(query_statistics_t* entry, uint64_t latencyNs, uint64_t rows, uint64_t memory, bool failed) {
+  if (entry == nullptr)
+    return;
+
+  entry->calls.fetch_add(1, std::memory_order_relaxed);
+  if (failed)
+    entry->errors.fetch_add(1, std::memory_order_relaxed);
+  entry->latencyNs.fetch_add(latencyNs, std::memory_order_relaxed);
+  entry->rows.fetch_add(rows, std::memory_order_relaxed);
+  entry->memory.fetch_add(memory, std::memory_order_relaxed);
+  entry->latencies[latencyBucket(latencyNs)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<query_summary_t> QueryStatistics::summary() const {
+  std::vector<query_summary_t> result;
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    const auto& entry = _entries[i];
+    const uint64_t version = entry.version.load(std::memory_order_acquire);
+    if (version % 2 != 0 || entry.key.load(std::memory_order_relaxed) == 0 || entry.calls == 0)
+      continue;
+
+    query_summary_t summary;
+    summary.planHash = entry.planHash;
+    summary.query = entry.query;
+    summary.calls = entry.calls;
+    summary.errors = entry.errors;
+    summary.latencyNs = entry.latencyNs;
+    summary.rows = entry.rows;
+    summary.memory = entry.memory;
+
+    // the histogram is read while it is updated, so its total may differ
+    // from the calls read before
+    uint64_t counts[query_statistics_t::LATENCY_BUCKETS], total = 0;
+    for (size_t b = 0; b < query_statistics_t::LATENCY_BUCKETS; ++b)
+      total += counts[b] = entry.latencies[b];
+    summary.p99LatencyNs = 0;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < query_statistics_t::LATENCY_BUCKETS && total > 0; ++b) {
+      seen += counts[b];
+      if (seen * 100 >= total * 99) {
+        summary.p99LatencyNs = latencyBound(b);
+        break;
+      }
+    }
+
+    for (size_t o = 0; o < query_statistics_t::MAX_OPERATORS; ++o) {
+      const auto& op = entry.operators[o];
+      if (op.state.load(std::memory_order_acquire) == 2 && op.executions > 0)
+        summary.operators.push_back({op.name, op.executions, op.timeNs, op.memory});
+    }
+
+    // Names are only rewritten after the version changed
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.version.load(std::memory_order_relaxed) != version)
+      continue;
+    result.push_back(summary);
+  }
+
+  std::sort(result.begin(), result.end(), [] (const query_summary_t& a, const query_summary_t& b) {
+    return a.latencyNs > b.latencyNs;
+  });
+  return result;
+}
+
+uint64_t QueryStatistics::dropped() const {
+  return _dropped;
+}
+
+void QueryStatistics::clear() {
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    auto& entry = _entries[i];
+    beginWrite(entry);
+    resetCounters(entry);
+    for (auto& op : entry.operators)
+      op.state = 0;
+    entry.key.store(0, std::memory_order_release);
+    endWrite(entry);
+  }
+  _dropped = 0;
+}
+
+}
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "helper/noncopyable.h"
+
+namespace Json {
+class Value;
+}
+
+namespace hyrise {
+namespace access {
+
+/// Time spent in one plan operation of a query and the memory of its
+/// results, by its position in the plan
+typedef struct operator_statistics_t {
+  static const size_t NAME_LENGTH = 64;
+
+  // 0 unnamed, 1 name being written, 2 name readable
+  std::atomic<int> state;
+  char name[NAME_LENGTH];
+  std::atomic<uint64_t> executions;
+  std::atomic<uint64_t> timeNs;
+  std::atomic<uint64_t> memory;
+} operator_statistics_t;
+
+/// Counters of one query plan, see QueryStatistics
+typedef struct query_statistics_t {
+  static const size_t QUERY_LENGTH = 512;
+  static const size_t MAX_OPERATORS = 32;
+  // four buckets per power of two of the latency in us
+  static const size_t LATENCY_BUCKETS = 4 * 40;
+
+  // 64 bits of the plan hash, 0 for free entries
+  std::atomic<uint64_t> key;
+  // Odd while the plan hash, query and operator names are rewritten,
+  // readers copy them only if the version is even and unchanged
+  std::atomic<uint64_t> version;
+  char planHash[41];
+  char query[QUERY_LENGTH];
+
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> errors;
+  std::atomic<uint64_t> latencyNs;
+  std::atomic<uint64_t> rows;
+  std::atomic<uint64_t> memory;
+  std::atomic<uint64_t> latencies[LATENCY_BUCKETS];
+  operator_statistics_t operators[MAX_OPERATORS];
+} query_statistics_t;
+
+/// Readable copies of the counters of a query plan and its operators
+typedef struct operator_summary_t {
+  std::string name;
+  uint64_t executions;
+  uint64_t timeNs;
+  uint64_t memory;
+} operator_summary_t;
+
+typedef struct query_summary_t {
+  std::string planHash;
+  std::string query;
+  uint64_t calls;
+  uint64_t errors;
+  uint64_t latencyNs;
+  uint64_t p99LatencyNs;
+  uint64_t rows;
+  uint64_t memory;
+  // every operator that was executed, in the order of the plan
+  std::vector<operator_summary_t> operators;
+} query_summary_t;
+
+/// Aggregated statistics of all queries the server executed, per plan
+/// hash, similar to pg_stat_statements.
+///
+/// Plans are identified by the hash of their normalized form, in which
+/// the literals of predicates, inserted rows and limits are replaced by
+/// "?", so queries that differ in their parameters share an entry.
+/// Every response records the latency of its query from parsing to
+/// responding, the rows returned or affected, the memory of its
+/// intermediate results and whether it failed. Plan operations add their
+/// execution time and the memory of their results to the operator at their
+/// position in the plan. The
+/// entries live in a fixed open-addressing table that is updated with
+/// atomic operations only. A plan that finds no free entry within
+/// MAX_PROBES slots evicts the least called plan among them; queries in
+/// flight while their entry is evicted or cleared are counted for its
+/// next plan. Summaries skip entries that are evicted while they are
+/// copied. The 99th percentile of the latency is estimated from a
+/// log-scale histogram and is at most 25% too high. The statistics are
+/// queried with the QueryStatisticsTable plan operation.
+class QueryStatistics : noncopyable {
+ public:
+  static const size_t CAPACITY = 1024;
+  static const size_t MAX_PROBES = 16;
+
+  static QueryStatistics& getInstance();
+
+  /// Plan of a query without its literals and scheduling hints
+  static std::string normalize(const Json::Value& query);
+
+  /// Entry of a plan, created on its first call; nullptr only if another
+  /// plan took over the evicted entry meanwhile. planHash is the binary
+  /// hash of the normalized query.
+  query_statistics_t* entry(const std::string& planHash, const std::string& query);
+
+  /// Counters of the operator at a position of the plan of an entry,
+  /// nullptr beyond MAX_OPERATORS
+  static operator_statistics_t* operatorAt(query_statistics_t* entry, size_t position, const std::string& name);
+
+  static void record(query_statistics_t* entry, uint64_t latencyNs, uint64_t rows, uint64_t memory, bool failed);
+
+  /// Summaries of all plans that were called, by descending total latency
+  std::vector<query_summary_t> summary() const;
+
+  /// Plans that were evicted to make room for other plans
+  uint64_t dropped() const;
+
+  /// Frees all entries
+  void clear();
+
+ private:
+  QueryStatistics();
+
+  std::unique_ptr<query_statistics_t[]> _entries;
+  std::atomic<uint64_t> _dropped;
+};
+
+}
+}
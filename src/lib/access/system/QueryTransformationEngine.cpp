@@ -13,6 +13,9 @@ Json::Value &QueryTransformationEngine::transform(Json::Value &query) {
   Json::Value::Members operatorIds = query["operators"].getMemberNames();
   Json::Value operatorConfiguration;
   for (size_t i = 0; i < operatorIds.size(); ++i) {
+    // skip operators that an earlier transformation fused into another one
+    if (!query["operators"].isMember(operatorIds[i]))
+      continue;
     operatorConfiguration = query["operators"][operatorIds[i]];
     // check whether operator should be transformed; postpone transformation if dynamic transformation is required
     if (operatorConfiguration["dynamic"].asBool() == false && _factory.count(operatorConfiguration["type"].asString()) > 0)
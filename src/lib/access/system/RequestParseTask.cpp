@@ -1,11 +1,15 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "access/system/RequestParseTask.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <deque>
 #include <iomanip>
 #include <map>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 #include <thread>
 
@@ -13,6 +17,7 @@
 
 #include "access/system/ResponseTask.h"
 #include "access/system/PlanOperation.h"
+#include "access/system/QueryStatistics.h"
 #include "access/system/QueryTransformationEngine.h"
 #include "access/tx/Commit.h"
 
@@ -27,6 +32,8 @@
 #include "net/AbstractConnection.h"
 
 #include "taskscheduler/AbstractTaskScheduler.h"
+#include "taskscheduler/AdmissionController.h"
+#include "taskscheduler/FairShareScheduler.h"
 #include "taskscheduler/SharedScheduler.h"
 
 namespace hyrise {
@@ -54,6 +61,91 @@ const std::string RequestParseTask::vname() {
 namespace {
 log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("hyrise.access"));
 log4cxx::LoggerPtr _query_logger(log4cxx::Logger::getLogger("hyrise.access.queries"));
+
+std::atomic<size_t> _inlineThreshold(RequestParseTask::DEFAULT_INLINE_THRESHOLD);
+}
+
+const size_t RequestParseTask::DEFAULT_INLINE_THRESHOLD;
+
+void RequestParseTask::setInlineThreshold(size_t threshold) {
+  _inlineThreshold = threshold;
+}
+
+size_t RequestParseTask::getInlineThreshold() {
+  return _inlineThreshold;
+}
+
+bool RequestParseTask::sortTopologically(std::vector<taskscheduler::task_ptr_t>& tasks, bool& chain) {
+  std::unordered_map<Task *, size_t> index;
+  for (size_t i = 0; i < tasks.size(); ++i)
+    index[tasks[i].get()] = i;
+
+  // Dependencies outside of tasks are not part of the plan
+  std::vector<size_t> waitCount(tasks.size(), 0);
+  std::vector<std::vector<size_t>> successors(tasks.size());
+  chain = true;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    for (const auto& dependency : tasks[i]->getDependencies()) {
+      auto it = index.find(dependency.get());
+      if (it == index.end())
+        continue;
+      successors[it->second].push_back(i);
+      ++waitCount[i];
+    }
+    chain &= waitCount[i] <= 1;
+  }
+
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    chain &= successors[i].size() <= 1;
+    if (waitCount[i] == 0)
+      ready.push_back(i);
+  }
+
+  std::vector<taskscheduler::task_ptr_t> sorted;
+  sorted.reserve(tasks.size());
+  while (!ready.empty()) {
+    const size_t i = ready.front();
+    ready.pop_front();
+    sorted.push_back(tasks[i]);
+    for (const auto& successor : successors[i]) {
+      if (--waitCount[successor] == 0)
+        ready.push_back(successor);
+    }
+  }
+
+  if (sorted.size() != tasks.size())
+    return false;
+  tasks.swap(sorted);
+  return true;
+}
+
+bool RequestParseTask::executesInline(const std::vector<taskscheduler::task_ptr_t>& tasks, bool chain, int priority) {
+  if (priority == Task::HIGH_PRIORITY)
+    return true;
+  // Dynamic tasks are split up by the scheduler
+  return chain && tasks.size() <= _inlineThreshold &&
+      std::none_of(tasks.begin(), tasks.end(), [] (const taskscheduler::task_ptr_t& task) { return task->isDynamic(); });
+}
+
+void RequestParseTask::executeInline(const std::vector<taskscheduler::task_ptr_t>& tasks) {
+  // Operators may add tasks to the plan while executing, e.g. subtasks of
+  // their own that their successors depend on. The first task that is not
+  // ready, and everything after it, is left to the scheduler.
+  size_t next = 0;
+  for (; next < tasks.size() && tasks[next]->isReady(); ++next) {
+    (*tasks[next])();
+    tasks[next]->notifyDoneObservers();
+  }
+
+  _responseTask->setQueryStart(_queryStart);
+  if (next == tasks.size() && _responseTask->isReady()) {
+    (*_responseTask)();
+  } else {
+    const auto& scheduler = taskscheduler::SharedScheduler::getInstance().getScheduler();
+    scheduler->schedule(_responseTask);
+    scheduler->scheduleQuery(std::vector<taskscheduler::task_ptr_t>(tasks.begin() + next, tasks.end()));
+  }
 }
 
 std::string hash(const std::string &v) {
@@ -79,6 +171,7 @@ void RequestParseTask::operator()() {
 
   int priority = Task::DEFAULT_PRIORITY;
   int sessionId = 0;
+  epoch_t deadline = 0;
 
   if (_connection->hasBody()) {
     // The body is a wellformed HTTP Post body, with key value pairs
@@ -96,6 +189,8 @@ void RequestParseTask::operator()() {
       ctx = tx::TransactionManager::beginTransaction();
       LOG4CXX_DEBUG(_logger, "Creating new transaction context " << ctx.tid);
     }
+    // Keeps the snapshot of the transaction alive for the garbage collector
+    tx::TransactionManager::touchTransaction(ctx);
 
     Json::Value request_data;
     Json::Reader reader;
@@ -115,16 +210,29 @@ void RequestParseTask::operator()() {
       LOG4CXX_DEBUG(_query_logger, request_data);
 
       const std::string& final_hash = hash(query_string);
+      // Queries that differ only in their literals share their statistics
+      const auto normalized = QueryStatistics::normalize(request_data);
+      _responseTask->setStatistics(QueryStatistics::getInstance().entry(hash(normalized), normalized));
       std::shared_ptr<Task> result = nullptr;
 
       if(request_data.isMember("priority"))
         priority = request_data["priority"].asInt();
       if(request_data.isMember("sessionId"))
         sessionId = request_data["sessionId"].asInt();
+      // ms after the query arrived, used by the FairShareScheduler
+      if(request_data.isMember("deadline"))
+        deadline = _queryStart + request_data["deadline"].asLargestUInt() * 1000000;
       _responseTask->setPriority(priority);
       _responseTask->setSessionId(sessionId);
+      _responseTask->setDeadline(deadline);
       _responseTask->setRecordPerformanceData(recordPerformance);
       try {
+        // Share of the workers of the session, kept by the FairShareScheduler
+        if (request_data.isMember("weight")) {
+          if (const auto fairShare = std::dynamic_pointer_cast<taskscheduler::FairShareScheduler>(
+                  taskscheduler::SharedScheduler::getInstance().getScheduler()))
+            fairShare->setSessionWeight(sessionId, request_data["weight"].asDouble());
+        }
         tasks = QueryParser::instance().deserialize(
                   QueryTransformationEngine::getInstance()->transform(request_data),
                   &result);
@@ -160,6 +268,7 @@ void RequestParseTask::operator()() {
         if (auto task = std::dynamic_pointer_cast<PlanOperation>(func)) {
           task->setPriority(priority);
           task->setSessionId(sessionId);
+          task->setDeadline(deadline);
           task->setPlanId(final_hash);
           task->setTXContext(ctx);
           task->setId(ctx.tid);
@@ -194,43 +303,46 @@ void RequestParseTask::operator()() {
   }
 
 
-  // high priority tasks are expected to be scheduled sequentially
-  if(priority == Task::HIGH_PRIORITY){
-    if (recordPerformance) {
-      *(performance_data.at(0)) = { 0, 0, "NO_PAPI", "RequestParseTask", 
-                                    "requestParse", _queryStart, get_epoch_nanoseconds(), 
-                                    boost::lexical_cast<std::string>(std::this_thread::get_id()) };
-    }
-
-    int number_of_tasks = tasks.size();
-    std::vector<bool> isExecuted(number_of_tasks, false);
-    int executedTasks = 0;
-    while(executedTasks < number_of_tasks){
-      for(int i = 0; i < number_of_tasks; i++){
-        if(!isExecuted[i] && tasks[i]->isReady()){
-          (*tasks[i])();
-          tasks[i]->notifyDoneObservers();
-          executedTasks++;
-          isExecuted[i] = true;
-        }
-      }
-    }
-    _responseTask->setQueryStart(_queryStart);
-    (*_responseTask)();
-    _responseTask.reset();  // yield responsibility
-
-  } else {
-    scheduler->schedule(_responseTask);
-    scheduler->scheduleQuery(tasks);
+  bool chain = false;
+  if (!sortTopologically(tasks, chain)) {
+    LOG4CXX_ERROR(_logger, "Dependencies of the plan contain a cycle");
+    chain = false;
+    priority = Task::DEFAULT_PRIORITY;
+  }
 
-    if (recordPerformance) {
-      *(performance_data.at(0)) = { 0, 0, "NO_PAPI", "RequestParseTask", "requestParse", 
-                                    _queryStart, get_epoch_nanoseconds(), 
-                                    boost::lexical_cast<std::string>(std::this_thread::get_id()) };
+  if (recordPerformance) {
+    *(performance_data.at(0)) = { 0, 0, "NO_PAPI", "RequestParseTask",
+                                  "requestParse", _queryStart, get_epoch_nanoseconds(),
+                                  boost::lexical_cast<std::string>(std::this_thread::get_id()),
+                                  {-1, -1, -1, -1} };
+  }
+  _responseTask->setQueryStart(_queryStart);
+
+  // Queries reserve what queries held so far before their results are
+  // charged, queries that have to wait for memory are scheduled once admitted
+  auto& admissionController = taskscheduler::AdmissionController::getInstance();
+  const size_t reservation = admissionController.getEstimate();
+  _responseTask->reserveMemory(reservation);
+  auto responseTask = _responseTask;
+  const auto admission = admissionController.admit(_responseTask->getSessionId(), reservation,
+                                                   [scheduler, responseTask, tasks] () {
+      scheduler->schedule(responseTask);
+      scheduler->scheduleQuery(tasks);
+    });
+
+  if (admission == taskscheduler::AdmissionController::Rejected) {
+    _responseTask->reserveMemory(0);
+    _responseTask->addErrorMessage("RequestParseTask: Query rejected, the memory budget of the server is exhausted");
+    _responseTask->respondWithErrors();
+  } else if (admission == taskscheduler::AdmissionController::Admitted) {
+    if (executesInline(tasks, chain, priority)) {
+      executeInline(tasks);
+    } else {
+      scheduler->schedule(_responseTask);
+      scheduler->scheduleQuery(tasks);
     }
-    _responseTask->setQueryStart(_queryStart);
-    _responseTask.reset();  // yield responsibility
   }
+  _responseTask.reset();  // yield responsibility
 }
 
 std::shared_ptr<ResponseTask> RequestParseTask::getResponseTask() const {
@@ -4,29 +4,55 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "helper/epoch.h"
 #include "net/Router.h"
 #include "net/AbstractConnection.h"
+#include "taskscheduler/Task.h"
 
 namespace hyrise {
 namespace access {
 
 class ResponseTask;
 
+/// Parses a query and executes its plan.
+///
+/// Plans that are a chain of few operators, typically point lookups and
+/// single row inserts, and high priority plans are executed inline: the
+/// operators run in topological order on the thread that parsed the
+/// request, followed by the response. All other plans are handed to the
+/// scheduler.
 class RequestParseTask : public net::AbstractRequestHandler {
  private:
   net::AbstractConnection *_connection;
   std::shared_ptr<ResponseTask> _responseTask;
   epoch_t _queryStart;
 
+  void executeInline(const std::vector<taskscheduler::task_ptr_t>& tasks);
+
  public:
+  static const size_t DEFAULT_INLINE_THRESHOLD = 8;
+
   explicit RequestParseTask(net::AbstractConnection *connection);
   virtual ~RequestParseTask();
   std::shared_ptr<ResponseTask> getResponseTask() const;
   virtual void operator()();
   static std::string name();
   const std::string vname();
+
+  /// Chains of at most threshold operators are executed inline, 0
+  /// schedules all plans that are not of high priority
+  static void setInlineThreshold(size_t threshold);
+  static size_t getInlineThreshold();
+
+  /// Sorts tasks such that every task follows its dependencies, chain is
+  /// set if each task has at most one dependency and one successor in tasks
+  /// \returns false if the dependencies contain a cycle
+  static bool sortTopologically(std::vector<taskscheduler::task_ptr_t>& tasks, bool& chain);
+
+  /// Whether a plan of the topologically sorted tasks is executed inline
+  static bool executesInline(const std::vector<taskscheduler::task_ptr_t>& tasks, bool chain, int priority);
 };
 
 }
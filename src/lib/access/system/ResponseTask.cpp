@@ -1,6 +1,7 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "access/system/ResponseTask.h"
 
+#include <algorithm>
 #include <thread>
 
 #include "json.h"
@@ -11,11 +12,16 @@
 #include "access/system/OutputTask.h"
 #include "io/TransactionManager.h"
 #include "helper/PapiTracer.h"
+#include "taskscheduler/AdmissionController.h"
 
 #include "net/AsyncConnection.h"
 
 #include "storage/AbstractTable.h"
+#include "storage/HorizontalTable.h"
+#include "storage/MutableVerticalTable.h"
+#include "storage/PointerCalculator.h"
 #include "storage/SimpleStore.h"
+#include "storage/Table.h"
 #include "storage/meta_storage.h"
 
 
@@ -24,6 +30,21 @@ namespace access {
 
 namespace {
 log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("hyrise.net"));
+
+/// Estimated bytes of a result table that are not shared with stored
+/// tables: the positions of a PointerCalculator and the value ids of
+/// materialized tables. Stores and views belong to the base data.
+size_t intermediateBytes(const storage::c_atable_ptr_t& table) {
+  if (const auto pc = std::dynamic_pointer_cast<const storage::PointerCalculator>(table)) {
+    const auto positions = pc->getPositions();
+    return positions ? positions->capacity() * sizeof(pos_t) : 0;
+  }
+  if (std::dynamic_pointer_cast<const storage::Table>(table) ||
+      std::dynamic_pointer_cast<const storage::MutableVerticalTable>(table) ||
+      std::dynamic_pointer_cast<const storage::HorizontalTable>(table))
+    return table->size() * table->columnCount() * sizeof(value_id_t);
+  return 0;
+}
 }
 
 template <typename T>
@@ -103,10 +124,45 @@ void ResponseTask::registerPlanOperation(const std::shared_ptr<PlanOperation>& p
   }
 
   _generatedKeyRefs.push_back(std::unique_ptr<std::vector<hyrise_int_t>>(genKeys));
+  planOp->setOperatorStatistics(QueryStatistics::operatorAt(
+      _statistics, _registeredOperations++, planOp->getOperatorId() + ":" + planOp->planOperationName()));
   perfMutex.unlock();
 }
 
 
+size_t ResponseTask::accountResults(const OperationData& results) {
+  size_t resultBytes = 0;
+  std::lock_guard<std::mutex> guard(_memoryMutex);
+  for (const auto& table : results.getTables()) {
+    if (table && _accountedResults.insert(table.get()).second)
+      resultBytes += intermediateBytes(table);
+  }
+  _resultBytes += resultBytes;
+
+  // Hash tables of the query live in the arena and are counted with it
+  const size_t total = _resultBytes + _arena->allocated();
+  _peakBytes = std::max(_peakBytes, total);
+  if (total > _chargedBytes) {
+    taskscheduler::AdmissionController::getInstance().charge(getSessionId(), total - _chargedBytes);
+    _chargedBytes = total;
+  }
+
+  const size_t limit = _arena->getLimit();
+  if (limit > 0 && total > limit)
+    throw QueryMemoryExceeded("Query exceeded its memory limit of " + std::to_string(limit) + " bytes");
+  return resultBytes;
+}
+
+size_t ResponseTask::getMemoryUsage() {
+  std::lock_guard<std::mutex> guard(_memoryMutex);
+  return _resultBytes + _arena->allocated();
+}
+
+void ResponseTask::reserveMemory(size_t bytes) {
+  std::lock_guard<std::mutex> guard(_memoryMutex);
+  _chargedBytes = bytes;
+}
+
 std::shared_ptr<PlanOperation> ResponseTask::getResultTask() {
   if (getDependencyCount() >  0) {
     return std::dynamic_pointer_cast<PlanOperation>(_dependencies[0]);
@@ -127,6 +183,7 @@ task_states_t ResponseTask::getState() const {
 void ResponseTask::operator()() {
   epoch_t responseStart = _recordPerformanceData ? get_epoch_nanoseconds() : 0;
   Json::Value response;
+  uint64_t rows = _affectedRows;
 
   if (getDependencyCount() > 0) {
     PapiTracer pt;
@@ -138,10 +195,6 @@ void ResponseTask::operator()() {
     const auto& result = predecessor->getResultTable();
 
     if (getState() != OpFail) {
-      if (!_isAutoCommit) {
-        response["session_context"] = std::to_string(_txContext.tid).append(" ").append(std::to_string(_txContext.lastCid));
-      }
-
       if (result) {
         // Make header
         Json::Value json_header(Json::arrayValue);
@@ -152,6 +205,7 @@ void ResponseTask::operator()() {
 
         // Copy the complete result
         response["real_size"] = result->size();
+        rows += result->size();
         response["rows"] = generateRowsJson(result, _transmitLimit, _transmitOffset);
         response["header"] = json_header;
       }
@@ -170,6 +224,12 @@ void ResponseTask::operator()() {
           element["startTime"] = Json::Value((double)(attr->startTime - queryStart) / 1000000);
           element["endTime"] = Json::Value((double)(attr->endTime - queryStart) / 1000000);
           element["executingThread"] = Json::Value(attr->executingThread);
+          if (attr->counters.cycles >= 0) {
+            element["cycles"] = Json::Value((Json::Int64) attr->counters.cycles);
+            element["instructions"] = Json::Value((Json::Int64) attr->counters.instructions);
+            element["llcMisses"] = Json::Value((Json::Int64) attr->counters.llcMisses);
+            element["branchMisses"] = Json::Value((Json::Int64) attr->counters.branchMisses);
+          }
           json_perf.append(element);
         }
         
@@ -184,6 +244,10 @@ void ResponseTask::operator()() {
 
         std::string threadId = boost::lexical_cast<std::string>(std::this_thread::get_id());
         responseElement["executingThread"] = Json::Value(threadId);
+        responseElement["arenaBytes"] = Json::Value((Json::UInt64) _arena->allocated());
+        responseElement["memory"] = Json::Value((Json::UInt64) getMemoryUsage());
+        responseElement["sessionMemory"] = Json::Value(
+            (Json::UInt64) taskscheduler::AdmissionController::getInstance().getSessionUsage(getSessionId()));
         json_perf.append(responseElement);
 
         response["performanceData"] = json_perf;
@@ -203,6 +267,21 @@ void ResponseTask::operator()() {
     LOG4CXX_DEBUG(_logger, "Table Use Count: " << result.use_count());
   }
 
+  respond(response, rows);
+}
+
+void ResponseTask::respondWithErrors() {
+  Json::Value response;
+  respond(response, 0);
+}
+
+void ResponseTask::respond(Json::Value& response, uint64_t rows) {
+  // Also sent if the query failed, so the client can roll back a
+  // transaction that its first query began
+  if (!_isAutoCommit) {
+    response["session_context"] = std::to_string(_txContext.tid).append(" ").append(std::to_string(_txContext.lastCid));
+  }
+
   if (!_error_messages.empty()) {
     Json::Value errors;
     for (const auto& msg: _error_messages) {
@@ -215,6 +294,24 @@ void ResponseTask::operator()() {
 
   Json::FastWriter fw;
   connection->respond(fw.write(response));
+
+  QueryStatistics::record(_statistics, get_epoch_nanoseconds() - queryStart, rows, getMemoryUsage(),
+                          !_error_messages.empty());
+
+  // A request that did not modify anything must not pin its snapshot until
+  // the session times out, a later request of the session registers again
+  tx::TransactionManager::releaseReadOnlyTransaction(_txContext.tid);
+
+  // The intermediate results are no longer needed once the response is out,
+  // their memory is released with what is left of the reservation
+  size_t charged, used;
+  {
+    std::lock_guard<std::mutex> guard(_memoryMutex);
+    charged = _chargedBytes;
+    used = std::max(_peakBytes, _resultBytes + _arena->allocated());
+    _chargedBytes = 0;
+  }
+  taskscheduler::AdmissionController::getInstance().release(getSessionId(), charged, used);
 }
 
 }
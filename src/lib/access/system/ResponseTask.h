@@ -4,15 +4,23 @@
 
 #include <atomic>
 #include <mutex>
+#include <unordered_set>
 
 #include "helper/epoch.h"
+#include "helper/QueryArena.h"
 #include "access/system/OutputTask.h"
+#include "access/system/QueryStatistics.h"
 #include "net/AbstractConnection.h"
 #include "io/TXContext.h"
 
+namespace Json {
+class Value;
+}
+
 namespace hyrise {
 namespace access {
 
+class OperationData;
 class PlanOperation;
 
 class ResponseTask : public taskscheduler::Task {
@@ -37,9 +45,25 @@ class ResponseTask : public taskscheduler::Task {
 
   bool _recordPerformanceData = true;
 
+  // Intermediate results of the plan operations of this query
+  std::shared_ptr<QueryArena> _arena;
+
+  // Memory held by the results of the plan operations, every result is
+  // counted once even if it is passed on by multiple operations
+  std::mutex _memoryMutex;
+  std::unordered_set<const void *> _accountedResults;
+  size_t _resultBytes = 0;
+  size_t _chargedBytes = 0;
+  size_t _peakBytes = 0;
+
+  // Statistics of the plan of this query and the number of its operations
+  query_statistics_t* _statistics = nullptr;
+  size_t _registeredOperations = 0;
+
  public:
   explicit ResponseTask(net::AbstractConnection *connection) :
-      connection(connection) {
+      connection(connection),
+      _arena(std::make_shared<QueryArena>(QueryArena::getDefaultLimit())) {
         _affectedRows = 0;
   }
 
@@ -53,6 +77,12 @@ class ResponseTask : public taskscheduler::Task {
     return queryStart;
   }
 
+  /// Statistics the query is recorded in, must be set before the plan
+  /// operations are registered
+  void setStatistics(query_statistics_t* statistics) {
+    _statistics = statistics;
+  }
+
   void registerPlanOperation(const std::shared_ptr<PlanOperation>& planOp);
 
   void addErrorMessage(std::string message) {
@@ -87,6 +117,24 @@ class ResponseTask : public taskscheduler::Task {
     _affectedRows += inc;
   }
 
+  const std::shared_ptr<QueryArena>& getArena() const {
+    return _arena;
+  }
+
+  /// Adds the results of a plan operation to the memory of this query and
+  /// charges it to the admission controller. Throws QueryMemoryExceeded if
+  /// the query holds more than the limit of its arena. Returns the bytes
+  /// of the results that were not accounted before.
+  size_t accountResults(const OperationData& results);
+
+  /// Bytes held by the intermediate results of this query
+  size_t getMemoryUsage();
+
+  /// Counts the bytes the admission controller reserves for this query as
+  /// charged, its results are charged once they exceed the reservation.
+  /// Has to be called before the query is admitted.
+  void reserveMemory(size_t bytes);
+
   performance_vector_t& getPerformanceData() {
     return performance_data;
   }
@@ -96,6 +144,15 @@ class ResponseTask : public taskscheduler::Task {
   std::shared_ptr<PlanOperation> getResultTask();
 
   virtual void operator()();
+
+  /// Sends only the error messages, for a query whose plan operations
+  /// never ran, e.g. because it was not admitted
+  void respondWithErrors();
+
+ private:
+  /// Adds the error messages to the response, sends it and releases the
+  /// resources of the query
+  void respond(Json::Value& response, uint64_t rows);
 };
 
 }
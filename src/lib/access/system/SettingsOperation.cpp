@@ -5,6 +5,12 @@
 
 #include "helper/Settings.h"
 
+#include "io/TransactionManager.h"
+
+#include "taskscheduler/CentralScheduler.h"
+#include "taskscheduler/FairShareScheduler.h"
+#include "taskscheduler/SharedScheduler.h"
+
 namespace hyrise {
 namespace access {
 
@@ -19,9 +25,37 @@ SettingsOperation::~SettingsOperation() {
 }
 
 void SettingsOperation::executePlanOperation() {
-  
-  if (_data.isMember("threadpoolSize"))
+  // the elastic pool of the central scheduler applies the pool settings
+  const auto scheduler = std::dynamic_pointer_cast<taskscheduler::CentralScheduler>(
+      taskscheduler::SharedScheduler::getInstance().getScheduler());
+
+  if (_data.isMember("threadpoolSize")) {
     Settings::getInstance()->setThreadpoolSize(_data["threadpoolSize"].asUInt());
+    if (scheduler)
+      scheduler->setMaxWorkers(_data["threadpoolSize"].asUInt());
+  }
+
+  if (_data.isMember("minWorkers")) {
+    Settings::getInstance()->setMinWorkers(_data["minWorkers"].asUInt());
+    if (scheduler)
+      scheduler->setMinWorkers(_data["minWorkers"].asUInt());
+  }
+
+  if (_data.isMember("workerIdleTimeout")) {
+    Settings::getInstance()->setWorkerIdleTimeout(_data["workerIdleTimeout"].asUInt());
+    if (scheduler)
+      scheduler->setIdleTimeout(std::chrono::milliseconds(_data["workerIdleTimeout"].asUInt()));
+  }
+
+  if (_data.isMember("deadlineUrgency")) {
+    const auto fairShare = std::dynamic_pointer_cast<taskscheduler::FairShareScheduler>(
+        taskscheduler::SharedScheduler::getInstance().getScheduler());
+    if (fairShare)
+      fairShare->setUrgency(_data["deadlineUrgency"].asLargestUInt() * 1000 * 1000);
+  }
+
+  if (_data.isMember("lockWaitTimeout"))
+    tx::TransactionManager::getInstance().setLockWaitTimeout(std::chrono::microseconds(_data["lockWaitTimeout"].asUInt()));
 
   if (_data.isMember("profilePath"))
     Settings::getInstance()->setProfilePath(_data["profilePath"].asString());
@@ -0,0 +1,349 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "access/system/WorkloadLayouter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+#include <log4cxx/logger.h>
+
+#include "access/LayoutTable.h"
+#include "layouter/calibration.h"
+#include "storage/PointerCalculator.h"
+#include "storage/Store.h"
+#include "storage/TableRangeView.h"
+#include "storage/storage_types_helper.h"
+
+namespace hyrise {
+namespace access {
+
+namespace {
+log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("hyrise.access.WorkloadLayouter"));
+
+const double DEFAULT_IMPROVEMENT = 0.1;
+
+double totalCost(const std::vector<double>& cost) {
+  return std::accumulate(cost.begin(), cost.end(), 0.0);
+}
+
+/// Current layout of the main table, partitions are consecutive columns
+layouter::Layout currentLayout(const storage::c_atable_ptr_t& main) {
+  layouter::Layout layout;
+  unsigned column = 0;
+  for (unsigned partition = 0; partition < main->partitionCount(); ++partition) {
+    layouter::subset_t subset;
+    for (size_t i = 0; i < main->partitionWidth(partition); ++i)
+      subset.push_back(column++);
+    layout.add(subset);
+  }
+  return layout;
+}
+
+/// Cuts the containers of layout into partitions of consecutive columns
+layouter::Layout consecutiveLayout(const layouter::Layout& layout, size_t columns) {
+  std::vector<size_t> container(columns, 0);
+  const auto raw = layout.raw();
+  for (size_t c = 0; c < raw.size(); ++c) {
+    for (const auto& column : raw[c])
+      container[column] = c;
+  }
+
+  layouter::Layout result;
+  layouter::subset_t subset;
+  for (unsigned column = 0; column < columns; ++column) {
+    if (!subset.empty() && container[column] != container[column - 1]) {
+      result.add(subset);
+      subset.clear();
+    }
+    subset.push_back(column);
+  }
+  if (!subset.empty())
+    result.add(subset);
+  return result;
+}
+
+/// Table header describing layout for the columns of table
+std::string layoutHeader(const layouter::Layout& layout, const storage::c_atable_ptr_t& table) {
+  std::vector<std::string> names, types, groups;
+  const auto raw = layout.raw();
+  for (size_t c = 0; c < raw.size(); ++c) {
+    for (const auto& column : raw[c]) {
+      names.push_back(table->nameOfColumn(column));
+      types.push_back(data_type_to_string(table->typeOfColumn(column)));
+      groups.push_back(std::to_string(c) + "_R");
+    }
+  }
+
+  std::stringstream header;
+  for (const auto& line : {names, types, groups}) {
+    for (size_t i = 0; i < line.size(); ++i)
+      header << (i > 0 ? "|" : "") << line[i];
+    header << "\n";
+  }
+  return header.str();
+}
+
+/// True if a and b share ownership, without locking the weak pointer
+bool sameStore(const std::weak_ptr<storage::Store>& a, const std::shared_ptr<storage::Store>& b) {
+  return !a.owner_before(b) && !b.owner_before(a);
+}
+}
+
+struct WorkloadLayouter::buffer_t {
+  buffer_t() : owned(true) {}
+
+  typedef struct {
+    std::weak_ptr<storage::Store> store;
+    std::map<access_t, unsigned> accesses;
+  } store_accesses_t;
+
+  // Only contended while a round collects the accesses
+  std::mutex mtx;
+  std::map<const storage::Store *, store_accesses_t> pending;
+  std::atomic<bool> owned;
+};
+
+/// Hands the buffer of a thread back to the layouter when the thread ends
+struct WorkloadLayouter::owner_t {
+  buffer_t* buffer = nullptr;
+
+  ~owner_t() {
+    if (buffer)
+      buffer->owned = false;
+  }
+};
+
+WorkloadLayouter& WorkloadLayouter::getInstance() {
+  static WorkloadLayouter layouter;
+  return layouter;
+}
+
+WorkloadLayouter::WorkloadLayouter() :
+    _recording(false),
+    _improvement(DEFAULT_IMPROVEMENT),
+    _running(false) {}
+
+WorkloadLayouter::~WorkloadLayouter() {
+  stop();
+}
+
+void WorkloadLayouter::start(std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if (_running)
+    throw std::runtime_error("Workload layouter is already running");
+  _recording = true;
+  _running = true;
+  _thread = std::thread(&WorkloadLayouter::run, this, interval);
+}
+
+void WorkloadLayouter::stop() {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (!_running)
+      return;
+    _running = false;
+  }
+  _wakeup.notify_all();
+  _thread.join();
+}
+
+void WorkloadLayouter::run(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(_mtx);
+  while (_running) {
+    _wakeup.wait_for(lock, interval);
+    if (!_running)
+      break;
+    lock.unlock();
+    try {
+      relayout();
+    } catch (const std::exception& e) {
+      LOG4CXX_ERROR(_logger, "Relayout failed: " << e.what());
+    }
+    lock.lock();
+  }
+}
+
+void WorkloadLayouter::setRecording(bool recording) {
+  _recording = recording;
+}
+
+bool WorkloadLayouter::isRecording() const {
+  return _recording;
+}
+
+void WorkloadLayouter::setImprovementThreshold(double ratio) {
+  _improvement = ratio;
+}
+
+void WorkloadLayouter::record(const storage::c_atable_ptr_t& table, const field_list_t& fields) {
+  if (!table || fields.empty())
+    return;
+
+  // Follow position lists down to the store, mapping the fields
+  const size_t rows = table->size();
+  field_list_t columns(fields);
+  storage::c_atable_ptr_t base = table;
+  while (const auto pc = std::dynamic_pointer_cast<const storage::PointerCalculator>(base)) {
+    for (auto& column : columns) {
+      if (column >= pc->columnCount())
+        return;
+      column = pc->getTableColumnForColumn(column);
+    }
+    base = pc->getTable();
+  }
+  // Parallel instances read a range of the rows each, count them as full accesses
+  if (const auto view = std::dynamic_pointer_cast<const storage::TableRangeView>(base))
+    base = view->getTable();
+
+  const auto store = std::const_pointer_cast<storage::Store>(std::dynamic_pointer_cast<const storage::Store>(base));
+  if (!store || store->size() == 0)
+    return;
+
+  access_t access;
+  for (const auto& column : columns) {
+    if (column >= store->columnCount())
+      return;
+    access.first.push_back(column);
+  }
+  std::sort(access.first.begin(), access.first.end());
+  access.first.erase(std::unique(access.first.begin(), access.first.end()), access.first.end());
+  const bool full = std::dynamic_pointer_cast<const storage::PointerCalculator>(table) == nullptr;
+  access.second = full ? 100 : std::max(1u, std::min(100u, (unsigned) std::lround(100.0 * rows / store->size())));
+
+  auto* buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mtx);
+  auto& accesses = buffer->pending[store.get()];
+  if (!sameStore(accesses.store, store)) {
+    // Another store reuses the address of a dropped one
+    accesses.store = store;
+    accesses.accesses.clear();
+  }
+  ++accesses.accesses[access];
+}
+
+WorkloadLayouter::buffer_t* WorkloadLayouter::threadBuffer() {
+  static thread_local owner_t owner;
+  if (owner.buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(_recordMtx);
+    for (const auto& buffer : _buffers) {
+      bool owned = false;
+      if (buffer->owned.compare_exchange_strong(owned, true)) {
+        owner.buffer = buffer.get();
+        break;
+      }
+    }
+    if (owner.buffer == nullptr) {
+      _buffers.emplace_back(new buffer_t);
+      owner.buffer = _buffers.back().get();
+    }
+  }
+  return owner.buffer;
+}
+
+void WorkloadLayouter::collect() {
+  std::lock_guard<std::mutex> lock(_recordMtx);
+  for (const auto& buffer : _buffers) {
+    std::map<const storage::Store *, buffer_t::store_accesses_t> pending;
+    {
+      std::lock_guard<std::mutex> bufferLock(buffer->mtx);
+      pending.swap(buffer->pending);
+    }
+    for (auto& p : pending) {
+      const auto store = p.second.store.lock();
+      if (!store)
+        continue;
+      auto& workload = _tables[p.first];
+      if (!workload || !sameStore(workload->store, store)) {
+        // The store is new or another store reuses the address of a
+        // dropped one, which a running round cannot use as it holds its
+        // stores
+        workload.reset(new table_workload_t);
+        workload->store = store;
+      }
+      for (const auto& access : p.second.accesses)
+        workload->pending[access.first] += access.second;
+    }
+  }
+}
+
+size_t WorkloadLayouter::relayout() {
+  std::lock_guard<std::mutex> layoutLock(_layoutMtx);
+  collect();
+
+  std::vector<std::pair<std::shared_ptr<storage::Store>, table_workload_t *>> stores;
+  for (auto it = _tables.begin(); it != _tables.end();) {
+    auto store = it->second->store.lock();
+    if (!store) {
+      it = _tables.erase(it);
+      continue;
+    }
+    if (!it->second->pending.empty())
+      stores.emplace_back(store, it->second.get());
+    ++it;
+  }
+
+  size_t changed = 0;
+  for (const auto& s : stores) {
+    if (relayout(s.first, *s.second))
+      ++changed;
+  }
+  return changed;
+}
+
+bool WorkloadLayouter::relayout(const std::shared_ptr<storage::Store>& store, table_workload_t& workload) {
+  std::map<access_t, unsigned> pending;
+  pending.swap(workload.pending);
+
+  std::vector<layouter::Query *> queries;
+  for (const auto& access : pending) {
+    const bool full = access.first.second == 100;
+    workload.queries.emplace_back(new layouter::Query(
+        full ? layouter::LayouterConfiguration::access_type_fullprojection : layouter::LayouterConfiguration::access_type_outoforder,
+        access.first.first,
+        full ? -1.0 : access.first.second / 100.0,
+        access.second));
+    queries.push_back(workload.queries.back().get());
+  }
+
+  const auto main = store->getMainTable();
+  const size_t columns = main->columnCount();
+  if (!workload.layouter) {
+    std::vector<std::string> names;
+    for (size_t column = 0; column < columns; ++column)
+      names.push_back(main->nameOfColumn(column));
+    layouter::Schema schema(std::vector<unsigned>(columns, sizeof(value_id_t)), store->size(), names);
+    for (const auto& query : queries)
+      schema.add(query);
+    workload.layouter.reset(new layouter::IncrementalCandidateLayouter());
+    workload.layouter->layout(schema, layouter::CostCalibration::current()->empty() ? HYRISE_COST : CALIBRATED_COST);
+  } else {
+    for (const auto& query : queries)
+      workload.layouter->incrementalLayout(query);
+  }
+
+  const auto current = currentLayout(main);
+  const auto proposed = consecutiveLayout(workload.layouter->getBestResult().layout, columns);
+  if (proposed == current || store->hasNextMain())
+    return false;
+
+  const double currentCost = totalCost(workload.layouter->getCost(current));
+  const double proposedCost = totalCost(workload.layouter->getCost(proposed));
+  if (proposedCost >= currentCost * (1.0 - _improvement))
+    return false;
+
+  LOG4CXX_INFO(_logger, "Changing layout of store with " << columns << " columns from "
+               << current.containerCount() << " to " << proposed.containerCount()
+               << " partitions with the next merge, cost " << currentCost << " -> " << proposedCost);
+  store->setNextMain(LayoutTable::createEmptyLayoutedTable(layoutHeader(proposed, main), main));
+  return true;
+}
+
+void WorkloadLayouter::clear() {
+  std::lock_guard<std::mutex> layoutLock(_layoutMtx);
+  collect();
+  _tables.clear();
+}
+
+}
+}
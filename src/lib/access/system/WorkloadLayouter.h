@@ -0,0 +1,118 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "helper/noncopyable.h"
+#include "helper/types.h"
+#include "layouter/incremental.h"
+#include "storage/storage_types.h"
+
+namespace hyrise {
+
+namespace storage {
+class Store;
+}
+
+namespace access {
+
+/// Adapts the vertical partitioning of stores to the queries executed on
+/// them.
+///
+/// While recording, plan operations report the columns they read from
+/// their input into a buffer of their thread. Accesses to a store,
+/// directly or through position lists, are aggregated by columns and
+/// selectivity, i.e. the share of the rows of the store the operation
+/// read. Every relayout() collects the accesses of all threads recorded
+/// since the previous round, turns them into layouter queries and adds
+/// them to an IncrementalCandidateLayouter per store. The columns of a
+/// store keep their order, so the best layout is cut into partitions of
+/// consecutive columns. If that layout is cheaper than the current layout
+/// of the main table by more than the improvement threshold, the store
+/// gets an empty main in the new layout that its next merge writes into.
+class WorkloadLayouter : noncopyable {
+ public:
+  static WorkloadLayouter& getInstance();
+
+  ~WorkloadLayouter();
+
+  /// Starts recording and runs relayout() in a background thread every
+  /// interval
+  void start(std::chrono::milliseconds interval);
+
+  /// Stops the background thread, recording stays enabled
+  void stop();
+
+  void setRecording(bool recording);
+  bool isRecording() const;
+
+  /// Relative cost improvement required to change the layout of a store
+  void setImprovementThreshold(double ratio);
+
+  /// Records that an operation read fields of all rows of table
+  void record(const storage::c_atable_ptr_t& table, const field_list_t& fields);
+
+  /// Runs the layouter for every store with recorded accesses on the
+  /// calling thread
+  /// \returns number of stores that change their layout with the next merge
+  size_t relayout();
+
+  /// Forgets all recorded accesses
+  void clear();
+
+ private:
+  // Sorted columns and selectivity in percent of an access
+  typedef std::pair<std::vector<unsigned>, unsigned> access_t;
+
+  typedef struct {
+    std::weak_ptr<storage::Store> store;
+    // Accesses since the last round and their number
+    std::map<access_t, unsigned> pending;
+    // Queries of all rounds, referenced by the layouter
+    std::vector<std::unique_ptr<layouter::Query>> queries;
+    std::unique_ptr<layouter::IncrementalCandidateLayouter> layouter;
+  } table_workload_t;
+
+  struct buffer_t;
+  struct owner_t;
+
+  WorkloadLayouter();
+
+  void run(std::chrono::milliseconds interval);
+
+  buffer_t* threadBuffer();
+
+  /// Moves the accesses in the buffers of all threads to the pending
+  /// accesses of their stores
+  void collect();
+
+  /// Returns true if the store gets a new layout
+  bool relayout(const std::shared_ptr<storage::Store>& store, table_workload_t& workload);
+
+  std::atomic<bool> _recording;
+  std::atomic<double> _improvement;
+
+  // Buffers of all threads that recorded accesses, buffers of threads that
+  // ended are handed to new threads
+  std::mutex _recordMtx;
+  std::vector<std::unique_ptr<buffer_t>> _buffers;
+  // Serializes rounds, guards the workloads of the stores
+  std::mutex _layoutMtx;
+  std::map<const storage::Store *, std::unique_ptr<table_workload_t>> _tables;
+
+  std::thread _thread;
+  bool _running;
+  std::mutex _mtx;
+  std::condition_variable _wakeup;
+};
+
+}
+}
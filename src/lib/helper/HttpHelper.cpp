@@ -48,6 +48,24 @@ std::unique_ptr<char, decltype(&std::free)> url_decode(const char *str) {
   return {buf, &std::free};
 }
 
+/* Returns a url-encoded version of str */
+std::string url_encode(const std::string &str) {
+  std::string result;
+  result.reserve(str.size() * 3);
+  for (const char c : str) {
+    if (isalnum((unsigned char) c) || c == '-' || c == '_' || c == '.' || c == '~') {
+      result += c;
+    } else if (c == ' ') {
+      result += '+';
+    } else {
+      result += '%';
+      result += to_hex(c >> 4);
+      result += to_hex(c & 15);
+    }
+  }
+  return result;
+}
+
 }
 
 
@@ -76,3 +94,7 @@ std::string urldecode(const std::string &input) {
   std::string res(t.get());
   return std::move(res);
 }
+
+std::string urlencode(const std::string &input) {
+  return test::url_encode(input);
+}
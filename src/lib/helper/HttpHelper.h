@@ -6,3 +6,5 @@ std::map<std::string, std::string> parseHTTPFormData(std::string formData, const
 
 std::string urldecode(const std::string &input);
 
+std::string urlencode(const std::string &input);
+
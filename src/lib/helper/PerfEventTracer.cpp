@@ -0,0 +1,154 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "helper/PerfEventTracer.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+const int COUNTERS = 4;
+
+// In the order of perf_counters_t, the cycle counter leads the group
+const uint64_t EVENTS[COUNTERS] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/// The counters of one thread, read together
+class CounterGroup {
+ public:
+  CounterGroup() : _opened(0) {
+    int leader = -1;
+    for (int i = 0; i < COUNTERS; ++i) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = EVENTS[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      _fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+      if (_fds[i] >= 0) {
+        _order[_opened++] = i;
+        if (leader < 0)
+          leader = _fds[i];
+      } else if (i == 0) {
+        // without the leader there is no group to add the others to
+        for (int j = 1; j < COUNTERS; ++j)
+          _fds[j] = -1;
+        return;
+      }
+    }
+  }
+
+  ~CounterGroup() {
+    for (int i = 0; i < COUNTERS; ++i) {
+      if (_fds[i] >= 0)
+        close(_fds[i]);
+    }
+  }
+
+  bool available() const {
+    return _opened > 0;
+  }
+
+  /// Reads the counters into values, -1 for counters that are not open
+  bool read(int64_t values[], int64_t &enabled, int64_t &running) const {
+    if (!available())
+      return false;
+
+    uint64_t buffer[3 + COUNTERS];
+    const ssize_t expected = (3 + _opened) * sizeof(uint64_t);
+    if (::read(_fds[0], buffer, sizeof(buffer)) != expected)
+      return false;
+
+    enabled = buffer[1];
+    running = buffer[2];
+    for (int i = 0; i < COUNTERS; ++i)
+      values[i] = -1;
+    for (int i = 0; i < _opened; ++i)
+      values[_order[i]] = buffer[3 + i];
+    return true;
+  }
+
+ private:
+  int _fds[COUNTERS];
+  // Counter of the i-th value of a group read
+  int _order[COUNTERS];
+  int _opened;
+};
+
+thread_local bool disabled = false;
+
+/// The group of the calling thread, nullptr if it does not count
+const CounterGroup *counters() {
+  if (disabled)
+    return nullptr;
+  static thread_local CounterGroup group;
+  return &group;
+}
+
+#endif
+
+const perf_counters_t UNAVAILABLE = {-1, -1, -1, -1};
+
+}
+
+PerfEventTracer::PerfEventTracer() : _enabled(0), _running(0), _started(false), _values(UNAVAILABLE) {}
+
+void PerfEventTracer::start() {
+#ifdef __linux__
+  const auto *group = counters();
+  _started = group && group->read(_start, _enabled, _running);
+#endif
+}
+
+void PerfEventTracer::stop() {
+  _values = UNAVAILABLE;
+#ifdef __linux__
+  int64_t end[COUNTERS], enabled, running;
+  if (!_started || !counters()->read(end, enabled, running))
+    return;
+  _started = false;
+
+  // share of the time the group was on the PMU, nothing was counted if
+  // it never was
+  const int64_t enabledDelta = enabled - _enabled;
+  const int64_t runningDelta = running - _running;
+  if (runningDelta <= 0)
+    return;
+  const double scale = static_cast<double>(enabledDelta) / runningDelta;
+
+  int64_t *values[COUNTERS] = {&_values.cycles, &_values.instructions, &_values.llcMisses, &_values.branchMisses};
+  for (int i = 0; i < COUNTERS; ++i) {
+    if (end[i] >= 0)
+      *values[i] = static_cast<int64_t>((end[i] - _start[i]) * scale);
+  }
+#endif
+}
+
+bool PerfEventTracer::isAvailable() {
+#ifdef __linux__
+  const auto *group = counters();
+  return group && group->available();
+#else
+  return false;
+#endif
+}
+
+void PerfEventTracer::disableForThread() {
+#ifdef __linux__
+  disabled = true;
+#endif
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <stdint.h>
+
+/// Hardware counters measured by a PerfEventTracer, -1 for counters the
+/// kernel or the machine does not provide
+typedef struct {
+  int64_t cycles;
+  int64_t instructions;
+  int64_t llcMisses;
+  int64_t branchMisses;
+} perf_counters_t;
+
+/// Counts hardware events of the calling thread with perf_event_open,
+/// without the PAPI library
+///
+/// Usage:
+///
+///     PerfEventTracer pt;
+///     pt.start();
+///     /* do some work */
+///     pt.stop();
+///     std::cout << pt.values().cycles << std::endl;
+///
+/// The counters of a thread are opened as one group on its first use
+/// and stay open for the lifetime of the thread, so start and stop only
+/// read the group once each. start and stop have to be called on the
+/// same thread. Counters the kernel multiplexes are scaled to the time
+/// they were enabled, all values are -1 if the group was not scheduled
+/// on the PMU between start and stop. If perf events are not permitted,
+/// e.g. by kernel.perf_event_paranoid, or not supported, all values are
+/// -1 as well.
+class PerfEventTracer {
+ public:
+  PerfEventTracer();
+
+  void start();
+  void stop();
+
+  const perf_counters_t &values() const {
+    return _values;
+  }
+
+  /// True if the calling thread could open at least the cycle counter
+  static bool isAvailable();
+
+  /// Keeps the calling thread from opening counters, for threads that run
+  /// a single task and would open and close the group for it
+  static void disableForThread();
+
+ private:
+  static const int COUNTERS = 4;
+
+  int64_t _start[COUNTERS];
+  int64_t _enabled;
+  int64_t _running;
+  bool _started;
+  perf_counters_t _values;
+};
@@ -0,0 +1,138 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "helper/QueryArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+namespace hyrise {
+
+const size_t QueryArena::alignment;
+const size_t QueryArena::first_chunk_size;
+const size_t QueryArena::max_chunk_size;
+const size_t QueryArena::min_reuse_size;
+const size_t QueryArena::STRIPES;
+const size_t QueryArena::REUSE_CLASSES;
+
+namespace {
+std::atomic<size_t> _defaultLimit(0);
+
+size_t stripeOfThread(size_t stripes) {
+  static std::atomic<size_t> next(0);
+  static thread_local size_t stripe = next++;
+  return stripe % stripes;
+}
+
+/// Size class of a freed block, the largest i with min_reuse_size << i <= bytes
+size_t freeClass(size_t bytes, size_t classes) {
+  size_t c = 0;
+  while (c + 1 < classes && (QueryArena::min_reuse_size << (c + 1)) <= bytes)
+    ++c;
+  return c;
+}
+}
+
+QueryArena::QueryArena(size_t limit) : _limit(limit) {}
+
+QueryArena::~QueryArena() {
+  for (auto chunk : _chunks)
+    free(chunk);
+}
+
+void *QueryArena::allocate(size_t bytes) {
+  bytes = (bytes + alignment - 1) & ~(alignment - 1);
+  const size_t limit = _limit;
+  if (_allocated.fetch_add(bytes) + bytes > limit && limit > 0) {
+    _allocated -= bytes;
+    throw QueryMemoryExceeded("Query exceeded its memory limit of " + std::to_string(limit) + " bytes");
+  }
+
+  if (bytes >= min_reuse_size && _freeBlocks > 0) {
+    if (void *block = reuse(bytes))
+      return block;
+  }
+
+  auto& stripe = _stripes[stripeOfThread(STRIPES)];
+  std::lock_guard<locking::Spinlock> guard(stripe.lock);
+  if (bytes > static_cast<size_t>(stripe.end - stripe.next)) {
+    // Large allocations get their own chunk so that the current one is
+    // not abandoned
+    if (bytes > stripe.chunkSize / 2)
+      return newChunk(bytes);
+    stripe.next = newChunk(stripe.chunkSize);
+    stripe.end = stripe.next + stripe.chunkSize;
+    stripe.chunkSize = std::min(stripe.chunkSize * 2, max_chunk_size);
+  }
+  void *result = stripe.next;
+  stripe.next += bytes;
+  return result;
+}
+
+void QueryArena::deallocate(void *p, size_t bytes) {
+  bytes = (bytes + alignment - 1) & ~(alignment - 1);
+  // Smaller blocks are left in their chunk and stay accounted
+  if (p == nullptr || bytes < min_reuse_size)
+    return;
+  {
+    std::lock_guard<locking::Spinlock> guard(_freeLock);
+    _free[freeClass(bytes, REUSE_CLASSES)].push_back(p);
+  }
+  ++_freeBlocks;
+  _allocated -= bytes;
+}
+
+void *QueryArena::reuse(size_t bytes) {
+  // Every block of the next larger class than the one of bytes is large
+  // enough, blocks of the class of bytes itself may be smaller
+  std::lock_guard<locking::Spinlock> guard(_freeLock);
+  const size_t c = freeClass(bytes, REUSE_CLASSES);
+  const size_t first = (min_reuse_size << c) == bytes ? c : c + 1;
+  for (size_t i = first; i < REUSE_CLASSES; ++i) {
+    if (!_free[i].empty()) {
+      void *block = _free[i].back();
+      _free[i].pop_back();
+      --_freeBlocks;
+      return block;
+    }
+  }
+  return nullptr;
+}
+
+char *QueryArena::newChunk(size_t bytes) {
+  void *chunk = nullptr;
+  if (posix_memalign(&chunk, alignment, bytes) != 0)
+    throw std::bad_alloc();
+  {
+    std::lock_guard<locking::Spinlock> guard(_chunkLock);
+    _chunks.push_back(static_cast<char *>(chunk));
+  }
+  _reserved += bytes;
+  return static_cast<char *>(chunk);
+}
+
+size_t QueryArena::allocated() const {
+  return _allocated;
+}
+
+size_t QueryArena::reserved() const {
+  return _reserved;
+}
+
+void QueryArena::setLimit(size_t limit) {
+  _limit = limit;
+}
+
+size_t QueryArena::getLimit() const {
+  return _limit;
+}
+
+void QueryArena::setDefaultLimit(size_t limit) {
+  _defaultLimit = limit;
+}
+
+size_t QueryArena::getDefaultLimit() {
+  return _defaultLimit;
+}
+
+}  // namespace hyrise
@@ -0,0 +1,174 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "helper/locking.h"
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+
+/// Thrown when a query allocates more than the limit of its arena
+class QueryMemoryExceeded : public std::runtime_error {
+ public:
+  explicit QueryMemoryExceeded(const std::string& what) : std::runtime_error(what) {}
+};
+
+/// Memory for the intermediate results of one query.
+///
+/// Allocations are served by bumping a pointer through chunks that are
+/// allocated from the global heap, each chunk twice as large as the one
+/// before up to max_chunk_size. Operators of a query allocate on several
+/// threads at once, so every thread bumps through the chunks of one of
+/// a few stripes of the arena. Freed blocks of at least min_reuse_size
+/// bytes, e.g. the buckets of a hash table that grew, no longer count
+/// towards the limit and serve later allocations; the chunks themselves
+/// are released at once when the arena is destroyed. The arena counts the
+/// bytes it handed out and throws QueryMemoryExceeded if an allocation
+/// would exceed the limit.
+class QueryArena : noncopyable {
+ public:
+  static const size_t alignment = 16;
+  static const size_t first_chunk_size = 64 * 1024;
+  static const size_t max_chunk_size = 16 * 1024 * 1024;
+  static const size_t min_reuse_size = 256;
+
+  /// Creates an arena, no memory is reserved before the first
+  /// allocation. A limit of 0 means unlimited.
+  explicit QueryArena(size_t limit = 0);
+  ~QueryArena();
+
+  void *allocate(size_t bytes);
+  /// Returns a block of bytes from allocate to the arena
+  void deallocate(void *p, size_t bytes);
+
+  /// Bytes handed out by allocate and not deallocated
+  size_t allocated() const;
+  /// Bytes of all chunks taken from the heap
+  size_t reserved() const;
+
+  void setLimit(size_t limit);
+  size_t getLimit() const;
+
+  /// Limit of the arenas of new queries, 0 means unlimited
+  static void setDefaultLimit(size_t limit);
+  static size_t getDefaultLimit();
+
+ private:
+  char *newChunk(size_t bytes);
+  void *reuse(size_t bytes);
+
+  static const size_t STRIPES = 8;
+  // Chunk a thread bumps through, padded so that stripes used by
+  // different threads do not share a cache line
+  typedef struct {
+    locking::Spinlock lock;
+    char *next = nullptr;
+    char *end = nullptr;
+    size_t chunkSize = first_chunk_size;
+    char padding[64];
+  } stripe_t;
+  std::array<stripe_t, STRIPES> _stripes;
+
+  // Guards the list of chunks
+  locking::Spinlock _chunkLock;
+  std::vector<char *> _chunks;
+
+  // Freed blocks by size class, class i holds blocks of at least
+  // min_reuse_size << i bytes
+  static const size_t REUSE_CLASSES = 24;
+  locking::Spinlock _freeLock;
+  std::array<std::vector<void *>, REUSE_CLASSES> _free;
+  std::atomic<size_t> _freeBlocks {0};
+
+  std::atomic<size_t> _allocated {0};
+  std::atomic<size_t> _reserved {0};
+  std::atomic<size_t> _limit;
+};
+
+/// Standard allocator on a QueryArena. Copies share the arena and keep it
+/// alive, so containers using it may outlive the query context that
+/// created them. Without an arena memory comes from the global heap.
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef ArenaAllocator<U> other;
+  };
+
+  ArenaAllocator(const std::shared_ptr<QueryArena>& arena = nullptr) : _arena(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.arena()) {}
+
+  pointer allocate(size_type n, const void * = nullptr) {
+    if (_arena)
+      return static_cast<pointer>(_arena->allocate(n * sizeof(T)));
+    return static_cast<pointer>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (_arena)
+      _arena->deallocate(p, n * sizeof(T));
+    else
+      ::operator delete(p);
+  }
+
+  template <typename U, typename... ARGS>
+  void construct(U *p, ARGS&&... args) {
+    ::new(static_cast<void *>(p)) U(std::forward<ARGS>(args)...);
+  }
+
+  template <typename U>
+  void destroy(U *p) {
+    p->~U();
+  }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  pointer address(reference x) const {
+    return &x;
+  }
+
+  const_pointer address(const_reference x) const {
+    return &x;
+  }
+
+  const std::shared_ptr<QueryArena>& arena() const {
+    return _arena;
+  }
+
+ private:
+  std::shared_ptr<QueryArena> _arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+}  // namespace hyrise
@@ -2,7 +2,7 @@
 #include "Settings.h"
 #include "Environment.h"
 
-Settings::Settings() : threadpoolSize(1) {
+Settings::Settings() : threadpoolSize(1), _MinWorkers(0), _WorkerIdleTimeout(0) {
 
   // Initiate the class based on Enviroment Variables
   setDBPath(getEnv("HYRISE_DB_PATH", ""));
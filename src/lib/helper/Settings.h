@@ -24,6 +24,12 @@ class Settings {
   ADD_MEMBER(std::string, ProfilePath);
   ADD_MEMBER(std::string, DBPath);
 
+  //  Workers the elastic pool of the CentralScheduler keeps while idle,
+  //  and the time in ms after which idle workers above them retire.
+  //  0 keeps the defaults of the scheduler.
+  ADD_MEMBER(size_t, MinWorkers);
+  ADD_MEMBER(size_t, WorkerIdleTimeout);
+
 
   Settings();
 
@@ -5,3 +5,15 @@ inline bool atomic_cas(T* ptr, T oldV, T newV) {
 	return __sync_bool_compare_and_swap(ptr, oldV, newV);
 }
 
+// Publishes a value together with all writes before it to threads that
+// read it with atomic_load_acquire
+template <typename T>
+inline void atomic_store_release(T* ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+inline T atomic_load_acquire(const T* ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
@@ -38,6 +38,7 @@ static const transaction_cid_t INF_CID = std::numeric_limits<transaction_cid_t>:
 enum class TX_CODE {
 	TX_OK,
 	TX_FAIL_CONCURRENT_COMMIT,
+	TX_FAIL_LOCK_TIMEOUT,
 	TX_FAIL_OTHER
 };
 
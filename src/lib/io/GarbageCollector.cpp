@@ -0,0 +1,140 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "io/GarbageCollector.h"
+
+#include "helper/epoch.h"
+#include "io/StorageManager.h"
+#include "io/TransactionManager.h"
+#include "storage/Store.h"
+
+#include <log4cxx/logger.h>
+
+namespace hyrise {
+namespace io {
+
+namespace {
+log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("hyrise.io.GarbageCollector"));
+
+const auto DEFAULT_SESSION_TIMEOUT = std::chrono::minutes(10);
+const double DEFAULT_FRAGMENTATION_RATIO = 0.25;
+const size_t DEFAULT_FRAGMENTATION_MIN_ROWS = 1024;
+}
+
+GarbageCollector& GarbageCollector::getInstance() {
+  static GarbageCollector gc;
+  return gc;
+}
+
+GarbageCollector::GarbageCollector() :
+    _sessionTimeout(std::chrono::duration_cast<std::chrono::nanoseconds>(DEFAULT_SESSION_TIMEOUT).count()),
+    _fragmentationRatio(DEFAULT_FRAGMENTATION_RATIO),
+    _fragmentationMinRows(DEFAULT_FRAGMENTATION_MIN_ROWS),
+    _running(false),
+    _stats({0, 0, 0}) {}
+
+GarbageCollector::~GarbageCollector() {
+  stop();
+}
+
+void GarbageCollector::start(std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if (_running)
+    throw std::runtime_error("Garbage collector is already running");
+  _running = true;
+  _thread = std::thread(&GarbageCollector::run, this, interval);
+}
+
+void GarbageCollector::stop() {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (!_running)
+      return;
+    _running = false;
+  }
+  _wakeup.notify_all();
+  _thread.join();
+}
+
+void GarbageCollector::run(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(_mtx);
+  while (_running) {
+    _wakeup.wait_for(lock, interval);
+    if (!_running)
+      break;
+    lock.unlock();
+    try {
+      collect();
+    } catch (const std::exception& e) {
+      LOG4CXX_ERROR(_logger, "Garbage collection failed: " << e.what());
+    }
+    lock.lock();
+  }
+}
+
+gc_stats_t GarbageCollector::collect() {
+  std::lock_guard<std::mutex> lock(_collectMtx);
+  gc_stats_t result = {0, 0, 0};
+
+  // Abandoned transactions release their locks and no longer pin old snapshots
+  const epoch_t now = get_epoch_nanoseconds();
+  const epoch_t timeout = _sessionTimeout;
+  if (now > timeout)
+    result.transactions = tx::TransactionManager::reclaimAbandonedTransactions(now - timeout);
+
+  const auto oldest_snapshot = tx::TransactionManager::getOldestActiveSnapshot();
+  auto* sm = StorageManager::getInstance();
+  for (const auto& name : sm->getTableNames()) {
+    auto store = std::dynamic_pointer_cast<storage::Store>(sm->getTable(name));
+    if (!store)
+      continue;
+
+    const size_t delta_size = store->getDeltaTable()->size();
+    if (delta_size < _fragmentationMinRows)
+      continue;
+
+    // Writers wait while the store is checked and copied, readers keep
+    // reading it and see the copy in their next query
+    storage::Store::WriteExclusion exclusion(*store);
+    const size_t dead = store->deadDeltaRows(oldest_snapshot);
+    if (dead <= delta_size * _fragmentationRatio || tx::TransactionManager::hasActiveModifications(store))
+      continue;
+
+    const auto compacted = store->compactDelta(oldest_snapshot);
+    if (!compacted)
+      continue;
+    sm->replaceTable(name, compacted);
+    // Transactions that still hold the old store fail to write to it
+    exclusion.retire();
+
+    const size_t removed = store->size() - compacted->size();
+    result.rows += removed;
+    // Value ids of all columns plus begin, end and tid of each row
+    result.bytes += removed * (store->columnCount() * sizeof(storage::value_id_t) + 3 * sizeof(tx::transaction_id_t));
+    LOG4CXX_DEBUG(_logger, "Compacted delta of " << name << ", removed " << removed << " of " << delta_size << " rows");
+  }
+
+  _stats.transactions += result.transactions;
+  _stats.rows += result.rows;
+  _stats.bytes += result.bytes;
+
+  if (result.transactions > 0 || result.rows > 0) {
+    LOG4CXX_INFO(_logger, "Reclaimed " << result.transactions << " transactions and "
+                 << result.rows << " rows (" << result.bytes << " bytes)");
+  }
+  return result;
+}
+
+gc_stats_t GarbageCollector::getStats() const {
+  std::lock_guard<std::mutex> lock(_collectMtx);
+  return _stats;
+}
+
+void GarbageCollector::setSessionTimeout(std::chrono::milliseconds timeout) {
+  _sessionTimeout = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+}
+
+void GarbageCollector::setFragmentationThreshold(double ratio, size_t min_rows) {
+  _fragmentationRatio = ratio;
+  _fragmentationMinRows = min_rows;
+}
+
+} } // namespace hyrise::io
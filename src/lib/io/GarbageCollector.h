@@ -0,0 +1,81 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "helper/noncopyable.h"
+#include "helper/types.h"
+
+namespace hyrise {
+namespace io {
+
+/// Result of one or more garbage collection runs
+typedef struct {
+  /// Number of abandoned transactions that were rolled back
+  size_t transactions;
+  /// Number of dead delta rows that were physically removed
+  size_t rows;
+  /// Estimated number of bytes freed by removing the rows
+  size_t bytes;
+} gc_stats_t;
+
+/// Background garbage collector for transaction state and dead row versions
+///
+/// Each run rolls back transactions that were not accessed within the
+/// session timeout, e.g. sessions that clients abandoned after obtaining
+/// a session context. Afterwards the delta of every store in the
+/// StorageManager is compacted if its share of rows that are invisible to
+/// the oldest active snapshot exceeds the fragmentation threshold and no
+/// registered transaction modifies the store. Compaction excludes the
+/// writers of the store, replaces it in the StorageManager by a compacted
+/// copy and retires it, so transactions that still write to the old store
+/// fail and have to be retried.
+class GarbageCollector : noncopyable {
+ public:
+  static GarbageCollector& getInstance();
+
+  ~GarbageCollector();
+
+  /// Starts collecting in a background thread every interval
+  void start(std::chrono::milliseconds interval);
+
+  /// Stops the background thread, waiting for a running collection
+  void stop();
+
+  /// Runs a single collection on the calling thread
+  gc_stats_t collect();
+
+  /// Accumulated statistics of all collections
+  gc_stats_t getStats() const;
+
+  /// Transactions not accessed for longer than timeout are rolled back
+  void setSessionTimeout(std::chrono::milliseconds timeout);
+
+  /// Deltas with at least min_rows rows of which more than ratio are dead
+  /// are compacted
+  void setFragmentationThreshold(double ratio, size_t min_rows);
+
+ private:
+  GarbageCollector();
+
+  void run(std::chrono::milliseconds interval);
+
+  std::atomic<uint64_t> _sessionTimeout;
+  std::atomic<double> _fragmentationRatio;
+  std::atomic<size_t> _fragmentationMinRows;
+
+  std::thread _thread;
+  bool _running;
+  std::mutex _mtx;
+  std::condition_variable _wakeup;
+
+  // Serializes collections and guards _stats
+  mutable std::mutex _collectMtx;
+  gc_stats_t _stats;
+};
+
+} } // namespace hyrise::io
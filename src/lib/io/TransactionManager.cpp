@@ -4,6 +4,7 @@
 #include <limits>
 #include <stdexcept>
 #include <map>
+#include <numeric>
 
 #include "optional.hpp"
 #include "helper/make_unique.h"
@@ -15,13 +16,26 @@ namespace hyrise {
 namespace tx {
 
 void TXModifications::insertPos(const storage::c_atable_ptr_t& tab, pos_t pos) {
-  static locking::Spinlock _mtx;
-  _handle(_mtx, inserted, tab, pos);
+  std::lock_guard<locking::Spinlock> lck(_mtx);
+  inserted[tab].push_back(pos);
+}
+
+void TXModifications::insertPositions(const storage::c_atable_ptr_t& tab, pos_t first, size_t count) {
+  std::lock_guard<locking::Spinlock> lck(_mtx);
+  auto& positions = inserted[tab];
+  positions.resize(positions.size() + count);
+  std::iota(positions.end() - count, positions.end(), first);
 }
 
 void TXModifications::deletePos(const storage::c_atable_ptr_t& tab, pos_t pos) {
-  static locking::Spinlock _mtx;
-  _handle(_mtx, deleted, tab, pos);
+  std::lock_guard<locking::Spinlock> lck(_mtx);
+  deleted[tab].push_back(pos);
+}
+
+void TXModifications::deletePositions(const storage::c_atable_ptr_t& tab, const pos_list_t& pos) {
+  std::lock_guard<locking::Spinlock> lck(_mtx);
+  auto& positions = deleted[tab];
+  positions.insert(positions.end(), pos.begin(), pos.end());
 }
 
 bool TXModifications::hasDeleted(const storage::c_atable_ptr_t& tab) const {
@@ -45,17 +59,21 @@ bool TXModifications::handleCheck(const map_t& data, const storage::c_atable_ptr
   return (it != data.end() && it->second.size() > 0);
 }
 
-void TXModifications::_handle(locking::Spinlock& mtx, map_t& data, const storage::c_atable_ptr_t& key, pos_t pos) {
-  std::lock_guard<locking::Spinlock> lck(mtx);
-  if(data.find(key) == data.end()) {
-    data[key] = pos_list_t();
-  }
-  data[key].push_back(pos);
-}
+const transaction_cid_t TransactionManager::COMMIT_WINDOW;
+const size_t TransactionManager::REGISTRY_SHARDS;
+const size_t TransactionManager::DEFAULT_LOCK_WAIT_TIMEOUT_US;
 
 TransactionManager::TransactionManager() :
     _transactionCount(ATOMIC_VAR_INIT(tx::START_TID)),
-    _commitId(ATOMIC_VAR_INIT(tx::UNKNOWN_CID)) {}
+    _commitId(ATOMIC_VAR_INIT(tx::UNKNOWN_CID)),
+    _nextCommitId(ATOMIC_VAR_INIT(tx::UNKNOWN_CID)),
+    _lockWaitTimeout(ATOMIC_VAR_INIT(DEFAULT_LOCK_WAIT_TIMEOUT_US)),
+    _collectedSnapshot(ATOMIC_VAR_INIT(tx::UNKNOWN_CID)),
+    _completed(new std::atomic<transaction_cid_t>[COMMIT_WINDOW]) {
+  for (transaction_cid_t i = 0; i < COMMIT_WINDOW; ++i) {
+    _completed[i] = UNKNOWN_CID;
+  }
+}
 
 TransactionManager& TransactionManager::getInstance() {
   static TransactionManager tm;
@@ -79,35 +97,165 @@ TXContext TransactionManager::buildContext() {
 }
 
 transaction_cid_t TransactionManager::prepareCommit() {
-  transaction_id_t result;
-  while((result = tryPrepareCommit()) == 0) {
+  const transaction_cid_t cid = ++_nextCommitId;
+  // Wait until the completion slot for this cid is no longer in use by an
+  // older commit, the commit at the head of the window never waits
+  while (cid - getLastCommitId() >= COMMIT_WINDOW) {
     std::this_thread::yield();
   }
-  return result;
+  return cid;
 }
 
-void TransactionManager::abort() {
-  if (!_txLock.is_locked())
-    throw std::runtime_error("Cannot abort a not running transaction.");
-  _txLock.unlock();
+void TransactionManager::abort(transaction_cid_t cid) {
+  publishCommit(cid);
 }
 
-transaction_cid_t TransactionManager::tryPrepareCommit() {
-  _txLock.lock();
-  return getLastCommitId() + 1;
+void TransactionManager::publishCommit(transaction_cid_t cid) {
+  if (cid <= getLastCommitId() || cid > _nextCommitId)
+    throw std::runtime_error("Double commit detected, possible TX corruption");
+  if (_completed[cid % COMMIT_WINDOW].exchange(cid) == cid)
+    throw std::runtime_error("Double commit detected, possible TX corruption");
+
+  // Whoever takes the successor of the last commit id out of its slot owns
+  // its publication. Slots hold the commit id itself, so a thread working
+  // with an outdated last commit id cannot take a reused slot. All operations
+  // are sequentially consistent, so either we observe the completion of our
+  // successor after advancing or its committer observes our advance, no
+  // completed cid is left behind.
+  while (true) {
+    const transaction_cid_t last = _commitId.load();
+    transaction_cid_t expected = last + 1;
+    if (!_completed[expected % COMMIT_WINDOW].compare_exchange_strong(expected, UNKNOWN_CID))
+      return;
+    _commitId.store(last + 1);
+  }
 }
 
 TXModifications& TransactionManager::operator[](const transaction_id_t& key) {
-  return _txData([&key] (map_t& txData) -> TXModifications& {
-      if (txData.find(key) == txData.end()) {
-        txData[key] = make_unique<TransactionData>();
+  return getTransactionData(key)._modifications;
+}
+
+TransactionData& TransactionManager::getTransactionData(transaction_id_t tid) {
+  const auto now = get_epoch_nanoseconds();
+  return getInstance().shard(tid).data([&tid, &now] (map_t& txData) -> TransactionData& {
+      auto& data = txData[tid];
+      if (!data) {
+        data = make_unique<TransactionData>();
+        data->_context.tid = tid;
+        data->_modifications.tid = tid;
+      }
+      data->_lastAccess = now;
+      return *data;
+    });
+}
+
+TXContext TransactionManager::getContext(transaction_id_t tid) {
+  return getTransactionData(tid)._context;
+}
+
+void TransactionManager::touchTransaction(const TXContext& ctx) {
+  auto& txmgr = getInstance();
+  const auto now = get_epoch_nanoseconds();
+  auto& shard = txmgr.shard(ctx.tid);
+  bool reclaimed = false;
+  const bool registered = shard.data([&ctx, &now, &shard, &reclaimed] (map_t& txData) -> bool {
+      // The client continues a transaction the garbage collector rolled back
+      if (shard.reclaimed.count(ctx.tid)) {
+        reclaimed = true;
+        return false;
       }
-      return txData[key]->_modifications;
+      auto& data = txData[ctx.tid];
+      const bool created = !data;
+      if (created) {
+        data = make_unique<TransactionData>();
+        data->_context.tid = ctx.tid;
+        data->_modifications.tid = ctx.tid;
+      }
+      if (data->_context.lastCid == UNKNOWN_CID)
+        data->_context.lastCid = ctx.lastCid;
+      data->_lastAccess = now;
+      return created;
+    });
+  if (reclaimed)
+    throw std::runtime_error("Transaction " + std::to_string(ctx.tid) + " was rolled back as abandoned");
+
+  // The registration is made before the collected snapshot is read, so
+  // either the garbage collector sees it or it is rejected here
+  if (registered && ctx.lastCid < txmgr._collectedSnapshot) {
+    txmgr.endTransaction(ctx.tid);
+    throw std::runtime_error("Snapshot of transaction " + std::to_string(ctx.tid) + " is too old, restart the transaction");
+  }
+}
+
+void TransactionManager::releaseReadOnlyTransaction(transaction_id_t tid) {
+  getInstance().shard(tid).data([&tid] (map_t& txData) {
+      auto it = txData.find(tid);
+      if (it != txData.end() && !it->second->_committing &&
+          it->second->_modifications.inserted.empty() && it->second->_modifications.deleted.empty())
+        txData.erase(it);
     });
 }
 
+transaction_cid_t TransactionManager::getOldestActiveSnapshot() {
+  auto& txmgr = getInstance();
+  const auto scan = [&txmgr] (transaction_cid_t oldest) -> transaction_cid_t {
+    for (const auto& shard : txmgr._txData) {
+      shard.data([&oldest] (const map_t& txData) {
+          for (const auto& kv : txData) {
+            oldest = std::min(oldest, kv.second->_context.lastCid);
+          }
+        });
+    }
+    return oldest;
+  };
+
+  // Transactions registering after this point see at least this commit id
+  const transaction_cid_t oldest = scan(getInstance().getLastCommitId());
+
+  // Sessions that register an older snapshot from now on are rejected.
+  // Registrations made while the horizon is published are found by the
+  // second scan, since both take the lock of their shard.
+  transaction_cid_t horizon = txmgr._collectedSnapshot;
+  while (horizon < oldest && !txmgr._collectedSnapshot.compare_exchange_weak(horizon, oldest)) {}
+  return scan(oldest);
+}
+
+size_t TransactionManager::reclaimAbandonedTransactions(epoch_t last_access_before) {
+  std::vector<TXContext> abandoned;
+  for (auto& shard : getInstance()._txData) {
+    shard.data([&abandoned, &last_access_before, &shard] (map_t& txData) {
+        for (auto& kv : txData) {
+          // A transaction that is committing is left to its commit
+          if (kv.second->_lastAccess < last_access_before && !kv.second->_committing) {
+            kv.second->_reclaimed = true;
+            // Outlives the registration, so a later commit still fails
+            shard.reclaimed.insert(kv.first);
+            abandoned.push_back(kv.second->_context);
+          }
+        }
+      });
+  }
+  for (const auto& ctx : abandoned) {
+    undoTransaction(ctx);
+  }
+  return abandoned.size();
+}
+
+bool TransactionManager::hasActiveModifications(const storage::c_atable_ptr_t& table) {
+  bool modified = false;
+  for (const auto& shard : getInstance()._txData) {
+    shard.data([&modified, &table] (const map_t& txData) {
+        for (const auto& kv : txData) {
+          const auto& mods = kv.second->_modifications;
+          modified |= mods.hasInserted(table) || mods.hasDeleted(table);
+        }
+      });
+  }
+  return modified;
+}
+
 std::optional<const TXModifications&> TransactionManager::getModifications(const transaction_id_t key) const {
-  return _txData([&key] (const map_t& txData) -> std::optional<const TXModifications&> {
+  return shard(key).data([&key] (const map_t& txData) -> std::optional<const TXModifications&> {
       auto it = txData.find(key);
       if (it == txData.end()) {
         return std::nullopt;
@@ -117,34 +265,59 @@ std::optional<const TXModifications&> TransactionManager::getModifications(const
 }
 
 
-void TransactionManager::commit(transaction_id_t tid) {
-  if (!_txLock.is_locked())
-    throw std::runtime_error("Double commit detected, possible TX corruption");
-  ++_commitId;
-  _txLock.unlock();
-
+void TransactionManager::commit(transaction_id_t tid, transaction_cid_t cid) {
+  publishCommit(cid);
   endTransaction(tid);
 }
 
 
+void TransactionManager::setLockWaitTimeout(std::chrono::microseconds timeout) {
+  _lockWaitTimeout = timeout.count();
+}
+
+std::chrono::microseconds TransactionManager::getLockWaitTimeout() const {
+  return std::chrono::microseconds(_lockWaitTimeout.load());
+}
+
 void TransactionManager::reset() {
   _transactionCount = START_TID;
   _commitId = UNKNOWN_CID;
-  _txData([] (map_t& txData) { txData.clear(); });
+  _nextCommitId = UNKNOWN_CID;
+  _collectedSnapshot = UNKNOWN_CID;
+  for (transaction_cid_t i = 0; i < COMMIT_WINDOW; ++i) {
+    _completed[i] = UNKNOWN_CID;
+  }
+  for (auto& shard : _txData) {
+    shard.data([&shard] (map_t& txData) {
+        txData.clear();
+        shard.reclaimed.clear();
+      });
+  }
 }
 
 TXContext TransactionManager::beginTransaction() {
-  return getInstance().buildContext();
+  auto& txmgr = getInstance();
+  const auto tid = txmgr.getTransactionId();
+  // Registered with UNKNOWN_CID first: a garbage collection that does not
+  // see the registration read the last commit id before the one below
+  auto& data = getTransactionData(tid);
+  const auto last_cid = txmgr.getLastCommitId();
+  txmgr.shard(tid).data([&data, &last_cid] (map_t&) {
+      data._context.lastCid = last_cid;
+    });
+  return {tid, last_cid};
 }
 
 std::vector<TXContext> TransactionManager::getCurrentModifyingTransactionContexts() {
-  return getInstance()._txData([] (const map_t& data) {
-      std::vector<TXContext> result;
-      for(const auto& kv: data) {
-        result.push_back(kv.second->_context);
-      }
-      return result;
-    });
+  std::vector<TXContext> result;
+  for (const auto& shard : getInstance()._txData) {
+    shard.data([&result] (const map_t& data) {
+        for(const auto& kv: data) {
+          result.push_back(kv.second->_context);
+        }
+      });
+  }
+  return result;
 }
 
 
@@ -153,23 +326,41 @@ bool TransactionManager::isValidTransactionId(transaction_id_t tid) {
 }
 
 storage::store_ptr_t getStore(const storage::c_atable_ptr_t& table) {
+  // The table may have been unloaded in the meantime
+  if (table == nullptr)
+    return nullptr;
   return std::const_pointer_cast<storage::Store>(
       checked_pointer_cast<const storage::Store>(table));
 }
 
 void TransactionManager::endTransaction(transaction_id_t tid) {
   // Clear all relevant data for this transaction
-  _txData([&tid] (map_t& txData) {
+  shard(tid).data([&tid] (map_t& txData) {
       txData.erase(tid);
     });
 }
 
 void TransactionManager::rollbackTransaction(TXContext ctx) {
+  undoTransaction(ctx);
+  // The client learned that its transaction ended
+  auto& shard = getInstance().shard(ctx.tid);
+  shard.data([&ctx, &shard] (map_t&) {
+      shard.reclaimed.erase(ctx.tid);
+    });
+}
+
+void TransactionManager::undoTransaction(TXContext ctx) {
   // unmark positions previously marked for delete
   // auto& txData = getTransactionData(ctx.tid);
   for(auto& kv : getInstance()[ctx.tid].deleted) {
-    auto store = getStore(kv.first.lock());
-    store->unmarkForDeletion(kv.second, ctx.tid);
+    if (auto store = getStore(kv.first.lock()))
+      store->unmarkForDeletion(kv.second, ctx.tid);
+  }
+
+  // rows inserted by us become invisible to everyone and can be collected
+  for(auto& kv : getInstance()[ctx.tid].inserted) {
+    if (auto store = getStore(kv.first.lock()))
+      store->abortInsertions(kv.second, ctx.tid);
   }
 
   getInstance().endTransaction(ctx.tid);
@@ -177,7 +368,43 @@ void TransactionManager::rollbackTransaction(TXContext ctx) {
 
 transaction_cid_t TransactionManager::commitTransaction(TXContext ctx) {
   auto& txmgr = getInstance();
+  // The garbage collector must not roll back the transaction while it
+  // commits, nor may a transaction it rolled back commit
+  auto& shard = txmgr.shard(ctx.tid);
+  const bool reclaimed = shard.data([&ctx, &shard] (map_t& txData) -> bool {
+      // The registration of a reclaimed transaction may already be gone
+      if (shard.reclaimed.erase(ctx.tid))
+        return true;
+      auto it = txData.find(ctx.tid);
+      if (it == txData.end())
+        return false;
+      it->second->_committing = !it->second->_reclaimed;
+      return it->second->_reclaimed;
+    });
+  if (reclaimed)
+    throw std::runtime_error("Transaction " + std::to_string(ctx.tid) + " was rolled back as abandoned");
+
   ctx.cid = txmgr.prepareCommit();
+  // Completes the drawn commit id without changes if the commit fails,
+  // however it fails, since all later commits wait for it to be published
+  struct CommitGuard {
+    TransactionManager& txmgr;
+    const TXContext& ctx;
+    bool committed;
+    ~CommitGuard() {
+      if (committed)
+        return;
+      txmgr.abort(ctx.cid);
+      // The client may roll the transaction back, or else the garbage collector
+      const auto& tid = ctx.tid;
+      txmgr.shard(tid).data([&tid] (map_t& txData) {
+          auto it = txData.find(tid);
+          if (it != txData.end())
+            it->second->_committing = false;
+        });
+    }
+  } guard = {txmgr, ctx, false};
+
   if (auto mods = txmgr.getModifications(ctx.tid)) {
     const auto& modifications = *mods;
     // Only update the required positions
@@ -187,7 +414,6 @@ transaction_cid_t TransactionManager::commitTransaction(TXContext ctx) {
       // records will be always only written by us
       if (auto store = getStore(weak_table.lock())) {
         if (TX_CODE::TX_OK != store->checkForConcurrentCommit(kv.second, ctx.tid)) {
-          txmgr.abort();
           throw std::runtime_error("Aborted TX with Last Commit ID != New Commit ID");
         }
       }
@@ -198,7 +424,6 @@ transaction_cid_t TransactionManager::commitTransaction(TXContext ctx) {
       if (auto store = getStore(weak_table.lock())) {
         auto result = store->commitPositions(kv.second, ctx.cid, true);
         if (result != TX_CODE::TX_OK) {
-          txmgr.abort();
           throw std::runtime_error("Aborted TX with "); // TODO at return code to error message
         }
       }
@@ -209,13 +434,13 @@ transaction_cid_t TransactionManager::commitTransaction(TXContext ctx) {
       if (auto store = getStore(weak_table.lock())) {
         auto result = store->commitPositions(kv.second, ctx.cid, false);
         if (result != TX_CODE::TX_OK) {
-          txmgr.abort();
           throw std::runtime_error("Aborted TX with "); // TODO at return code to error message
         }
       }
     }
   }
-  txmgr.commit(ctx.tid);
+  guard.committed = true;
+  txmgr.commit(ctx.tid, ctx.cid);
   return ctx.cid;
 }
 
@@ -2,12 +2,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
+#include "helper/epoch.h"
 #include "helper/locking.h"
+#include "helper/noncopyable.h"
 #include "helper/Synchronized.h"
 #include "helper/types.h"
 #include "io/TXContext.h"
@@ -39,9 +44,17 @@ class TXModifications {
   // Keeps track of all inserted rows
   void insertPos(const storage::c_atable_ptr_t& tab, pos_t pos);
 
+  // Keeps track of count consecutive inserted rows starting at first,
+  // appended under a single lock acquisition
+  void insertPositions(const storage::c_atable_ptr_t& tab, pos_t first, size_t count);
+
   // Keeps track of all deleted rows
   void deletePos(const storage::c_atable_ptr_t& tab, pos_t pos);
 
+  // Keeps track of a batch of deleted rows, appended under a single lock
+  // acquisition
+  void deletePositions(const storage::c_atable_ptr_t& tab, const storage::pos_list_t& pos);
+
   bool hasDeleted(const storage::c_atable_ptr_t& tab) const;
 
   bool hasInserted(const storage::c_atable_ptr_t& tab) const;
@@ -52,13 +65,62 @@ class TXModifications {
 private:
   bool handleCheck(const map_t& data, const storage::c_atable_ptr_t& tab) const;
 
-  // Abstraction to the specific inserted and deleted row processes.
-  void _handle(locking::Spinlock& mtx, map_t& data, const storage::c_atable_ptr_t& key, pos_t pos);
+  // Operators of the same transaction may record modifications in
+  // parallel, transactions never share a lock
+  locking::Spinlock _mtx;
+};
+
+/// Collects the rows a plan operation modifies in one table and records
+/// them in the modifications of its transaction in a single batch. Rows
+/// collected so far are also recorded if the operation throws, so that a
+/// rollback releases their locks.
+class TXModificationBatch : noncopyable {
+ public:
+  TXModificationBatch(TXModifications& modifications, const storage::c_atable_ptr_t& table) :
+      _modifications(modifications), _table(table), _firstInserted(0), _inserted(0) {}
+
+  ~TXModificationBatch() { flush(); }
+
+  /// Rows have to be inserted consecutively
+  void inserted(pos_t pos) {
+    if (_inserted == 0)
+      _firstInserted = pos;
+    ++_inserted;
+  }
+
+  void deleted(pos_t pos) { _deleted.push_back(pos); }
+
+  /// Records the collected rows, must be called before the transaction is
+  /// rolled back
+  void flush() {
+    if (_inserted > 0)
+      _modifications.insertPositions(_table, _firstInserted, _inserted);
+    if (!_deleted.empty())
+      _modifications.deletePositions(_table, _deleted);
+    _inserted = 0;
+    _deleted.clear();
+  }
+
+ private:
+  TXModifications& _modifications;
+  storage::c_atable_ptr_t _table;
+  pos_t _firstInserted;
+  size_t _inserted;
+  storage::pos_list_t _deleted;
 };
 
 typedef struct TXData {
   TXContext _context;
   TXModifications _modifications;
+  // Time of the last registration or modification, used to detect
+  // abandoned transactions
+  epoch_t _lastAccess = 0;
+  // Set while the transaction commits, so the garbage collector does not
+  // roll it back meanwhile
+  bool _committing = false;
+  // Set once the garbage collector rolls the transaction back, so it can
+  // no longer commit
+  bool _reclaimed = false;
 } TransactionData;
 
 /// Transaction manager based on transaction contexts
@@ -69,16 +131,33 @@ class TransactionManager {
   /// @{
 
   /// Starts a new transaction context, creates TransactionData object
-  /// to be accessed through the returned context's `tid`.
+  /// to be accessed through the returned context's `tid`. The transaction
+  /// is registered before its snapshot is taken, so the garbage collector
+  /// keeps all row versions visible to it.
   static TXContext beginTransaction();
 
-  /// Returns transaction data reference for modification
+  /// Returns transaction data reference for modification, creating the
+  /// transaction data if it does not exist yet
   /// \param tid transaction id
   static TransactionData& getTransactionData(transaction_id_t tid);
   /// Returns context for tid
   /// \param tid transaction id
   static TXContext getContext(transaction_id_t tid);
 
+  /// Registers the transaction together with its snapshot and refreshes
+  /// its last access time, so that the garbage collector neither reclaims
+  /// it nor any row version visible to it. Fails if the transaction was
+  /// not registered anymore and the garbage collector may already have
+  /// removed row versions of its snapshot.
+  /// \param ctx transaction context
+  static void touchTransaction(const TXContext& ctx);
+
+  /// Ends the registration of a transaction that did not modify any
+  /// table, e.g. once a read-only request was answered. Its snapshot no
+  /// longer holds back the garbage collector.
+  /// \param tid transaction id
+  static void releaseReadOnlyTransaction(transaction_id_t tid);
+
   /// Make all changes visible to other transaction, ending the lifetime
   /// of the transaction context identified by tid
   /// \param tid transaction id to commit
@@ -96,10 +175,32 @@ class TransactionManager {
   static std::vector<TXContext> getCurrentModifyingTransactionContexts();
   /// @}
 
+  /// \defgroup Garbage Collection Support
+  /// @{
+
+  /// Returns the oldest snapshot any registered transaction may read,
+  /// transactions registered without a snapshot pin it to UNKNOWN_CID.
+  /// Transactions that register an older snapshot afterwards fail in
+  /// touchTransaction().
+  static transaction_cid_t getOldestActiveSnapshot();
+
+  /// Rolls back all registered transactions that were not accessed since
+  /// the given point in time, except for transactions that are committing.
+  /// Their ids are remembered, so a client that returns later fails to
+  /// commit or continue them.
+  /// \returns number of reclaimed transactions
+  static size_t reclaimAbandonedTransactions(epoch_t last_access_before);
+
+  /// Checks whether any registered transaction recorded modifications
+  /// for the given table
+  static bool hasActiveModifications(const storage::c_atable_ptr_t& table);
+  /// @}
+
   // Singleton Constructor
   static TransactionManager& getInstance();
 
-  // get the last valid commit id for visibility
+  // get the last valid commit id for visibility, all transactions with a
+  // commit id up to and including this one have completed their commit
   transaction_id_t getLastCommitId();
 
   /*
@@ -109,23 +210,22 @@ class TransactionManager {
   TXContext buildContext();
 
   /*
-
-   * Starts the Synchronized Transaction Process
+  * Starts the Commit Process
   *
-  * The call to prepare commit retrieves the next possible commit ID from the
-  * list and locks the call to serialized all incoming transactions. We
-  * protect this method using a spin lock. The lock is released in the
-  * @commit() method.
+  * The call to prepare commit atomically draws the next commit ID without
+  * serializing against other committing transactions. Commits may complete
+  * out of order, the last commit id only advances to the highest commit id
+  * for which all smaller commit ids have completed. Only a bounded window of
+  * commit ids may be in flight, callers block if the window is exhausted.
   */
   transaction_cid_t prepareCommit();
 
-  void abort();
   /**
-  * Tries to acquire the spin lock for the prepare commit call and returns
-  * UNKNOWN in case of failure or the next commit ID in case of
-  * success
+  * Completes the given commit id without making any changes, must be called
+  * for every prepared commit id that is not passed to @commit() so that
+  * the last commit id can advance past it
   */
-  transaction_cid_t tryPrepareCommit();
+  void abort(transaction_cid_t cid);
 
   /*
   * Returns the modifications set for the given transaction id
@@ -133,30 +233,73 @@ class TransactionManager {
   TXModifications& operator[](const transaction_id_t& key);
 
   /**
-  * This call relases the prepare commit lock and increments the commit ID
-  * counter;
+  * Marks the commit id as completed, advances the last commit id as far as
+  * possible and ends the transaction
   */
-  void commit(transaction_id_t tid);
+  void commit(transaction_id_t tid, transaction_cid_t cid);
 
   void endTransaction(transaction_id_t tid);
 
+  /// Default lock wait timeout in us, long enough to outlast the commit of
+  /// a short transaction holding the lock
+  static const size_t DEFAULT_LOCK_WAIT_TIMEOUT_US = 1000;
+
+  /// Time a writer waits for a row locked by another transaction to be
+  /// released before giving up; 0 fails immediately on locked rows
+  void setLockWaitTimeout(std::chrono::microseconds timeout);
+  std::chrono::microseconds getLockWaitTimeout() const;
+
   void reset();
 
 
  private:
   std::optional<const TXModifications&> getModifications(const transaction_id_t key) const;
 
+  /// Marks a prepared commit id as completed and advances the last
+  /// commit id over all contiguously completed commit ids
+  void publishCommit(transaction_cid_t cid);
+
+  /// Undoes the modifications of a transaction and ends it
+  static void undoTransaction(TXContext ctx);
+
   std::atomic<transaction_id_t> _transactionCount;
+  // Last commit id visible to new transactions
   std::atomic<transaction_cid_t> _commitId;
+  // Last commit id handed out by prepareCommit()
+  std::atomic<transaction_cid_t> _nextCommitId;
+  // Lock wait timeout in microseconds
+  std::atomic<int64_t> _lockWaitTimeout;
+  // Oldest snapshot handed to the garbage collector, older snapshots may
+  // miss row versions
+  std::atomic<transaction_cid_t> _collectedSnapshot;
+
+  // Maximum number of commit ids in flight
+  static const transaction_cid_t COMMIT_WINDOW = 1 << 14;
+  // Completed but not yet published commit ids, indexed by cid % COMMIT_WINDOW,
+  // empty slots hold UNKNOWN_CID
+  std::unique_ptr<std::atomic<transaction_cid_t>[]> _completed;
 
   using map_t = std::unordered_map<transaction_id_t,
                                    std::unique_ptr<TransactionData>>;
 
-  // Keeping track of all transactions and their modifications
-  Synchronized<map_t, locking::Spinlock> _txData;
+  // Number of independently locked shards of the transaction registry
+  static const size_t REGISTRY_SHARDS = 64;
+
+  typedef struct {
+    Synchronized<map_t, locking::Spinlock> data;
+    // Transactions rolled back by the garbage collector whose client was not
+    // told yet, only accessed while data is locked
+    std::unordered_set<transaction_id_t> reclaimed;
+    // Keeps neighbouring shards on separate cache lines
+    char padding[64];
+  } registry_shard_t;
+
+  registry_shard_t& shard(transaction_id_t tid) { return _txData[tid % REGISTRY_SHARDS]; }
+  const registry_shard_t& shard(transaction_id_t tid) const { return _txData[tid % REGISTRY_SHARDS]; }
 
-  // Spin Lock for transactions
-  locking::Spinlock _txLock;
+  // Keeping track of all transactions and their modifications, sharded by
+  // transaction id so that concurrent transactions do not contend
+  std::array<registry_shard_t, REGISTRY_SHARDS> _txData;
 
   TransactionManager();
 
@@ -1,5 +1,6 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "base.h"
+#include "calibration.h"
 #include "layout_utils.h"
 #include "matrix.h"
 
@@ -100,6 +101,8 @@ double Query::containerCost(std::vector<unsigned> container, Schema s, std::stri
 
   if (_costModel.compare(HYRISE_COST) == 0) {
     cost = hyriseCost();
+  } else if (_costModel.compare(CALIBRATED_COST) == 0) {
+    cost = calibratedCost();
   } else {
     cost = INT_MIN;
   }
@@ -121,6 +124,29 @@ double Query::hyriseCost() {
   return misses;
 }
 
+/*
+  Weighs the cache misses of the HYRISE cost model with the measured
+  time to load a cache line from a working set of the size of the
+  container. Out of order accesses with a high selectivity touch most
+  lines in order, so their cost moves from random towards sequential
+  line costs with the selectivity.
+*/
+double Query::calibratedCost() {
+  const auto calibration = CostCalibration::current();
+  const double bytes = (double) _containerWidth * _schema.nbTuples;
+  const double sequential = calibration->lineCost(CostCalibration::access_sequential, bytes);
+
+  if (type == LayouterConfiguration::access_type_fullprojection) {
+    return hyriseProjection() * sequential;
+  } else if (type == LayouterConfiguration::access_type_outoforder) {
+    const double random = calibration->lineCost(CostCalibration::access_random, bytes);
+    const double selectivity = std::min(std::max(parameter, 0.0), 1.0);
+    return hyriseOOO() * (random + selectivity * (sequential - random));
+  }
+
+  return DBL_MIN;
+}
+
 double Query::hyriseProjection() {
   if (_containerWidth <= CACHE_LINE_SIZE) {
     return ceil(_containerWidth * _schema.nbTuples / (CACHE_LINE_SIZE * 1.0));
@@ -868,7 +894,7 @@ void FastCandidateLayouter::layout(Schema s, std::string costModel) {
   _candidateList = std::vector<std::set<unsigned> >();
 
   schema = s;
-  costModel = costModel;
+  this->costModel = costModel;
 
   // This is the part where the relevant subsets
   // are created
@@ -904,7 +930,7 @@ void FastCandidateLayouter::layout(Schema s, std::string costModel) {
   // Prepare result
   std::vector<double> costs;
   BOOST_FOREACH(subset_t s, result) {
-    costs.push_back(schema.costForSubset(s, HYRISE_COST));
+    costs.push_back(schema.costForSubset(s, costModel));
   }
   Layout l(result);
   Result r(l, costs);
@@ -919,7 +945,7 @@ double FastCandidateLayouter::costFor(subset_t first) {
   BOOST_FOREACH(unsigned j, _mapping[i])
   tmp.push_back(j);
 
-  result = schema.costForSubset(tmp, HYRISE_COST);
+  result = schema.costForSubset(tmp, costModel);
   return result;
 }
 
@@ -1045,7 +1071,7 @@ void CandidateLayouter::layout(Schema s, std::string cM) {
         double current;
 
         if (cache.count(subsets[i]) == 0)
-          cache[subsets[i]] = schema.costForSubset(subsets[i], HYRISE_COST);
+          cache[subsets[i]] = schema.costForSubset(subsets[i], costModel);
 
         current = cache[subsets[i]];
 
@@ -1055,7 +1081,7 @@ void CandidateLayouter::layout(Schema s, std::string cM) {
             uncheckedSubsets[j] = false;
             double test;
             if (cache.count(subsets[j]) == 0)
-              cache[subsets[j]] = schema.costForSubset(subsets[j], HYRISE_COST);
+              cache[subsets[j]] = schema.costForSubset(subsets[j], costModel);
 
             test = cache[subsets[j]];
 
@@ -102,6 +102,7 @@ class Query {
   void getAttUnion();
   double containerCost(std::vector<unsigned> container, Schema s, std::string costModel);
   double hyriseCost();
+  double calibratedCost();
   double hyriseProjection();
   double hyrisePartialProjection(unsigned po, unsigned pw);
   double hyriseEquivalentProjection(bool v);
@@ -0,0 +1,256 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "calibration.h"
+#include "config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hwloc.h>
+
+#include "helper/HwlocHelper.h"
+
+namespace hyrise {
+namespace layouter {
+
+namespace {
+
+// Cache lines loaded per sequential measurement and number of dependent
+// loads per random measurement
+const size_t SEQUENTIAL_LINES = 1 << 24;
+const size_t RANDOM_LOADS = 1 << 22;
+const size_t REPETITIONS = 3;
+
+// The DRAM working set is this multiple of the last level cache
+const size_t DRAM_FACTOR = 4;
+const size_t MIN_DRAM_BYTES = 64 * 1024 * 1024;
+const size_t MAX_DRAM_BYTES = 1024 * 1024 * 1024;
+
+typedef std::chrono::high_resolution_clock hr_clock;
+
+std::mutex currentMutex;
+std::shared_ptr<const CostCalibration> currentCalibration = std::make_shared<const CostCalibration>();
+
+double nsPer(hr_clock::duration duration, size_t count) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / (double) count;
+}
+
+double sequentialCost(char *buffer, size_t bytes) {
+  const size_t lines = bytes / CACHE_LINE_SIZE;
+  const size_t passes = std::max<size_t>(1, SEQUENTIAL_LINES / lines);
+  double best = std::numeric_limits<double>::max();
+
+  for (size_t r = 0; r < REPETITIONS; ++r) {
+    size_t sum = 0;
+    auto start = hr_clock::now();
+    for (size_t p = 0; p < passes; ++p)
+      for (size_t l = 0; l < lines; ++l)
+        sum += *reinterpret_cast<volatile size_t *>(buffer + l * CACHE_LINE_SIZE);
+    best = std::min(best, nsPer(hr_clock::now() - start, passes * lines));
+
+    volatile size_t sink = sum;
+    (void) sink;
+  }
+  return best;
+}
+
+// Links all cache lines of the buffer to a single cycle in random order
+void linkRandomly(char *buffer, size_t bytes) {
+  const size_t lines = bytes / CACHE_LINE_SIZE;
+  std::vector<size_t> order(lines);
+  std::iota(order.begin(), order.end(), 0);
+
+  // Sattolo's algorithm, a random permutation with a single cycle
+  std::mt19937_64 generator(lines);
+  for (size_t i = lines - 1; i > 0; --i)
+    std::swap(order[i], order[std::uniform_int_distribution<size_t>(0, i - 1)(generator)]);
+
+  for (size_t i = 0; i < lines; ++i)
+    *reinterpret_cast<char **>(buffer + order[i] * CACHE_LINE_SIZE) = buffer + order[(i + 1) % lines] * CACHE_LINE_SIZE;
+}
+
+double randomCost(char *buffer, size_t bytes) {
+  linkRandomly(buffer, bytes);
+  const size_t loads = RANDOM_LOADS;
+  double best = std::numeric_limits<double>::max();
+
+  for (size_t r = 0; r < REPETITIONS; ++r) {
+    char *position = buffer;
+    auto start = hr_clock::now();
+    for (size_t l = 0; l < loads; ++l)
+      position = *reinterpret_cast<char * volatile *>(position);
+    best = std::min(best, nsPer(hr_clock::now() - start, loads));
+
+    char * volatile sink = position;
+    (void) sink;
+  }
+  return best;
+}
+
+// Sizes of the data caches of the first core, smallest first
+std::vector<size_t> cacheSizes(hwloc_topology_t topology) {
+  std::vector<size_t> sizes;
+  for (hwloc_obj_t obj = hwloc_get_obj_by_type(topology, HWLOC_OBJ_PU, 0); obj != nullptr; obj = obj->parent) {
+#if HWLOC_API_VERSION >= 0x00020000
+    const bool cache = hwloc_obj_type_is_dcache(obj->type);
+#else
+    const bool cache = obj->type == HWLOC_OBJ_CACHE && obj->attr->cache.type != HWLOC_OBJ_CACHE_INSTRUCTION;
+#endif
+    if (cache && obj->attr->cache.size > 0)
+      sizes.push_back(obj->attr->cache.size);
+  }
+
+  if (sizes.empty())
+    sizes = {32 * 1024, 256 * 1024, 8 * 1024 * 1024};
+  return sizes;
+}
+
+}
+
+CostCalibration::CostCalibration() : _remoteSequential(0), _remoteRandom(0), _remoteShare(0) {
+}
+
+CostCalibration CostCalibration::measure() {
+  hwloc_topology_t topology = getHWTopology();
+  const auto caches = cacheSizes(topology);
+  const size_t dram = std::min(std::max(caches.back() * DRAM_FACTOR, MIN_DRAM_BYTES), MAX_DRAM_BYTES);
+
+  CostCalibration calibration;
+  void *buffer = nullptr;
+  if (posix_memalign(&buffer, CACHE_LINE_SIZE, dram) != 0)
+    throw std::bad_alloc();
+  // Untouched pages all map to the zero page, which stays in the caches
+  memset(buffer, 1, dram);
+  for (const auto &size : caches)
+    calibration.addLevel(size / 2, sequentialCost((char *) buffer, size / 2), randomCost((char *) buffer, size / 2));
+  calibration.addLevel(dram, sequentialCost((char *) buffer, dram), randomCost((char *) buffer, dram));
+  free(buffer);
+
+  // Load from the memory of the second node while running on the first
+  const unsigned nodes = getNumberOfNodes(topology);
+  if (nodes > 1) {
+    hwloc_obj_t local = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NODE, 0);
+    hwloc_obj_t remote = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NODE, 1);
+
+    hwloc_cpuset_t binding = hwloc_bitmap_alloc();
+    hwloc_get_cpubind(topology, binding, HWLOC_CPUBIND_THREAD);
+    hwloc_set_cpubind(topology, local->cpuset, HWLOC_CPUBIND_THREAD);
+
+    void *remoteBuffer = hwloc_alloc_membind_nodeset(topology, dram, remote->nodeset, HWLOC_MEMBIND_BIND, 0);
+    if (remoteBuffer != nullptr) {
+      // Touching the pages places them on the remote node
+      memset(remoteBuffer, 1, dram);
+      calibration.setRemote(sequentialCost((char *) remoteBuffer, dram), randomCost((char *) remoteBuffer, dram), (nodes - 1) / (double) nodes);
+      hwloc_free(topology, remoteBuffer, dram);
+    }
+
+    hwloc_set_cpubind(topology, binding, HWLOC_CPUBIND_THREAD);
+    hwloc_bitmap_free(binding);
+  }
+
+  return calibration;
+}
+
+CostCalibration CostCalibration::load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file)
+    throw std::runtime_error("Cannot read layouter calibration " + path);
+
+  CostCalibration calibration;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string kind;
+    if (!(fields >> kind) || kind[0] == '#')
+      continue;
+
+    if (kind == "level") {
+      size_t bytes;
+      double sequential, random;
+      if (!(fields >> bytes >> sequential >> random))
+        throw std::runtime_error("Malformed level in layouter calibration " + path);
+      calibration.addLevel(bytes, sequential, random);
+    } else if (kind == "remote") {
+      double sequential, random, share;
+      if (!(fields >> sequential >> random >> share))
+        throw std::runtime_error("Malformed remote costs in layouter calibration " + path);
+      calibration.setRemote(sequential, random, share);
+    } else {
+      throw std::runtime_error("Unknown entry " + kind + " in layouter calibration " + path);
+    }
+  }
+  return calibration;
+}
+
+void CostCalibration::save(const std::string &path) const {
+  std::ofstream file(path);
+  if (!file)
+    throw std::runtime_error("Cannot write layouter calibration " + path);
+
+  file << "# level <working set bytes> <sequential ns/line> <random ns/line>" << std::endl;
+  for (const auto &level : _levels)
+    file << "level " << level.bytes << " " << level.sequential << " " << level.random << std::endl;
+  if (_remoteShare > 0) {
+    file << "# remote <sequential ns/line> <random ns/line> <share of remote accesses>" << std::endl;
+    file << "remote " << _remoteSequential << " " << _remoteRandom << " " << _remoteShare << std::endl;
+  }
+}
+
+void CostCalibration::addLevel(size_t bytes, double sequential, double random) {
+  level_t level = {bytes, sequential, random};
+  auto position = std::upper_bound(_levels.begin(), _levels.end(), level,
+                                   [](const level_t &a, const level_t &b) { return a.bytes < b.bytes; });
+  _levels.insert(position, level);
+}
+
+void CostCalibration::setRemote(double sequential, double random, double share) {
+  _remoteSequential = sequential;
+  _remoteRandom = random;
+  _remoteShare = share;
+}
+
+double CostCalibration::lineCost(access_pattern_t pattern, double bytes) const {
+  if (_levels.empty())
+    return 1.0;
+
+  auto cost = [&](size_t i) {
+    double local = pattern == access_sequential ? _levels[i].sequential : _levels[i].random;
+    if (i + 1 < _levels.size() || _remoteShare == 0)
+      return local;
+    double remote = pattern == access_sequential ? _remoteSequential : _remoteRandom;
+    return (1 - _remoteShare) * local + _remoteShare * remote;
+  };
+
+  if (bytes <= _levels.front().bytes)
+    return cost(0);
+  if (bytes >= _levels.back().bytes)
+    return cost(_levels.size() - 1);
+
+  size_t upper = 1;
+  while (_levels[upper].bytes < bytes)
+    ++upper;
+  const double ratio = std::log(bytes / _levels[upper - 1].bytes) / std::log(_levels[upper].bytes / (double) _levels[upper - 1].bytes);
+  return cost(upper - 1) + ratio * (cost(upper) - cost(upper - 1));
+}
+
+std::shared_ptr<const CostCalibration> CostCalibration::current() {
+  std::lock_guard<std::mutex> lock(currentMutex);
+  return currentCalibration;
+}
+
+void CostCalibration::setCurrent(const CostCalibration &calibration) {
+  auto next = std::make_shared<const CostCalibration>(calibration);
+  std::lock_guard<std::mutex> lock(currentMutex);
+  currentCalibration = next;
+}
+
+} } // namespace hyrise::layouter
@@ -0,0 +1,83 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hyrise {
+namespace layouter {
+
+/*
+  Access costs of the memory hierarchy of the machine, measured by
+  microbenchmarks and used by the CALIBRATED_COST model to turn the
+  cache misses of the analytic HYRISE_COST model into time.
+
+  Each level is a working set size, e.g. half of the L1, L2 and last
+  level cache and a multiple of the last level cache up to 1GB for
+  DRAM, with the time in ns to load a cache line when scanning the working set
+  sequentially and when chasing pointers through it in random order.
+  Costs between the measured sizes are interpolated on a logarithmic
+  scale. Working sets larger than the last level are served from
+  DRAM, on machines with several NUMA nodes the share of remote nodes
+  is charged the remote costs, as the NUMA aware schedulers interleave
+  memory over all nodes.
+*/
+class CostCalibration {
+
+ public:
+
+  typedef enum {
+    access_sequential,
+    access_random
+  } access_pattern_t;
+
+  typedef struct {
+    size_t bytes;
+    double sequential;
+    double random;
+  } level_t;
+
+  // An empty calibration that costs every cache line 1
+  CostCalibration();
+
+  // Runs the microbenchmarks on the calling thread, takes several seconds
+  static CostCalibration measure();
+
+  // Reads a calibration written by save
+  static CostCalibration load(const std::string &path);
+
+  void save(const std::string &path) const;
+
+  // Time in ns to load one cache line of a working set of the given size
+  double lineCost(access_pattern_t pattern, double bytes) const;
+
+  void addLevel(size_t bytes, double sequential, double random);
+
+  void setRemote(double sequential, double random, double share);
+
+  const std::vector<level_t> &levels() const {
+    return _levels;
+  }
+
+  bool empty() const {
+    return _levels.empty();
+  }
+
+  // Calibration used by CALIBRATED_COST, empty if none was set
+  static std::shared_ptr<const CostCalibration> current();
+
+  static void setCurrent(const CostCalibration &calibration);
+
+ private:
+
+  std::vector<level_t> _levels;
+
+  double _remoteSequential;
+  double _remoteRandom;
+  // Share of DRAM accesses that go to a remote node
+  double _remoteShare;
+
+};
+
+} } // namespace hyrise::layouter
@@ -5,6 +5,7 @@
 #define HYRISE_COST "HYRISECost"
 #define ROW_COST "RowCost"
 #define COL_COST "ColumnCost"
+#define CALIBRATED_COST "CalibratedCost"
 
 namespace hyrise {
 namespace layouter {
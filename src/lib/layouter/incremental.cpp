@@ -151,7 +151,7 @@ void IncrementalCandidateLayouter::incrementalLayout(Query *q) {
   CandidateLayouter bl;
   Schema mappedSchema = buildSchema(qa, q);
 
-  bl.layout(mappedSchema, HYRISE_COST);
+  bl.layout(mappedSchema, costModel);
 
   // // update my schema etc
   schema.queries.push_back(q);
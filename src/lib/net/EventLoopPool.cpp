@@ -0,0 +1,195 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "net/EventLoopPool.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#include <hwloc.h>
+#include <log4cxx/logger.h>
+
+#include "helper/HwlocHelper.h"
+#include "net/AsyncConnection.h"
+
+namespace hyrise {
+namespace net {
+
+namespace {
+
+log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("hyrise.net.EventLoopPool"));
+
+std::atomic<EventLoopPool *> _running(nullptr);
+
+/// Binds the calling thread to a core of NUMA node index % nodes and its
+/// allocations to that node, so that connection state stays local
+void bindToNode(size_t index) {
+  hwloc_topology_t topology = getHWTopology();
+  const unsigned nodes = getNumberOfNodes(topology);
+  unsigned core = index % getNumberOfCoresOnSystem();
+  if (nodes > 0) {
+    const auto cores = getCoresForNode(topology, index % nodes);
+    if (cores.empty())
+      return;
+    core = cores[(index / nodes) % cores.size()];
+  }
+
+  hwloc_obj_t obj = hwloc_get_obj_by_type(topology, HWLOC_OBJ_CORE, core);
+  hwloc_cpuset_t cpuset = hwloc_bitmap_dup(obj->cpuset);
+  hwloc_bitmap_singlify(cpuset);
+  if (hwloc_set_cpubind(topology, cpuset, HWLOC_CPUBIND_THREAD | HWLOC_CPUBIND_STRICT | HWLOC_CPUBIND_NOMEMBIND))
+    LOG4CXX_WARN(_logger, "Could not bind event loop " << index << ": " << strerror(errno));
+  hwloc_bitmap_free(cpuset);
+
+  if (hwloc_set_membind_nodeset(topology, obj->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD))
+    LOG4CXX_WARN(_logger, "Could not membind event loop " << index << ": " << strerror(errno));
+}
+
+/// Binds a listening socket that shares port with the other loops
+int bindReusePort(size_t port) {
+#ifdef SO_REUSEPORT
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+
+  int on = 1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0 ||
+      bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+/// Checks that no other process, with or without SO_REUSEPORT, uses port
+bool portAvailable(size_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return false;
+
+  int on = 1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  const bool available = bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0;
+  close(fd);
+  return available;
+}
+
+}
+
+EventLoopPool::EventLoopPool(size_t loops, bool pin) : _pin(pin) {
+#ifndef SO_REUSEPORT
+  if (loops > 1) {
+    LOG4CXX_WARN(_logger, "SO_REUSEPORT is not supported, using a single event loop");
+    loops = 1;
+  }
+#endif
+  if (loops == 0)
+    throw std::runtime_error("At least one event loop is required");
+
+  for (size_t i = 0; i < loops; ++i) {
+    std::unique_ptr<event_loop_t> l(new event_loop_t);
+    l->loop = ev_loop_new(EVFLAG_AUTO);
+    ebb_server_init(&l->server, l->loop);
+    l->server.new_connection = new_connection;
+    l->stop.data = l.get();
+    ev_async_init(&l->stop, stop_cb);
+    ev_async_start(l->loop, &l->stop);
+    _loops.push_back(std::move(l));
+  }
+}
+
+EventLoopPool::~EventLoopPool() {
+  shutdown();
+  for (auto& thread : _threads)
+    thread.join();
+  closeSockets();
+  for (auto& l : _loops)
+    ev_loop_destroy(l->loop);
+}
+
+bool EventLoopPool::listen(size_t port) {
+  if (_loops.size() == 1)
+    return ebb_server_listen_on_port(&_loops[0]->server, port) != -1;
+
+  if (!portAvailable(port))
+    return false;
+  for (size_t i = 0; i < _loops.size(); ++i) {
+    const int fd = bindReusePort(port);
+    if (fd < 0) {
+      closeSockets();
+      return false;
+    }
+    _sockets.push_back(fd);
+  }
+
+  // From here on the servers own the sockets
+  for (size_t i = 0; i < _loops.size(); ++i) {
+    if (ebb_server_listen_on_fd(&_loops[i]->server, _sockets[i]) == -1)
+      throw std::runtime_error("Could not listen on port " + std::to_string(port));
+  }
+  _sockets.clear();
+  return true;
+}
+
+void EventLoopPool::run() {
+  _running = this;
+  for (size_t i = 1; i < _loops.size(); ++i)
+    _threads.emplace_back(&EventLoopPool::runLoop, this, i);
+  runLoop(0);
+  for (auto& thread : _threads)
+    thread.join();
+  _threads.clear();
+  _running = nullptr;
+}
+
+void EventLoopPool::runLoop(size_t index) {
+  if (_pin)
+    bindToNode(index);
+  ev_loop(_loops[index]->loop, 0);
+}
+
+void EventLoopPool::shutdown() {
+  for (auto& l : _loops)
+    ev_async_send(l->loop, &l->stop);
+}
+
+size_t EventLoopPool::size() const {
+  return _loops.size();
+}
+
+EventLoopPool *EventLoopPool::running() {
+  return _running;
+}
+
+void EventLoopPool::stop_cb(struct ev_loop *loop, ev_async *w, int revents) {
+  auto l = static_cast<event_loop_t *>(w->data);
+  ebb_server_unlisten(&l->server);
+  ev_async_stop(loop, w);
+}
+
+void EventLoopPool::closeSockets() {
+  for (const auto& fd : _sockets)
+    close(fd);
+  _sockets.clear();
+}
+
+}
+}
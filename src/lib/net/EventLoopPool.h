@@ -0,0 +1,68 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#ifndef SRC_LIB_NET_EVENTLOOPPOOL_H_
+#define SRC_LIB_NET_EVENTLOOPPOOL_H_
+
+#include <ev.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ebb/ebb.h"
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+namespace net {
+
+/// Runs the HTTP front end on multiple libev event loops.
+///
+/// Every loop has its own ebb_server with its own listening socket on the
+/// same port. With more than one loop the sockets are bound with
+/// SO_REUSEPORT so that the kernel distributes new connections among the
+/// loops. A connection stays on the loop that accepted it: requests are
+/// parsed there and responses of AsyncConnection are handed back to it
+/// through the ev_async watcher of the connection.
+class EventLoopPool : noncopyable {
+ public:
+  /// Creates loops event loops. With pin, loop i is bound to a core of
+  /// NUMA node i % nodes.
+  EventLoopPool(size_t loops, bool pin);
+  ~EventLoopPool();
+
+  /// Starts listening on port with all loops
+  /// \returns false if the port is already in use
+  bool listen(size_t port);
+
+  /// Runs all loops, the first one on the calling thread, until all
+  /// servers stopped listening and their connections are closed
+  void run();
+
+  /// Stops accepting connections on all loops, may be called from any thread
+  void shutdown();
+
+  size_t size() const;
+
+  /// The pool currently running, nullptr if none
+  static EventLoopPool *running();
+
+ private:
+  typedef struct {
+    struct ev_loop *loop;
+    ebb_server server;
+    ev_async stop;
+  } event_loop_t;
+
+  static void stop_cb(struct ev_loop *loop, ev_async *w, int revents);
+  void runLoop(size_t index);
+  void closeSockets();
+
+  bool _pin;
+  std::vector<std::unique_ptr<event_loop_t>> _loops;
+  std::vector<int> _sockets;
+  std::vector<std::thread> _threads;
+};
+
+}
+}
+
+#endif  // SRC_LIB_NET_EVENTLOOPPOOL_H_
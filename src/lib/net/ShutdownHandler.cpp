@@ -1,6 +1,7 @@
 #include "net/ShutdownHandler.h"
 #include <iostream>
 #include "net/AsyncConnection.h"
+#include "net/EventLoopPool.h"
 #include "ebb/ebb.h"
 
 namespace hyrise {
@@ -21,7 +22,10 @@ const std::string ShutdownHandler::vname() {
 void ShutdownHandler::operator()() {
   if (auto ac = dynamic_cast<AsyncConnection*>(_connection)) {
     ac->respond("shutting down");
-    ebb_server_unlisten(ac->connection->server);
+    if (auto pool = EventLoopPool::running())
+      pool->shutdown();
+    else
+      ebb_server_unlisten(ac->connection->server);
   }
 }
 
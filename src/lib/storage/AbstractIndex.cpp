@@ -6,5 +6,23 @@ namespace storage {
 
 AbstractIndex::~AbstractIndex() {}
 
+void AbstractIndex::addRows(const AbstractTable& table, pos_t first, size_t num) {
+  if (first >= _indexedEnd) {
+    insertRows(table, first, num);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_deferredMtx);
+  for (pos_t row = first; row < first + num; ++row) {
+    if (row >= _indexedEnd || _deferred.erase(row) > 0)
+      insertRows(table, row, 1);
+  }
+}
+
+void AbstractIndex::setIndexedRows(pos_t end, const std::vector<pos_t>& deferred) {
+  std::lock_guard<std::mutex> lock(_deferredMtx);
+  _deferred = std::set<pos_t>(deferred.begin(), deferred.end());
+  _indexedEnd = end;
+}
+
 } } // namespace hyrise::storage
 
@@ -6,11 +6,19 @@
  */
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <helper/types.h>
 #include <storage/AbstractResource.h>
 
 namespace hyrise {
 namespace storage {
 
+class AbstractTable;
+
 class AbstractIndex : public AbstractResource {
 
 public:
@@ -20,6 +28,29 @@ public:
   virtual ~AbstractIndex();
 
   virtual void shrink() = 0;
+
+  /// Indexes attached to a Store (see Store::addIndex) are notified of
+  /// rows written to its delta. Rows that are never committed remain in
+  /// the index and have to be filtered by visibility.
+  virtual void insertRows(const AbstractTable& table, pos_t first, size_t num) {}
+
+  /// Notifies attached indexes that the store dropped all rows that are
+  /// not marked in kept, e.g. during a merge or a delta compaction. The
+  /// remaining rows keep their order.
+  virtual void moveRows(const AbstractTable& table, const std::vector<bool>& kept) {}
+
+  /// Passes rows written to the delta of a store on to insertRows(),
+  /// except rows that were already added when the index was attached
+  void addRows(const AbstractTable& table, pos_t first, size_t num);
+
+  /// Marks all rows before end as indexed except the deferred ones, whose
+  /// values were not written yet when the index was attached
+  void setIndexedRows(pos_t end, const std::vector<pos_t>& deferred);
+
+private:
+  std::atomic<pos_t> _indexedEnd {0};
+  std::set<pos_t> _deferred;
+  std::mutex _deferredMtx;
 };
 
 } } // namespace hyrise::storage
@@ -57,7 +57,7 @@ public:
   }
 
   virtual AbstractMergeStrategy *copy() {
-    throw std::runtime_error("Merge Strategy Copy is like killing a kitten");
+    return new DefaultMergeStrategy();
   }
 
 };
@@ -0,0 +1,183 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "helper/locking.h"
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+namespace storage {
+
+/// Vector of fixed size, cache line aligned chunks that can grow
+/// concurrently while being read.
+///
+/// In contrast to tbb::concurrent_vector every chunk holds exactly
+/// chunk_size elements, so a chunk can be handed out as a plain
+/// contiguous array, e.g. for vectorized processing. Elements never move
+/// once allocated: growing only appends new chunks and, if necessary,
+/// replaces the chunk directory. Replaced directories are retired and
+/// only freed on destruction so that concurrent readers stay valid.
+template <typename T, std::size_t ChunkBits = 12>
+class ChunkedVector : private noncopyable {
+ public:
+  static const std::size_t chunk_bits = ChunkBits;
+  static const std::size_t chunk_size = std::size_t(1) << ChunkBits;
+  static const std::size_t chunk_mask = chunk_size - 1;
+
+  ChunkedVector() : _chunks(nullptr), _capacity(0), _size(0) {}
+
+  ChunkedVector(std::size_t n, T value) : ChunkedVector() {
+    grow_to_at_least(n, value);
+  }
+
+  ChunkedVector(ChunkedVector&& other) : ChunkedVector() {
+    swap(other);
+  }
+
+  ChunkedVector& operator=(ChunkedVector&& other) {
+    ChunkedVector tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  ~ChunkedVector() {
+    clear();
+  }
+
+  inline T& operator[](std::size_t i) {
+    return _chunks.load(std::memory_order_acquire)[i >> chunk_bits][i & chunk_mask];
+  }
+
+  inline const T& operator[](std::size_t i) const {
+    return _chunks.load(std::memory_order_acquire)[i >> chunk_bits][i & chunk_mask];
+  }
+
+  inline std::size_t size() const {
+    return _size.load(std::memory_order_acquire);
+  }
+
+  /// Number of chunks spanned by size()
+  inline std::size_t chunkCount() const {
+    return (size() + chunk_mask) >> chunk_bits;
+  }
+
+  /// Pointer to the contiguous storage of chunk c; only the first
+  /// size() - c * chunk_size elements of the last chunk are initialized.
+  inline T* chunk(std::size_t c) {
+    return _chunks.load(std::memory_order_acquire)[c];
+  }
+
+  inline const T* chunk(std::size_t c) const {
+    return _chunks.load(std::memory_order_acquire)[c];
+  }
+
+  /// Grows the vector to at least n elements, initializing all newly
+  /// added elements with value. Safe to call concurrently with other
+  /// calls to grow_to_at_least() and with element access.
+  void grow_to_at_least(std::size_t n, T value) {
+    if (n <= size())
+      return;
+
+    std::lock_guard<locking::Spinlock> lock(_growLock);
+    const std::size_t old_size = size();
+    if (n <= old_size)
+      return;
+
+    const std::size_t needed = (n + chunk_mask) >> chunk_bits;
+    if (needed > _capacity)
+      growDirectory(needed);
+
+    T** chunks = _chunks.load(std::memory_order_relaxed);
+    for (std::size_t c = (old_size + chunk_mask) >> chunk_bits; c < needed; ++c) {
+      chunks[c] = allocateChunk();
+    }
+
+    for (std::size_t i = old_size; i < n; ++i) {
+      chunks[i >> chunk_bits][i & chunk_mask] = value;
+    }
+    _size.store(n, std::memory_order_release);
+  }
+
+  /// Shrinks the vector to n elements and releases all chunks that are no
+  /// longer used. Must not be called concurrently with any other access.
+  void truncate(std::size_t n) {
+    if (n >= size())
+      return;
+
+    T** chunks = _chunks.load();
+    for (std::size_t c = (n + chunk_mask) >> chunk_bits, e = chunkCount(); c < e; ++c) {
+      free(chunks[c]);
+      chunks[c] = nullptr;
+    }
+    _size.store(n);
+  }
+
+  void swap(ChunkedVector& other) {
+    T** chunks = _chunks.load();
+    _chunks.store(other._chunks.load());
+    other._chunks.store(chunks);
+    std::swap(_capacity, other._capacity);
+    std::size_t sz = _size.load();
+    _size.store(other._size.load());
+    other._size.store(sz);
+    _retired.swap(other._retired);
+  }
+
+ private:
+  static T* allocateChunk() {
+    void* mem = nullptr;
+    if (posix_memalign(&mem, 64, chunk_size * sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return static_cast<T*>(mem);
+  }
+
+  void growDirectory(std::size_t needed) {
+    std::size_t capacity = std::max<std::size_t>(_capacity * 2, 16);
+    while (capacity < needed)
+      capacity *= 2;
+
+    T** old_chunks = _chunks.load(std::memory_order_relaxed);
+    T** chunks = new T*[capacity]();
+    std::copy(old_chunks, old_chunks + _capacity, chunks);
+    _chunks.store(chunks, std::memory_order_release);
+    _capacity = capacity;
+    if (old_chunks != nullptr)
+      _retired.push_back(old_chunks);
+  }
+
+  void clear() {
+    T** chunks = _chunks.load();
+    if (chunks != nullptr) {
+      for (std::size_t c = 0, e = chunkCount(); c < e; ++c)
+        free(chunks[c]);
+      delete[] chunks;
+    }
+    for (auto dir : _retired)
+      delete[] dir;
+    _retired.clear();
+    _chunks.store(nullptr);
+    _capacity = 0;
+    _size.store(0);
+  }
+
+  std::atomic<T**> _chunks;
+  std::size_t _capacity;
+  std::atomic<std::size_t> _size;
+  std::vector<T**> _retired;
+  locking::Spinlock _growLock;
+};
+
+template <typename T, std::size_t ChunkBits>
+const std::size_t ChunkedVector<T, ChunkBits>::chunk_bits;
+template <typename T, std::size_t ChunkBits>
+const std::size_t ChunkedVector<T, ChunkBits>::chunk_size;
+template <typename T, std::size_t ChunkBits>
+const std::size_t ChunkedVector<T, ChunkBits>::chunk_mask;
+
+} } // namespace hyrise::storage
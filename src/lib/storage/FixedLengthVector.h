@@ -76,6 +76,9 @@ class FixedLengthVector : public AbstractFixedLengthVector<T> {
   virtual void clear() { _values.clear(); }
   virtual void rewriteColumn(const size_t, const size_t) {}
   virtual void *data() override { return _values.data();}
+
+  // Number of interleaved columns, the stride of rows in data()
+  std::size_t columns() const { return _columns; }
  private:
   void check_access(std::size_t columns, std::size_t rows) const {
 #ifdef EXPENSIVE_ASSERTIONS
@@ -0,0 +1,242 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "helper/types.h"
+
+#include "storage/storage_types.h"
+#include "storage/AbstractIndex.h"
+#include "storage/AbstractTable.h"
+#include "storage/BaseDictionary.h"
+#include "storage/BitCompressedVector.h"
+#include "storage/RawTable.h"
+
+namespace hyrise {
+namespace storage {
+
+/// Index on the value ids of the main dictionary of a column.
+///
+/// The positions of all main rows are stored in one array grouped by value
+/// id, offsets[vid] points to the first position of vid. This needs one
+/// offset per distinct value and one position per row instead of a hash
+/// node and a separately allocated position list per value. With
+/// compression both arrays are bit packed to the number of bits needed for
+/// the largest position. The index is built in two passes over the value
+/// ids, counting and scattering, each split among multiple threads. Rows
+/// outside the main dictionary, e.g. of the delta of a store, are kept in
+/// a hash map. A rebuild creates new arrays aside and swaps them in while
+/// holding the lock of the hash map, which readers take before they load
+/// the arrays.
+template<typename T>
+class GroupKeyIndex : public AbstractIndex {
+public:
+  /// Minimum number of rows each build thread processes
+  static const size_t rows_per_thread = 1 << 16;
+
+  virtual ~GroupKeyIndex() {}
+
+  GroupKeyIndex(const c_atable_ptr_t& in, field_t column, bool compressed = false) :
+      _column(column), _compressed(compressed) {
+    if (in != nullptr)
+      build(*in);
+    else
+      _main = std::make_shared<main_t>();
+  }
+
+  /// Arrays are sized exactly when they are built
+  void shrink() {}
+
+  void insertRows(const AbstractTable& table, pos_t first, size_t num) override {
+    for (pos_t row = first; row < first + num; ++row) {
+      T key = table.getValue<T>(_column, row);
+      std::lock_guard<std::mutex> lock(_deltaMtx);
+      _delta[key].push_back(row);
+    }
+  }
+
+  /// Value ids of the main change with a merge, so the index is rebuilt
+  void moveRows(const AbstractTable& table, const std::vector<bool>& kept) override {
+    build(table);
+  }
+
+  /// Sorted positions of all rows with the value id vid in the main
+  pos_list_t getPositionsForValueId(value_id_t vid) const {
+    return std::atomic_load(&_main)->positionsFor(vid);
+  }
+
+  /// Sorted positions of all rows with the value key
+  pos_list_t getPositionsForKey(const T& key) const {
+    pos_list_t result;
+    std::lock_guard<std::mutex> lock(_deltaMtx);
+    const auto main = std::atomic_load(&_main);
+    if (main->dictionary && main->dictionary->valueExists(key))
+      result = main->positionsFor(main->dictionary->getValueIdForValue(key));
+
+    auto it = _delta.find(key);
+    if (it != _delta.end()) {
+      const size_t indexed = result.size();
+      result.insert(result.end(), it->second.begin(), it->second.end());
+      std::sort(result.begin() + indexed, result.end());
+    }
+    return result;
+  }
+
+  /// Bytes used by the offsets and positions of the main
+  size_t memoryUsage() const {
+    const auto main = std::atomic_load(&_main);
+    if (main->packedOffsets)
+      return (main->packedOffsets->size() * main->offsetBits + main->packedPositions->size() * main->positionBits) / 8;
+    return (main->offsets.size() + main->positions.size()) * sizeof(pos_t);
+  }
+
+private:
+  struct main_t {
+    std::shared_ptr<BaseDictionary<T>> dictionary;
+    value_id_t distinct = 0;
+    // Positions of the rows of value id vid are positions[offsets[vid], offsets[vid + 1])
+    pos_list_t offsets;
+    pos_list_t positions;
+    // Bit packed offsets and positions if compressed
+    std::unique_ptr<BitCompressedVector<pos_t>> packedOffsets;
+    std::unique_ptr<BitCompressedVector<pos_t>> packedPositions;
+    uint64_t offsetBits = 0;
+    uint64_t positionBits = 0;
+
+    inline size_t offset(value_id_t vid) const {
+      return packedOffsets ? packedOffsets->get(0, vid) : offsets[vid];
+    }
+
+    inline pos_t position(size_t i) const {
+      return packedPositions ? packedPositions->get(0, i) : positions[i];
+    }
+
+    pos_list_t positionsFor(value_id_t vid) const {
+      pos_list_t result;
+      if (vid >= distinct)
+        return result;
+      const size_t first = offset(vid), last = offset(vid + 1);
+      result.reserve(last - first);
+      for (size_t i = first; i < last; ++i)
+        result.push_back(position(i));
+      return result;
+    }
+  };
+
+  static uint64_t bitsFor(uint64_t max) {
+    uint64_t bits = 1;
+    while (bits < 64 && (max >> bits) != 0)
+      ++bits;
+    return bits;
+  }
+
+  /// Builds the arrays aside and publishes them with the rows outside the
+  /// main dictionary
+  void build(const AbstractTable& table) {
+    std::lock_guard<std::mutex> rebuild(_rebuildMtx);
+    auto main = std::make_shared<main_t>();
+    auto& dictionary = main->dictionary;
+    if (dynamic_cast<const RawTable *>(&table) == nullptr)
+      dictionary = std::dynamic_pointer_cast<BaseDictionary<T>>(table.dictionaryByTableId(_column, 0));
+    const value_id_t distinct = main->distinct = dictionary ? dictionary->size() : 0;
+    const size_t rows = table.size();
+
+    const size_t threads = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), rows / rows_per_thread));
+    const size_t chunk = (rows + threads - 1) / threads;
+    auto forEachChunk = [&] (std::function<void(size_t, size_t, size_t)> work) {
+      std::vector<std::thread> workers;
+      for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work, t, t * chunk, std::min(rows, (t + 1) * chunk));
+      work(0, 0, std::min(rows, chunk));
+      for (auto& worker : workers)
+        worker.join();
+    };
+
+    // First pass, count the rows of every value id per chunk
+    std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(distinct, 0));
+    std::vector<pos_list_t> unindexed(threads);
+    forEachChunk([&] (size_t t, size_t from, size_t to) {
+        for (size_t row = from; row < to; ++row) {
+          if (dictionary) {
+            const ValueId vid = table.getValueId(_column, row);
+            if (vid.table == 0 && vid.valueId < distinct) {
+              ++counts[t][vid.valueId];
+              continue;
+            }
+          }
+          unindexed[t].push_back(row);
+        }
+      });
+
+    // Turn the counts into the first position of each chunk within a value id
+    auto& offsets = main->offsets;
+    offsets.assign(distinct + 1, 0);
+    size_t total = 0;
+    for (value_id_t vid = 0; vid < distinct; ++vid) {
+      offsets[vid] = total;
+      for (size_t t = 0; t < threads; ++t) {
+        const size_t count = counts[t][vid];
+        counts[t][vid] = total;
+        total += count;
+      }
+    }
+    offsets[distinct] = total;
+
+    // Second pass, scatter the positions, chunks are in row order so the
+    // positions of each value id stay sorted
+    auto& positions = main->positions;
+    positions.assign(total, 0);
+    forEachChunk([&] (size_t t, size_t from, size_t to) {
+        auto& next = counts[t];
+        for (size_t row = from; row < to && dictionary; ++row) {
+          const ValueId vid = table.getValueId(_column, row);
+          if (vid.table == 0 && vid.valueId < distinct)
+            positions[next[vid.valueId]++] = row;
+        }
+      });
+
+    if (_compressed) {
+      main->offsetBits = bitsFor(total);
+      main->positionBits = bitsFor(rows);
+      main->packedOffsets.reset(new BitCompressedVector<pos_t>(1, offsets.size(), {main->offsetBits}));
+      main->packedOffsets->resize(offsets.size());
+      for (size_t i = 0; i < offsets.size(); ++i)
+        main->packedOffsets->set(0, i, offsets[i]);
+      main->packedPositions.reset(new BitCompressedVector<pos_t>(1, positions.size(), {main->positionBits}));
+      main->packedPositions->resize(positions.size());
+      for (size_t i = 0; i < positions.size(); ++i)
+        main->packedPositions->set(0, i, positions[i]);
+      pos_list_t().swap(offsets);
+      pos_list_t().swap(positions);
+    }
+
+    std::unordered_map<T, pos_list_t> delta;
+    for (const auto& rows_of_chunk : unindexed) {
+      for (const auto& row : rows_of_chunk)
+        delta[table.getValue<T>(_column, row)].push_back(row);
+    }
+
+    std::lock_guard<std::mutex> lock(_deltaMtx);
+    std::atomic_store(&_main, std::shared_ptr<const main_t>(main));
+    _delta.swap(delta);
+  }
+
+  field_t _column;
+  bool _compressed;
+  // Main rows as of construction or the last moveRows()
+  std::shared_ptr<const main_t> _main;
+  // Serializes rebuilds
+  std::mutex _rebuildMtx;
+
+  // Rows that are not part of the main dictionary
+  std::unordered_map<T, pos_list_t> _delta;
+  mutable std::mutex _deltaMtx;
+};
+
+} } // namespace hyrise::storage
@@ -10,6 +10,7 @@
 
 #include "helper/types.h"
 #include "helper/checked_cast.h"
+#include "helper/QueryArena.h"
 
 #include "storage/AbstractHashTable.h"
 #include "storage/AbstractTable.h"
@@ -116,13 +117,18 @@ public:
   }
 };
 
+// Nodes and buckets of the maps are allocated from the arena of the query
+// building them, if any
+template<class KEY>
+using hash_map_allocator_t = ArenaAllocator<std::pair<const KEY, pos_t> >;
+
 // Multi Keys
-typedef std::unordered_multimap<aggregate_key_t, pos_t, GroupKeyHash<aggregate_key_t> > aggregate_hash_map_t;
-typedef std::unordered_multimap<join_key_t, pos_t, GroupKeyHash<join_key_t> > join_hash_map_t;
+typedef std::unordered_multimap<aggregate_key_t, pos_t, GroupKeyHash<aggregate_key_t>, std::equal_to<aggregate_key_t>, hash_map_allocator_t<aggregate_key_t> > aggregate_hash_map_t;
+typedef std::unordered_multimap<join_key_t, pos_t, GroupKeyHash<join_key_t>, std::equal_to<join_key_t>, hash_map_allocator_t<join_key_t> > join_hash_map_t;
 
 // Single Keys
-typedef std::unordered_multimap<aggregate_single_key_t, pos_t, SingleGroupKeyHash<aggregate_single_key_t> > aggregate_single_hash_map_t;
-typedef std::unordered_multimap<join_single_key_t, pos_t, SingleGroupKeyHash<join_single_key_t> > join_single_hash_map_t;
+typedef std::unordered_multimap<aggregate_single_key_t, pos_t, SingleGroupKeyHash<aggregate_single_key_t>, std::equal_to<aggregate_single_key_t>, hash_map_allocator_t<aggregate_single_key_t> > aggregate_single_hash_map_t;
+typedef std::unordered_multimap<join_single_key_t, pos_t, SingleGroupKeyHash<join_single_key_t>, std::equal_to<join_single_key_t>, hash_map_allocator_t<join_single_key_t> > join_single_hash_map_t;
 
 /// HashTable based on a map; key specifies the key for the given map
 template<class MAP, class KEY> class HashTable;
@@ -170,6 +176,10 @@ private:
     }
   }
 
+  static map_t arenaMap(const std::shared_ptr<QueryArena> &arena) {
+    return map_t(0, typename map_t::hasher(), typename map_t::key_equal(), typename map_t::allocator_type(arena));
+  }
+
   pos_list_t constructPositions(const map_const_range_t &range) const {
     return constructPositions(range.first, range.second);
   }
@@ -187,7 +197,9 @@ public:
   HashTable() {}
 
   // create a new HashTable based on a number of HashTables
-  explicit HashTable(const std::vector<std::shared_ptr<const AbstractHashTable> >& hashTables) {
+  explicit HashTable(const std::vector<std::shared_ptr<const AbstractHashTable> >& hashTables,
+                     const std::shared_ptr<QueryArena> &arena = nullptr)
+    : _map(arenaMap(arena)) {
     _dirty = true;
     for (auto & nextElement: hashTables) {
       const auto& ht = checked_pointer_cast<const HashTable<MAP, KEY>>(nextElement);
@@ -197,11 +209,20 @@ public:
 
   // Hash given table's columns directly into the new HashTable
   // row_offset is used if t is a TableRangeView, so that the HashTable can build the pos_lists based on the row numbers of the original table
-  HashTable(c_atable_ptr_t t, const field_list_t &f, size_t row_offset = 0)
-    : _table(t), _fields(f), _numKeys(0), _dirty(true) {
+  HashTable(c_atable_ptr_t t, const field_list_t &f, size_t row_offset = 0,
+            const std::shared_ptr<QueryArena> &arena = nullptr)
+    : _map(arenaMap(arena)), _table(t), _fields(f), _numKeys(0), _dirty(true) {
     populate_map(row_offset);
   }
 
+  // Hash only the given rows of the table's columns, more rows can be
+  // added with insertRows
+  HashTable(c_atable_ptr_t t, const field_list_t &f, const pos_list_t &rows,
+            const std::shared_ptr<QueryArena> &arena = nullptr)
+    : _map(arenaMap(arena)), _table(t), _fields(f), _numKeys(0), _dirty(true) {
+    insertRows(rows);
+  }
+
   virtual ~HashTable() {}
 
   std::string stats() const {
@@ -231,6 +252,14 @@ public:
     return constructPositions(range);
   }
 
+  /// Adds the given rows of the table to the map
+  void insertRows(const pos_list_t &rows) {
+    _dirty = true;
+    const size_t fieldSize = _fields.size();
+    for (const auto& row : rows)
+      _map.insert(typename map_t::value_type(MAP::hasher::getGroupKey(_table, _fields, fieldSize, row), row));
+  }
+
   /// Get const interators to underlying map's begin or end.
   map_const_iterator_t getMapBegin() const {
     return _map.begin();
@@ -12,8 +12,10 @@
 #include "storage/AbstractIndex.h"
 #include "storage/AbstractTable.h"
 
+#include <array>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 namespace hyrise {
 namespace storage {
@@ -23,53 +25,174 @@ class InvertedIndex : public AbstractIndex {
 private:
   //using inverted_index_t = std::map<T, pos_list_t>;
   using inverted_index_t = std::unordered_map<T, pos_list_t>;
-  inverted_index_t _index;
+  static const size_t delta_partitions = 16;
+
+  typedef struct {
+    std::mutex mtx;
+    inverted_index_t index;
+  } delta_partition_t;
+
+  // Positions indexed on construction or by the last moveRows(). The map
+  // is never changed once published, moveRows() builds a new one and
+  // swaps it in while holding the locks of all delta partitions.
+  std::shared_ptr<const inverted_index_t> _index;
+  // Positions added by insertRows(), partitioned by key so that
+  // concurrent inserts of different keys rarely contend
+  mutable std::array<delta_partition_t, delta_partitions> _delta;
+  // Serializes the builders of new maps
+  std::mutex _rebuildMtx;
+  field_t _column;
+
+  delta_partition_t& partitionFor(const T& key) const {
+    return _delta[std::hash<T>()(key) % delta_partitions];
+  }
+
+  /// Replaces the indexed positions, readers see either the old map and
+  /// delta or the new map and the delta without the removed positions
+  void publish(std::shared_ptr<const inverted_index_t> index,
+               const std::array<inverted_index_t, delta_partitions>& removed) {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (auto & partition : _delta)
+      locks.emplace_back(partition.mtx);
+    std::atomic_store(&_index, index);
+    for (size_t i = 0; i < delta_partitions; ++i) {
+      // Positions inserted since they were copied remain in the delta
+      for (const auto& e : removed[i]) {
+        auto& positions = _delta[i].index[e.first];
+        positions.erase(positions.begin(), positions.begin() + e.second.size());
+        if (positions.empty())
+          _delta[i].index.erase(e.first);
+      }
+    }
+  }
 
 public:
   virtual ~InvertedIndex() {};
 
   void shrink() {
-    for (auto & e : _index) {
+    std::lock_guard<std::mutex> rebuild(_rebuildMtx);
+    auto index = std::make_shared<inverted_index_t>(*std::atomic_load(&_index));
+    for (auto & e : *index) {
       e.second.shrink_to_fit();
     }
+    publish(index, std::array<inverted_index_t, delta_partitions>());
+    for (auto & partition : _delta) {
+      std::lock_guard<std::mutex> lock(partition.mtx);
+      for (auto & e : partition.index)
+        e.second.shrink_to_fit();
+    }
   }
 
-  explicit InvertedIndex(const c_atable_ptr_t& in, field_t column) {
+  explicit InvertedIndex(const c_atable_ptr_t& in, field_t column) : _column(column) {
+    auto index = std::make_shared<inverted_index_t>();
     if (in != nullptr) {
       for (size_t row = 0; row < in->size(); ++row) {
         T tmp = in->getValue<T>(column, row);
-        typename inverted_index_t::iterator find = _index.find(tmp);
-        if (find == _index.end()) {
+        typename inverted_index_t::iterator find = index->find(tmp);
+        if (find == index->end()) {
           pos_list_t pos;
           pos.push_back(row);
-          _index[tmp] = pos;
+          (*index)[tmp] = pos;
         } else {
           find->second.push_back(row);
         }
       }
     }
+    _index = index;
   };
 
+  void insertRows(const AbstractTable& table, pos_t first, size_t num) override {
+    for (pos_t row = first; row < first + num; ++row) {
+      T key = table.getValue<T>(_column, row);
+      auto& partition = partitionFor(key);
+      std::lock_guard<std::mutex> lock(partition.mtx);
+      partition.index[key].push_back(row);
+    }
+  }
+
+  /// Builds the remapped positions aside, readers keep using the current
+  /// ones until they are swapped
+  void moveRows(const AbstractTable& table, const std::vector<bool>& kept) override {
+    // New position of every kept row
+    std::vector<pos_t> moved(kept.size());
+    pos_t next = 0;
+    for (size_t row = 0; row < kept.size(); ++row) {
+      if (kept[row])
+        moved[row] = next++;
+    }
+    auto remap = [&kept, &moved] (pos_list_t& positions) {
+      size_t out = 0;
+      for (const auto& p : positions) {
+        if (p < kept.size() && kept[p])
+          positions[out++] = moved[p];
+      }
+      positions.resize(out);
+    };
+
+    std::lock_guard<std::mutex> rebuild(_rebuildMtx);
+    std::array<inverted_index_t, delta_partitions> copied;
+    for (size_t i = 0; i < delta_partitions; ++i) {
+      std::lock_guard<std::mutex> lock(_delta[i].mtx);
+      copied[i] = _delta[i].index;
+    }
+
+    auto index = std::make_shared<inverted_index_t>(*std::atomic_load(&_index));
+    for (const auto& partition : copied) {
+      for (const auto& e : partition) {
+        // Concurrent inserts may have appended out of order
+        pos_list_t sorted(e.second);
+        std::sort(sorted.begin(), sorted.end());
+        auto& positions = (*index)[e.first];
+        positions.insert(positions.end(), sorted.begin(), sorted.end());
+      }
+    }
+
+    for (auto it = index->begin(); it != index->end();) {
+      remap(it->second);
+      if (it->second.empty())
+        it = index->erase(it);
+      else
+        ++it;
+    }
+    publish(index, copied);
+  }
+
   /**
-   * returns a list of positions where key was found.
+   * returns a list of positions where key was found, including rows
+   * inserted after the index was built. Positions are sorted.
    */
   pos_list_t getPositionsForKey(T key) {
-    typename inverted_index_t::iterator it = _index.find(key);
-    if (it != _index.end()) {
-      return it->second;
-    } else {
-      pos_list_t empty;
-      return empty;
+    pos_list_t result;
+    auto& partition = partitionFor(key);
+    std::lock_guard<std::mutex> lock(partition.mtx);
+    const auto index = std::atomic_load(&_index);
+    typename inverted_index_t::const_iterator it = index->find(key);
+    if (it != index->end())
+      result = it->second;
+
+    auto delta = partition.index.find(key);
+    if (delta != partition.index.end()) {
+      const size_t indexed = result.size();
+      result.insert(result.end(), delta->second.begin(), delta->second.end());
+      std::sort(result.begin() + indexed, result.end());
     }
+    return result;
   };
 
   
   bool exists(T key) const {
-    return _index.count(key) > 0;
+    auto& partition = partitionFor(key);
+    std::lock_guard<std::mutex> lock(partition.mtx);
+    if (std::atomic_load(&_index)->count(key) > 0)
+      return true;
+    return partition.index.count(key) > 0;
   }
 
+  /// Positions indexed on construction or by the last merge, without
+  /// rows inserted since. The reference is only valid until the next
+  /// merge of the store.
   const pos_list_t& getPositionsForKeyRef(T key) {
-    const auto& it = _index.find(key);
+    const auto& it = std::atomic_load(&_index)->find(key);
     return it->second;
   };
 
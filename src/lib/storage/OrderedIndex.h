@@ -0,0 +1,308 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "helper/types.h"
+
+#include "storage/storage_types.h"
+#include "storage/AbstractIndex.h"
+#include "storage/AbstractTable.h"
+#include "storage/BaseDictionary.h"
+#include "storage/PointerCalculator.h"
+#include "storage/RawTable.h"
+
+namespace hyrise {
+namespace storage {
+
+/// Index on one column that keeps its keys in order and serves point,
+/// range and prefix lookups.
+///
+/// Rows present when the index is built or remapped are stored in a read
+/// only B+-tree: the sorted keys form the leaf level, each inner level
+/// holds the first key of every node_size entries of the level below and
+/// the positions of all keys are stored contiguously. Rows of an ordered
+/// main dictionary are bulk loaded in dictionary order without comparing
+/// keys. Rows inserted afterwards (see AbstractIndex::insertRows) go to a
+/// sorted map and are folded into the tree by moveRows(). The tree is never
+/// changed once published, moveRows() builds a new one and swaps it in
+/// while holding the lock readers take before they load the tree.
+template<typename T>
+class OrderedIndex : public AbstractIndex {
+public:
+  static const size_t node_size = 64;
+
+  virtual ~OrderedIndex() {}
+
+  explicit OrderedIndex(const c_atable_ptr_t& in, field_t column) : _column(column) {
+    auto tree = std::make_shared<tree_t>();
+    if (in != nullptr) {
+      std::vector<std::pair<T, pos_t>> unsorted;
+      bulkLoad(in, unsorted, *tree);
+      std::sort(unsorted.begin(), unsorted.end());
+      fold(*tree, unsorted);
+    } else {
+      tree->offsets.push_back(0);
+    }
+    _tree = tree;
+  }
+
+  void shrink() {
+    std::lock_guard<std::mutex> rebuild(_rebuildMtx);
+    auto tree = std::make_shared<tree_t>(*std::atomic_load(&_tree));
+    tree->keys.shrink_to_fit();
+    tree->offsets.shrink_to_fit();
+    tree->positions.shrink_to_fit();
+    std::lock_guard<std::mutex> lock(_deltaMtx);
+    std::atomic_store(&_tree, std::shared_ptr<const tree_t>(tree));
+  }
+
+  void insertRows(const AbstractTable& table, pos_t first, size_t num) override {
+    for (pos_t row = first; row < first + num; ++row) {
+      T key = table.getValue<T>(_column, row);
+      std::lock_guard<std::mutex> lock(_deltaMtx);
+      _delta[key].push_back(row);
+    }
+  }
+
+  void moveRows(const AbstractTable& table, const std::vector<bool>& kept) override {
+    std::vector<pos_t> moved(kept.size());
+    pos_t next = 0;
+    for (size_t row = 0; row < kept.size(); ++row) {
+      if (kept[row])
+        moved[row] = next++;
+    }
+
+    // The tree is built aside, readers keep using the current one
+    std::lock_guard<std::mutex> rebuild(_rebuildMtx);
+    std::map<T, pos_list_t> copied;
+    {
+      std::lock_guard<std::mutex> lock(_deltaMtx);
+      copied = _delta;
+    }
+    std::vector<std::pair<T, pos_t>> rows;
+    for (const auto& e : copied) {
+      for (const auto& p : e.second)
+        rows.emplace_back(e.first, p);
+    }
+    std::sort(rows.begin(), rows.end());
+    auto folded = std::make_shared<tree_t>(*std::atomic_load(&_tree));
+    fold(*folded, rows);
+
+    // Remapping keeps the order of positions within a key
+    auto tree = std::make_shared<tree_t>();
+    tree->offsets.push_back(0);
+    for (size_t k = 0; k < folded->keys.size(); ++k) {
+      for (size_t i = folded->offsets[k]; i < folded->offsets[k + 1]; ++i) {
+        const pos_t p = folded->positions[i];
+        if (p < kept.size() && kept[p])
+          tree->positions.push_back(moved[p]);
+      }
+      if (tree->positions.size() > tree->offsets.back()) {
+        tree->keys.push_back(folded->keys[k]);
+        tree->offsets.push_back(tree->positions.size());
+      }
+    }
+    buildInnerLevels(*tree);
+
+    std::lock_guard<std::mutex> lock(_deltaMtx);
+    std::atomic_store(&_tree, std::shared_ptr<const tree_t>(tree));
+    // Positions inserted since they were copied remain in the delta
+    for (const auto& e : copied) {
+      auto& positions = _delta[e.first];
+      positions.erase(positions.begin(), positions.begin() + e.second.size());
+      if (positions.empty())
+        _delta.erase(e.first);
+    }
+  }
+
+  /// Calls visit(key, first, last) with the positions of every key not
+  /// less than from in ascending key order until visit returns false
+  template <typename Visitor>
+  void forEachFrom(const T& from, Visitor visit) const {
+    std::lock_guard<std::mutex> lock(_deltaMtx);
+    const auto tree = std::atomic_load(&_tree);
+    const auto& keys = tree->keys;
+    const auto& offsets = tree->offsets;
+    const pos_t *positions = tree->positions.data();
+    size_t k = lowerBound(*tree, from);
+    auto d = _delta.lower_bound(from);
+    pos_list_t merged;
+    while (k < keys.size() || d != _delta.end()) {
+      bool continue_visit;
+      if (d == _delta.end() || (k < keys.size() && keys[k] < d->first)) {
+        continue_visit = visit(keys[k], positions + offsets[k], positions + offsets[k + 1]);
+        ++k;
+      } else if (k == keys.size() || d->first < keys[k]) {
+        continue_visit = visit(d->first, d->second.data(), d->second.data() + d->second.size());
+        ++d;
+      } else {
+        merged.assign(positions + offsets[k], positions + offsets[k + 1]);
+        merged.insert(merged.end(), d->second.begin(), d->second.end());
+        continue_visit = visit(keys[k], merged.data(), merged.data() + merged.size());
+        ++k;
+        ++d;
+      }
+      if (!continue_visit)
+        break;
+    }
+  }
+
+  /// Sorted positions of all rows with from <= key <= to
+  pos_list_t getPositionsForRange(const T& from, const T& to) const {
+    pos_list_t result;
+    forEachFrom(from, [&] (const T& key, const pos_t *first, const pos_t *last) {
+        if (to < key)
+          return false;
+        result.insert(result.end(), first, last);
+        return true;
+      });
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  pos_list_t getPositionsForKey(const T& key) const {
+    return getPositionsForRange(key, key);
+  }
+
+  /// Sorted positions of all rows whose key starts with prefix, only
+  /// available for string columns
+  pos_list_t getPositionsForPrefix(const T& prefix) const {
+    pos_list_t result;
+    forEachFrom(prefix, [&] (const T& key, const pos_t *first, const pos_t *last) {
+        if (key.compare(0, prefix.size(), prefix) != 0)
+          return false;
+        result.insert(result.end(), first, last);
+        return true;
+      });
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+private:
+  // Leaf level, positions of keys[k] are positions[offsets[k], offsets[k + 1])
+  struct tree_t {
+    std::vector<T> keys;
+    std::vector<size_t> offsets;
+    pos_list_t positions;
+    // Separator keys, inner[0] is the level right above the leaves
+    std::vector<std::vector<T>> inner;
+  };
+
+  /// Loads the rows of the ordered main dictionary by counting sort over
+  /// the value ids, all other rows are returned in unsorted
+  void bulkLoad(const c_atable_ptr_t& in, std::vector<std::pair<T, pos_t>>& unsorted, tree_t& tree) const {
+    std::shared_ptr<BaseDictionary<T>> dict;
+    if (!std::dynamic_pointer_cast<const PointerCalculator>(in) && !std::dynamic_pointer_cast<const RawTable>(in))
+      dict = std::dynamic_pointer_cast<BaseDictionary<T>>(in->dictionaryByTableId(_column, 0));
+    if (dict && !dict->isOrdered())
+      dict.reset();
+
+    const size_t dict_size = dict ? dict->size() : 0;
+    std::vector<size_t> counts(dict_size + 1, 0);
+    for (size_t row = 0; row < in->size(); ++row) {
+      if (dict) {
+        const ValueId vid = in->getValueId(_column, row);
+        if (vid.table == 0) {
+          ++counts[vid.valueId + 1];
+          continue;
+        }
+      }
+      unsorted.emplace_back(in->getValue<T>(_column, row), row);
+    }
+    if (!dict)
+      return;
+
+    for (size_t vid = 0; vid < dict_size; ++vid)
+      counts[vid + 1] += counts[vid];
+    tree.positions.resize(counts[dict_size]);
+    std::vector<size_t> fill(counts.begin(), counts.end() - 1);
+    for (size_t row = 0; row < in->size(); ++row) {
+      const ValueId vid = in->getValueId(_column, row);
+      if (vid.table == 0)
+        tree.positions[fill[vid.valueId]++] = row;
+    }
+    tree.offsets.push_back(0);
+    for (value_id_t vid = 0; vid < dict_size; ++vid) {
+      if (counts[vid + 1] > counts[vid]) {
+        tree.keys.push_back(dict->getValueForValueId(vid));
+        tree.offsets.push_back(counts[vid + 1]);
+      }
+    }
+  }
+
+  /// Merges sorted (key, position) pairs into the leaf level. Positions
+  /// of pairs are larger than all positions already stored for their key.
+  static void fold(tree_t& tree, const std::vector<std::pair<T, pos_t>>& rows) {
+    if (tree.offsets.empty())
+      tree.offsets.push_back(0);
+    if (!rows.empty()) {
+      std::vector<T> keys;
+      std::vector<size_t> offsets(1, 0);
+      pos_list_t positions;
+      positions.reserve(tree.positions.size() + rows.size());
+      size_t k = 0, r = 0;
+      while (k < tree.keys.size() || r < rows.size()) {
+        const bool take_key = r == rows.size() || (k < tree.keys.size() && !(rows[r].first < tree.keys[k]));
+        const T key = take_key ? tree.keys[k] : rows[r].first;
+        if (take_key) {
+          positions.insert(positions.end(), tree.positions.begin() + tree.offsets[k], tree.positions.begin() + tree.offsets[k + 1]);
+          ++k;
+        }
+        for (; r < rows.size() && !(key < rows[r].first); ++r)
+          positions.push_back(rows[r].second);
+        keys.push_back(key);
+        offsets.push_back(positions.size());
+      }
+      tree.keys = std::move(keys);
+      tree.offsets = std::move(offsets);
+      tree.positions = std::move(positions);
+    }
+    buildInnerLevels(tree);
+  }
+
+  static void buildInnerLevels(tree_t& tree) {
+    tree.inner.clear();
+    const std::vector<T> *below = &tree.keys;
+    while (below->size() > node_size) {
+      std::vector<T> level;
+      for (size_t i = 0; i < below->size(); i += node_size)
+        level.push_back((*below)[i]);
+      tree.inner.push_back(std::move(level));
+      below = &tree.inner.back();
+    }
+  }
+
+  /// Index of the first key not less than key, descending from the root
+  static size_t lowerBound(const tree_t& tree, const T& key) {
+    size_t node = 0;
+    for (auto level = tree.inner.rbegin(); level != tree.inner.rend(); ++level) {
+      const auto first = level->begin() + node * node_size;
+      const auto last = level->begin() + std::min(level->size(), (node + 1) * node_size);
+      // Last separator not greater than key, the first node if there is none
+      const auto it = std::upper_bound(first, last, key);
+      node = (it == first ? first : it - 1) - level->begin();
+    }
+    const auto first = tree.keys.begin() + std::min(tree.keys.size(), node * node_size);
+    const auto last = tree.keys.begin() + std::min(tree.keys.size(), (node + 1) * node_size);
+    return std::lower_bound(first, last, key) - tree.keys.begin();
+  }
+
+  field_t _column;
+
+  // Tree of the rows present on construction or the last moveRows()
+  std::shared_ptr<const tree_t> _tree;
+  // Serializes the builders of new trees
+  std::mutex _rebuildMtx;
+
+  // Rows inserted since the tree was built
+  std::map<T, pos_list_t> _delta;
+  mutable std::mutex _deltaMtx;
+};
+
+} } // namespace hyrise::storage
@@ -1,6 +1,9 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include <storage/Store.h>
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <thread>
 
 #include <io/TransactionManager.h>
 #include <storage/storage_types.h>
@@ -11,12 +14,15 @@
 #include <helper/locking.h>
 #include <helper/cas.h>
 
+#include "storage/AbstractIndex.h"
 #include "storage/DictionaryFactory.h"
 #include "storage/ConcurrentUnorderedDictionary.h"
 #include "storage/ConcurrentFixedLengthVector.h"
 
 namespace hyrise { namespace storage {
 
+const size_t Store::mvcc_chunk_size;
+
 TableMerger* createDefaultMerger() {
   return new TableMerger(new DefaultMergeStrategy, new SequentialHeapMerger, false);
 }
@@ -39,10 +45,8 @@ Store::Store(atable_ptr_t main_table) :
     _delta_size(0),
     _main_table(main_table),
     delta(main_table->copy_structure(create_concurrent_dict, create_concurrent_storage)),
-    merger(createDefaultMerger()),
-    _cidBeginVector(main_table->size(), 0),
-    _cidEndVector(main_table->size(), tx::INF_CID),
-    _tidVector(main_table->size(), tx::UNKNOWN) {
+    merger(createDefaultMerger()) {
+  resetMainVisibility(main_table->size());
   setUuid();
 }
 
@@ -50,10 +54,67 @@ Store::~Store() {
   delete merger;
 }
 
+namespace {
+// Counter of the writes in progress the calling thread uses
+size_t writerSlot(size_t slots) {
+  static std::atomic<size_t> next(0);
+  static thread_local size_t slot = next++;
+  return slot % slots;
+}
+}
+
+/// Registers a write in progress, waits while writers are excluded and
+/// fails on a retired store unless rolling back
+class Store::WriteGuard {
+ public:
+  explicit WriteGuard(const Store& store, bool rollback = false) :
+      _count(store._writers[writerSlot(WRITER_SLOTS)].count) {
+    while (true) {
+      // Sequentially consistent, so either the exclusion sees this write
+      // or this write sees the exclusion
+      ++_count;
+      const int state = store._writeState;
+      if (state == WRITABLE || (state == RETIRED && rollback))
+        return;
+      --_count;
+      if (state == RETIRED)
+        throw std::runtime_error("Store was replaced by a compacted copy, retry the transaction");
+      std::this_thread::yield();
+    }
+  }
+
+  ~WriteGuard() {
+    --_count;
+  }
+
+ private:
+  std::atomic<size_t>& _count;
+};
+
+Store::WriteExclusion::WriteExclusion(Store& store) : _store(store), _lock(store._exclusionMtx) {
+  if (_store._writeState == RETIRED)
+    return;
+  _store._writeState = EXCLUDED;
+  for (const auto& slot : _store._writers) {
+    while (slot.count != 0)
+      std::this_thread::yield();
+  }
+}
+
+Store::WriteExclusion::~WriteExclusion() {
+  int excluded = EXCLUDED;
+  _store._writeState.compare_exchange_strong(excluded, WRITABLE);
+}
+
+void Store::WriteExclusion::retire() {
+  _store._writeState = RETIRED;
+}
+
 void Store::merge() {
   if (merger == nullptr) {
     throw std::runtime_error("No Merger set.");
   }
+  WriteExclusion exclusion(*this);
 
   // Create new delta and merge
   atable_ptr_t new_delta = delta->copy_structure(create_concurrent_dict, create_concurrent_storage);
@@ -62,25 +123,56 @@ void Store::merge() {
   std::vector<c_atable_ptr_t> tmp {_main_table, delta};
 
   // get valid positions
-  std::vector<bool> validPositions(_cidBeginVector.size());
+  const size_t rows = size();
+  std::vector<bool> validPositions(rows);
   tx::transaction_cid_t last_commit_id = tx::TransactionManager::getInstance().getLastCommitId();
-  functional::forEachWithIndex(_cidBeginVector, [&](size_t i, bool v){
-    validPositions[i] = isVisibleForTransaction(i, last_commit_id, tx::MERGE_TID);
-  });
+  visibility_bitmap_t bitmap;
+  for (size_t chunk = 0, chunks = mvccChunkCount(); chunk < chunks; ++chunk) {
+    buildVisibilityBitmap(chunk, last_commit_id, tx::MERGE_TID, bitmap);
+    const size_t first = chunk * mvcc_chunk_size;
+    const size_t last = std::min(rows, first + mvcc_chunk_size);
+    for (size_t row = first; row < last; ++row) {
+      const size_t bit = row - first;
+      validPositions[row] = (bitmap[bit / 64] >> (bit % 64)) & 1;
+    }
+  }
 
-  auto tables = merger->merge(tmp, true, validPositions);
+  atable_ptr_t next_main;
+  {
+    std::lock_guard<std::mutex> lock(_nextMainMtx);
+    next_main.swap(_nextMain);
+  }
+  auto tables = next_main ? merger->mergeToTable(next_main, tmp, true, validPositions)
+                          : merger->merge(tmp, true, validPositions);
   assert(tables.size() == 1);
   _main_table = tables.front();
-  // Fixup the cid and tid vectors
-  _cidBeginVector = tbb::concurrent_vector<tx::transaction_cid_t>(_main_table->size(), tx::UNKNOWN_CID);
-  _cidEndVector = tbb::concurrent_vector<tx::transaction_cid_t>(_main_table->size(), tx::INF_CID);
-  _tidVector = tbb::concurrent_vector<tx::transaction_id_t>(_main_table->size(), tx::START_TID);
-  
+  // Fixup the cid and tid vectors, after the merge all rows are visible
+  resetMainVisibility(_main_table->size());
+
   // Replace the delta partition
   delta = new_delta;
   _delta_size = new_delta->size();
+
+  // The merger keeps valid rows in order, so indexes only need to be remapped
+  moveIndexedRows(validPositions);
+}
+
+
+void Store::setNextMain(const atable_ptr_t& main) {
+  if (main->size() != 0 || main->columnCount() != columnCount())
+    throw std::runtime_error("Next main table must be empty and have the columns of the store");
+  for (size_t column = 0; column < columnCount(); ++column) {
+    if (main->nameOfColumn(column) != nameOfColumn(column))
+      throw std::runtime_error("Next main table must keep the order of the columns of the store");
+  }
+  std::lock_guard<std::mutex> lock(_nextMainMtx);
+  _nextMain = main;
 }
 
+bool Store::hasNextMain() const {
+  std::lock_guard<std::mutex> lock(_nextMainMtx);
+  return _nextMain != nullptr;
+}
 
 atable_ptr_t Store::getMainTable() const {
   return _main_table;
@@ -244,27 +336,93 @@ bool Store::isVisibleForTransaction(pos_t pos, tx::transaction_cid_t last_commit
   }
 }
 
+void Store::resetMainVisibility(size_t main_size) {
+  _cidBeginVector = mvcc_vector_t(main_size, tx::UNKNOWN_CID);
+  _cidEndVector = mvcc_vector_t(main_size, tx::INF_CID);
+  _tidVector = mvcc_vector_t(main_size, tx::START_TID);
+
+  _mainChunks = main_size / mvcc_chunk_size;
+  _touchedMainChunks.reset(new std::atomic<bool>[_mainChunks]);
+  for (size_t chunk = 0; chunk < _mainChunks; ++chunk) {
+    _touchedMainChunks[chunk] = false;
+  }
+}
+
+bool Store::isAllVisibleChunk(size_t chunk) const {
+  return chunk < _mainChunks && !_touchedMainChunks[chunk].load(std::memory_order_acquire);
+}
+
+size_t Store::mvccChunkCount() const {
+  return (size() + mvcc_chunk_size - 1) / mvcc_chunk_size;
+}
+
+void Store::buildVisibilityBitmap(size_t chunk, tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid, visibility_bitmap_t& bitmap) const {
+  if (isAllVisibleChunk(chunk)) {
+    // Untouched main rows have cidBegin=0 and cidEnd=INF
+    bitmap.fill(~uint64_t(0));
+    return;
+  }
+
+  const size_t first = chunk * mvcc_chunk_size;
+  const size_t rows = std::min(mvcc_chunk_size, size() - first);
+  const auto* begin = _cidBeginVector.chunk(chunk);
+  const auto* end = _cidEndVector.chunk(chunk);
+  const auto* tids = _tidVector.chunk(chunk);
+
+  // Branch free formulation of isVisibleForTransaction, processing 64 rows
+  // per bitmap word so that the compiler can vectorize the inner loop
+  bitmap.fill(0);
+  for (size_t base = 0; base < rows; base += 64) {
+    const size_t count = std::min<size_t>(64, rows - base);
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const size_t row = base + i;
+      const uint64_t own = tids[row] == tid;
+      const uint64_t own_visible = last_commit_id < begin[row];
+      const uint64_t foreign_visible = (begin[row] <= last_commit_id) & (last_commit_id < end[row]);
+      word |= ((own & own_visible) | ((own ^ 1) & foreign_visible)) << i;
+    }
+    bitmap[base / 64] = word;
+  }
+}
+
 // This method iterates of the pos list and validates each position
 void Store::validatePositions(pos_list_t& pos, tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid) const {
   // Make sure we captured all rows
   assert(_cidBeginVector.size() == size() && _cidEndVector.size() == size() && _tidVector.size() == size());
 
-  // Pos is nullptr, we should circumvent
+  // Positions of untouched main chunks are always visible, everything else
+  // is checked row by row since pos lists are usually sparse
   auto end = std::remove_if(std::begin(pos), std::end(pos), [&](const pos_t& v){
-
-    return !isVisibleForTransaction(v, last_commit_id, tid);
-
+    return !isAllVisibleChunk(v / mvcc_chunk_size) && !isVisibleForTransaction(v, last_commit_id, tid);
   } );
   if (end != pos.end())
     pos.erase(end, pos.end());
 }
 
 pos_list_t Store::buildValidPositions(tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid) const {
+  const size_t rows = size();
   pos_list_t result;
-  functional::forEachWithIndex(_cidBeginVector, [&](size_t i, tx::transaction_cid_t v){
-    if(isVisibleForTransaction(i, last_commit_id, tid)) result.push_back(i);
-  });
-  return std::move(result);
+  result.reserve(rows);
+
+  visibility_bitmap_t bitmap;
+  for (size_t chunk = 0, chunks = mvccChunkCount(); chunk < chunks; ++chunk) {
+    const size_t first = chunk * mvcc_chunk_size;
+    if (isAllVisibleChunk(chunk)) {
+      result.resize(result.size() + mvcc_chunk_size);
+      std::iota(result.end() - mvcc_chunk_size, result.end(), first);
+      continue;
+    }
+    buildVisibilityBitmap(chunk, last_commit_id, tid, bitmap);
+    for (size_t w = 0; w < bitmap.size(); ++w) {
+      uint64_t word = bitmap[w];
+      while (word) {
+        result.push_back(first + w * 64 + __builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+  }
+  return result;
 }
 
 std::pair<size_t, size_t> Store::resizeDelta(size_t num) {
@@ -273,18 +431,20 @@ std::pair<size_t, size_t> Store::resizeDelta(size_t num) {
 }
 
 std::pair<size_t, size_t> Store::appendToDelta(size_t num) {
+  WriteGuard guard(*this);
   std::size_t start =_delta_size.fetch_add(num);
   delta->resize(start + num);
 
   auto main_tables_size = _main_table->size();
-  _cidBeginVector.resize(main_tables_size + start + num, tx::INF_CID);
-  _cidEndVector.resize(main_tables_size + start + num, tx::INF_CID);
-  _tidVector.resize(main_tables_size + start + num, tx::START_TID);
+  _cidBeginVector.grow_to_at_least(main_tables_size + start + num, tx::INF_CID);
+  _cidEndVector.grow_to_at_least(main_tables_size + start + num, tx::INF_CID);
+  _tidVector.grow_to_at_least(main_tables_size + start + num, tx::START_TID);
 
   return {start, start + num};
 }
 
 void Store::copyRowToDelta(const c_atable_ptr_t& source, const size_t src_row, const size_t dst_row, tx::transaction_id_t tid) {
+  WriteGuard guard(*this);
   auto main_tables_size = _main_table->size();
 
   // Update the validity
@@ -294,46 +454,257 @@ void Store::copyRowToDelta(const c_atable_ptr_t& source, const size_t src_row, c
 }
 
 tx::TX_CODE Store::commitPositions(const pos_list_t& pos, const tx::transaction_cid_t cid, bool valid) {
+  WriteGuard guard(*this);
   for(const auto& p : pos) {
     if(valid) {
       _cidBeginVector[p] = cid;
     } else {
       _cidEndVector[p] = cid;
     }
-    _tidVector[p] = tx::START_TID;
+    // Writers waiting for the row acquire the tid in markForDeletion, so
+    // they see the end cid once the row is unlocked
+    atomic_store_release(&_tidVector[p], tx::START_TID);
   }
   return tx::TX_CODE::TX_OK;
 }
 
 tx::TX_CODE Store::checkForConcurrentCommit(const pos_list_t& pos, const tx::transaction_id_t tid) const {
   for(const auto& p : pos) {
-    if (_tidVector[p] != tid)
+    if (_tidVector[p] != tid) {
+      ++_writeConflicts;
       return tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT;
+    }
   }
   return tx::TX_CODE::TX_OK;
 }
 
 tx::TX_CODE Store::markForDeletion(const pos_t pos, const tx::transaction_id_t tid) {
-  if(atomic_cas(&_tidVector[pos], tx::START_TID, tid)) {
-    return tx::TX_CODE::TX_OK;
-  }
+  bool waited = false;
+  std::chrono::steady_clock::time_point deadline;
+  while (true) {
+    // A guard per attempt, so an exclusion does not wait for the holder
+    WriteGuard guard(*this);
+
+    // The chunk leaves the all-visible fast path before its first row is locked
+    const size_t chunk = pos / mvcc_chunk_size;
+    if (chunk < _mainChunks && !waited) {
+      _touchedMainChunks[chunk].store(true, std::memory_order_release);
+    }
+
+    if(atomic_cas(&_tidVector[pos], tx::START_TID, tid)) {
+      // The first committer wins, a row deleted or updated by a committed
+      // transaction must not be deleted again
+      if (_cidEndVector[pos] != tx::INF_CID) {
+        atomic_store_release(&_tidVector[pos], tx::START_TID);
+        ++_writeConflicts;
+        return tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT;
+      }
+      if (waited)
+        ++_lockRetries;
+      return tx::TX_CODE::TX_OK;
+    }
+
+    const auto holder = atomic_load_acquire(&_tidVector[pos]);
+    if(holder == tx::START_TID) {
+      // Released in the meantime
+      continue;
+    }
+    if(holder == tid) {
+      // It is a row that we inserted ourselves. We remove the TID, leaving it with TID=0,begin=0,end=0 which is invisible to everyone
+      // No need for a CAS here since we already have it "locked"
+      _tidVector[pos] = 0;
+      return tx::TX_CODE::TX_OK;
+    }
+
+    if(holder == tx::UNKNOWN) {
+      // Rows of aborted transactions are never visible again
+      ++_writeConflicts;
+      return tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT;
+    }
 
-  if(_tidVector[pos] == tid) {
-    // It is a row that we inserted ourselves. We remove the TID, leaving it with TID=0,begin=0,end=0 which is invisible to everyone
-    // No need for a CAS here since we already have it "locked"
-    _tidVector[pos] = 0;
-    return tx::TX_CODE::TX_OK;
+    // The row is locked by a running transaction, wait for its commit or
+    // rollback instead of aborting right away
+    if (!waited) {
+      const auto timeout = tx::TransactionManager::getInstance().getLockWaitTimeout();
+      if (timeout.count() <= 0) {
+        ++_writeConflicts;
+        return tx::TX_CODE::TX_FAIL_LOCK_TIMEOUT;
+      }
+      waited = true;
+      ++_lockWaits;
+      deadline = std::chrono::steady_clock::now() + timeout;
+    } else if (std::chrono::steady_clock::now() >= deadline) {
+      ++_writeConflicts;
+      return tx::TX_CODE::TX_FAIL_LOCK_TIMEOUT;
+    }
+    std::this_thread::yield();
   }
+}
 
-  return tx::TX_CODE::TX_FAIL_CONCURRENT_COMMIT;
+Store::conflict_stats_t Store::getConflictStats() const {
+  return {_lockWaits.load(), _lockRetries.load(), _writeConflicts.load()};
 }
 
 tx::TX_CODE Store::unmarkForDeletion(const pos_list_t& pos, const tx::transaction_id_t tid) {
+  WriteGuard guard(*this, true);
   for(const auto& p : pos) {
     if (_tidVector[p] == tid)
-      _tidVector[p] = tx::START_TID;
+      atomic_store_release(&_tidVector[p], tx::START_TID);
   }
   return tx::TX_CODE::TX_OK;
 }
 
+tx::TX_CODE Store::abortInsertions(const pos_list_t& pos, const tx::transaction_id_t tid) {
+  WriteGuard guard(*this, true);
+  for(const auto& p : pos) {
+    // TID=0 and begin=INF is invisible to everyone
+    if (_tidVector[p] == tid)
+      atomic_store_release(&_tidVector[p], tx::UNKNOWN);
+  }
+  return tx::TX_CODE::TX_OK;
+}
+
+size_t Store::deadDeltaRows(tx::transaction_cid_t oldest_snapshot) const {
+  size_t dead = 0;
+  for (size_t pos = _main_table->size(), end = size(); pos < end; ++pos) {
+    if (_tidVector[pos] == tx::UNKNOWN ||
+        (_tidVector[pos] == tx::START_TID && _cidEndVector[pos] <= oldest_snapshot)) {
+      ++dead;
+    }
+  }
+  return dead;
+}
+
+std::shared_ptr<Store> Store::compactDelta(tx::transaction_cid_t oldest_snapshot) const {
+  const size_t main_size = _main_table->size();
+  const size_t delta_size = delta->size();
+
+  // Main rows locked by a transaction would be committed to this store
+  for (size_t pos = 0; pos < main_size; ++pos) {
+    if (isAllVisibleChunk(pos / mvcc_chunk_size)) {
+      pos += mvcc_chunk_size - 1;
+      continue;
+    }
+    if (_tidVector[pos] != tx::START_TID && _tidVector[pos] != tx::UNKNOWN)
+      return nullptr;
+  }
+
+  std::vector<size_t> live;
+  for (size_t row = 0; row < delta_size; ++row) {
+    const size_t pos = main_size + row;
+    if (_tidVector[pos] == tx::UNKNOWN)
+      continue;
+    // Rows locked by a transaction or appended but not committed yet
+    if (_tidVector[pos] != tx::START_TID || _cidBeginVector[pos] == tx::INF_CID)
+      return nullptr;
+    if (_cidEndVector[pos] <= oldest_snapshot)
+      continue;
+    live.push_back(row);
+  }
+
+  if (live.size() == delta_size)
+    return nullptr;
+
+  auto store = std::make_shared<Store>(_main_table);
+  // Serial columns are keyed by the id of the store
+  store->setUuid(getUuid());
+  auto* copied = merger ? merger->copy() : nullptr;
+  delete store->merger;
+  store->merger = copied;
+  {
+    std::lock_guard<std::mutex> lock(_nextMainMtx);
+    store->_nextMain = _nextMain;
+  }
+  for (size_t chunk = 0; chunk < _mainChunks; ++chunk)
+    store->_touchedMainChunks[chunk] = _touchedMainChunks[chunk].load();
+  for (size_t pos = 0; pos < main_size; ++pos) {
+    store->_cidBeginVector[pos] = _cidBeginVector[pos];
+    store->_cidEndVector[pos] = _cidEndVector[pos];
+    store->_tidVector[pos] = _tidVector[pos];
+  }
+
+  store->delta = delta->copy_structure(create_concurrent_dict, create_concurrent_storage);
+  store->appendToDelta(live.size());
+  for (size_t row = 0; row < live.size(); ++row) {
+    store->delta->copyRowFrom(delta, live[row], row, true);
+    const size_t from = main_size + live[row];
+    const size_t to = main_size + row;
+    store->_cidBeginVector[to] = _cidBeginVector[from];
+    store->_cidEndVector[to] = _cidEndVector[from];
+    store->_tidVector[to] = _tidVector[from];
+  }
+
+  // Attached indexes move to the compacted store, as after a merge
+  if (auto indexes = std::atomic_load(&_indexes)) {
+    std::vector<bool> kept(main_size + delta_size, false);
+    std::fill(kept.begin(), kept.begin() + main_size, true);
+    for (const auto row : live)
+      kept[main_size + row] = true;
+    for (const auto& index : *indexes)
+      store->addIndex(index);
+    store->moveIndexedRows(kept);
+  }
+  return store;
+}
+
+void Store::addIndex(const std::shared_ptr<AbstractIndex>& index) {
+  std::lock_guard<std::mutex> lock(_indexMtx);
+  auto indexes = std::make_shared<index_list_t>();
+  if (auto current = std::atomic_load(&_indexes))
+    *indexes = *current;
+  if (std::find(indexes->begin(), indexes->end(), index) == indexes->end())
+    indexes->push_back(index);
+  std::atomic_store(&_indexes, std::shared_ptr<const index_list_t>(indexes));
+}
+
+bool Store::addIndex(const std::shared_ptr<AbstractIndex>& index, const c_atable_ptr_t& main) {
+  WriteExclusion exclusion(*this);
+  if (main != _main_table)
+    return false;
+
+  // Appended rows are locked by their writer before they are filled
+  std::vector<pos_t> deferred;
+  const size_t end = size();
+  size_t first = _main_table->size();
+  for (size_t pos = first; pos <= end; ++pos) {
+    if (pos < end && (_tidVector[pos] != tx::START_TID || _cidBeginVector[pos] != tx::INF_CID))
+      continue;
+    if (pos > first)
+      index->insertRows(*this, first, pos - first);
+    if (pos < end)
+      deferred.push_back(pos);
+    first = pos + 1;
+  }
+  // Writers that filled their rows call addToIndexes() after attaching
+  index->setIndexedRows(end, deferred);
+  addIndex(index);
+  return true;
+}
+
+void Store::removeIndex(const std::shared_ptr<AbstractIndex>& index) {
+  std::lock_guard<std::mutex> lock(_indexMtx);
+  auto current = std::atomic_load(&_indexes);
+  if (!current)
+    return;
+  auto indexes = std::make_shared<index_list_t>(*current);
+  indexes->erase(std::remove(indexes->begin(), indexes->end(), index), indexes->end());
+  std::atomic_store(&_indexes, std::shared_ptr<const index_list_t>(indexes));
+}
+
+void Store::addToIndexes(pos_t first, size_t num) const {
+  if (auto indexes = std::atomic_load(&_indexes)) {
+    for (const auto& index : *indexes)
+      index->addRows(*this, first, num);
+  }
+}
+
+void Store::moveIndexedRows(const std::vector<bool>& kept) const {
+  if (auto indexes = std::atomic_load(&_indexes)) {
+    for (const auto& index : *indexes) {
+      index->moveRows(*this, kept);
+      index->setIndexedRows(0, {});
+    }
+  }
+}
+
 }}
@@ -15,13 +15,22 @@
 #include <storage/SequentialHeapMerger.h>
 #include <storage/PrettyPrinter.h>
 
+#include <storage/ChunkedVector.h>
+
+#include <helper/noncopyable.h>
 #include <helper/types.h>
 
-#include "tbb/concurrent_vector.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace hyrise {
 namespace storage {
 
+class AbstractIndex;
+
 /**
  * Store consists of one or more main tables and a delta store and is the
  * only entity capable of modifying the content of the table(s) after
@@ -30,10 +39,36 @@ namespace storage {
  */
 class Store : public AbstractTable {
 public:
+  /// MVCC metadata is kept in contiguous chunks of rows that grow with the delta
+  typedef ChunkedVector<tx::transaction_id_t> mvcc_vector_t;
+  static const size_t mvcc_chunk_size = mvcc_vector_t::chunk_size;
+  /// Validity bitmap for one MVCC chunk, bit i of word w refers to the
+  /// row chunk * mvcc_chunk_size + w * 64 + i
+  typedef std::array<uint64_t, mvcc_chunk_size / 64> visibility_bitmap_t;
+
   Store();
   explicit Store(atable_ptr_t main_table);
   virtual ~Store();
 
+  /// Excludes writers of the store while it exists. Writers that try to
+  /// modify the store wait, and the exclusion waits for writes in
+  /// progress, so the MVCC vectors and the delta are stable. Readers are
+  /// not excluded. merge() and the garbage collector run under it, only
+  /// one exclusion exists at a time.
+  class WriteExclusion : noncopyable {
+   public:
+    explicit WriteExclusion(Store& store);
+    ~WriteExclusion();
+
+    /// Lets all later writes to the store fail, for a store that was
+    /// replaced by a copy. Rolling back is still possible.
+    void retire();
+
+   private:
+    Store& _store;
+    std::lock_guard<std::mutex> _lock;
+  };
+
   atable_ptr_t getMainTable() const;
   void setDelta(atable_ptr_t _delta);
   atable_ptr_t getDeltaTable() const;
@@ -44,6 +79,14 @@ public:
   /// @param _merger Pointer to a merger instance.
   void setMerger(TableMerger *_merger);
 
+  /// Lets the next merge() write main and delta into main instead of a
+  /// table with the layout of the current main, which changes the
+  /// vertical partitioning of the store. main must be empty and have the
+  /// columns of the store in the same order. Readers see the new layout
+  /// once the merge replaces the main table.
+  void setNextMain(const atable_ptr_t& main);
+  bool hasNextMain() const;
+
   /// Resize the current delta size atomically to new size and return
   /// a pair of start and end for the resized delta that can be used
   /// as a write area that is safe to use
@@ -56,6 +99,13 @@ public:
   void validatePositions(pos_list_t& pos, tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid ) const;
   pos_list_t buildValidPositions(tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid) const;
 
+  /// Number of MVCC chunks covering main and delta
+  size_t mvccChunkCount() const;
+
+  /// Computes the visibility of all rows of one MVCC chunk at once. Bits of
+  /// rows beyond the end of the store are cleared.
+  void buildVisibilityBitmap(size_t chunk, tx::transaction_cid_t last_commit_id, tx::transaction_id_t tid, visibility_bitmap_t& bitmap) const;
+
   /// Copies a new row to the delta table, sets the validity and the
   /// tx id accordingly. May need to resize delta.
   void copyRowToDelta(const c_atable_ptr_t& source, size_t src_row, size_t dst_row, tx::transaction_id_t tid);
@@ -66,8 +116,62 @@ public:
   inline tx::transaction_id_t tid(size_t row) const { return _tidVector[row]; }
   inline void setTid(size_t row, tx::transaction_id_t tid) { _tidVector[row] = tid; }
   tx::TX_CODE checkForConcurrentCommit(const pos_list_t& pos, tx::transaction_id_t tid) const;
+  /// Locks the row for deletion by the transaction. Follows first
+  /// committer wins: fails with TX_FAIL_CONCURRENT_COMMIT if another
+  /// transaction already committed a delete or update of the row. If the
+  /// row is locked by a running transaction, waits up to the lock wait
+  /// timeout of the TransactionManager for it to finish and fails with
+  /// TX_FAIL_LOCK_TIMEOUT otherwise. Readers are never blocked.
   tx::TX_CODE markForDeletion(pos_t pos,  tx::transaction_id_t tid);
   tx::TX_CODE unmarkForDeletion(const pos_list_t& pos, tx::transaction_id_t tid);
+  /// Makes rows inserted by an aborted transaction invisible to everyone
+  tx::TX_CODE abortInsertions(const pos_list_t& pos, tx::transaction_id_t tid);
+
+  /// Number of delta rows that no transaction with a snapshot at or after
+  /// oldest_snapshot can see anymore
+  size_t deadDeltaRows(tx::transaction_cid_t oldest_snapshot) const;
+
+  /// Builds a copy of the store without its dead delta rows, sharing the
+  /// main table. Main positions stay stable, delta positions are shifted.
+  /// The store itself is not changed, so readers that hold it keep a
+  /// consistent view while the copy replaces it. Must be called under a
+  /// WriteExclusion, which is retired once the copy replaced the store.
+  /// Attached indexes move to the copy and are remapped to its positions,
+  /// as they are by a merge.
+  /// Returns nullptr if no delta row is dead or if any row is still being
+  /// written or locked by a transaction.
+  std::shared_ptr<Store> compactDelta(tx::transaction_cid_t oldest_snapshot) const;
+
+  /// Write-write conflict statistics of this store
+  typedef struct {
+    /// Number of times a writer waited for a row locked by another transaction
+    size_t waits;
+    /// Number of waits that ended with the writer locking the row because
+    /// the holder rolled back
+    size_t retries;
+    /// Number of writes that failed due to a write-write conflict or a lock
+    /// wait timeout
+    size_t conflicts;
+  } conflict_stats_t;
+
+  conflict_stats_t getConflictStats() const;
+
+  /// Attaches an index on this store. Attached indexes are notified of
+  /// rows written to the delta via addToIndexes() and are remapped on
+  /// merge(). The index must cover all rows of the
+  /// store when it is attached.
+  void addIndex(const std::shared_ptr<AbstractIndex>& index);
+  /// Attaches an index built from main, the main table of this store, and
+  /// adds the delta rows written so far while writers are excluded. Rows
+  /// whose values are not written yet are added once their writer calls
+  /// addToIndexes(). Returns false without attaching the index if a merge
+  /// replaced the main table meanwhile.
+  bool addIndex(const std::shared_ptr<AbstractIndex>& index, const c_atable_ptr_t& main);
+  void removeIndex(const std::shared_ptr<AbstractIndex>& index);
+
+  /// Adds the num rows starting at position first to all attached
+  /// indexes. Writers call this once the values of the rows are final.
+  void addToIndexes(pos_t first, size_t num) const;
 
   /// AbstractTable interface
   const ColumnMetadata& metadataAt(const size_t column_index, const size_t row_index = 0, const table_id_t table_id = 0) const override;
@@ -88,6 +192,8 @@ public:
   void debugStructure(size_t level=0) const override;
 
  private:
+  class WriteGuard;
+
   std::atomic<std::size_t> _delta_size;
   //* Vector containing the main tables
   atable_ptr_t _main_table;
@@ -98,16 +204,60 @@ public:
   //* Current merger
   TableMerger *merger;
 
+  //* Empty main table the next merge writes into, if any
+  atable_ptr_t _nextMain;
+  mutable std::mutex _nextMainMtx;
+
   typedef struct { const atable_ptr_t& table; size_t offset_in_table; size_t table_index; } table_offset_idx_t;
   table_offset_idx_t responsibleTable(size_t row) const;
- 
+
+  /// Resets the MVCC vectors to an all-visible main of the given size.
+  /// Its rows are unlocked (START_TID), so transactions can delete them
+  /// right away, also in a store that was never merged.
+  void resetMainVisibility(size_t main_size);
+
+  /// Returns true if the chunk is fully covered by main and none of its
+  /// rows has been touched by a transaction since the last merge
+  bool isAllVisibleChunk(size_t chunk) const;
+
   // TX Management
   // Stores the CID of the transaction that created the row
-  tbb::concurrent_vector<tx::transaction_id_t> _cidBeginVector;
+  mvcc_vector_t _cidBeginVector;
   // Stores the CID of the transaction that deleted the row
-  tbb::concurrent_vector<tx::transaction_id_t> _cidEndVector;
+  mvcc_vector_t _cidEndVector;
   // Stores the TID for each record to identify your own writes
-  tbb::concurrent_vector<tx::transaction_id_t> _tidVector;
+  mvcc_vector_t _tidVector;
+
+  // Number of leading chunks that lie completely within main
+  size_t _mainChunks = 0;
+  // Marks main chunks that contain rows locked or deleted by a transaction
+  std::unique_ptr<std::atomic<bool>[]> _touchedMainChunks;
+
+  /// Notifies all attached indexes that only the kept rows remain
+  void moveIndexedRows(const std::vector<bool>& kept) const;
+
+  // Attached indexes, replaced as a whole so that writers can read the
+  // list without locking
+  typedef std::vector<std::shared_ptr<AbstractIndex>> index_list_t;
+  std::shared_ptr<const index_list_t> _indexes;
+  std::mutex _indexMtx;
+
+  // Writes in progress, striped over padded counters so that writers on
+  // different threads do not share a cache line
+  static const size_t WRITER_SLOTS = 16;
+  typedef struct {
+    std::atomic<size_t> count {0};
+    char padding[64 - sizeof(std::atomic<size_t>)];
+  } writer_slot_t;
+  mutable std::array<writer_slot_t, WRITER_SLOTS> _writers;
+  typedef enum { WRITABLE, EXCLUDED, RETIRED } write_state_t;
+  std::atomic<int> _writeState {WRITABLE};
+  std::mutex _exclusionMtx;
+
+  // Write-write conflict statistics
+  std::atomic<size_t> _lockWaits {0};
+  std::atomic<size_t> _lockRetries {0};
+  mutable std::atomic<size_t> _writeConflicts {0};
   friend class PrettyPrinter;
 };
 
@@ -89,7 +89,7 @@ std::vector<atable_ptr_t > TableMerger::merge(std::vector<c_atable_ptr_t > &inpu
 }
 
 TableMerger *TableMerger::copy() {
-  return new TableMerger(_strategy->copy(), _merger->copy());
+  return new TableMerger(_strategy->copy(), _merger->copy(), _compress);
 }
 
 } } // namespace hyrise::storage
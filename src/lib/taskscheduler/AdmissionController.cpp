@@ -0,0 +1,123 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "taskscheduler/AdmissionController.h"
+
+#include <algorithm>
+
+#include <log4cxx/logger.h>
+
+namespace hyrise {
+namespace taskscheduler {
+
+namespace {
+log4cxx::LoggerPtr _logger(log4cxx::Logger::getLogger("taskscheduler.AdmissionController"));
+
+// Weight of a finished query in the estimate of the next reservation
+const size_t ESTIMATE_WEIGHT = 8;
+}
+
+const size_t AdmissionController::DEFAULT_MAX_WAITING;
+
+AdmissionController& AdmissionController::getInstance() {
+  static AdmissionController instance;
+  return instance;
+}
+
+void AdmissionController::setBudget(size_t bytes) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _budget = bytes;
+}
+
+size_t AdmissionController::getBudget() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _budget;
+}
+
+void AdmissionController::setMaxWaiting(size_t queries) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _maxWaiting = queries;
+}
+
+size_t AdmissionController::getMaxWaiting() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _maxWaiting;
+}
+
+bool AdmissionController::fits(size_t reservation) const {
+  return _budget == 0 || _usage == 0 || (_usage < _budget && reservation <= _budget - _usage);
+}
+
+void AdmissionController::reserve(int session, size_t bytes) {
+  _usage += bytes;
+  _sessionUsage[session] += bytes;
+}
+
+AdmissionController::admission_t AdmissionController::admit(int session, size_t reservation,
+                                                            const std::function<void()>& start) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  // Queries that arrived earlier are started first
+  if ((_budget == 0 || _waiting.empty()) && fits(reservation)) {
+    reserve(session, reservation);
+    return Admitted;
+  }
+  if (_waiting.size() >= _maxWaiting) {
+    LOG4CXX_WARN(_logger, "Rejecting query, " << _usage << " bytes in use with a budget of " << _budget);
+    return Rejected;
+  }
+  _waiting.push_back({session, reservation, start});
+  return Waiting;
+}
+
+void AdmissionController::charge(int session, size_t bytes) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  reserve(session, bytes);
+}
+
+void AdmissionController::release(int session, size_t bytes, size_t used) {
+  std::function<void()> start;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _usage -= std::min(bytes, _usage);
+    auto it = _sessionUsage.find(session);
+    if (it != _sessionUsage.end()) {
+      it->second -= std::min(bytes, it->second);
+      if (it->second == 0)
+        _sessionUsage.erase(it);
+    }
+    _estimate = (_estimate * (ESTIMATE_WEIGHT - 1) + used) / ESTIMATE_WEIGHT;
+
+    // Every finished query starts at most one other, so that waiting
+    // queries do not all start at once as soon as the usage drops
+    if (!_waiting.empty() && fits(_waiting.front().reservation)) {
+      auto& next = _waiting.front();
+      reserve(next.session, next.reservation);
+      start = std::move(next.start);
+      _waiting.pop_front();
+    }
+  }
+  if (start)
+    start();
+}
+
+size_t AdmissionController::getEstimate() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _estimate;
+}
+
+size_t AdmissionController::getUsage() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _usage;
+}
+
+size_t AdmissionController::getSessionUsage(int session) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _sessionUsage.find(session);
+  return it == _sessionUsage.end() ? 0 : it->second;
+}
+
+size_t AdmissionController::getWaiting() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _waiting.size();
+}
+
+}
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+/// Admits queries only while the memory held by the intermediate results
+/// of running queries is below a global budget.
+///
+/// A query reserves the bytes it is expected to hold when it is admitted,
+/// as its results are only charged after the operators producing them ran.
+/// Queries track the bytes they hold beyond their reservation with
+/// charge() and hand all of them back with release() once they responded.
+/// A query arriving while the budget is exhausted or too small for its
+/// reservation waits and is started in arrival order when running queries
+/// release their memory. If max_waiting queries already wait, further
+/// queries are rejected.
+class AdmissionController : noncopyable {
+ public:
+  typedef enum {
+    Admitted,
+    Waiting,
+    Rejected
+  } admission_t;
+
+  static const size_t DEFAULT_MAX_WAITING = 128;
+
+  static AdmissionController& getInstance();
+
+  /// Budget in bytes, 0 disables admission control
+  void setBudget(size_t bytes);
+  size_t getBudget() const;
+
+  void setMaxWaiting(size_t queries);
+  size_t getMaxWaiting() const;
+
+  /// Decides whether a new query of session may run and charges its
+  /// reservation once it is admitted. A query is admitted while the usage
+  /// including its reservation fits the budget, or if no other query holds
+  /// memory. If it has to wait, start is called once the query is admitted,
+  /// possibly on another thread.
+  admission_t admit(int session, size_t reservation, const std::function<void()>& start);
+
+  /// Adds bytes to the memory held by the queries of session
+  void charge(int session, size_t bytes);
+
+  /// Called by every query that finished, bytes is the memory charged for
+  /// it including its reservation and used the most it actually held.
+  /// Starts the next waiting query if the budget allows.
+  void release(int session, size_t bytes, size_t used);
+
+  /// Bytes to reserve for a new query, the moving average of what finished
+  /// queries held
+  size_t getEstimate() const;
+
+  size_t getUsage() const;
+  size_t getSessionUsage(int session) const;
+  size_t getWaiting() const;
+
+ private:
+  AdmissionController() {}
+
+  mutable std::mutex _mutex;
+  size_t _budget = 0;
+  size_t _maxWaiting = DEFAULT_MAX_WAITING;
+  size_t _usage = 0;
+  size_t _estimate = 0;
+  std::unordered_map<int, size_t> _sessionUsage;
+
+  typedef struct {
+    int session;
+    size_t reservation;
+    std::function<void()> start;
+  } waiting_query_t;
+  std::deque<waiting_query_t> _waiting;
+
+  bool fits(size_t reservation) const;
+  void reserve(int session, size_t bytes);
+};
+
+}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "taskscheduler/BlockingRegion.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+namespace {
+thread_local BlockingObserver* observer = nullptr;
+}
+
+BlockingRegion::BlockingRegion() : _observer(observer) {
+  // regions nested in a region do not block the worker again
+  observer = nullptr;
+  if (_observer)
+    _observer->notifyBlocked();
+}
+
+BlockingRegion::~BlockingRegion() {
+  if (_observer) {
+    _observer->notifyUnblocked();
+    observer = _observer;
+  }
+}
+
+void BlockingRegion::setObserver(BlockingObserver* o) {
+  observer = o;
+}
+
+} } // namespace hyrise::taskscheduler
@@ -0,0 +1,40 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+/// Scheduler that is told when one of its worker threads blocks
+class BlockingObserver {
+ public:
+  virtual ~BlockingObserver() {}
+  virtual void notifyBlocked() = 0;
+  virtual void notifyUnblocked() = 0;
+};
+
+/// Marks a section in which the calling thread waits for I/O or sleeps
+/// instead of using its core.
+///
+/// Plan operations wrap blocking calls into a BlockingRegion, so an
+/// elastic scheduler can run another worker on the core meanwhile. On
+/// threads that are no worker of such a scheduler, it does nothing.
+///
+///     {
+///       BlockingRegion blocking;
+///       std::this_thread::sleep_for(wait);
+///     }
+class BlockingRegion : noncopyable {
+ public:
+  BlockingRegion();
+  ~BlockingRegion();
+
+  /// Sets the scheduler of the calling worker thread, nullptr for none
+  static void setObserver(BlockingObserver* observer);
+
+ private:
+  BlockingObserver* _observer;
+};
+
+} } // namespace hyrise::taskscheduler
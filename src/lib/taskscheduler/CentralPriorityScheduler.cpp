@@ -7,6 +7,7 @@
 
 #include "CentralPriorityScheduler.h"
 #include "SharedScheduler.h"
+#include "SchedulerTracer.h"
 
 namespace hyrise {
 namespace taskscheduler {
@@ -25,13 +26,13 @@ CentralPriorityScheduler::CentralPriorityScheduler(int threads) {
   if(threads > getNumberOfCoresOnSystem()){
     fprintf(stderr, "Tried to use more threads then cores - no binding of threads takes place\n");
     for(int i = 0; i < threads; i++){
-      _worker_threads.emplace_back(PriorityWorkerThread(*this));
+      _worker_threads.emplace_back(PriorityWorkerThread(*this, i));
     }
   } else {
     // bind threads to cores
     for(int i = 0; i < threads; i++){
       //_worker_threads.push_back(new std::thread(WorkerThread(*this)));
-      std::thread thread(PriorityWorkerThread(*this));
+      std::thread thread(PriorityWorkerThread(*this, i));
       hwloc_cpuset_t cpuset;
       hwloc_obj_t obj;
       hwloc_topology_t topology = getHWTopology();
@@ -95,7 +96,7 @@ void PriorityWorkerThread::operator()(){
       ul.unlock();
       
       if (task) {
-        (*task)();
+        SchedulerTracer::getInstance().execute(*task, core);
         LOG4CXX_DEBUG(scheduler._logger, "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec);
         // notify done observers that task is done
         task->notifyDoneObservers();
@@ -126,6 +127,7 @@ void CentralPriorityScheduler::schedule(std::shared_ptr<Task> task){
   task->lockForNotifications();
   if (task->isReady()){
     std::lock_guard<lock_t> lk(_queueMutex);
+    SchedulerTracer::getInstance().enqueued(*task);
     _runQueue.push(task);
     _condition.notify_one();
   }
@@ -176,6 +178,7 @@ void CentralPriorityScheduler::notifyReady(std::shared_ptr<Task> task) {
   if (tmp == 1) {
     LOG4CXX_DEBUG(_logger, "Task " << std::hex << (void *)task.get() << std::dec << " ready to run");
     std::lock_guard<lock_t> lk(_queueMutex);
+    SchedulerTracer::getInstance().enqueued(*task);
     _runQueue.push(task);
     _condition.notify_one();
   } else
@@ -24,11 +24,13 @@ class CentralPriorityScheduler;
 class PriorityWorkerThread {
 private:
     CentralPriorityScheduler &scheduler;
+    // core the thread is bound to, its index if threads are not bound
+    int core;
 public:
 
   typedef AbstractTaskScheduler::lock_t lock_t;
 
-    PriorityWorkerThread(CentralPriorityScheduler &s) : scheduler(s) { }
+    PriorityWorkerThread(CentralPriorityScheduler &s, int core) : scheduler(s), core(core) { }
     void operator()();
 };
 
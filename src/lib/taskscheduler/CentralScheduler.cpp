@@ -6,6 +6,9 @@
  */
 
 #include "CentralScheduler.h"
+#include "SchedulerTracer.h"
+
+#include <algorithm>
 
 namespace hyrise {
 namespace taskscheduler {
@@ -16,21 +19,32 @@ log4cxx::LoggerPtr CentralScheduler::_logger = log4cxx::Logger::getLogger("tasks
 namespace {
 bool registered  =
     SharedScheduler::registerScheduler<CentralScheduler>("CentralScheduler");
+
+// start of the BlockingRegion the worker is in
+thread_local epoch_t blockedSince = 0;
 }
 
-CentralScheduler::CentralScheduler(int threads) {
+CentralScheduler::CentralScheduler(int threads) :
+    _workers(threads),
+    _maxWorkers(std::max(threads, 1)),
+    _minWorkers(_maxWorkers),
+    _idleTimeout(DEFAULT_IDLE_TIMEOUT_MS),
+    _nextCore(threads),
+    _startTime(get_epoch_nanoseconds()),
+    _busyTime(0),
+    _blockedTime(0) {
     _status = START_UP;
   // create and launch threads
   if(threads > getNumberOfCoresOnSystem()){
     fprintf(stderr, "Tried to use more threads then cores - no binding of threads takes place\n");
     for(int i = 0; i < threads; i++){
-      _worker_threads.emplace_back(WorkerThread(*this));
+      _worker_threads.emplace_back(WorkerThread(*this, i));
     }
   } else {
     // bind threads to cores
     for(int i = 0; i < threads; i++){
       //_worker_threads.push_back(new std::thread(WorkerThread(*this)));
-      std::thread thread(WorkerThread(*this));
+      std::thread thread(WorkerThread(*this, i));
       hwloc_cpuset_t cpuset;
       hwloc_obj_t obj;
       hwloc_topology_t topology = getHWTopology();
@@ -76,13 +90,14 @@ CentralScheduler::~CentralScheduler() {
 }
 
 void WorkerThread::operator()(){
+  BlockingRegion::setObserver(&scheduler);
+  // lock queue to get task
+  std::unique_lock<lock_t> ul(scheduler._queueMutex);
   //infinite thread loop
   while (1) {
     if (scheduler._status == scheduler.TO_STOP){
       break;
     }
-    // lock queue to get task
-    std::unique_lock<lock_t> ul(scheduler._queueMutex);
     // get task and execute
     if (scheduler._runQueue.size() > 0) {
       std::shared_ptr<Task> task = scheduler._runQueue.front();
@@ -90,26 +105,36 @@ void WorkerThread::operator()(){
       scheduler._runQueue.pop();
       ul.unlock();
       if (task) {
-        (*task)();
+        const epoch_t start = get_epoch_nanoseconds();
+        SchedulerTracer::getInstance().execute(*task, core);
         LOG4CXX_DEBUG(scheduler._logger, "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec);
         // notify done observers that task is done
         task->notifyDoneObservers();
+        scheduler._busyTime += get_epoch_nanoseconds() - start;
       }
+      ul.lock();
+      // blocked workers returned, more workers than allowed are running
+      if (scheduler.retire(false))
+        break;
     }
     // no task in runQueue -> sleep and wait for new tasks
     else {
-      //if queue still empty go to sleep and wait until new tasks have been arrived
-      if (scheduler._runQueue.size() < 1) {
-        // if thread is about to stop, break execution loop
-
-        if (scheduler._status != scheduler.RUN)
-          continue;
-
-        
-        scheduler._condition.wait(ul);
+      // if thread is about to stop, break execution loop
+      if (scheduler._status != scheduler.RUN) {
+        ul.unlock();
+        std::this_thread::yield();
+        ul.lock();
+        continue;
       }
+
+      ++scheduler._idle;
+      const bool timeout = scheduler._condition.wait_for(ul, scheduler._idleTimeout) == std::cv_status::timeout;
+      --scheduler._idle;
+      if (scheduler._runQueue.empty() && scheduler.retire(timeout))
+        break;
     }
   }
+  BlockingRegion::setObserver(nullptr);
 }
 
 /*
@@ -121,10 +146,13 @@ void CentralScheduler::schedule(std::shared_ptr<Task> task){
 
   // lock the task - otherwise, a notify might happen prior to the task being added to the wait set
   task->lockForNotifications();
+  bool added = false;
   if (task->isReady()){
     std::lock_guard<lock_t> lk(_queueMutex);
+    SchedulerTracer::getInstance().enqueued(*task);
     _runQueue.push(task);
     _condition.notify_one();
+    added = grow();
   }
   else {
     task->addReadyObserver(shared_from_this());
@@ -133,11 +161,16 @@ void CentralScheduler::schedule(std::shared_ptr<Task> task){
     LOG4CXX_DEBUG(_logger,  "Task " << std::hex << (void *)task.get() << std::dec << " inserted in wait queue");
   }
   task->unlockForNotifications();
+  spawn(added);
 }
 /*
  * shutdown task scheduler; makes sure all underlying threads are stopped
  */
 void CentralScheduler::shutdown(){
+  {
+    std::lock_guard<std::mutex> lk(_threadsMutex);
+    _stopping = true;
+  }
   {
     std::lock_guard<lock_t> lk(_queueMutex);
     {
@@ -146,17 +179,26 @@ void CentralScheduler::shutdown(){
     //wake up thread in case thread is sleeping
     _condition.notify_all();
   }
-  for(size_t i = 0; i < _worker_threads.size(); i++){
-    _worker_threads[i].join();
+  // workers may still schedule tasks while they finish, so they are
+  // joined without holding the mutex
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lk(_threadsMutex);
+    threads.swap(_worker_threads);
+  }
+  for(size_t i = 0; i < threads.size(); i++){
+    threads[i].join();
   }
-  _worker_threads.clear();
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _retired.clear();
+  _workers = 0;
 }
 
 /**
  * get number of worker
  */
 size_t CentralScheduler::getNumberOfWorker() const{
-  return _worker_threads.size();
+  return _workers.load();
 }
 
 /*
@@ -171,13 +213,135 @@ void CentralScheduler::notifyReady(std::shared_ptr<Task> task) {
   // if task was found in wait set, schedule task to next queue
   if (tmp == 1) {
     LOG4CXX_DEBUG(_logger, "Task " << std::hex << (void *)task.get() << std::dec << " ready to run");
-    std::lock_guard<lock_t> lk(_queueMutex);
-    _runQueue.push(task);
-    _condition.notify_one();
+    bool added;
+    {
+      std::lock_guard<lock_t> lk(_queueMutex);
+      SchedulerTracer::getInstance().enqueued(*task);
+      _runQueue.push(task);
+      _condition.notify_one();
+      added = grow();
+    }
+    spawn(added);
   } else
     // should never happen, but check to identify potential race conditions
     LOG4CXX_ERROR(_logger, "Task that notified to be ready to run was not found / found more than once in waitSet! " << std::to_string(tmp));
 }
 
+void CentralScheduler::notifyBlocked() {
+  blockedSince = get_epoch_nanoseconds();
+  bool added;
+  {
+    std::lock_guard<lock_t> lk(_queueMutex);
+    ++_blocked;
+    added = grow();
+  }
+  spawn(added);
+}
+
+void CentralScheduler::notifyUnblocked() {
+  _blockedTime += get_epoch_nanoseconds() - blockedSince;
+  std::lock_guard<lock_t> lk(_queueMutex);
+  --_blocked;
+}
+
+bool CentralScheduler::grow() {
+  // idle workers take the queued tasks, and the pool does not grow while
+  // maxWorkers workers run or it reached its thread limit
+  if (_status != RUN || _idle >= _runQueue.size() || _workers - _blocked >= _maxWorkers ||
+      _workers >= _maxWorkers * MAX_THREADS_PER_WORKER)
+    return false;
+
+  // counted right away, so concurrent callers do not add a worker twice
+  ++_workers;
+  ++_spawned;
+  LOG4CXX_DEBUG(_logger, "Adding worker, " << _workers << " workers, " << _blocked << " blocked");
+  return true;
+}
+
+bool CentralScheduler::retire(bool idle) {
+  const size_t running = _workers - _blocked;
+  if (_status != RUN || !(running > _maxWorkers || (idle && running > _minWorkers)))
+    return false;
+
+  --_workers;
+  ++_retiredCount;
+  // the thread is joined once it released the queue mutex
+  _retired.push_back(std::this_thread::get_id());
+  LOG4CXX_DEBUG(_logger, "Retired worker, " << _workers << " workers, " << _blocked << " blocked");
+  return true;
+}
+
+void CentralScheduler::spawn(size_t count) {
+  if (count == 0)
+    return;
+
+  std::vector<std::thread::id> retired;
+  {
+    std::lock_guard<lock_t> lk(_queueMutex);
+    retired.swap(_retired);
+  }
+
+  std::lock_guard<std::mutex> lk(_threadsMutex);
+  for (const auto& id : retired) {
+    auto thread = std::find_if(_worker_threads.begin(), _worker_threads.end(), [&id] (const std::thread& t) {
+      return t.get_id() == id;
+    });
+    // a worker may retire before its thread was added, it is joined on
+    // shutdown then
+    if (thread != _worker_threads.end()) {
+      thread->join();
+      _worker_threads.erase(thread);
+    }
+  }
+  // the pool was counted with the workers, shutdown() resets it
+  if (_stopping)
+    return;
+  for (size_t i = 0; i < count; ++i)
+    _worker_threads.emplace_back(WorkerThread(*this, _nextCore++));
+}
+
+void CentralScheduler::setMaxWorkers(size_t maxWorkers) {
+  size_t added = 0;
+  {
+    std::lock_guard<lock_t> lk(_queueMutex);
+    _maxWorkers = std::max(maxWorkers, size_t(1));
+    _minWorkers = std::min(_minWorkers, _maxWorkers);
+    while (grow())
+      ++added;
+    // idle workers above the maximum retire
+    _condition.notify_all();
+  }
+  spawn(added);
+}
+
+void CentralScheduler::setMinWorkers(size_t minWorkers) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _minWorkers = std::min(minWorkers, _maxWorkers);
+}
+
+void CentralScheduler::setIdleTimeout(std::chrono::milliseconds idleTimeout) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _idleTimeout = idleTimeout;
+  // idle workers wait for the new timeout
+  _condition.notify_all();
+}
+
+worker_pool_statistics_t CentralScheduler::getPoolStatistics() {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  worker_pool_statistics_t statistics;
+  statistics.workers = _workers;
+  statistics.blocked = _blocked;
+  statistics.idle = _idle;
+  statistics.maxWorkers = _maxWorkers;
+  statistics.spawned = _spawned;
+  statistics.retired = _retiredCount;
+  statistics.busyTime = _busyTime;
+  statistics.blockedTime = _blockedTime;
+  const double capacity = double(get_epoch_nanoseconds() - _startTime) * _maxWorkers;
+  const epoch_t running = statistics.busyTime > statistics.blockedTime ? statistics.busyTime - statistics.blockedTime : 0;
+  statistics.utilization = capacity > 0 ? running / capacity : 0;
+  return statistics;
+}
+
 } } // namespace hyrise::taskscheduler
 
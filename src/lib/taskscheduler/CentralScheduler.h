@@ -8,8 +8,13 @@
 #pragma once
 
 #include "AbstractTaskScheduler.h"
+#include "BlockingRegion.h"
 #include "helper/HwlocHelper.h"
+#include "helper/epoch.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <queue>
 #include <condition_variable>
@@ -24,21 +29,48 @@ class CentralScheduler;
 class WorkerThread {
 private:
     CentralScheduler &scheduler;
+    // core the thread is bound to, its index if threads are not bound
+    int core;
 public:
 
     typedef AbstractTaskScheduler::lock_t lock_t;
 
-    WorkerThread(CentralScheduler &s) : scheduler(s) { }
+    WorkerThread(CentralScheduler &s, int core) : scheduler(s), core(core) { }
     void operator()();
 };
 
 
+/// State of the worker pool of a CentralScheduler
+typedef struct worker_pool_statistics_t {
+  // threads, including blocked ones
+  size_t workers;
+  size_t blocked;
+  size_t idle;
+  size_t maxWorkers;
+  // threads started and ended by the pool after startup
+  size_t spawned;
+  size_t retired;
+  epoch_t busyTime;
+  epoch_t blockedTime;
+  // share of maxWorkers cores that ran tasks without blocking since startup
+  double utilization;
+} worker_pool_statistics_t;
+
 /**
  * a central scheduler holds a task queue and n worker threads
+ *
+ * The pool is elastic: while workers are blocked in a BlockingRegion and
+ * tasks are queued, threads are added so that up to maxWorkers workers
+ * run tasks, at most MAX_THREADS_PER_WORKER * maxWorkers threads in
+ * total. Added threads are not bound to a core. Workers retire when more
+ * than maxWorkers of them run because blocked workers returned, and when
+ * they were idle for the idle timeout while more than minWorkers exist.
+ * Both bounds default to the number of threads the scheduler started with.
  */
 class CentralScheduler : 
   public AbstractTaskScheduler,
   public TaskReadyObserver,
+  public BlockingObserver,
   public std::enable_shared_from_this<TaskReadyObserver> {
   friend class WorkerThread;
 protected:
@@ -60,10 +92,43 @@ protected:
   // mutex to protect status
   lock_t _statusMutex;
 
+  // worker pool, protected by _queueMutex; the number of workers is also
+  // read without it
+  std::atomic<size_t> _workers;
+  size_t _blocked = 0;
+  size_t _idle = 0;
+  size_t _maxWorkers;
+  size_t _minWorkers;
+  std::chrono::milliseconds _idleTimeout;
+  // workers that ended and are not joined yet
+  std::vector<std::thread::id> _retired;
+  // protects _worker_threads, threads are started and joined under it
+  // without holding _queueMutex
+  std::mutex _threadsMutex;
+  // set by shutdown(), no threads are started afterwards
+  bool _stopping = false;
+  int _nextCore;
+  size_t _spawned = 0;
+  size_t _retiredCount = 0;
+  epoch_t _startTime;
+  std::atomic<epoch_t> _busyTime;
+  std::atomic<epoch_t> _blockedTime;
+
+  // counts a worker to be added if queued tasks wait for one, _queueMutex
+  // held; the caller starts it with spawn() after releasing the mutex
+  bool grow();
+  // whether the calling worker leaves the pool, _queueMutex held
+  bool retire(bool idle);
+  // joins retired workers and starts count workers, _queueMutex not held
+  void spawn(size_t count);
+
   static log4cxx::LoggerPtr _logger;
 
 
 public:
+  static const size_t MAX_THREADS_PER_WORKER = 4;
+  static const size_t DEFAULT_IDLE_TIMEOUT_MS = 1000;
+
   CentralScheduler(int threads = getNumberOfCoresOnSystem());
   virtual ~CentralScheduler();
 
@@ -83,6 +148,16 @@ public:
 
   virtual void notifyReady(std::shared_ptr<Task> task);
 
+  virtual void notifyBlocked();
+  virtual void notifyUnblocked();
+
+  /// Workers that run tasks at the same time, lowers minWorkers if needed
+  void setMaxWorkers(size_t maxWorkers);
+  /// Workers kept while idle
+  void setMinWorkers(size_t minWorkers);
+  void setIdleTimeout(std::chrono::milliseconds idleTimeout);
+
+  worker_pool_statistics_t getPoolStatistics();
 };
 
 } } // namespace hyrise::taskscheduler
@@ -7,6 +7,8 @@
 
 #include "CoreBoundPriorityQueue.h"
 
+#include "taskscheduler/SchedulerTracer.h"
+
 #include <iostream>
 #include <errno.h>
 #include <string.h>
@@ -34,7 +36,7 @@ void CoreBoundPriorityQueue::executeTask() {
       _blocked = true;
       //LOG4CXX_DEBUG(logger, "Started executing task" << std::hex << &task << std::dec << " on core " << _core);
       // run task
-      (*task)();
+      SchedulerTracer::getInstance().execute(*task, _core);
       //std::cout << "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
 
       LOG4CXX_DEBUG(logger, "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core);
@@ -69,6 +71,7 @@ CoreBoundPriorityQueue::CoreBoundPriorityQueue(int core): AbstractCoreBoundQueue
 }
 
 void CoreBoundPriorityQueue::push(std::shared_ptr<Task> task) {
+  SchedulerTracer::getInstance().enqueued(*task);
  // std::cout << "TASKQUEUE: task: "  << std::hex << (void * )task.get() << std::dec << " pushed to queue " << _core << std::endl;
   _runQueue.push(task);
   //_condition.notify_one();
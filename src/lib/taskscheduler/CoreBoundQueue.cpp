@@ -7,6 +7,8 @@
 
 #include "CoreBoundQueue.h"
 
+#include "taskscheduler/SchedulerTracer.h"
+
 #include <iostream>
 #include <errno.h>
 #include <string.h>
@@ -41,7 +43,7 @@ void CoreBoundQueue::executeTask() {
         //LOG4CXX_DEBUG(logger, "Started executing task" << std::hex << &task << std::dec << " on core " << _core);
         // run task
         //std::cout << "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
-        (*task)();
+        SchedulerTracer::getInstance().execute(*task, _core);
         LOG4CXX_DEBUG(logger, "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core);
         // notify done observers that task is done
         task->notifyDoneObservers();
@@ -74,6 +76,7 @@ CoreBoundQueue::CoreBoundQueue(int core): AbstractCoreBoundQueue(), _blocked(fal
 }
 
 void CoreBoundQueue::push(std::shared_ptr<Task> task) {
+  SchedulerTracer::getInstance().enqueued(*task);
   //std::cout << "TASKQUEUE: task: "  << std::hex << (void * )task.get() << std::dec << " pushed to queue " << _core << std::endl;
   std::lock_guard<lock_t> lk(_queueMutex);
   _runQueue.push(task);
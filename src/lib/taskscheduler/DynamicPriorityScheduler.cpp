@@ -1,5 +1,6 @@
 // Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
 #include "DynamicPriorityScheduler.h"
+#include "taskscheduler/SchedulerTracer.h"
 #include "taskscheduler/SharedScheduler.h"
 
 namespace hyrise {
@@ -40,6 +41,7 @@ void DynamicPriorityScheduler::notifyReady(std::shared_ptr<Task> task){
       for (const auto& i : tasks) {
         if (i->isReady()) {
           std::lock_guard<decltype(_queueMutex)> lk(_queueMutex);
+          SchedulerTracer::getInstance().enqueued(*i);
           _runQueue.push(i);
           _condition.notify_one();
         } else {   
@@ -51,6 +53,7 @@ void DynamicPriorityScheduler::notifyReady(std::shared_ptr<Task> task){
       }
     } else { // task is not dynamic
       std::lock_guard<decltype(_queueMutex)> lk(_queueMutex);
+      SchedulerTracer::getInstance().enqueued(*task);
       _runQueue.push(task);
       _condition.notify_one();
     }
@@ -0,0 +1,281 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "taskscheduler/FairShareScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "taskscheduler/SchedulerTracer.h"
+#include "taskscheduler/SharedScheduler.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+log4cxx::LoggerPtr FairShareScheduler::_logger = log4cxx::Logger::getLogger("taskscheduler.FairShareScheduler");
+
+// register Scheduler at SharedScheduler
+namespace {
+bool registered  =
+    SharedScheduler::registerScheduler<FairShareScheduler>("FairShareScheduler");
+}
+
+const epoch_t FairShareScheduler::HISTORY_HALF_LIFE;
+
+FairShareScheduler::FairShareScheduler(int threads) {
+  _status = START_UP;
+  // create and launch threads
+  if(threads > getNumberOfCoresOnSystem()){
+    fprintf(stderr, "Tried to use more threads then cores - no binding of threads takes place\n");
+    for(int i = 0; i < threads; i++){
+      _worker_threads.emplace_back(FairShareWorkerThread(*this, i));
+    }
+  } else {
+    // bind threads to cores
+    hwloc_topology_t topology = getHWTopology();
+    for(int i = 0; i < threads; i++){
+      std::thread thread(FairShareWorkerThread(*this, i));
+      hwloc_obj_t obj = hwloc_get_obj_by_type(topology, HWLOC_OBJ_CORE, i);
+      // the bitmap to modify
+      hwloc_cpuset_t cpuset = hwloc_bitmap_dup(obj->cpuset);
+      // remove hyperthreads
+      hwloc_bitmap_singlify(cpuset);
+      if (hwloc_set_thread_cpubind(topology, thread.native_handle(), cpuset, HWLOC_CPUBIND_STRICT | HWLOC_CPUBIND_NOMEMBIND)) {
+        char *str;
+        int error = errno;
+        hwloc_bitmap_asprintf(&str, obj->cpuset);
+        fprintf(stderr, "Couldn't bind to cpuset %s: %s\n", str, strerror(error));
+        fprintf(stderr, "Continuing as normal, however, no guarantees\n");
+        free(str);
+      }
+      hwloc_bitmap_free(cpuset);
+      _worker_threads.push_back(std::move(thread));
+    }
+  }
+  _status = RUN;
+}
+
+FairShareScheduler::~FairShareScheduler() {
+  // wait until all threads have joined
+  if(_worker_threads.size() > 0)
+    shutdown();
+}
+
+void FairShareWorkerThread::operator()(){
+  while (1) {
+    std::unique_lock<AbstractTaskScheduler::lock_t> ul(scheduler._queueMutex);
+    if (scheduler._status == scheduler.TO_STOP)
+      break;
+
+    const auto task = scheduler.next();
+    if (task) {
+      ul.unlock();
+      const epoch_t start = get_epoch_nanoseconds();
+      SchedulerTracer::getInstance().execute(*task, core);
+      const epoch_t time = get_epoch_nanoseconds() - start;
+      LOG4CXX_DEBUG(scheduler._logger, "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec);
+      // successors are queued before the task is accounted, so the time
+      // of its query is kept while the query goes on
+      task->notifyDoneObservers();
+      scheduler.finished(task, time);
+    } else if (scheduler._status == scheduler.RUN) {
+      // no task in the run queues -> sleep and wait for new tasks
+      scheduler._condition.wait(ul);
+    }
+  }
+}
+
+void FairShareScheduler::schedule(std::shared_ptr<Task> task){
+  // lock the task - otherwise, a notify might happen prior to the task being added to the wait set
+  task->lockForNotifications();
+  if (task->isReady()) {
+    enqueue(task);
+  } else {
+    task->addReadyObserver(shared_from_this());
+    std::lock_guard<lock_t> lk(_setMutex);
+    _waitSet.insert(task);
+    LOG4CXX_DEBUG(_logger,  "Task " << std::hex << (void *)task.get() << std::dec << " inserted in wait queue");
+  }
+  task->unlockForNotifications();
+}
+
+void FairShareScheduler::notifyReady(std::shared_ptr<Task> task) {
+  // remove task from wait set
+  _setMutex.lock();
+  int tmp = _waitSet.erase(task);
+  _setMutex.unlock();
+
+  // if task was found in wait set, schedule task to next queue
+  if (tmp == 1) {
+    LOG4CXX_DEBUG(_logger, "Task " << std::hex << (void *)task.get() << std::dec << " ready to run");
+    enqueue(task);
+  } else {
+    // should never happen, but check to identify potential race conditions
+    LOG4CXX_ERROR(_logger, "Task that notified to be ready to run was not found / found more than once in waitSet! " << std::to_string(tmp));
+  }
+}
+
+void FairShareScheduler::enqueue(const std::shared_ptr<Task>& task) {
+  if (!task->isDynamic()) {
+    push(task);
+    return;
+  }
+
+  for (const auto& i : task->applyDynamicParallelization(task->determineDynamicCount(_maxTaskSize))) {
+    if (i->isReady()) {
+      push(i);
+    } else {
+      i->addReadyObserver(shared_from_this());
+      std::lock_guard<lock_t> lk(_setMutex);
+      _waitSet.insert(i);
+    }
+  }
+}
+
+void FairShareScheduler::push(const std::shared_ptr<Task>& task) {
+  SchedulerTracer::getInstance().enqueued(*task);
+  std::lock_guard<lock_t> lk(_queueMutex);
+
+  auto found = _sessions.find(task->getSessionId());
+  if (found == _sessions.end()) {
+    found = _sessions.emplace(task->getSessionId(), session_state_t()).first;
+    found->second.virtualTime = _virtualTime;
+  } else if (found->second.queries.empty()) {
+    // an idle session keeps what is left of its lead
+    const double lead = std::max(0.0, found->second.virtualTime - _virtualTime);
+    found->second.virtualTime = _virtualTime + lead * decay(get_epoch_nanoseconds() - found->second.idleSince);
+  } else if (found->second.queued == 0) {
+    // a session does not save up time while it has nothing queued
+    found->second.virtualTime = std::max(found->second.virtualTime, _virtualTime);
+  }
+  auto& session = found->second;
+  auto& query = session.queries[task->getId()];
+  query.tasks.push_back(task);
+  ++query.queued;
+  ++query.outstanding;
+  ++session.queued;
+
+  _queued.insert(task.get());
+  if (task->getDeadline() > 0)
+    _deadlines.emplace(task->getDeadline(), task);
+  _condition.notify_one();
+}
+
+std::shared_ptr<Task> FairShareScheduler::next() {
+  std::shared_ptr<Task> task;
+
+  // tasks taken by their query are removed from the deadlines lazily
+  while (!_deadlines.empty() && !_queued.count(_deadlines.begin()->second.get()))
+    _deadlines.erase(_deadlines.begin());
+  if (!_deadlines.empty() && _deadlines.begin()->first <= get_epoch_nanoseconds() + _urgency) {
+    task = _deadlines.begin()->second;
+    _deadlines.erase(_deadlines.begin());
+  } else {
+    session_state_t *session = nullptr;
+    for (auto& s : _sessions) {
+      if (s.second.queued > 0 && (!session || s.second.virtualTime < session->virtualTime))
+        session = &s.second;
+    }
+    if (!session)
+      return nullptr;
+
+    query_state_t *query = nullptr;
+    for (auto& q : session->queries) {
+      if (q.second.queued > 0 && (!query || q.second.time < query->time))
+        query = &q.second;
+    }
+
+    // and tasks taken by their deadline from their query
+    while (!_queued.count(query->tasks.front().get()))
+      query->tasks.pop_front();
+    task = query->tasks.front();
+    query->tasks.pop_front();
+    _virtualTime = session->virtualTime;
+  }
+
+  _queued.erase(task.get());
+  auto& session = _sessions[task->getSessionId()];
+  --session.queued;
+  --session.queries[task->getId()].queued;
+  return task;
+}
+
+void FairShareScheduler::finished(const std::shared_ptr<Task>& task, epoch_t time) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _sessionTimes[task->getSessionId()] += time;
+
+  auto session = _sessions.find(task->getSessionId());
+  if (session == _sessions.end())
+    return;
+  const auto weight = _weights.find(task->getSessionId());
+  session->second.virtualTime += time / (weight == _weights.end() ? 1.0 : weight->second);
+
+  auto& queries = session->second.queries;
+  auto query = queries.find(task->getId());
+  if (query != queries.end()) {
+    query->second.time += time;
+    if (--query->second.outstanding == 0)
+      queries.erase(query);
+  }
+  if (!queries.empty())
+    return;
+
+  // idle sessions are kept until their lead decayed
+  const epoch_t now = get_epoch_nanoseconds();
+  session->second.idleSince = now;
+  for (auto s = _sessions.begin(); s != _sessions.end();) {
+    if (s->second.queries.empty() && (s->second.virtualTime - _virtualTime) * decay(now - s->second.idleSince) < 1)
+      s = _sessions.erase(s);
+    else
+      ++s;
+  }
+}
+
+double FairShareScheduler::decay(epoch_t idle) {
+  return std::exp2(-static_cast<double>(idle) / HISTORY_HALF_LIFE);
+}
+
+void FairShareScheduler::setUrgency(epoch_t urgency) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _urgency = urgency;
+}
+
+void FairShareScheduler::setSessionWeight(int sessionId, double weight) {
+  if (weight <= 0)
+    throw std::runtime_error("The weight of a session has to be positive");
+  std::lock_guard<lock_t> lk(_queueMutex);
+  _weights[sessionId] = weight;
+}
+
+epoch_t FairShareScheduler::getSessionTime(int sessionId) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  const auto time = _sessionTimes.find(sessionId);
+  return time == _sessionTimes.end() ? 0 : time->second;
+}
+
+epoch_t FairShareScheduler::getQueryTime(int queryId) {
+  std::lock_guard<lock_t> lk(_queueMutex);
+  for (const auto& session : _sessions) {
+    const auto query = session.second.queries.find(queryId);
+    if (query != session.second.queries.end())
+      return query->second.time;
+  }
+  return 0;
+}
+
+void FairShareScheduler::shutdown(){
+  {
+    std::lock_guard<lock_t> lk(_queueMutex);
+    _status = TO_STOP;
+    //wake up thread in case thread is sleeping
+    _condition.notify_all();
+  }
+  for(size_t i = 0; i < _worker_threads.size(); i++){
+    _worker_threads[i].join();
+  }
+  _worker_threads.clear();
+}
+
+size_t FairShareScheduler::getNumberOfWorker() const{
+  return _worker_threads.size();
+}
+
+} } // namespace hyrise::taskscheduler
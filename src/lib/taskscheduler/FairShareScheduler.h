@@ -0,0 +1,139 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "taskscheduler/AbstractTaskScheduler.h"
+#include "helper/epoch.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+class FairShareScheduler;
+
+// worker thread of the FairShareScheduler
+class FairShareWorkerThread {
+private:
+    FairShareScheduler &scheduler;
+    // core the thread is bound to, its index if threads are not bound
+    int core;
+public:
+    FairShareWorkerThread(FairShareScheduler &s, int core) : scheduler(s), core(core) { }
+    void operator()();
+};
+
+/**
+ * Central scheduler that shares the workers between sessions and queries
+ * by the CPU time they consumed instead of static priorities.
+ *
+ * Sessions are served by weighted fair queuing: every session has a
+ * virtual time that advances by the run time of its tasks divided by the
+ * weight of the session, and the next task is taken from the session with
+ * the smallest virtual time. A session that becomes active again starts
+ * at the virtual time of the last session served, so idling does not
+ * save up CPU time, plus the lead it had over it when it went idle. The
+ * lead halves every HISTORY_HALF_LIFE ns of idling, so a session cannot
+ * shed the CPU time it consumed by pausing briefly. Within a session, the query (the id of its tasks)
+ * that consumed the least CPU time runs first, so short queries finish
+ * ahead of long analytical ones; the time of a query is kept while it
+ * has tasks queued or running. Tasks of queries with a deadline run in
+ * earliest deadline order as soon as their deadline is less than the
+ * urgency horizon away.
+ *
+ * Tasks are not interrupted, a long operation yields the worker at task
+ * boundaries only. With a maximum task size, dynamic operations are split
+ * into instances of about that run time like in the
+ * DynamicPriorityScheduler, which bounds the time a short query waits
+ * for a worker.
+ */
+class FairShareScheduler :
+  public AbstractTaskScheduler,
+  public TaskReadyObserver,
+  public std::enable_shared_from_this<TaskReadyObserver> {
+  friend class FairShareWorkerThread;
+public:
+  static const epoch_t DEFAULT_URGENCY = 5 * 1000 * 1000;
+  static const epoch_t HISTORY_HALF_LIFE = 1000 * 1000 * 1000;
+
+  FairShareScheduler(int threads = getNumberOfCoresOnSystem());
+  virtual ~FairShareScheduler();
+
+  virtual void schedule(std::shared_ptr<Task> task);
+  virtual void notifyReady(std::shared_ptr<Task> task);
+  void shutdown();
+  size_t getNumberOfWorker() const;
+
+  void setMaxTaskSize(size_t maxTaskSize) {
+    _maxTaskSize = maxTaskSize;
+  }
+
+  /// Tasks whose deadline is closer than this many ns run before all others
+  void setUrgency(epoch_t urgency);
+
+  /// Share of the workers a session gets relative to others, 1 by default
+  void setSessionWeight(int sessionId, double weight);
+
+  /// CPU time in ns the tasks of a session consumed since the scheduler started
+  epoch_t getSessionTime(int sessionId);
+
+  /// CPU time in ns the tasks of a query consumed, 0 once it has no tasks left
+  epoch_t getQueryTime(int queryId);
+
+protected:
+  typedef struct query_state_t {
+    query_state_t() : time(0), queued(0), outstanding(0) {}
+    epoch_t time;
+    // tasks in the run queues, and those plus the running ones
+    size_t queued;
+    size_t outstanding;
+    std::deque<std::shared_ptr<Task>> tasks;
+  } query_state_t;
+
+  typedef struct session_state_t {
+    session_state_t() : virtualTime(0), queued(0), idleSince(0) {}
+    double virtualTime;
+    size_t queued;
+    // set once the last query of the session finished
+    epoch_t idleSince;
+    std::unordered_map<int, query_state_t> queries;
+  } session_state_t;
+
+  /// Adds a ready task to the run queues, splitting dynamic tasks
+  void enqueue(const std::shared_ptr<Task>& task);
+  void push(const std::shared_ptr<Task>& task);
+  /// Takes the next task from the run queues, nullptr if they are empty
+  std::shared_ptr<Task> next();
+  void finished(const std::shared_ptr<Task>& task, epoch_t time);
+  /// Share of the lead of a session that remains after idling
+  static double decay(epoch_t idle);
+
+  std::unordered_set<std::shared_ptr<Task>> _waitSet;
+  lock_t _setMutex;
+
+  // run queues, protected by _queueMutex
+  std::unordered_map<int, session_state_t> _sessions;
+  // tasks with a deadline, also queued with their query
+  std::multimap<epoch_t, std::shared_ptr<Task>> _deadlines;
+  // tasks in the run queues, the others are already taken
+  std::unordered_set<Task *> _queued;
+  std::map<int, double> _weights;
+  std::map<int, epoch_t> _sessionTimes;
+  double _virtualTime = 0;
+  epoch_t _urgency = DEFAULT_URGENCY;
+  lock_t _queueMutex;
+
+  std::vector<std::thread> _worker_threads;
+  std::condition_variable_any _condition;
+  scheduler_status_t _status;
+  size_t _maxTaskSize = 0;
+
+  static log4cxx::LoggerPtr _logger;
+};
+
+} } // namespace hyrise::taskscheduler
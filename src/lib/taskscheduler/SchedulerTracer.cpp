@@ -0,0 +1,245 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#include "taskscheduler/SchedulerTracer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <set>
+
+#include "helper/HwlocHelper.h"
+#include "taskscheduler/Task.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+/// An event in a ring buffer, copied word by word so readers never race
+/// with its writer
+struct SchedulerTracer::slot_t {
+  static const size_t WORDS = sizeof(trace_event_t) / sizeof(uint64_t);
+  static_assert(sizeof(trace_event_t) % sizeof(uint64_t) == 0, "trace events are copied in words");
+
+  // 2 * (i + 1) once it holds the i-th event of its buffer, odd while the
+  // event is written
+  std::atomic<size_t> sequence {0};
+  std::atomic<uint64_t> words[WORDS];
+
+  void write(size_t i, const trace_event_t& event) {
+    uint64_t copy[WORDS];
+    memcpy(copy, &event, sizeof(event));
+    sequence.store(2 * i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t w = 0; w < WORDS; ++w)
+      words[w].store(copy[w], std::memory_order_relaxed);
+    sequence.store(2 * i + 2, std::memory_order_release);
+  }
+
+  /// Copies the i-th event, false if the slot holds another one
+  bool read(size_t i, trace_event_t& event) const {
+    const size_t before = sequence.load(std::memory_order_acquire);
+    if (before != 2 * i + 2)
+      return false;
+    uint64_t copy[WORDS];
+    for (size_t w = 0; w < WORDS; ++w)
+      copy[w] = words[w].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) != before)
+      return false;
+    memcpy(&event, copy, sizeof(event));
+    return true;
+  }
+};
+
+struct SchedulerTracer::buffer_t {
+  buffer_t() : slots(CAPACITY), first(0), next(0), owned(true) {}
+
+  std::vector<slot_t> slots;
+  // events before first were cleared
+  std::atomic<size_t> first;
+  // number of events written, the last CAPACITY of them are kept
+  std::atomic<size_t> next;
+  std::atomic<bool> owned;
+};
+
+/// Hands the buffer of a thread back to the tracer when the thread ends
+struct SchedulerTracer::owner_t {
+  buffer_t* buffer = nullptr;
+
+  ~owner_t() {
+    if (buffer)
+      buffer->owned = false;
+  }
+};
+
+namespace {
+
+/// NUMA node of a core, 0 if it is unknown
+int nodeOfCore(int core) {
+  if (core < 0 || core >= getNumberOfCoresOnSystem())
+    return 0;
+  try {
+    return getNodeForCore(core);
+  } catch (const std::exception&) {
+    return 0;
+  }
+}
+
+void writeString(std::ostream& out, const char* value) {
+  out << '"';
+  for (; *value; ++value) {
+    if (*value == '"' || *value == '\\')
+      out << '\\';
+    if (static_cast<unsigned char>(*value) >= 0x20)
+      out << *value;
+  }
+  out << '"';
+}
+
+}
+
+SchedulerTracer& SchedulerTracer::getInstance() {
+  static SchedulerTracer tracer;
+  return tracer;
+}
+
+SchedulerTracer::SchedulerTracer() : _enabled(false) {}
+
+SchedulerTracer::~SchedulerTracer() {}
+
+void SchedulerTracer::setEnabled(bool enabled) {
+  _enabled = enabled;
+}
+
+void SchedulerTracer::enqueued(Task& task) {
+  if (isEnabled())
+    task.setEnqueueTime(get_epoch_nanoseconds());
+}
+
+void SchedulerTracer::execute(Task& task, int core) {
+  if (!isEnabled()) {
+    task();
+    return;
+  }
+
+  const epoch_t start = get_epoch_nanoseconds();
+  task();
+  record(task, core, -1, start, get_epoch_nanoseconds());
+}
+
+void SchedulerTracer::stolen(Task& task, int core, int victim) {
+  if (isEnabled()) {
+    const epoch_t now = get_epoch_nanoseconds();
+    record(task, core, victim, now, now);
+  }
+}
+
+void SchedulerTracer::record(Task& task, int core, int victim, epoch_t start, epoch_t end) {
+  auto* buffer = threadBuffer();
+  const size_t n = buffer->next.load(std::memory_order_relaxed);
+
+  trace_event_t event;
+  memset(&event, 0, sizeof(event));
+  const std::string name = task.vname();
+  const size_t length = std::min(name.size(), trace_event_t::NAME_LENGTH - 1);
+  memcpy(event.name, name.data(), length);
+  event.core = core;
+  event.victim = victim;
+  event.enqueued = task.getEnqueueTime();
+  event.start = start;
+  event.end = end;
+  buffer->slots[n % CAPACITY].write(n, event);
+
+  buffer->next.store(n + 1, std::memory_order_release);
+}
+
+SchedulerTracer::buffer_t* SchedulerTracer::threadBuffer() {
+  static thread_local owner_t owner;
+  if (owner.buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (const auto& buffer : _buffers) {
+      bool owned = false;
+      if (buffer->owned.compare_exchange_strong(owned, true)) {
+        owner.buffer = buffer.get();
+        break;
+      }
+    }
+    if (owner.buffer == nullptr) {
+      _buffers.emplace_back(new buffer_t);
+      owner.buffer = _buffers.back().get();
+    }
+  }
+  return owner.buffer;
+}
+
+std::vector<trace_event_t> SchedulerTracer::events() const {
+  std::vector<trace_event_t> result;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    trace_event_t event;
+    for (const auto& buffer : _buffers) {
+      const size_t n = buffer->next.load(std::memory_order_acquire);
+      for (size_t i = std::max(buffer->first.load(), n - std::min(n, CAPACITY)); i < n; ++i) {
+        if (buffer->slots[i % CAPACITY].read(i, event))
+          result.push_back(event);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end(), [] (const trace_event_t& a, const trace_event_t& b) {
+    return a.start < b.start;
+  });
+  return result;
+}
+
+void SchedulerTracer::writeChromeTrace(std::ostream& out) const {
+  const auto trace = events();
+  const epoch_t origin = trace.empty() ? 0 : trace.front().start;
+  std::map<int, int> nodes;
+  for (const auto& event : trace) {
+    if (!nodes.count(event.core))
+      nodes[event.core] = nodeOfCore(event.core);
+  }
+
+  // timestamps of the trace format are in us
+  const auto us = [origin] (epoch_t time) { return (time - origin) / 1000.0; };
+  out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+  bool first = true;
+  std::set<int> namedNodes;
+  for (const auto& core : nodes) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    if (namedNodes.insert(core.second).second) {
+      out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << core.second
+          << ", \"args\": {\"name\": \"NUMA node " << core.second << "\"}},\n";
+    }
+    out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << core.second << ", \"tid\": " << core.first
+        << ", \"args\": {\"name\": \"core " << core.first << "\"}}";
+  }
+
+  for (const auto& event : trace) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\": ";
+    writeString(out, event.name);
+    out << ", \"pid\": " << nodes[event.core] << ", \"tid\": " << event.core << ", \"ts\": " << us(event.start);
+    if (event.victim < 0) {
+      out << ", \"cat\": \"task\", \"ph\": \"X\", \"dur\": " << (event.end - event.start) / 1000.0 << ", \"args\": {";
+      if (event.enqueued > 0 && event.enqueued <= event.start)
+        out << "\"queueWaitUs\": " << (event.start - event.enqueued) / 1000.0 << ", ";
+      out << "\"node\": " << nodes[event.core] << "}}";
+    } else {
+      out << ", \"cat\": \"steal\", \"ph\": \"i\", \"s\": \"t\", \"args\": {\"from\": " << event.victim << "}}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+void SchedulerTracer::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  // the count of events only grows, a writer may still be recording
+  for (const auto& buffer : _buffers)
+    buffer->first = buffer->next.load();
+}
+
+}
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2012 Hasso-Plattner-Institut fuer Softwaresystemtechnik GmbH. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "helper/epoch.h"
+#include "helper/noncopyable.h"
+
+namespace hyrise {
+namespace taskscheduler {
+
+class Task;
+
+/// A task run by a worker, or a task stolen by one
+typedef struct trace_event_t {
+  static const size_t NAME_LENGTH = 32;
+
+  char name[NAME_LENGTH];
+  // core of the worker that ran or stole the task
+  int core;
+  // queue the task was stolen from, -1 if the task was run
+  int victim;
+  // 0 if the task was queued before tracing was enabled
+  epoch_t enqueued;
+  epoch_t start;
+  epoch_t end;
+} trace_event_t;
+
+/// Timeline of the tasks executed by the worker threads of the schedulers.
+///
+/// While enabled, queues stamp tasks when they are pushed, and workers
+/// record the queue wait and run time of every task they execute and the
+/// tasks they steal from other queues. Every thread writes into its own
+/// ring buffer of the last CAPACITY events without locking, so tracing
+/// costs two clock reads per task. The events are written as Chrome trace
+/// JSON, with one process per NUMA node and one thread per core, to be
+/// opened in chrome://tracing or Perfetto. Every slot of a ring buffer
+/// carries a sequence number, readers skip the events that are overwritten
+/// while they copy them, so disable tracing before writing the trace for
+/// a complete timeline. Clearing only moves the first event of every
+/// buffer, the threads keep writing.
+class SchedulerTracer : noncopyable {
+ public:
+  /// Events kept per thread
+  static const size_t CAPACITY = 1 << 14;
+
+  static SchedulerTracer& getInstance();
+
+  void setEnabled(bool enabled);
+  bool isEnabled() const {
+    return _enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Stamps a task that is pushed to a run queue
+  void enqueued(Task& task);
+  /// Runs a task on the worker of a core and records it
+  void execute(Task& task, int core);
+  void stolen(Task& task, int core, int victim);
+
+  /// Events of all threads, ordered by start time
+  std::vector<trace_event_t> events() const;
+
+  void writeChromeTrace(std::ostream& out) const;
+
+  /// Drops the events recorded so far
+  void clear();
+
+ private:
+  struct slot_t;
+  struct buffer_t;
+  struct owner_t;
+
+  SchedulerTracer();
+  ~SchedulerTracer();
+
+  void record(Task& task, int core, int victim, epoch_t start, epoch_t end);
+  buffer_t* threadBuffer();
+
+  std::atomic<bool> _enabled;
+  // buffers of all threads that recorded events, buffers of threads that
+  // ended are handed to new threads
+  mutable std::mutex _mtx;
+  std::vector<std::unique_ptr<buffer_t>> _buffers;
+};
+
+}
+}
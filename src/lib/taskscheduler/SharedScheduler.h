@@ -10,6 +10,7 @@
 
 #include <taskscheduler/AbstractTaskScheduler.h>
 #include <taskscheduler/DynamicPriorityScheduler.h>
+#include <taskscheduler/FairShareScheduler.h>
 #include <stdexcept>
 
 namespace hyrise {
@@ -72,6 +73,8 @@ public:
       _sharedScheduler = _schedulers[scheduler]->create(cores);
       if (auto dynamicScheduler = std::dynamic_pointer_cast<DynamicPriorityScheduler>(_sharedScheduler)) {
       	dynamicScheduler->setMaxTaskSize(maxTaskSize);
+      } else if (auto fairShareScheduler = std::dynamic_pointer_cast<FairShareScheduler>(_sharedScheduler)) {
+        fairShareScheduler->setMaxTaskSize(maxTaskSize);
       }
     } else
       throw SchedulerException("Requested scheduler was not registered");
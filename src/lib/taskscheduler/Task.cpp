@@ -156,6 +156,11 @@ int Task::getDependencyCount() {
   return _dependencies.size();
 }
 
+std::vector<task_ptr_t> Task::getDependencies() {
+  std::lock_guard<decltype(_depMutex)> lk(_depMutex);
+  return _dependencies;
+}
+
 // TODO make nicer; method needed to identify result task of a query
 // in the query tree, we have no successor if we have no doneObserver
 bool Task::hasSuccessors() {
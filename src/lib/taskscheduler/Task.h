@@ -13,6 +13,7 @@
 #include <condition_variable>
 #include <string>
 
+#include "helper/epoch.h"
 #include "helper/locking.h"
 #include "helper/types.h"
 
@@ -85,6 +86,12 @@ protected:
   int _sessionId;
   // id - equals transaction id
   int _id;
+  // time the task was pushed to a run queue, only set while the
+  // SchedulerTracer is enabled
+  epoch_t _enqueueTime = 0;
+  // time by which the query of the task should be done, 0 for none;
+  // used by the FairShareScheduler
+  epoch_t _deadline = 0;
 
   // if true, the DynamicPriorityScheduler will determine the number of instances.
   bool _dynamic = false;
@@ -130,6 +137,10 @@ public:
    * gets the number of dependencies
    */
   int getDependencyCount();
+  /*
+   * gets a copy of the dependencies
+   */
+  std::vector<task_ptr_t> getDependencies();
   /*
    * set dependencies directly and not managed by Task; make sure dependency count and dependencies match;
    * currently used to set dependencies for a task that is ready to run (no unmet dependencies), but needs to get inputs
@@ -219,6 +230,22 @@ public:
     _sessionId = sessionId;
   }
 
+  epoch_t getEnqueueTime() const {
+    return _enqueueTime;
+  }
+
+  void setEnqueueTime(epoch_t enqueueTime) {
+    _enqueueTime = enqueueTime;
+  }
+
+  epoch_t getDeadline() const {
+    return _deadline;
+  }
+
+  void setDeadline(epoch_t deadline) {
+    _deadline = deadline;
+  }
+
   // used in the DynamicPriorityScheduler
   // if true and task is ParallizablePlanOperation the number of instances is determined
   // by an operators determineDynamicCount operation.
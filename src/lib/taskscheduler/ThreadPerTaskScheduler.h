@@ -8,6 +8,7 @@
 #pragma once
 
 #include "AbstractTaskScheduler.h"
+#include "helper/PerfEventTracer.h"
 #include <taskscheduler/SharedScheduler.h>
 #include <memory>
 
@@ -23,6 +24,9 @@ class TaskExecutor {
 public:
   TaskExecutor(std::shared_ptr<Task> task) : _task(task) { }
   void operator()(){
+    // the thread ends with its task, opening counters would cost more
+    // than the task
+    PerfEventTracer::disableForThread();
     (*_task)();
     _task->notifyDoneObservers();
   };
@@ -7,6 +7,8 @@
 
 #include "WSCoreBoundPriorityQueue.h"
 
+#include "taskscheduler/SchedulerTracer.h"
+
 namespace hyrise {
 namespace taskscheduler {
 
@@ -56,7 +58,7 @@ void WSCoreBoundPriorityQueue::executeTask() {
       //LOG4CXX_DEBUG(logger, "Started executing task" << std::hex << &task << std::dec << " on core " << _core);
       // run task
       //std::cout << "Running task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
-      (*task)();
+      SchedulerTracer::getInstance().execute(*task, _core);
       //std::cout << "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
 
       LOG4CXX_DEBUG(logger, "Executed task " << std::hex << &task << std::dec << " on core " << _core);
@@ -76,6 +78,7 @@ std::shared_ptr<Task> WSCoreBoundPriorityQueue::stealTasks() {
         // we steal relative from the current queue to distribute stealing over queues
         task = static_cast<WSCoreBoundPriorityQueue *>(_allQueues->at((i + _core) % number_of_queues))->stealTask();
         if (task != nullptr) {
+          SchedulerTracer::getInstance().stolen(*task, _core, (i + _core) % number_of_queues);
           //push(task);
           //std::cout << "Queue " << _core << " stole Task " <<  task->vname() << "; hex " << std::hex << &task << std::dec << " from queue " << i << std::endl;
           break;
@@ -99,6 +102,7 @@ std::shared_ptr<Task> WSCoreBoundPriorityQueue::stealTask() {
 
 
 void WSCoreBoundPriorityQueue::push(std::shared_ptr<Task> task) {
+  SchedulerTracer::getInstance().enqueued(*task);
   // mutex is bad! but apparently we need it, otherwise, threads do not know whether they can sleep, cause runqueue.size may be incorrect if not synced
   std::lock_guard<lock_t> lk(_queueMutex);
   _runQueue.push(task);
@@ -7,6 +7,8 @@
 
 #include "WSCoreBoundQueue.h"
 
+#include "taskscheduler/SchedulerTracer.h"
+
 namespace hyrise {
 namespace taskscheduler {
 
@@ -60,7 +62,7 @@ void WSCoreBoundQueue::executeTask() {
       //LOG4CXX_DEBUG(logger, "Started executing task" << std::hex << &task << std::dec << " on core " << _core);
       // run task
       //std::cout << "Running task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
-      (*task)();
+      SchedulerTracer::getInstance().execute(*task, _core);
       //std::cout << "Executed task " << task->vname() << "; hex " << std::hex << &task << std::dec << " on core " << _core<< std::endl;
 
       LOG4CXX_DEBUG(logger, "Executed task " << std::hex << &task << std::dec << " on core " << _core);
@@ -84,6 +86,7 @@ std::shared_ptr<Task> WSCoreBoundQueue::stealTasks() {
           // we steal relative from the current queue to distribute stealing over queues
           task = static_cast<WSCoreBoundQueue *>(queues->at((i + _core) % number_of_queues))->stealTask();
           if (task != nullptr) {
+            SchedulerTracer::getInstance().stolen(*task, _core, (i + _core) % number_of_queues);
             //push(task);
             //std::cout << "Queue " << _core << " stole Task " <<  task->vname() << "; hex " << std::hex << &task << std::dec << " from queue " << i << std::endl;
             break;
@@ -108,6 +111,7 @@ std::shared_ptr<Task> WSCoreBoundQueue::stealTask() {
 }
 
 void WSCoreBoundQueue::push(std::shared_ptr<Task> task) {
+  SchedulerTracer::getInstance().enqueued(*task);
   std::lock_guard<lock_t> lk(_queueMutex);
   _runQueue.push_back(task);
   _condition.notify_one();
@@ -3,11 +3,17 @@
 
 #include <helper/PapiTracer.h>
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <math.h>
 #include <string>
 #include <map>
+#include <vector>
 
 typedef class values {
  private:
@@ -15,12 +21,14 @@ typedef class values {
  public:
   double stddev, mean, min, max;
   size_t num_values;
+  std::vector<double> samples;
   values() :
       tmp_stddev(0), stddev(0), mean(0),
       min(std::numeric_limits<PapiTracer::result_t>::max()), max(0),
       num_values(0) {}
 
   void updateWith(double value) {
+    samples.push_back(value);
     min = value < min ? value : min;
     max = value > max ? value : max;
 
@@ -30,22 +38,34 @@ typedef class values {
     mean += delta / num_values;
     tmp_stddev += delta * (value - mean);
 
-    auto variance = tmp_stddev / (num_values - 1);
+    auto variance = num_values > 1 ? tmp_stddev / (num_values - 1) : 0;
     stddev = sqrt(variance);
   }
+
+  // Nearest rank percentile of the samples, p in [0, 1]
+  double percentile(double p) const {
+    if (samples.empty())
+      return 0;
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    const size_t rank = static_cast<size_t>(ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+  }
 } values_t;
 
 void testing::Benchmark::logValue(const std::string& key,
                                   double value) const {
 
     std::stringstream tmp;
-    tmp << value;
+    tmp << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
     RecordProperty(key.c_str(), tmp.str().c_str());
 }
 
 void testing::Benchmark::TestBody()
 {
   std::map<std::string, values_t> counters { {"PAPI_TOT_CYC", {} }, {PapiEvent(), {}} };
+  // wall clock time of the body, also when PAPI is not available
+  values_t time;
   for(int i=0; i < NumIterations() + WarmUp(); ++i) {
       BenchmarkSetUp();
 
@@ -54,20 +74,24 @@ void testing::Benchmark::TestBody()
         pt.addEvent(kv.first);
       }
 
+      const auto start = std::chrono::steady_clock::now();
       pt.start();
       BenchmarkBody();
       pt.stop();
+      const auto end = std::chrono::steady_clock::now();
 
       BenchmarkTearDown();
       if (i >= WarmUp()) {
         for (auto& kv: counters) {
           kv.second.updateWith(pt.value(kv.first));
         }
+        time.updateWith(std::chrono::duration<double, std::nano>(end - start).count());
       }
 
 
   }
 
+  counters.emplace("TIME_NS", time);
   for (auto& kv: counters) {
     const auto& key = kv.first;
     auto& values = kv.second;
@@ -75,5 +99,13 @@ void testing::Benchmark::TestBody()
     logValue(key+"_MAX", values.max);
     logValue(key+"_MEAN", values.mean);
     logValue(key+"_STDDEV", values.stddev);
+    logValue(key+"_MEDIAN", values.percentile(0.5));
+    logValue(key+"_P95", values.percentile(0.95));
   }
+  logValue("ITERATIONS", NumIterations());
+
+  // peak resident memory of the process so far, in kB on Linux
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    logValue("MAX_RSS_KB", usage.ru_maxrss);
 }
@@ -2,9 +2,14 @@
 #define GTEST_BENCHMARK_H
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 // Helper macro for defining tests.
@@ -152,6 +157,100 @@ namespace testing
 	    }
     };
 
+    // Writes the properties logged by every benchmark to a file once all
+    // benchmarks ran, either as JSON
+    //
+    //   {"benchmarks": [{"name": "Case.test", "results": {"TIME_NS_MEAN": 1.5, ...}}, ...]}
+    //
+    // or as CSV with one line per benchmark and property
+    //
+    //   benchmark,metric,value
+    //   "Case.test","TIME_NS_MEAN",1.5
+    //
+    // tools/benchcompare.py compares two such files.
+    class BenchmarkResultWriter : public ::testing::EmptyTestEventListener
+    {
+    public:
+        typedef enum { JSON, CSV } format_t;
+
+    private:
+        typedef std::vector<std::pair<std::string, std::string> > properties_t;
+
+        const ::std::string filename;
+        const format_t format;
+        std::vector<std::pair<std::string, properties_t> > results;
+
+        static bool isNumber(const std::string& value)
+        {
+            // nan and inf are not valid JSON numbers
+            char* end = NULL;
+            const double number = strtod(value.c_str(), &end);
+            return !value.empty() && *end == '\0' && std::isfinite(number);
+        }
+
+        static std::string quote(const std::string& value, char escape)
+        {
+            std::string quoted = "\"";
+            for (size_t i = 0; i < value.size(); ++i)
+            {
+                if (value[i] == '"' || (escape == '\\' && value[i] == '\\'))
+                    quoted += escape;
+                quoted += value[i];
+            }
+            return quoted + "\"";
+        }
+
+    public:
+        BenchmarkResultWriter(const std::string& _filename, format_t _format) : filename(_filename), format(_format)
+        {
+        }
+
+        virtual void OnTestEnd(const ::testing::TestInfo& test_info)
+        {
+            const TestResult* tr = test_info.result();
+            properties_t properties;
+            for (int i = 0; i < tr->test_property_count(); ++i)
+            {
+                properties.push_back(std::make_pair(tr->GetTestProperty(i).key(), tr->GetTestProperty(i).value()));
+            }
+            results.push_back(std::make_pair(std::string(test_info.test_case_name()) + "." + test_info.name(), properties));
+        }
+
+        virtual void OnTestProgramEnd(const UnitTest&)
+        {
+            std::ofstream out(filename.c_str());
+            if (format == CSV)
+            {
+                out << "benchmark,metric,value\n";
+                for (size_t i = 0; i < results.size(); ++i)
+                {
+                    for (size_t j = 0; j < results[i].second.size(); ++j)
+                    {
+                        const std::string& value = results[i].second[j].second;
+                        // names of parameterized benchmarks may contain commas
+                        out << quote(results[i].first, '"') << "," << quote(results[i].second[j].first, '"') << ","
+                            << (isNumber(value) ? value : quote(value, '"')) << "\n";
+                    }
+                }
+                return;
+            }
+
+            out << "{\"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                out << (i ? ",\n" : "\n") << "{\"name\": " << quote(results[i].first, '\\') << ", \"results\": {";
+                for (size_t j = 0; j < results[i].second.size(); ++j)
+                {
+                    const std::string& value = results[i].second[j].second;
+                    out << (j ? ", " : "") << quote(results[i].second[j].first, '\\') << ": "
+                        << (isNumber(value) ? value : quote(value, '\\'));
+                }
+                out << "}}";
+            }
+            out << "\n]}\n";
+        }
+    };
+
     class Benchmark : public ::testing::Test
     {
 
@@ -0,0 +1,151 @@
+#!/usr/bin/env python
+"""Compares two runs of hyrise-perf written with
+
+    hyrise-perf --benchmark_output=json:<file>   (or csv:<file>)
+
+For every benchmark of both runs the mean of a metric is compared with
+Welch's t-test on the mean, standard deviation and number of iterations
+each run logged. A change counts as a regression or improvement if it
+is larger than the threshold and significant at the given level. The
+exit status is 1 if any benchmark regressed, so the tool can gate a
+release:
+
+    tools/benchcompare.py baseline.json candidate.json --metric TIME_NS
+"""
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import math
+import re
+import sys
+
+
+def load(path):
+    """Returns {benchmark: {property: value}} of a JSON or CSV result file"""
+    with open(path) as f:
+        content = f.read()
+    results = {}
+    if content.lstrip().startswith("{"):
+        for benchmark in json.loads(content)["benchmarks"]:
+            results[benchmark["name"]] = benchmark["results"]
+    else:
+        for row in csv.DictReader(content.splitlines()):
+            try:
+                value = float(row["value"])
+            except ValueError:
+                value = row["value"]
+            results.setdefault(row["benchmark"], {})[row["metric"]] = value
+    return results
+
+
+def betacf(a, b, x):
+    """Continued fraction of the incomplete beta function"""
+    qab, qap, qam = a + b, a + 1.0, a - 1.0
+    c, d = 1.0, 1.0 - qab * x / qap
+    d = 1.0 / (d if abs(d) > 1e-30 else 1e-30)
+    h = d
+    for m in range(1, 201):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > 1e-30 else 1e-30)
+        c = 1.0 + aa / c
+        c = c if abs(c) > 1e-30 else 1e-30
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > 1e-30 else 1e-30)
+        c = 1.0 + aa / c
+        c = c if abs(c) > 1e-30 else 1e-30
+        delta = d * c
+        h *= delta
+        if abs(delta - 1.0) < 3e-12:
+            break
+    return h
+
+
+def betainc(a, b, x):
+    """Regularized incomplete beta function I_x(a, b)"""
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                     a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * betacf(a, b, x) / a
+    return 1.0 - front * betacf(b, a, 1.0 - x) / b
+
+
+def welch(mean1, stddev1, n1, mean2, stddev2, n2):
+    """Two-sided p-value of Welch's t-test for equal means"""
+    if n1 < 2 or n2 < 2:
+        # no estimate of the variance of a single iteration
+        return 1.0
+    v1 = stddev1 ** 2 / n1
+    v2 = stddev2 ** 2 / n2
+    if v1 + v2 == 0:
+        return 1.0 if mean1 == mean2 else 0.0
+    t = (mean2 - mean1) / math.sqrt(v1 + v2)
+    df = (v1 + v2) ** 2 / (v1 ** 2 / (n1 - 1) + v2 ** 2 / (n2 - 1))
+    return betainc(df / 2.0, 0.5, df / (df + t * t))
+
+
+def statistics(results, metric):
+    mean = results.get(metric + "_MEAN")
+    if mean is None:
+        return None
+    return (float(mean), float(results.get(metric + "_STDDEV", 0)), int(results.get("ITERATIONS", 1)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two hyrise-perf result files")
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--metric", default="TIME_NS",
+                        help="metric to compare, e.g. TIME_NS or PAPI_TOT_CYC (default %(default)s)")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative change below which benchmarks count as unchanged (default %(default)s)")
+    parser.add_argument("--alpha", type=float, default=0.05,
+                        help="significance level of the t-test (default %(default)s)")
+    parser.add_argument("--higher-is-better", action="store_true",
+                        help="the metric is a throughput, not a latency or cost")
+    parser.add_argument("--filter", default="", help="regular expression the benchmark names must match")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+    pattern = re.compile(args.filter)
+
+    regressions = 0
+    print("%-50s %14s %14s %9s %8s  %s" % ("Benchmark", "Baseline", "Candidate", "Change", "p", "Verdict"))
+    for name in sorted(set(baseline) | set(candidate)):
+        if not pattern.search(name):
+            continue
+        before = statistics(baseline.get(name, {}), args.metric)
+        after = statistics(candidate.get(name, {}), args.metric)
+        if before is None and after is None:
+            # the benchmark does not log the metric
+            continue
+        if before is None or after is None:
+            print("%-50s %s" % (name, "only in " + (args.candidate if before is None else args.baseline)))
+            continue
+
+        change = (after[0] - before[0]) / before[0] if before[0] else 0.0
+        p = welch(before[0], before[1], before[2], after[0], after[1], after[2])
+        worse = change < 0 if args.higher_is_better else change > 0
+        verdict = "same"
+        if p < args.alpha and abs(change) > args.threshold:
+            verdict = "REGRESSION" if worse else "improvement"
+            regressions += verdict == "REGRESSION"
+        print("%-50s %14.6g %14.6g %+8.1f%% %8.3f  %s" % (name, before[0], after[0], 100 * change, p, verdict))
+
+    if regressions:
+        print("%d benchmark(s) regressed" % regressions)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())